@@ -5,6 +5,7 @@
 #include "flutter/assets/asset_manager.h"
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/common/startup_profile.h"
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -68,6 +69,7 @@ std::unique_ptr<fml::Mapping> AssetManager::GetAsMapping(
   for (const auto& resolver : resolvers_) {
     auto mapping = resolver->GetAsMapping(asset_name);
     if (mapping != nullptr) {
+      StartupProfile::Record(StartupProfile::Kind::kAsset, asset_name);
       return mapping;
     }
   }
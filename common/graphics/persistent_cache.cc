@@ -4,11 +4,14 @@
 
 #include "flutter/common/graphics/persistent_cache.h"
 
+#include <algorithm>
 #include <future>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 
+#include "flutter/common/startup_profile.h"
 #include "flutter/fml/base32.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/hex_codec.h"
@@ -47,6 +50,8 @@ std::string PersistentCache::SkKeyToFilePath(const SkData& key) {
 
 bool PersistentCache::gIsReadOnly = false;
 
+size_t PersistentCache::gMaxCacheFileBytes = 16 * 1024 * 1024;
+
 std::atomic<bool> PersistentCache::cache_sksl_ = false;
 std::atomic<bool> PersistentCache::strategy_set_ = false;
 
@@ -85,7 +90,15 @@ bool PersistentCache::Purge() {
 
   std::promise<bool> removed;
   GetWorkerTaskRunner()->PostTask([&removed,
-                                   cache_directory = cache_directory_]() {
+                                   cache_directory = cache_directory_,
+                                   cache_file = cache_file_,
+                                   sksl_cache_file = sksl_cache_file_]() {
+    if (cache_file) {
+      cache_file->Clear();
+    }
+    if (sksl_cache_file) {
+      sksl_cache_file->Clear();
+    }
     if (cache_directory->is_valid()) {
       // Only remove files but not directories.
       FML_LOG(INFO) << "Purge persistent cache.";
@@ -190,11 +203,21 @@ sk_sp<SkData> ParseBase64(const std::string& input) {
   return data;
 }
 
-size_t PersistentCache::PrecompileKnownSkSLs(GrDirectContext* context) const {
+size_t PersistentCache::PrecompileKnownSkSLs(GrDirectContext* context) {
+  precompiled_known_sksls_ = true;
+  std::optional<std::vector<SkSLCache>> prepared_sksls;
+  {
+    std::scoped_lock lock(prepared_sksls_mutex_);
+    if (prepared_sksls_asset_manager_ == asset_manager_) {
+      prepared_sksls = std::move(prepared_sksls_);
+    }
+    prepared_sksls_.reset();
+    prepared_sksls_asset_manager_ = nullptr;
+  }
   // clang-tidy has trouble reasoning about some of the complicated array and
   // pointer-arithmetic code in rapidjson.
   // NOLINTNEXTLINE(clang-analyzer-cplusplus.PlacementNew)
-  auto known_sksls = LoadSkSLs();
+  auto known_sksls = prepared_sksls ? std::move(*prepared_sksls) : LoadSkSLs();
   // A trace must be present even if no precompilations have been completed.
   FML_TRACE_EVENT("flutter", "PersistentCache::PrecompileKnownSkSLs", "count",
                   known_sksls.size());
@@ -217,11 +240,58 @@ size_t PersistentCache::PrecompileKnownSkSLs(GrDirectContext* context) const {
   return precompiled_count;
 }
 
+void PersistentCache::PrepareKnownSkSLs(
+    const std::vector<std::string>& usage_order) {
+  TRACE_EVENT0("flutter", "PersistentCache::PrepareKnownSkSLs");
+  // Once the SkSLs have been precompiled they are only needed again if the
+  // rendering context is recreated, which is not worth holding on to them.
+  if (precompiled_known_sksls_) {
+    return;
+  }
+  auto asset_manager = asset_manager_;
+  auto sksls = LoadSkSLs();
+
+  std::unordered_map<std::string, size_t> usage_index;
+  for (size_t i = 0; i < usage_order.size(); i++) {
+    usage_index.emplace(usage_order[i], i);
+  }
+  std::vector<std::pair<size_t, SkSLCache>> ordered;
+  ordered.reserve(sksls.size());
+  for (auto& sksl : sksls) {
+    auto found = usage_index.find(SkKeyToFilePath(*sksl.key));
+    ordered.emplace_back(
+        found == usage_index.end() ? usage_order.size() : found->second,
+        std::move(sksl));
+  }
+  std::stable_sort(
+      ordered.begin(), ordered.end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; });
+  sksls.clear();
+  for (auto& [index, sksl] : ordered) {
+    sksls.push_back(std::move(sksl));
+  }
+
+  std::scoped_lock lock(prepared_sksls_mutex_);
+  if (precompiled_known_sksls_) {
+    return;
+  }
+  prepared_sksls_ = std::move(sksls);
+  prepared_sksls_asset_manager_ = std::move(asset_manager);
+}
+
 std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
   TRACE_EVENT0("flutter", "PersistentCache::LoadSkSLs");
   std::vector<PersistentCache::SkSLCache> result;
+  if (sksl_cache_file_) {
+    for (auto& entry : sksl_cache_file_->GetEntries()) {
+      result.push_back({std::move(entry.key), std::move(entry.value)});
+    }
+  }
   fml::FileVisitor visitor = [&result](const fml::UniqueFD& directory,
                                        const std::string& filename) {
+    if (filename == PersistentCacheFile::kFileName) {
+      return true;
+    }
     SkSLCache cache = LoadFile(directory, filename, true);
     if (cache.key != nullptr && cache.value != nullptr) {
       result.push_back(cache);
@@ -278,14 +348,35 @@ PersistentCache::PersistentCache(bool read_only)
     : is_read_only_(read_only),
       cache_directory_(MakeCacheDirectory(cache_base_path_, read_only, false)),
       sksl_cache_directory_(
-          MakeCacheDirectory(cache_base_path_, read_only, true)) {
+          MakeCacheDirectory(cache_base_path_, read_only, true)),
+      cache_file_(cache_directory_ && cache_directory_->is_valid()
+                      ? std::make_shared<PersistentCacheFile>(
+                            cache_directory_, gMaxCacheFileBytes)
+                      : nullptr),
+      sksl_cache_file_(
+          sksl_cache_directory_ && sksl_cache_directory_->is_valid()
+              ? std::make_shared<PersistentCacheFile>(sksl_cache_directory_,
+                                                      gMaxCacheFileBytes)
+              : nullptr),
+      flush_scheduled_(std::make_shared<std::atomic<bool>>(false)) {
   if (!IsValid()) {
     FML_LOG(WARNING) << "Could not acquire the persistent cache directory. "
                         "Caching of GPU resources on disk is disabled.";
   }
 }
 
-PersistentCache::~PersistentCache() = default;
+PersistentCache::~PersistentCache() {
+  // Write what was stored since the last flush, as a flush that is still
+  // scheduled may not run before the process exits.
+  if (!is_read_only_) {
+    if (cache_file_) {
+      cache_file_->Flush();
+    }
+    if (sksl_cache_file_) {
+      sksl_cache_file_->Flush();
+    }
+  }
+}
 
 bool PersistentCache::IsValid() const {
   return cache_directory_ && cache_directory_->is_valid();
@@ -335,14 +426,68 @@ sk_sp<SkData> PersistentCache::load(const SkData& key) {
   if (file_name.empty()) {
     return nullptr;
   }
-  auto result =
-      PersistentCache::LoadFile(*cache_directory_, file_name, false).value;
+  // Shaders that are asked for are recorded whether they are found or not,
+  // as the ones that are not found are compiled and stored.
+  StartupProfile::Record(StartupProfile::Kind::kShader, file_name);
+  sk_sp<SkData> result;
+  {
+    std::scoped_lock lock(prefetched_mutex_);
+    auto found = prefetched_.find(file_name);
+    if (found != prefetched_.end()) {
+      result = std::move(found->second);
+      prefetched_.erase(found);
+    }
+  }
+  if (result == nullptr && cache_file_) {
+    result = cache_file_->Load(file_name);
+  }
+  if (result == nullptr) {
+    result =
+        PersistentCache::LoadFile(*cache_directory_, file_name, false).value;
+  }
   if (result != nullptr) {
     TRACE_EVENT0("flutter", "PersistentCacheLoadHit");
   }
   return result;
 }
 
+size_t PersistentCache::Prefetch(const std::vector<std::string>& file_names) {
+  TRACE_EVENT0("flutter", "PersistentCachePrefetch");
+  if (!IsValid()) {
+    return 0;
+  }
+  size_t count = 0;
+  for (const auto& file_name : file_names) {
+    {
+      std::scoped_lock lock(prefetched_mutex_);
+      if (prefetch_discarded_) {
+        break;
+      }
+    }
+    auto value = cache_file_ ? cache_file_->Load(file_name) : nullptr;
+    if (value == nullptr) {
+      value =
+          PersistentCache::LoadFile(*cache_directory_, file_name, false).value;
+    }
+    if (value == nullptr) {
+      continue;
+    }
+    std::scoped_lock lock(prefetched_mutex_);
+    if (prefetch_discarded_) {
+      break;
+    }
+    prefetched_.emplace(file_name, std::move(value));
+    count++;
+  }
+  return count;
+}
+
+void PersistentCache::DiscardPrefetched() {
+  std::scoped_lock lock(prefetched_mutex_);
+  prefetch_discarded_ = true;
+  prefetched_.clear();
+}
+
 static void PersistentCacheStore(fml::RefPtr<fml::TaskRunner> worker,
                                  std::shared_ptr<fml::UniqueFD> cache_directory,
                                  std::string key,
@@ -409,14 +554,43 @@ void PersistentCache::store(const SkData& key, const SkData& data) {
     return;
   }
 
-  std::unique_ptr<fml::MallocMapping> mapping = BuildCacheObject(key, data);
-  if (!mapping) {
+  auto& cache_file = cache_sksl_ ? sksl_cache_file_ : cache_file_;
+  if (!cache_file) {
     return;
   }
+  cache_file->Store(file_name, key, data);
+  ScheduleFlush();
+}
 
-  PersistentCacheStore(GetWorkerTaskRunner(),
-                       cache_sksl_ ? sksl_cache_directory_ : cache_directory_,
-                       std::move(file_name), std::move(mapping));
+void PersistentCache::ScheduleFlush() {
+  if (flush_scheduled_->exchange(true)) {
+    return;
+  }
+  auto task = [flush_scheduled = flush_scheduled_,  //
+               cache_file = cache_file_,            //
+               sksl_cache_file = sksl_cache_file_   //
+  ]() {
+    flush_scheduled->store(false);
+    if (cache_file) {
+      cache_file->Flush();
+    }
+    if (sksl_cache_file) {
+      sksl_cache_file->Flush();
+    }
+  };
+
+  auto worker = GetWorkerTaskRunner();
+  if (!worker) {
+    FML_LOG(WARNING)
+        << "The persistent cache has no available workers. Performing the task "
+           "on the current thread. This slow operation is going to occur on a "
+           "frame workload.";
+    task();
+    return;
+  }
+  // The shaders of a frame are compiled one after the other, so waiting a
+  // moment lets one write cover all of them.
+  worker->PostDelayedTask(task, fml::TimeDelta::FromMilliseconds(500));
 }
 
 void PersistentCache::DumpSkp(const SkData& data) {
@@ -5,11 +5,17 @@
 #ifndef FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_H_
 #define FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_H_
 
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "flutter/assets/asset_manager.h"
+#include "flutter/common/graphics/persistent_cache_file.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
 #include "flutter/fml/unique_fd.h"
@@ -25,6 +31,12 @@ class ShellTest;
 ///
 /// This is mainly used for Shaders but is also written to by Dart.  It is
 /// thread-safe for reading and writing from multiple threads.
+///
+/// Entries are stored in a single |PersistentCacheFile| per directory, which
+/// is written on a worker a moment after entries are stored so that the
+/// stores of a frame are written together. Entries that were stored in a
+/// file of their own by earlier versions, or that ship as read-only files,
+/// are still loaded.
 class PersistentCache : public GrContextOptions::PersistentCache {
  public:
   // Mutable static switch that can be set before GetCacheForProcess. If true,
@@ -34,6 +46,11 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   // packages.
   static bool gIsReadOnly;
 
+  // Mutable static switch that can be set before GetCacheForProcess. The
+  // size the entries of each cache file are trimmed to when it is written,
+  // dropping the least recently used entries first.
+  static size_t gMaxCacheFileBytes;
+
   static PersistentCache* GetCacheForProcess();
   static void ResetCacheForProcess();
 
@@ -88,6 +105,34 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   // |GrContextOptions::PersistentCache|
   sk_sp<SkData> load(const SkData& key) override;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Reads the given cache files into memory so that the next
+  ///             |load| of each of them does not have to touch the disk.
+  ///             This is meant to be called on a worker while the engine
+  ///             starts up, with the files a previous launch loaded before
+  ///             its first frame.
+  ///
+  /// @param      file_names  Names of files in the cache directory, as
+  ///                         returned by |SkKeyToFilePath|.
+  ///
+  /// @return     The number of files that were read.
+  ///
+  size_t Prefetch(const std::vector<std::string>& file_names);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Drops the prefetched files that were not loaded, and stops
+  ///             any later or ongoing |Prefetch|. This is meant to be called
+  ///             once the first frame has been rasterized, as the files the
+  ///             startup did not ask for by then may never be asked for.
+  ///
+  void DiscardPrefetched();
+
+  /// The directory the cache is stored in, or nullptr if it could not be
+  /// opened.
+  std::shared_ptr<fml::UniqueFD> GetCacheDirectory() const {
+    return IsValid() ? cache_directory_ : nullptr;
+  }
+
   struct SkSLCache {
     sk_sp<SkData> key;
     sk_sp<SkData> value;
@@ -109,7 +154,19 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   ///
   /// @return     The number of SkSLs precompiled.
   ///
-  size_t PrecompileKnownSkSLs(GrDirectContext* context) const;
+  size_t PrecompileKnownSkSLs(GrDirectContext* context);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Loads the SkSLs that |PrecompileKnownSkSLs| precompiles
+  ///             ahead of time, so that only the compilation itself is left
+  ///             for the thread of the rendering context. Meant to be called
+  ///             on a worker during startup.
+  ///
+  /// @param      usage_order  The file names of the shaders in the order a
+  ///                          previous launch first used them. Those SkSLs
+  ///                          are precompiled first, in that order.
+  ///
+  void PrepareKnownSkSLs(const std::vector<std::string>& usage_order);
 
   // Return mappings for all skp's accessible through the AssetManager
   std::vector<std::unique_ptr<fml::Mapping>> GetSkpsFromAssetManager() const;
@@ -151,8 +208,21 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   const bool is_read_only_;
   const std::shared_ptr<fml::UniqueFD> cache_directory_;
   const std::shared_ptr<fml::UniqueFD> sksl_cache_directory_;
+  const std::shared_ptr<PersistentCacheFile> cache_file_;
+  const std::shared_ptr<PersistentCacheFile> sksl_cache_file_;
+  // Whether a flush of the cache files has been posted and not run yet.
+  const std::shared_ptr<std::atomic<bool>> flush_scheduled_;
   mutable std::mutex worker_task_runners_mutex_;
   std::multiset<fml::RefPtr<fml::TaskRunner>> worker_task_runners_;
+  std::mutex prefetched_mutex_;
+  std::unordered_map<std::string, sk_sp<SkData>> prefetched_;
+  bool prefetch_discarded_ = false;
+  // The SkSLs loaded by |PrepareKnownSkSLs| and the asset manager they were
+  // loaded from.
+  std::mutex prepared_sksls_mutex_;
+  std::optional<std::vector<SkSLCache>> prepared_sksls_;
+  std::shared_ptr<AssetManager> prepared_sksls_asset_manager_;
+  std::atomic<bool> precompiled_known_sksls_ = false;
 
   bool stored_new_shaders_ = false;
   bool is_dumping_skp_ = false;
@@ -170,6 +240,10 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   fml::RefPtr<fml::TaskRunner> GetWorkerTaskRunner() const;
 
+  // Writes the cache files on a worker after a short delay, unless that is
+  // already going to happen.
+  void ScheduleFlush();
+
   friend class testing::ShellTest;
 
   FML_DISALLOW_COPY_AND_ASSIGN(PersistentCache);
@@ -0,0 +1,368 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/graphics/persistent_cache_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr uint32_t kSignature = 0x46435346;
+constexpr uint32_t kVersion = 1;
+// The hashes of the keys are hex encoded SHA-1 digests.
+constexpr size_t kHashSize = 40;
+
+struct FileHeader {
+  uint32_t signature;
+  uint32_t version;
+  uint32_t entry_count;
+  uint32_t reserved;
+  uint64_t use_count;
+  uint64_t index_checksum;
+};
+
+struct IndexEntry {
+  char hash[kHashSize];
+  uint32_t key_size;
+  uint32_t value_size;
+  uint64_t offset;
+  uint64_t last_use;
+  uint64_t checksum;
+};
+
+// 64-bit FNV-1a. It only has to catch truncated and partially written data,
+// not deliberate tampering.
+uint64_t Checksum(const uint8_t* data,
+                  size_t size,
+                  uint64_t hash = 0xcbf29ce484222325) {
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+uint64_t Checksum(const SkData& key, const SkData& value) {
+  return Checksum(value.bytes(), value.size(),
+                  Checksum(key.bytes(), key.size()));
+}
+
+}  // namespace
+
+PersistentCacheFile::PersistentCacheFile(
+    std::shared_ptr<fml::UniqueFD> directory,
+    size_t max_bytes)
+    : directory_(std::move(directory)), max_bytes_(max_bytes) {
+  Map();
+}
+
+PersistentCacheFile::~PersistentCacheFile() = default;
+
+void PersistentCacheFile::Map() {
+  TRACE_EVENT0("flutter", "PersistentCacheFile::Map");
+  if (!directory_ || !directory_->is_valid()) {
+    return;
+  }
+  auto file = fml::OpenFileReadOnly(*directory_, kFileName);
+  if (!file.is_valid()) {
+    return;
+  }
+  auto mapping = std::make_shared<fml::FileMapping>(file);
+  const uint8_t* data = mapping->GetMapping();
+  const size_t size = mapping->GetSize();
+
+  auto corrupt = [&](const char* reason) {
+    FML_LOG(WARNING) << "Ignoring the persistent cache file: " << reason;
+    records_.clear();
+    data_size_ = 0;
+    // Have the next flush replace the file.
+    dirty_ = true;
+  };
+
+  FileHeader header;
+  if (data == nullptr || size < sizeof(header)) {
+    return corrupt("truncated header");
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (header.signature != kSignature || header.version != kVersion) {
+    return corrupt("unknown format");
+  }
+  if (header.entry_count > (size - sizeof(header)) / sizeof(IndexEntry)) {
+    return corrupt("truncated index");
+  }
+  const uint8_t* index = data + sizeof(header);
+  const size_t index_size = header.entry_count * sizeof(IndexEntry);
+  if (Checksum(index, index_size) != header.index_checksum) {
+    return corrupt("corrupt index");
+  }
+
+  const uint64_t data_start = sizeof(header) + index_size;
+  for (uint32_t i = 0; i < header.entry_count; i++) {
+    IndexEntry entry;
+    std::memcpy(&entry, index + i * sizeof(IndexEntry), sizeof(entry));
+    const uint64_t entry_size =
+        static_cast<uint64_t>(entry.key_size) + entry.value_size;
+    if (entry.offset < data_start || entry.offset > size ||
+        entry_size > size - entry.offset) {
+      return corrupt("entry out of bounds");
+    }
+    Record record;
+    record.key_size = entry.key_size;
+    record.value_size = entry.value_size;
+    record.offset = entry.offset;
+    record.checksum = entry.checksum;
+    record.last_use = entry.last_use;
+    records_[std::string(entry.hash, kHashSize)] = std::move(record);
+    data_size_ += entry_size;
+  }
+  use_count_ = header.use_count;
+  mapping_ = std::move(mapping);
+}
+
+bool PersistentCacheFile::Read(Record& record, bool need_key, Entry* entry) {
+  if (record.value != nullptr) {
+    entry->key = record.key;
+    entry->value = record.value;
+    return true;
+  }
+  const uint8_t* key = mapping_->GetMapping() + record.offset;
+  const uint8_t* value = key + record.key_size;
+  if (!record.verified) {
+    if (Checksum(value, record.value_size, Checksum(key, record.key_size)) !=
+        record.checksum) {
+      return false;
+    }
+    record.verified = true;
+  }
+  if (need_key) {
+    entry->key = SkData::MakeWithCopy(key, record.key_size);
+  }
+  entry->value = SkData::MakeWithCopy(value, record.value_size);
+  return true;
+}
+
+void PersistentCacheFile::Erase(
+    std::unordered_map<std::string, Record>::iterator it) {
+  data_size_ -= it->second.key_size + it->second.value_size;
+  records_.erase(it);
+  dirty_ = true;
+}
+
+sk_sp<SkData> PersistentCacheFile::Load(const std::string& hash) {
+  std::scoped_lock lock(mutex_);
+  auto found = records_.find(hash);
+  if (found == records_.end()) {
+    return nullptr;
+  }
+  Entry entry;
+  if (!Read(found->second, false, &entry)) {
+    FML_LOG(WARNING) << "Dropping a corrupt persistent cache entry: " << hash;
+    Erase(found);
+    return nullptr;
+  }
+  found->second.last_use = ++use_count_;
+  // Have the next flush save the new recency of the entry, so that trimming
+  // after a restart does not go by an old order.
+  dirty_ = true;
+  return entry.value;
+}
+
+void PersistentCacheFile::Store(const std::string& hash,
+                                const SkData& key,
+                                const SkData& value) {
+  if (hash.size() != kHashSize) {
+    return;
+  }
+  std::scoped_lock lock(mutex_);
+  auto found = records_.find(hash);
+  if (found != records_.end()) {
+    Erase(found);
+  }
+  Record record;
+  record.key_size = key.size();
+  record.value_size = value.size();
+  record.checksum = Checksum(key, value);
+  record.last_use = ++use_count_;
+  record.verified = true;
+  record.key = SkData::MakeWithCopy(key.data(), key.size());
+  record.value = SkData::MakeWithCopy(value.data(), value.size());
+  data_size_ += record.key_size + record.value_size;
+  records_[hash] = std::move(record);
+  dirty_ = true;
+}
+
+std::vector<PersistentCacheFile::Entry> PersistentCacheFile::GetEntries() {
+  std::scoped_lock lock(mutex_);
+  std::vector<std::string> hashes;
+  hashes.reserve(records_.size());
+  for (const auto& record : records_) {
+    hashes.push_back(record.first);
+  }
+  std::sort(hashes.begin(), hashes.end());
+
+  std::vector<Entry> entries;
+  entries.reserve(hashes.size());
+  for (const auto& hash : hashes) {
+    auto found = records_.find(hash);
+    Entry entry;
+    if (Read(found->second, true, &entry)) {
+      entries.push_back(std::move(entry));
+    } else {
+      FML_LOG(WARNING) << "Dropping a corrupt persistent cache entry: "
+                       << hash;
+      Erase(found);
+    }
+  }
+  return entries;
+}
+
+void PersistentCacheFile::TrimToMaxBytes() {
+  if (data_size_ <= max_bytes_) {
+    return;
+  }
+  std::vector<std::pair<uint64_t, std::string>> by_last_use;
+  by_last_use.reserve(records_.size());
+  for (const auto& record : records_) {
+    by_last_use.emplace_back(record.second.last_use, record.first);
+  }
+  std::sort(by_last_use.begin(), by_last_use.end());
+  for (const auto& [last_use, hash] : by_last_use) {
+    if (data_size_ <= max_bytes_) {
+      break;
+    }
+    Erase(records_.find(hash));
+  }
+}
+
+bool PersistentCacheFile::Flush() {
+  TRACE_EVENT0("flutter", "PersistentCacheFile::Flush");
+  // The file is always written under the same name, so a flush must be done
+  // with it before the next one replaces it.
+  std::scoped_lock flush_lock(flush_mutex_);
+  std::shared_ptr<fml::Mapping> data;
+  uint64_t clear_count;
+  {
+    std::scoped_lock lock(mutex_);
+    if (!dirty_) {
+      return true;
+    }
+    if (!directory_ || !directory_->is_valid()) {
+      return false;
+    }
+    TrimToMaxBytes();
+
+    std::vector<std::string> hashes;
+    hashes.reserve(records_.size());
+    for (const auto& record : records_) {
+      hashes.push_back(record.first);
+    }
+    std::sort(hashes.begin(), hashes.end());
+
+    const size_t index_size = hashes.size() * sizeof(IndexEntry);
+    std::vector<uint8_t> buffer;
+    buffer.resize(sizeof(FileHeader) + index_size + data_size_);
+    uint8_t* index = buffer.data() + sizeof(FileHeader);
+    uint64_t offset = sizeof(FileHeader) + index_size;
+    for (size_t i = 0; i < hashes.size(); i++) {
+      Record& record = records_[hashes[i]];
+      IndexEntry entry;
+      std::memcpy(entry.hash, hashes[i].data(), kHashSize);
+      entry.key_size = record.key_size;
+      entry.value_size = record.value_size;
+      entry.offset = offset;
+      entry.last_use = record.last_use;
+      entry.checksum = record.checksum;
+      std::memcpy(index + i * sizeof(IndexEntry), &entry, sizeof(entry));
+
+      uint8_t* destination = buffer.data() + offset;
+      if (record.value != nullptr) {
+        std::memcpy(destination, record.key->data(), record.key_size);
+        std::memcpy(destination + record.key_size, record.value->data(),
+                    record.value_size);
+      } else {
+        // Entries that were not read yet are copied along with their
+        // checksum, so that they are still checked when they are read.
+        std::memcpy(destination, mapping_->GetMapping() + record.offset,
+                    record.key_size + record.value_size);
+      }
+      record.offset = offset;
+      record.key = nullptr;
+      record.value = nullptr;
+      offset += record.key_size + record.value_size;
+    }
+
+    FileHeader header = {};
+    header.signature = kSignature;
+    header.version = kVersion;
+    header.entry_count = hashes.size();
+    header.use_count = use_count_;
+    header.index_checksum = Checksum(index, index_size);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    // The entries now point into the data that is written, which also lets
+    // go of the mapping of the file before it is replaced.
+    data = std::make_shared<fml::DataMapping>(std::move(buffer));
+    mapping_ = data;
+    clear_count = clear_count_;
+    dirty_ = false;
+  }
+
+  // The file is written without holding |mutex_|, so that loads and stores
+  // are not held up by the disk.
+  bool success = fml::WriteAtomically(*directory_, kFileName, *data);
+  std::shared_ptr<fml::FileMapping> mapping;
+  if (success) {
+    auto file = fml::OpenFileReadOnly(*directory_, kFileName);
+    mapping = std::make_shared<fml::FileMapping>(file);
+    success = mapping->GetMapping() != nullptr &&
+              mapping->GetSize() == data->GetSize();
+  }
+
+  std::scoped_lock lock(mutex_);
+  if (clear_count != clear_count_) {
+    fml::UnlinkFile(*directory_, kFileName);
+    return true;
+  }
+  if (!success) {
+    // The entries keep pointing into the data, which stays in memory until
+    // the next flush writes it again.
+    FML_LOG(WARNING) << "Could not write the persistent cache file.";
+    dirty_ = true;
+    return false;
+  }
+  // The file holds the same data at the same offsets.
+  mapping_ = std::move(mapping);
+  return true;
+}
+
+void PersistentCacheFile::Clear() {
+  std::scoped_lock lock(mutex_);
+  records_.clear();
+  data_size_ = 0;
+  mapping_ = nullptr;
+  clear_count_++;
+  dirty_ = false;
+  if (directory_ && directory_->is_valid()) {
+    fml::UnlinkFile(*directory_, kFileName);
+  }
+}
+
+size_t PersistentCacheFile::GetEntryCount() const {
+  std::scoped_lock lock(mutex_);
+  return records_.size();
+}
+
+size_t PersistentCacheFile::GetDataSize() const {
+  std::scoped_lock lock(mutex_);
+  return data_size_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,151 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_FILE_H_
+#define FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_FILE_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Keeps the entries of the persistent cache in a single file
+///             that is memory mapped, instead of in a file per entry.
+///
+///             The file starts with an index from the hash of the key of each
+///             entry to the offset of the entry in the file, followed by the
+///             keys and values of the entries. The index and each entry have
+///             a checksum. A file with a corrupt index is ignored as a whole,
+///             and an entry with a corrupt key or value is dropped when it is
+///             first read.
+///
+///             Loads read from the mapping of the file. Stores are kept in
+///             memory until |Flush| rewrites the file, which also drops the
+///             least recently used entries once the entries take more than
+///             the maximum size. The file is not mapped while it is
+///             rewritten, since some platforms cannot replace a mapped file.
+///             Loads read from the data being written meanwhile.
+///
+///             All methods are thread-safe.
+///
+class PersistentCacheFile {
+ public:
+  static constexpr char kFileName[] = "io.flutter.shader_cache";
+
+  struct Entry {
+    sk_sp<SkData> key;
+    sk_sp<SkData> value;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Maps the cache file in |directory|, if there is one.
+  ///
+  /// @param[in]  directory  The directory of the cache file.
+  /// @param[in]  max_bytes  The size the keys and values of the entries are
+  ///                        trimmed to when the file is rewritten.
+  ///
+  PersistentCacheFile(std::shared_ptr<fml::UniqueFD> directory,
+                      size_t max_bytes);
+
+  ~PersistentCacheFile();
+
+  //----------------------------------------------------------------------------
+  /// @brief      The value stored for the key with the given hash, or nullptr
+  ///             if there is none.
+  ///
+  /// @param[in]  hash  The hash of the key, as returned by
+  ///                   |PersistentCache::SkKeyToFilePath|.
+  ///
+  sk_sp<SkData> Load(const std::string& hash);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Stores the |value| for the |key|. It is only written to the
+  ///             file by the next |Flush|.
+  ///
+  void Store(const std::string& hash, const SkData& key, const SkData& value);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The keys and values of all entries, ordered by their hashes.
+  ///
+  std::vector<Entry> GetEntries();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Rewrites the file if entries were stored or dropped since it
+  ///             was last written.
+  ///
+  /// @return     Whether the file is up to date.
+  ///
+  bool Flush();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Drops all of the entries, in memory and on disk.
+  ///
+  void Clear();
+
+  size_t GetEntryCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The size of the keys and values of all entries.
+  ///
+  size_t GetDataSize() const;
+
+ private:
+  struct Record {
+    uint32_t key_size = 0;
+    uint32_t value_size = 0;
+    // The offset of the key in |mapping_|, followed by the value. Only used
+    // if |key| is nullptr. The data being written by a flush has the same
+    // layout as the file it is written to.
+    uint64_t offset = 0;
+    uint64_t checksum = 0;
+    uint64_t last_use = 0;
+    bool verified = false;
+    // The key and value of an entry stored since the file was last written.
+    sk_sp<SkData> key;
+    sk_sp<SkData> value;
+  };
+
+  const std::shared_ptr<fml::UniqueFD> directory_;
+  const size_t max_bytes_;
+  mutable std::mutex mutex_;
+  // Held for the whole of |Flush|, before |mutex_|, so that concurrent
+  // flushes do not write and map each other's files.
+  std::mutex flush_mutex_;
+  // The mapping of the file, or the data a flush is writing to it.
+  std::shared_ptr<fml::Mapping> mapping_;
+  std::unordered_map<std::string, Record> records_;
+  size_t data_size_ = 0;
+  // Increases with every use of an entry, to order them by recency.
+  uint64_t use_count_ = 0;
+  // Increases with every |Clear|, to drop a file that a flush wrote while
+  // the entries were cleared.
+  uint64_t clear_count_ = 0;
+  bool dirty_ = false;
+
+  void Map();
+
+  // Reads the value, and the key if |need_key| is set, of a |record| from
+  // the mapping. Checks them against the checksum of the record the first
+  // time the record is read.
+  bool Read(Record& record, bool need_key, Entry* entry);
+
+  void Erase(std::unordered_map<std::string, Record>::iterator it);
+
+  void TrimToMaxBytes();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PersistentCacheFile);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_FILE_H_
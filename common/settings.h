@@ -203,6 +203,47 @@ struct Settings {
   // not supported on the platform.
   bool enable_impeller = false;
 
+  // Rasterize new picture raster cache entries on the concurrent worker
+  // threads instead of on the raster thread, drawing the pictures uncached
+  // until their entries are ready.
+  bool enable_async_raster_cache = false;
+
+  // The number of bytes of raster cache images that may be kept around
+  // while they are not being used, or 0 to evict every raster cache entry
+  // as soon as a frame does not use it.
+  size_t raster_cache_byte_budget = 0;
+
+  // Pack the images of small raster cache entries into shared atlas pages
+  // instead of giving each entry a texture of its own.
+  bool enable_raster_cache_atlas = false;
+
+  // Give each of the concurrent worker threads a task queue of its own and
+  // let idle workers steal tasks from busy ones, instead of having all of
+  // the workers take tasks from one shared queue.
+  bool enable_concurrent_work_stealing = false;
+
+  // The number of frames that may be in flight between the UI and the raster
+  // threads, or 0 to pick the depth based on the threading configuration.
+  // With a depth greater than 2, the animator produces frames ahead of vsync
+  // while an animation is running and the pipeline has room, so that a
+  // single slow UI frame does not cost a missed vsync.
+  uint32_t raster_pipeline_depth = 0;
+
+  // Have a newly built frame replace the frame that is still waiting to be
+  // rasterized, instead of rasterizing every frame in order. Frames are
+  // dropped instead of being drawn late when rasterization cannot keep up.
+  bool discard_stale_frames = false;
+
+  // Record the fonts, assets and shaders loaded before the first frame into
+  // the persistent cache directory, and load the ones the previous launch
+  // recorded on worker threads while the shell starts up.
+  bool enable_startup_profile = false;
+
+  // Dispatch the pointer events once per vsync, with the moves of each
+  // pointer resampled to the time the frame is displayed. This smooths out
+  // touch panels and styluses that report faster than the refresh rate.
+  bool resample_pointer_events = false;
+
   // Data set by platform-specific embedders for use in font initialization.
   uint32_t font_initialization_data = 0;
 
@@ -0,0 +1,149 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/startup_profile.h"
+
+#include <atomic>
+#include <sstream>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/mapping.h"
+
+namespace flutter {
+
+namespace {
+
+// The profile is a text file with a header line followed by one line per
+// entry, each made of a character for the kind of the entry, a space and
+// the name of the entry.
+constexpr char kHeader[] = "flutter-startup-profile-v1";
+constexpr std::array<char, StartupProfile::kKindCount> kKindTags = {'a', 'f',
+                                                                    's'};
+
+std::mutex recording_mutex;
+std::shared_ptr<StartupProfile> recording;
+std::atomic<bool> is_recording = false;
+thread_local bool recording_disabled_on_thread = false;
+
+}  // namespace
+
+StartupProfile::StartupProfile() = default;
+
+StartupProfile::~StartupProfile() = default;
+
+bool StartupProfile::Load(const fml::UniqueFD& directory) {
+  if (!directory.is_valid()) {
+    return false;
+  }
+  auto file = fml::OpenFileReadOnly(directory, kFileName);
+  if (!file.is_valid()) {
+    return false;
+  }
+  fml::FileMapping mapping(file);
+  if (mapping.GetMapping() == nullptr) {
+    return false;
+  }
+  std::istringstream stream(
+      std::string(reinterpret_cast<const char*>(mapping.GetMapping()),
+                  mapping.GetSize()));
+  std::string line;
+  if (!std::getline(stream, line) || line != kHeader) {
+    FML_LOG(WARNING) << "Ignoring a startup profile in an unknown format.";
+    return false;
+  }
+  while (std::getline(stream, line)) {
+    if (line.size() < 3 || line[1] != ' ') {
+      continue;
+    }
+    for (size_t kind = 0; kind < kKindCount; kind++) {
+      if (line[0] == kKindTags[kind]) {
+        Add(static_cast<Kind>(kind), line.substr(2));
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+bool StartupProfile::Save(const fml::UniqueFD& directory) const {
+  if (!directory.is_valid()) {
+    return false;
+  }
+  std::string contents = std::string(kHeader) + "\n";
+  {
+    std::scoped_lock lock(mutex_);
+    for (size_t kind = 0; kind < kKindCount; kind++) {
+      for (const auto& name : entries_[kind]) {
+        contents += kKindTags[kind];
+        contents += ' ';
+        contents += name;
+        contents += '\n';
+      }
+    }
+  }
+  fml::DataMapping mapping(contents);
+  return fml::WriteAtomically(directory, kFileName, mapping);
+}
+
+void StartupProfile::Add(Kind kind, const std::string& name) {
+  if (name.empty() || name.find('\n') != std::string::npos) {
+    return;
+  }
+  const size_t index = static_cast<size_t>(kind);
+  std::scoped_lock lock(mutex_);
+  if (entries_[index].size() >= kMaxEntriesPerKind) {
+    return;
+  }
+  if (entry_set_[index].insert(name).second) {
+    entries_[index].push_back(name);
+  }
+}
+
+std::vector<std::string> StartupProfile::Get(Kind kind) const {
+  std::scoped_lock lock(mutex_);
+  return entries_[static_cast<size_t>(kind)];
+}
+
+size_t StartupProfile::GetEntryCount() const {
+  std::scoped_lock lock(mutex_);
+  size_t count = 0;
+  for (const auto& entries : entries_) {
+    count += entries.size();
+  }
+  return count;
+}
+
+void StartupProfile::SetRecording(std::shared_ptr<StartupProfile> profile) {
+  std::scoped_lock lock(recording_mutex);
+  is_recording = profile != nullptr;
+  recording = std::move(profile);
+}
+
+std::shared_ptr<StartupProfile> StartupProfile::GetRecording() {
+  std::scoped_lock lock(recording_mutex);
+  return recording;
+}
+
+void StartupProfile::Record(Kind kind, const std::string& name) {
+  if (!is_recording.load(std::memory_order_relaxed) ||
+      recording_disabled_on_thread) {
+    return;
+  }
+  auto profile = GetRecording();
+  if (profile) {
+    profile->Add(kind, name);
+  }
+}
+
+StartupProfile::ScopedNoRecording::ScopedNoRecording()
+    : was_disabled_(recording_disabled_on_thread) {
+  recording_disabled_on_thread = true;
+}
+
+StartupProfile::ScopedNoRecording::~ScopedNoRecording() {
+  recording_disabled_on_thread = was_disabled_;
+}
+
+}  // namespace flutter
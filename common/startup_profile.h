@@ -0,0 +1,126 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_COMMON_STARTUP_PROFILE_H_
+#define FLUTTER_COMMON_STARTUP_PROFILE_H_
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      The fonts, assets and shaders an application used while it
+///             started up.
+///
+///             A profile is recorded during one launch and saved to disk so
+///             that the next launch can load what it lists on a worker pool
+///             while the rest of the engine is still being set up. Recording
+///             stops once the first frame has been rasterized.
+///
+///             All methods are thread-safe.
+///
+class StartupProfile {
+ public:
+  enum class Kind {
+    // The name of an asset in the asset manager.
+    kAsset,
+    // The name of a font asset in the asset manager.
+    kFont,
+    // The file name of an entry of the persistent shader cache.
+    kShader,
+  };
+
+  static constexpr size_t kKindCount = 3;
+
+  /// Entries beyond this number are not recorded, so that an application
+  /// that loads a lot during startup does not end up with a profile that
+  /// takes longer to replay than what it saves.
+  static constexpr size_t kMaxEntriesPerKind = 256;
+
+  static constexpr char kFileName[] = "io.flutter.startup_profile";
+
+  StartupProfile();
+
+  ~StartupProfile();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds the entries of the profile that was saved to
+  ///             |directory|.
+  ///
+  /// @return     Whether there was a profile that could be read.
+  ///
+  bool Load(const fml::UniqueFD& directory);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Writes the profile to |directory|, replacing the one that
+  ///             was saved there before.
+  ///
+  bool Save(const fml::UniqueFD& directory) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds an entry to the profile. Entries that were already
+  ///             added are ignored.
+  ///
+  void Add(Kind kind, const std::string& name);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The entries of the given kind, in the order they were first
+  ///             added.
+  ///
+  std::vector<std::string> Get(Kind kind) const;
+
+  size_t GetEntryCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the profile that |Record| adds entries to, or stops
+  ///             recording if |profile| is nullptr.
+  ///
+  static void SetRecording(std::shared_ptr<StartupProfile> profile);
+
+  static std::shared_ptr<StartupProfile> GetRecording();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds an entry to the profile that is being recorded, if any.
+  ///             This is cheap when nothing is being recorded, so it can be
+  ///             called wherever a font, asset or shader is loaded.
+  ///
+  static void Record(Kind kind, const std::string& name);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Keeps |Record| from recording anything on the current
+  ///             thread while it is alive. Used while a profile is replayed,
+  ///             so that a launch does not record what it only loaded
+  ///             because the previous launch did.
+  ///
+  class ScopedNoRecording {
+   public:
+    ScopedNoRecording();
+
+    ~ScopedNoRecording();
+
+   private:
+    const bool was_disabled_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(ScopedNoRecording);
+  };
+
+ private:
+  mutable std::mutex mutex_;
+  std::array<std::vector<std::string>, kKindCount> entries_;
+  std::array<std::set<std::string>, kKindCount> entry_set_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(StartupProfile);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_COMMON_STARTUP_PROFILE_H_
@@ -3,15 +3,25 @@
 // found in the LICENSE file.
 
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_canvas_dispatcher.h"
 #include "flutter/display_list/display_list_ops.h"
 #include "flutter/display_list/display_list_utils.h"
+#include "flutter/fml/thread_local.h"
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
 
+// The vectors that culled dispatches on this thread collect the indices of
+// the rendered ops into, kept so that their storage is reused by later
+// dispatches. A DisplayList nested in one that is being dispatched takes a
+// vector of its own while the outer one is still in use.
+FML_THREAD_LOCAL fml::ThreadLocalUniquePtr<std::vector<std::vector<int>>>
+    tls_rendered_ops_pool;
+
 const SaveLayerOptions SaveLayerOptions::kNoAttributes = SaveLayerOptions();
 const SaveLayerOptions SaveLayerOptions::kWithAttributes =
     kNoAttributes.with_renders_with_attributes();
@@ -24,7 +34,9 @@ DisplayList::DisplayList()
       unique_id_(0),
       bounds_({0, 0, 0, 0}),
       bounds_cull_({0, 0, 0, 0}),
-      can_apply_group_opacity_(true) {}
+      can_apply_group_opacity_(true),
+      may_read_backdrop_(false),
+      may_have_texture_images_(false) {}
 
 DisplayList::DisplayList(uint8_t* ptr,
                          size_t byte_count,
@@ -32,7 +44,9 @@ DisplayList::DisplayList(uint8_t* ptr,
                          size_t nested_byte_count,
                          unsigned int nested_op_count,
                          const SkRect& cull_rect,
-                         bool can_apply_group_opacity)
+                         bool can_apply_group_opacity,
+                         bool may_read_backdrop,
+                         bool may_have_texture_images)
     : storage_(ptr),
       byte_count_(byte_count),
       op_count_(op_count),
@@ -40,7 +54,9 @@ DisplayList::DisplayList(uint8_t* ptr,
       nested_op_count_(nested_op_count),
       bounds_({0, 0, -1, -1}),
       bounds_cull_(cull_rect),
-      can_apply_group_opacity_(can_apply_group_opacity) {
+      can_apply_group_opacity_(can_apply_group_opacity),
+      may_read_backdrop_(may_read_backdrop),
+      may_have_texture_images_(may_have_texture_images) {
   static std::atomic<uint32_t> nextID{1};
   do {
     unique_id_ = nextID.fetch_add(+1, std::memory_order_relaxed);
@@ -52,12 +68,53 @@ DisplayList::~DisplayList() {
   DisposeOps(ptr, ptr + byte_count_);
 }
 
+static inline bool IsRenderingOp(DisplayListOpType type) {
+  return type >= DisplayListOpType::kDrawPaint;
+}
+
+// Dispatches a single op and returns false if the op type is unknown.
+static inline bool DispatchOneOp(Dispatcher& dispatcher, const DLOp* op) {
+  switch (op->type) {
+#define DL_OP_DISPATCH(name)                                \
+  case DisplayListOpType::k##name:                          \
+    static_cast<const name##Op*>(op)->dispatch(dispatcher); \
+    return true;
+
+    FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPATCH)
+
+#undef DL_OP_DISPATCH
+
+    default:
+      FML_DCHECK(false);
+      return false;
+  }
+}
+
 void DisplayList::ComputeBounds() {
   DisplayListBoundsCalculator calculator(&bounds_cull_);
   Dispatch(calculator);
   bounds_ = calculator.bounds();
 }
 
+void DisplayList::ComputeBoundsAndRTree() {
+  TRACE_EVENT0("flutter", "DisplayList::ComputeBoundsAndRTree");
+  DisplayListBoundsCalculator calculator(&bounds_cull_, true);
+  uint8_t* ptr = storage_.get();
+  uint8_t* end = ptr + byte_count_;
+  int op_index = 0;
+  while (ptr < end) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    ptr += op->size;
+    FML_DCHECK(ptr <= end);
+    calculator.set_op_index(op_index++);
+    if (!DispatchOneOp(calculator, op)) {
+      break;
+    }
+  }
+  bounds_ = calculator.bounds();
+  rtree_ = calculator.BuildRTree();
+}
+
 void DisplayList::Dispatch(Dispatcher& dispatcher,
                            uint8_t* ptr,
                            uint8_t* end) const {
@@ -66,19 +123,61 @@ void DisplayList::Dispatch(Dispatcher& dispatcher,
     auto op = reinterpret_cast<const DLOp*>(ptr);
     ptr += op->size;
     FML_DCHECK(ptr <= end);
-    switch (op->type) {
-#define DL_OP_DISPATCH(name)                                \
-  case DisplayListOpType::k##name:                          \
-    static_cast<const name##Op*>(op)->dispatch(dispatcher); \
-    break;
-
-      FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPATCH)
+    if (!DispatchOneOp(dispatcher, op)) {
+      return;
+    }
+  }
+}
 
-#undef DL_OP_DISPATCH
+void DisplayList::Dispatch(Dispatcher& dispatcher,
+                           const SkRect& cull_rect) const {
+  if (!rtree_ || cull_rect.contains(bounds_)) {
+    Dispatch(dispatcher);
+    return;
+  }
+  auto pool = tls_rendered_ops_pool.get();
+  if (!pool) {
+    pool = new std::vector<std::vector<int>>();
+    tls_rendered_ops_pool.reset(pool);
+  }
+  std::vector<int> rendered_ops;
+  if (!pool->empty()) {
+    rendered_ops = std::move(pool->back());
+    pool->pop_back();
+    rendered_ops.clear();
+  }
+  rtree_->search(cull_rect, &rendered_ops);
+  uint8_t* ptr = storage_.get();
+  DispatchCulled(dispatcher, ptr, ptr + byte_count_, rendered_ops);
+  pool->push_back(std::move(rendered_ops));
+}
 
-      default:
-        FML_DCHECK(false);
-        return;
+void DisplayList::DispatchCulled(Dispatcher& dispatcher,
+                                 uint8_t* ptr,
+                                 uint8_t* end,
+                                 const std::vector<int>& rendered_ops) const {
+  TRACE_EVENT0("flutter", "DisplayList::DispatchCulled");
+  // The R-Tree returns the indices of the rendering ops in op order,
+  // possibly with duplicates when an op recorded more than one set of
+  // bounds, so we can walk them in lock step with the ops.
+  auto next_rendered = rendered_ops.begin();
+  auto rendered_end = rendered_ops.end();
+  int op_index = 0;
+  while (ptr < end) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    ptr += op->size;
+    FML_DCHECK(ptr <= end);
+    int index = op_index++;
+    if (IsRenderingOp(op->type)) {
+      while (next_rendered != rendered_end && *next_rendered < index) {
+        ++next_rendered;
+      }
+      if (next_rendered == rendered_end || *next_rendered != index) {
+        continue;
+      }
+    }
+    if (!DispatchOneOp(dispatcher, op)) {
+      return;
     }
   }
 }
@@ -173,6 +272,124 @@ static bool CompareOps(uint8_t* ptrA,
   return true;
 }
 
+// Runs are ended after an op whose hash has its low bits clear so that
+// the boundaries only depend on the contents of the ops, which yields
+// runs of 16 ops on average. The minimum and maximum run lengths keep
+// the number of runs reasonable for very uniform or varied lists.
+static constexpr uint64_t kRunBoundaryMask = 0xF;
+static constexpr uint32_t kMinRunOps = 4;
+static constexpr uint32_t kMaxRunOps = 64;
+
+static constexpr uint64_t kHashSeed = 0xcbf29ce484222325u;
+static constexpr uint64_t kHashPrime = 0x100000001b3u;
+
+// Hashes the bytes of a single op with FNV-1a applied to 32 bit words.
+// Ops are always at least 4 byte aligned and their padding is zero
+// filled by the builder so equal ops have equal hashes. Ops that hold
+// references to objects (images, paths, text blobs, ...) hash the
+// identity of the object rather than its contents.
+static uint64_t HashOp(const DLOp* op) {
+  const uint8_t* ptr = reinterpret_cast<const uint8_t*>(op);
+  uint64_t hash = kHashSeed;
+  for (size_t i = 0; i + sizeof(uint32_t) <= op->size; i += sizeof(uint32_t)) {
+    uint32_t word;
+    memcpy(&word, ptr + i, sizeof(word));
+    hash = (hash ^ word) * kHashPrime;
+  }
+  return hash;
+}
+
+const std::vector<DlOpRun>& DisplayList::op_runs() const {
+  std::call_once(op_runs_once_, [this]() {
+    uint8_t* start = storage_.get();
+    uint8_t* ptr = start;
+    uint8_t* end = ptr + byte_count_;
+    DlOpRun run = {0, 0, 0, 0, kHashSeed};
+    uint32_t op_index = 0;
+    while (ptr < end) {
+      auto op = reinterpret_cast<const DLOp*>(ptr);
+      ptr += op->size;
+      FML_DCHECK(ptr <= end);
+      op_index++;
+      uint64_t op_hash = HashOp(op);
+      run.hash = (run.hash ^ op_hash) * kHashPrime;
+      run.op_count++;
+      if (ptr == end || run.op_count >= kMaxRunOps ||
+          (run.op_count >= kMinRunOps && (op_hash & kRunBoundaryMask) == 0)) {
+        run.byte_count = (ptr - start) - run.offset;
+        op_runs_.push_back(run);
+        run = {static_cast<size_t>(ptr - start), 0, op_index, 0, kHashSeed};
+      }
+    }
+  });
+  return op_runs_;
+}
+
+DlReuseStats DisplayList::ComputeReuse(const DisplayList& previous) const {
+  TRACE_EVENT0("flutter", "DisplayList::ComputeReuse");
+  const std::vector<DlOpRun>& runs = op_runs();
+  DlReuseStats stats;
+  stats.run_count = runs.size();
+  stats.byte_count = byte_count_;
+  for (const DlOpRun& run : runs) {
+    stats.op_count += run.op_count;
+  }
+  if (this == &previous) {
+    stats.reused_run_count = stats.run_count;
+    stats.reused_byte_count = stats.byte_count;
+    stats.reused_op_count = stats.op_count;
+    stats.identical = true;
+    return stats;
+  }
+
+  std::unordered_multimap<uint64_t, const DlOpRun*> previous_runs;
+  for (const DlOpRun& run : previous.op_runs()) {
+    previous_runs.emplace(run.hash, &run);
+  }
+  uint8_t* ptr = storage_.get();
+  uint8_t* previous_ptr = previous.storage_.get();
+  auto matches = [&](const DlOpRun& run, const DlOpRun* candidate) {
+    if (candidate->byte_count != run.byte_count ||
+        candidate->op_count != run.op_count) {
+      return false;
+    }
+    uint8_t* run_ptr = ptr + run.offset;
+    uint8_t* candidate_ptr = previous_ptr + candidate->offset;
+    return CompareOps(run_ptr, run_ptr + run.byte_count, candidate_ptr,
+                      candidate_ptr + candidate->byte_count);
+  };
+  // The lists are equal if every run matches the run at the same position
+  // of the previous list and the lists are of the same length, so a run is
+  // matched against the run at its own position first.
+  size_t in_place_run_count = 0;
+  const std::vector<DlOpRun>& previous_op_runs = previous.op_runs();
+  for (size_t i = 0; i < runs.size(); i++) {
+    const DlOpRun& run = runs[i];
+    bool reused = false;
+    if (i < previous_op_runs.size() && previous_op_runs[i].hash == run.hash &&
+        previous_op_runs[i].offset == run.offset &&
+        matches(run, &previous_op_runs[i])) {
+      reused = true;
+      in_place_run_count++;
+    } else {
+      auto [begin, end] = previous_runs.equal_range(run.hash);
+      for (auto it = begin; it != end && !reused; ++it) {
+        reused = matches(run, it->second);
+      }
+    }
+    if (reused) {
+      stats.reused_run_count++;
+      stats.reused_byte_count += run.byte_count;
+      stats.reused_op_count += run.op_count;
+    }
+  }
+  stats.identical = in_place_run_count == runs.size() &&
+                    runs.size() == previous_op_runs.size() &&
+                    byte_count_ == previous.byte_count_ &&
+                    op_count_ == previous.op_count_;
+  return stats;
+}
+
 void DisplayList::RenderTo(DisplayListBuilder* builder,
                            SkScalar opacity) const {
   // TODO(100983): Opacity is not respected and attributes are not reset.
@@ -184,7 +401,11 @@ void DisplayList::RenderTo(DisplayListBuilder* builder,
 
 void DisplayList::RenderTo(SkCanvas* canvas, SkScalar opacity) const {
   DisplayListCanvasDispatcher dispatcher(canvas, opacity);
-  Dispatch(dispatcher);
+  if (rtree_) {
+    Dispatch(dispatcher, canvas->getLocalClipBounds());
+  } else {
+    Dispatch(dispatcher);
+  }
 }
 
 bool DisplayList::Equals(const DisplayList* other) const {
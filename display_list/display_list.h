@@ -5,8 +5,11 @@
 #ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_H_
 #define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_H_
 
+#include <mutex>
 #include <optional>
+#include <vector>
 
+#include "flutter/display_list/display_list_rtree.h"
 #include "flutter/display_list/display_list_sampling_options.h"
 #include "flutter/display_list/types.h"
 #include "flutter/fml/logging.h"
@@ -58,6 +61,9 @@
 
 namespace flutter {
 
+// The rendering ops (the Draw* ops that actually produce pixels) must
+// all appear at the end of this list, starting with DrawPaint, so that
+// a culled dispatch can identify them with a single comparison.
 #define FOR_EACH_DISPLAY_LIST_OP(V) \
   V(SetAntiAlias)                   \
   V(SetDither)                      \
@@ -106,6 +112,7 @@ namespace flutter {
   V(Restore)                        \
                                     \
   V(Translate)                      \
+  V(TranslateInt16)                 \
   V(Scale)                          \
   V(Rotate)                         \
   V(Skew)                           \
@@ -124,8 +131,11 @@ namespace flutter {
   V(DrawColor)                      \
                                     \
   V(DrawLine)                       \
+  V(DrawLineInt16)                  \
   V(DrawRect)                       \
+  V(DrawRectInt16)                  \
   V(DrawOval)                       \
+  V(DrawOvalInt16)                  \
   V(DrawCircle)                     \
   V(DrawRRect)                      \
   V(DrawDRRect)                     \
@@ -212,6 +222,51 @@ class SaveLayerOptions {
   };
 };
 
+// A contiguous sequence of ops within a DisplayList along with a hash of
+// their contents.
+//
+// A DisplayList is divided into runs at boundaries that are chosen by the
+// contents of the ops themselves rather than by their position so that
+// inserting or removing ops only disturbs the runs around the change and
+// the remaining runs can still be matched against the runs of a list that
+// was recorded before the change.
+struct DlOpRun {
+  // The byte offset of the first op of the run within the DisplayList
+  size_t offset;
+  size_t byte_count;
+
+  // The index of the first op of the run within the DisplayList
+  uint32_t op_index;
+  uint32_t op_count;
+
+  uint64_t hash;
+};
+
+// A report of how much of a DisplayList consists of runs of ops that
+// also appear in an earlier DisplayList. Unlike |DisplayList::op_count|,
+// the op counts include the attribute ops.
+struct DlReuseStats {
+  size_t run_count = 0;
+  size_t reused_run_count = 0;
+  size_t byte_count = 0;
+  size_t reused_byte_count = 0;
+  size_t op_count = 0;
+  size_t reused_op_count = 0;
+
+  // The fraction of the op bytes of the DisplayList that were reused.
+  double reused_fraction() const {
+    return byte_count == 0 ? 1.0
+                           : static_cast<double>(reused_byte_count) /
+                                 static_cast<double>(byte_count);
+  }
+
+  bool all_reused() const { return reused_run_count == run_count; }
+
+  // Whether the DisplayList has the same ops as the earlier one in the same
+  // order, in which case it |Equals| the earlier DisplayList.
+  bool identical = false;
+};
+
 // The base class that contains a sequence of rendering operations
 // for dispatch to a Dispatcher. These objects must be instantiated
 // through an instance of DisplayListBuilder::build().
@@ -226,9 +281,23 @@ class DisplayList : public SkRefCnt {
     Dispatch(ctx, ptr, ptr + byte_count_);
   }
 
+  // Dispatches all of the attribute, transform, clip, and save/restore
+  // operations, but only those rendering operations whose bounds may
+  // intersect the |cull_rect|, which is specified in the same coordinate
+  // space as the |bounds| of the DisplayList.
+  //
+  // Culling requires a spatial index of the rendering operations which
+  // is only available if the DisplayList was constructed by a builder
+  // that was asked to prepare one (see |has_rtree|). Without it, or if
+  // the |cull_rect| covers the entire DisplayList, all operations are
+  // dispatched.
+  void Dispatch(Dispatcher& ctx, const SkRect& cull_rect) const;
+
   void RenderTo(DisplayListBuilder* builder,
                 SkScalar opacity = SK_Scalar1) const;
 
+  // If the DisplayList has an R-Tree then only those rendering operations
+  // that intersect the local clip bounds of the |canvas| are rendered.
   void RenderTo(SkCanvas* canvas, SkScalar opacity = SK_Scalar1) const;
 
   // SkPicture always includes nested bytes, but nested ops are
@@ -262,6 +331,36 @@ class DisplayList : public SkRefCnt {
 
   bool can_apply_group_opacity() { return can_apply_group_opacity_; }
 
+  // The division of the ops of this DisplayList into hashed runs, which
+  // is computed on first use.
+  const std::vector<DlOpRun>& op_runs() const;
+
+  // Reports how many of the runs of ops in this DisplayList have an
+  // identical run somewhere in the |previous| DisplayList. The matching
+  // runs are found by their hashes and then verified op by op, so a run
+  // is only reported as reused if it would render the same ops.
+  //
+  // The same walk also determines whether the two DisplayLists are equal,
+  // so callers that need both do not have to call |Equals| as well.
+  DlReuseStats ComputeReuse(const DisplayList& previous) const;
+
+  // Indicates that the DisplayList may contain operations, possibly within
+  // nested DisplayLists or SkPictures, that read back the destination pixels
+  // surrounding them, such as a saveLayer with a backdrop filter. Such lists
+  // cannot be rendered in independent pieces (see DisplayListTileRasterizer).
+  bool may_read_backdrop() const { return may_read_backdrop_; }
+
+  // Indicates that the DisplayList may sample images that are backed by
+  // GPU textures, possibly within nested DisplayLists or SkPictures or
+  // within Skia filters and shaders. Such lists can only be rendered on
+  // a thread that owns the GPU context.
+  bool may_have_texture_images() const { return may_have_texture_images_; }
+
+  // Whether the DisplayList has a spatial index of its rendering
+  // operations that can be used to cull them during dispatch.
+  bool has_rtree() const { return rtree_ != nullptr; }
+  sk_sp<const DlRTree> rtree() const { return rtree_; }
+
   static void DisposeOps(uint8_t* ptr, uint8_t* end);
 
  private:
@@ -271,7 +370,9 @@ class DisplayList : public SkRefCnt {
               size_t nested_byte_count,
               unsigned int nested_op_count,
               const SkRect& cull_rect,
-              bool can_apply_group_opacity);
+              bool can_apply_group_opacity,
+              bool may_read_backdrop,
+              bool may_have_texture_images);
 
   std::unique_ptr<uint8_t, SkFunctionWrapper<void(void*), sk_free>> storage_;
   size_t byte_count_;
@@ -287,9 +388,21 @@ class DisplayList : public SkRefCnt {
   SkRect bounds_cull_;
 
   bool can_apply_group_opacity_;
+  bool may_read_backdrop_;
+  bool may_have_texture_images_;
+
+  sk_sp<const DlRTree> rtree_;
+
+  mutable std::once_flag op_runs_once_;
+  mutable std::vector<DlOpRun> op_runs_;
 
   void ComputeBounds();
+  void ComputeBoundsAndRTree();
   void Dispatch(Dispatcher& ctx, uint8_t* ptr, uint8_t* end) const;
+  void DispatchCulled(Dispatcher& ctx,
+                      uint8_t* ptr,
+                      uint8_t* end,
+                      const std::vector<int>& rendered_ops) const;
 
   friend class DisplayListBuilder;
 };
@@ -5,6 +5,7 @@
 #include "flutter/display_list/display_list_benchmarks.h"
 #include "flutter/display_list/display_list_builder.h"
 #include "flutter/display_list/display_list_flags.h"
+#include "flutter/display_list/display_list_utils.h"
 
 #include "third_party/skia/include/core/SkPoint.h"
 #include "third_party/skia/include/core/SkTextBlob.h"
@@ -1328,5 +1329,82 @@ void BM_SaveLayer(benchmark::State& state,
   canvas_provider->Snapshot(filename);
 }
 
+// A Dispatcher that ignores every call so that the dispatch benchmarks
+// below measure only the cost of walking and decoding the DisplayList.
+class NopDispatcher : public IgnoreAttributeDispatchHelper,
+                      public IgnoreClipDispatchHelper,
+                      public IgnoreTransformDispatchHelper,
+                      public IgnoreDrawDispatchHelper {};
+
+constexpr size_t kListTileHeight = 48;
+
+// Records |tile_count| list tiles in the style of a long scrolling list of
+// simple items. Each tile draws a background, an icon and a divider line
+// on integral coordinates and then translates down to the next row.
+sk_sp<DisplayList> BuildListTiles(size_t tile_count, bool compact) {
+  DisplayListBuilder builder(
+      SkRect::MakeWH(kFixedCanvasSize, tile_count * kListTileHeight), compact);
+  for (size_t i = 0; i < tile_count; i++) {
+    builder.setColor(i % 2 == 0 ? SK_ColorWHITE : SK_ColorLTGRAY);
+    builder.drawRect(SkRect::MakeWH(kFixedCanvasSize, kListTileHeight));
+    builder.setColor(SK_ColorBLUE);
+    builder.drawOval(SkRect::MakeXYWH(8, 8, 32, 32));
+    builder.setColor(SK_ColorGRAY);
+    builder.drawLine(SkPoint::Make(56, kListTileHeight - 1),
+                     SkPoint::Make(kFixedCanvasSize, kListTileHeight - 1));
+    builder.translate(0, kListTileHeight);
+  }
+  return builder.Build();
+}
+
+void AnnotateDisplayListSize(benchmark::State& state,
+                             const sk_sp<DisplayList>& display_list) {
+  state.counters["Bytes"] = display_list->bytes(false);
+  state.counters["Ops"] = display_list->op_count(false);
+  state.counters["BytesPerOp"] =
+      static_cast<double>(display_list->bytes(false)) /
+      display_list->op_count(false);
+}
+
+// Measures the cost of recording a list of tiles with either the default
+// or the compact encoding, and reports the resulting memory footprint.
+void BM_DisplayListBuildListTiles(benchmark::State& state, bool compact) {
+  size_t tile_count = state.range(0);
+  sk_sp<DisplayList> display_list;
+  for ([[maybe_unused]] auto _ : state) {
+    display_list = BuildListTiles(tile_count, compact);
+  }
+  AnnotateDisplayListSize(state, display_list);
+}
+
+// Measures the cost of walking and decoding a list of tiles recorded with
+// either the default or the compact encoding.
+void BM_DisplayListDispatchListTiles(benchmark::State& state, bool compact) {
+  size_t tile_count = state.range(0);
+  sk_sp<DisplayList> display_list = BuildListTiles(tile_count, compact);
+  NopDispatcher dispatcher;
+  for ([[maybe_unused]] auto _ : state) {
+    display_list->Dispatch(dispatcher);
+  }
+  AnnotateDisplayListSize(state, display_list);
+}
+
+BENCHMARK_CAPTURE(BM_DisplayListBuildListTiles, Default, false)
+    ->RangeMultiplier(4)
+    ->Range(64, 16384)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DisplayListBuildListTiles, Compact, true)
+    ->RangeMultiplier(4)
+    ->Range(64, 16384)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DisplayListDispatchListTiles, Default, false)
+    ->RangeMultiplier(4)
+    ->Range(64, 16384)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DisplayListDispatchListTiles, Compact, true)
+    ->RangeMultiplier(4)
+    ->Range(64, 16384)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace testing
 }  // namespace flutter
@@ -5,6 +5,10 @@
 #include "flutter/display_list/display_list_benchmarks_software.h"
 #include "flutter/display_list/display_list_benchmarks.h"
 
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/display_list/display_list_tile_rasterizer.h"
+#include "flutter/fml/concurrent_message_loop.h"
+
 namespace flutter {
 namespace testing {
 
@@ -24,5 +28,78 @@ sk_sp<SkSurface> SoftwareCanvasProvider::MakeOffscreenSurface(
 
 RUN_DISPLAYLIST_BENCHMARKS(Software)
 
+// Builds a full screen DisplayList resembling a busy frame: a background
+// followed by a grid of anti-aliased cards, each with a border, a circle
+// and a path, so that every tile has a comparable amount of work.
+static sk_sp<DisplayList> BuildFullScreenDisplayList(int width, int height) {
+  DisplayListBuilder builder(SkRect::MakeWH(width, height), false, true);
+  builder.drawColor(SK_ColorWHITE, DlBlendMode::kSrc);
+  builder.setAntiAlias(true);
+  SkPath path;
+  path.moveTo(4, 40);
+  path.cubicTo(20, 0, 40, 80, 60, 40);
+  path.quadTo(40, 70, 4, 40);
+  const int kCardSize = 64;
+  for (int y = 0; y < height; y += kCardSize) {
+    for (int x = 0; x < width; x += kCardSize) {
+      builder.save();
+      builder.translate(x, y);
+      builder.setStyle(DlDrawStyle::kFill);
+      builder.setColor(0xFF000000 | ((x & 0xFF) << 16) | ((y & 0xFF) << 8));
+      builder.drawRRect(SkRRect::MakeRectXY(
+          SkRect::MakeWH(kCardSize - 4, kCardSize - 4), 8, 8));
+      builder.setColor(SK_ColorYELLOW);
+      builder.drawCircle(SkPoint::Make(kCardSize / 2, kCardSize / 2), 12);
+      builder.setStyle(DlDrawStyle::kStroke);
+      builder.setStrokeWidth(3);
+      builder.setColor(SK_ColorBLUE);
+      builder.drawPath(path);
+      builder.restore();
+    }
+  }
+  return builder.Build();
+}
+
+// Rasterizes a full screen DisplayList in tiles using the number of
+// worker threads given by the benchmark argument in addition to the
+// benchmark thread. An argument of 0 renders on the benchmark thread
+// alone for comparison.
+static void BM_DisplayListTileRasterizer(benchmark::State& state) {
+  const int kWidth = 1920;
+  const int kHeight = 1080;
+  const size_t worker_count = state.range(0);
+
+  std::shared_ptr<fml::ConcurrentMessageLoop> loop;
+  std::shared_ptr<fml::ConcurrentTaskRunner> task_runner;
+  if (worker_count > 0) {
+    loop = fml::ConcurrentMessageLoop::Create(worker_count);
+    task_runner = loop->GetTaskRunner();
+  }
+  DisplayListTileRasterizer rasterizer(task_runner, worker_count);
+
+  auto display_list = BuildFullScreenDisplayList(kWidth, kHeight);
+  auto surface = SkSurface::MakeRasterN32Premul(kWidth, kHeight);
+  SkPixmap pixmap;
+  if (!surface->peekPixels(&pixmap)) {
+    state.SkipWithError("Could not access the pixels of the surface.");
+    return;
+  }
+
+  for ([[maybe_unused]] auto _ : state) {
+    rasterizer.Rasterize(display_list, pixmap, surface->props());
+  }
+  state.counters["Workers"] = worker_count;
+  state.counters["Ops"] = display_list->op_count();
+}
+
+BENCHMARK(BM_DisplayListTileRasterizer)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(3)
+    ->Arg(7)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,6 +4,8 @@
 
 #include "flutter/display_list/display_list_builder.h"
 
+#include <cmath>
+
 #include "flutter/display_list/display_list_blend_mode.h"
 #include "flutter/display_list/display_list_ops.h"
 
@@ -23,21 +25,92 @@ static void CopyV(void* dst, const S* src, int n, Rest&&... rest) {
   CopyV(SkTAddOffset<void>(dst, n * sizeof(S)), std::forward<Rest>(rest)...);
 }
 
+// A negative zero would be reconstructed as a positive zero by the
+// quantized ops, which would not compare as |Equals| to the original.
+static bool IsNegativeZero(SkScalar value) {
+  return value == 0 && std::signbit(value);
+}
+
+// Returns true if |value| is an integer that can be stored in an int16_t
+// and reconstructed exactly.
+static bool IsInt16(SkScalar value) {
+  return value >= INT16_MIN && value <= INT16_MAX &&
+         value == static_cast<int16_t>(value) && !IsNegativeZero(value);
+}
+
+// Returns true if |value| is an integer that can be stored in an uint16_t
+// and reconstructed exactly.
+static bool IsUInt16(SkScalar value) {
+  return value >= 0 && value <= UINT16_MAX &&
+         value == static_cast<uint16_t>(value) && !IsNegativeZero(value);
+}
+
+// Returns true if |rect| can be recorded as an int16_t origin with
+// uint16_t dimensions and reconstructed exactly on dispatch.
+static bool IsInt16Rect(const SkRect& rect) {
+  return IsInt16(rect.fLeft) && IsInt16(rect.fTop) &&
+         IsUInt16(rect.width()) && IsUInt16(rect.height()) &&
+         !IsNegativeZero(rect.fRight) && !IsNegativeZero(rect.fBottom);
+}
+
+// Image filters that are implemented by Skia may wrap an image.
+static bool MayHaveTextureImages(const DlImageFilter* filter) {
+  if (filter == nullptr) {
+    return false;
+  }
+  switch (filter->type()) {
+    case DlImageFilterType::kBlur:
+    case DlImageFilterType::kDilate:
+    case DlImageFilterType::kErode:
+    case DlImageFilterType::kMatrix:
+    case DlImageFilterType::kColorFilter:
+      return false;
+    case DlImageFilterType::kComposeFilter: {
+      const DlComposeImageFilter* compose = filter->asCompose();
+      FML_DCHECK(compose);
+      return MayHaveTextureImages(compose->outer().get()) ||
+             MayHaveTextureImages(compose->inner().get());
+    }
+    case DlImageFilterType::kUnknown:
+      return true;
+  }
+}
+
 template <typename T, typename... Args>
 void* DisplayListBuilder::Push(size_t pod, int op_inc, Args&&... args) {
-  size_t size = SkAlignPtr(sizeof(T) + pod);
+  size_t pad = 0;
+  size_t size;
+  if (compact_encoding_) {
+    // Ops that hold pointers, or that are followed by pod data which
+    // may hold pointers, must still start on a pointer boundary. All
+    // other ops only need to be 4 byte aligned. Any padding required
+    // to realign the next op is absorbed into the size of the previous
+    // op so that the list can still be walked using |DLOp::size|.
+    if ((alignof(T) > 4 || pod > 0) && used_ > 0) {
+      pad = SkAlignPtr(used_) - used_;
+    }
+    size = SkAlign4(sizeof(T) + pod);
+  } else {
+    size = SkAlignPtr(sizeof(T) + pod);
+  }
   FML_DCHECK(size < (1 << 24));
-  if (used_ + size > allocated_) {
+  if (used_ + pad + size > allocated_) {
     static_assert(SkIsPow2(DL_BUILDER_PAGE),
                   "This math needs updating for non-pow2.");
     // Next greater multiple of DL_BUILDER_PAGE.
-    allocated_ = (used_ + size + DL_BUILDER_PAGE) & ~(DL_BUILDER_PAGE - 1);
+    allocated_ =
+        (used_ + pad + size + DL_BUILDER_PAGE) & ~(DL_BUILDER_PAGE - 1);
     storage_.realloc(allocated_);
     FML_DCHECK(storage_.get());
     memset(storage_.get() + used_, 0, allocated_ - used_);
   }
+  if (pad > 0) {
+    reinterpret_cast<DLOp*>(storage_.get() + last_op_offset_)->size += pad;
+    used_ += pad;
+  }
   FML_DCHECK(used_ + size <= allocated_);
   auto op = reinterpret_cast<T*>(storage_.get() + used_);
+  last_op_offset_ = used_;
   used_ += size;
   new (op) T{std::forward<Args>(args)...};
   op->type = T::kType;
@@ -55,16 +128,28 @@ sk_sp<DisplayList> DisplayListBuilder::Build() {
   size_t nested_bytes = nested_bytes_;
   int nested_count = nested_op_count_;
   used_ = allocated_ = op_count_ = 0;
+  last_op_offset_ = 0;
   nested_bytes_ = nested_op_count_ = 0;
   storage_.realloc(bytes);
   bool compatible = layer_stack_.back().is_group_opacity_compatible();
-  return sk_sp<DisplayList>(new DisplayList(storage_.release(), bytes, count,
-                                            nested_bytes, nested_count,
-                                            cull_rect_, compatible));
+  bool may_read_backdrop = may_read_backdrop_;
+  bool may_have_texture_images = may_have_texture_images_;
+  may_read_backdrop_ = may_have_texture_images_ = false;
+  sk_sp<DisplayList> display_list(new DisplayList(
+      storage_.release(), bytes, count, nested_bytes, nested_count, cull_rect_,
+      compatible, may_read_backdrop, may_have_texture_images));
+  if (prepare_rtree_ && count >= rtree_min_op_count_) {
+    display_list->ComputeBoundsAndRTree();
+  }
+  return display_list;
 }
 
-DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect)
-    : cull_rect_(cull_rect) {
+DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect,
+                                       bool compact_encoding,
+                                       bool prepare_rtree)
+    : compact_encoding_(compact_encoding),
+      prepare_rtree_(prepare_rtree),
+      cull_rect_(cull_rect) {
   layer_stack_.emplace_back(SkM44(), cull_rect);
   current_layer_ = &layer_stack_.back();
 }
@@ -152,6 +237,8 @@ void DisplayListBuilder::onSetColorSource(const DlColorSource* source) {
         const DlImageColorSource* image_source = source->asImage();
         FML_DCHECK(image_source);
         Push<SetImageColorSourceOp>(0, 0, image_source);
+        CheckTextureImage(image_source->image() &&
+                          image_source->image()->isTextureBacked());
         break;
       }
       case DlColorSourceType::kLinearGradient: {
@@ -185,6 +272,8 @@ void DisplayListBuilder::onSetColorSource(const DlColorSource* source) {
       }
       case DlColorSourceType::kUnknown:
         Push<SetSkColorSourceOp>(0, 0, source->skia_object());
+        // Skia shaders can wrap arbitrary images.
+        CheckTextureImage(true);
         break;
     }
   }
@@ -227,10 +316,12 @@ void DisplayListBuilder::onSetImageFilter(const DlImageFilter* filter) {
       case DlImageFilterType::kComposeFilter:
       case DlImageFilterType::kColorFilter: {
         Push<SetSharedImageFilterOp>(0, 0, filter);
+        CheckTextureImage(MayHaveTextureImages(filter));
         break;
       }
       case DlImageFilterType::kUnknown: {
         Push<SetSkImageFilterOp>(0, 0, filter->skia_object());
+        CheckTextureImage(true);
         break;
       }
     }
@@ -311,6 +402,7 @@ void DisplayListBuilder::onSetMaskFilter(const DlMaskFilter* filter) {
       }
       case DlMaskFilterType::kUnknown:
         Push<SetSkMaskFilterOp>(0, 0, filter->skia_object());
+        CheckTextureImage(true);
         break;
     }
   }
@@ -465,8 +557,9 @@ void DisplayListBuilder::saveLayer(const SkRect* bounds,
                                    const SaveLayerOptions in_options,
                                    const DlImageFilter* backdrop) {
   SaveLayerOptions options = in_options.without_optimizations();
-  size_t save_layer_offset = used_;
   if (backdrop) {
+    may_read_backdrop_ = true;
+    CheckTextureImage(MayHaveTextureImages(backdrop));
     bounds  //
         ? Push<SaveLayerBackdropBoundsOp>(0, 1, *bounds, options, backdrop)
         : Push<SaveLayerBackdropOp>(0, 1, options, backdrop);
@@ -475,6 +568,9 @@ void DisplayListBuilder::saveLayer(const SkRect* bounds,
         ? Push<SaveLayerBoundsOp>(0, 1, *bounds, options)
         : Push<SaveLayerOp>(0, 1, options);
   }
+  // Read the offset back after the Push as a compact builder may have
+  // inserted alignment padding ahead of the op.
+  size_t save_layer_offset = last_op_offset_;
   CheckLayerOpacityCompatibility(options.renders_with_attributes());
   layer_stack_.emplace_back(current_layer_, save_layer_offset, true);
   current_layer_ = &layer_stack_.back();
@@ -504,7 +600,12 @@ void DisplayListBuilder::saveLayer(const SkRect* bounds,
 void DisplayListBuilder::translate(SkScalar tx, SkScalar ty) {
   if (SkScalarIsFinite(tx) && SkScalarIsFinite(ty) &&
       (tx != 0.0 || ty != 0.0)) {
-    Push<TranslateOp>(0, 1, tx, ty);
+    if (compact_encoding_ && IsInt16(tx) && IsInt16(ty)) {
+      Push<TranslateInt16Op>(0, 1, static_cast<int16_t>(tx),
+                             static_cast<int16_t>(ty));
+    } else {
+      Push<TranslateOp>(0, 1, tx, ty);
+    }
     current_layer_->matrix.preTranslate(tx, ty);
   }
 }
@@ -685,7 +786,16 @@ void DisplayListBuilder::drawColor(DlColor color, DlBlendMode mode) {
   CheckLayerOpacityCompatibility(mode);
 }
 void DisplayListBuilder::drawLine(const SkPoint& p0, const SkPoint& p1) {
-  Push<DrawLineOp>(0, 1, p0, p1);
+  if (compact_encoding_ && IsInt16(p0.fX) && IsInt16(p0.fY) &&
+      IsInt16(p1.fX - p0.fX) && IsInt16(p1.fY - p0.fY) &&
+      !IsNegativeZero(p1.fX) && !IsNegativeZero(p1.fY)) {
+    Push<DrawLineInt16Op>(0, 1, static_cast<int16_t>(p0.fX),
+                          static_cast<int16_t>(p0.fY),
+                          static_cast<int16_t>(p1.fX - p0.fX),
+                          static_cast<int16_t>(p1.fY - p0.fY));
+  } else {
+    Push<DrawLineOp>(0, 1, p0, p1);
+  }
   CheckLayerOpacityCompatibility();
 }
 void DisplayListBuilder::drawLine(const SkPoint& p0,
@@ -695,7 +805,14 @@ void DisplayListBuilder::drawLine(const SkPoint& p0,
   drawLine(p0, p1);
 }
 void DisplayListBuilder::drawRect(const SkRect& rect) {
-  Push<DrawRectOp>(0, 1, rect);
+  if (compact_encoding_ && IsInt16Rect(rect)) {
+    Push<DrawRectInt16Op>(0, 1, static_cast<int16_t>(rect.fLeft),
+                          static_cast<int16_t>(rect.fTop),
+                          static_cast<uint16_t>(rect.width()),
+                          static_cast<uint16_t>(rect.height()));
+  } else {
+    Push<DrawRectOp>(0, 1, rect);
+  }
   CheckLayerOpacityCompatibility();
 }
 void DisplayListBuilder::drawRect(const SkRect& rect, const DlPaint& paint) {
@@ -703,7 +820,14 @@ void DisplayListBuilder::drawRect(const SkRect& rect, const DlPaint& paint) {
   drawRect(rect);
 }
 void DisplayListBuilder::drawOval(const SkRect& bounds) {
-  Push<DrawOvalOp>(0, 1, bounds);
+  if (compact_encoding_ && IsInt16Rect(bounds)) {
+    Push<DrawOvalInt16Op>(0, 1, static_cast<int16_t>(bounds.fLeft),
+                          static_cast<int16_t>(bounds.fTop),
+                          static_cast<uint16_t>(bounds.width()),
+                          static_cast<uint16_t>(bounds.height()));
+  } else {
+    Push<DrawOvalOp>(0, 1, bounds);
+  }
   CheckLayerOpacityCompatibility();
 }
 void DisplayListBuilder::drawOval(const SkRect& bounds, const DlPaint& paint) {
@@ -854,6 +978,7 @@ void DisplayListBuilder::drawImage(const sk_sp<DlImage> image,
                                    const SkPoint point,
                                    DlImageSampling sampling,
                                    bool render_with_attributes) {
+  CheckTextureImage(image);
   render_with_attributes
       ? Push<DrawImageWithAttrOp>(0, 1, std::move(image), point, sampling)
       : Push<DrawImageOp>(0, 1, std::move(image), point, sampling);
@@ -877,6 +1002,7 @@ void DisplayListBuilder::drawImageRect(const sk_sp<DlImage> image,
                                        DlImageSampling sampling,
                                        bool render_with_attributes,
                                        SkCanvas::SrcRectConstraint constraint) {
+  CheckTextureImage(image);
   Push<DrawImageRectOp>(0, 1, std::move(image), src, dst, sampling,
                         render_with_attributes, constraint);
   CheckLayerOpacityCompatibility(render_with_attributes);
@@ -900,6 +1026,7 @@ void DisplayListBuilder::drawImageNine(const sk_sp<DlImage> image,
                                        const SkRect& dst,
                                        DlFilterMode filter,
                                        bool render_with_attributes) {
+  CheckTextureImage(image);
   render_with_attributes
       ? Push<DrawImageNineWithAttrOp>(0, 1, std::move(image), center, dst,
                                       filter)
@@ -924,6 +1051,7 @@ void DisplayListBuilder::drawImageLattice(const sk_sp<DlImage> image,
                                           const SkRect& dst,
                                           DlFilterMode filter,
                                           bool render_with_attributes) {
+  CheckTextureImage(image);
   int xDivCount = lattice.fXCount;
   int yDivCount = lattice.fYCount;
   FML_DCHECK((lattice.fRectTypes == nullptr) || (lattice.fColors != nullptr));
@@ -950,6 +1078,7 @@ void DisplayListBuilder::drawAtlas(const sk_sp<DlImage> atlas,
                                    DlImageSampling sampling,
                                    const SkRect* cull_rect,
                                    bool render_with_attributes) {
+  CheckTextureImage(atlas);
   int bytes = count * (sizeof(SkRSXform) + sizeof(SkRect));
   void* data_ptr;
   if (colors != nullptr) {
@@ -1014,6 +1143,9 @@ void DisplayListBuilder::drawPicture(const sk_sp<SkPicture> picture,
   // This behavior is identical to the way SkPicture computes nested op counts.
   nested_op_count_ += picture->approximateOpCount(true) - 1;
   nested_bytes_ += picture->approximateBytesUsed();
+  // We cannot inspect the SkPicture for backdrop filters or images.
+  may_read_backdrop_ = true;
+  CheckTextureImage(true);
   CheckLayerOpacityCompatibility(render_with_attributes);
 }
 void DisplayListBuilder::drawDisplayList(
@@ -1027,6 +1159,8 @@ void DisplayListBuilder::drawDisplayList(
   // This behavior is identical to the way SkPicture computes nested op counts.
   nested_op_count_ += display_list->op_count(true) - 1;
   nested_bytes_ += display_list->bytes(true);
+  may_read_backdrop_ |= display_list->may_read_backdrop();
+  CheckTextureImage(display_list->may_have_texture_images());
   UpdateLayerOpacityCompatibility(display_list->can_apply_group_opacity());
 }
 void DisplayListBuilder::drawTextBlob(const sk_sp<SkTextBlob> blob,
@@ -28,7 +28,19 @@ class DisplayListBuilder final : public virtual Dispatcher,
                                  public SkRefCnt,
                                  DisplayListOpFlags {
  public:
-  explicit DisplayListBuilder(const SkRect& cull_rect = kMaxCullRect_);
+  // If |compact_encoding| is true then the builder will pack ops that
+  // hold no pointers more tightly in memory and will record integral
+  // rects, ovals, lines and translations using 16-bit quantized ops
+  // whenever that can be done without any loss of precision. The
+  // resulting DisplayList renders identically, but uses fewer bytes
+  // which matters for pictures that are retained across many frames.
+  //
+  // If |prepare_rtree| is true then |Build| will also compute an R-Tree
+  // of the bounds of the rendering ops so that the resulting DisplayList
+  // can skip the ops outside of a cull rect when it is dispatched.
+  explicit DisplayListBuilder(const SkRect& cull_rect = kMaxCullRect_,
+                              bool compact_encoding = false,
+                              bool prepare_rtree = false);
 
   ~DisplayListBuilder();
 
@@ -342,16 +354,39 @@ class DisplayListBuilder final : public virtual Dispatcher,
 
   sk_sp<DisplayList> Build();
 
+  bool is_compact_encoding() const { return compact_encoding_; }
+  bool will_prepare_rtree() const { return prepare_rtree_; }
+
+  // Skips the R-Tree requested at construction if the DisplayList ends up
+  // with fewer than |count| ops, for which culling saves less than building
+  // and searching the R-Tree costs.
+  void set_rtree_min_op_count(int count) { rtree_min_op_count_ = count; }
+
  private:
   SkAutoTMalloc<uint8_t> storage_;
   size_t used_ = 0;
   size_t allocated_ = 0;
   int op_count_ = 0;
 
+  // The offset of the most recently pushed op, used to absorb alignment
+  // padding into its size when |compact_encoding_| is enabled.
+  size_t last_op_offset_ = 0;
+  const bool compact_encoding_;
+  const bool prepare_rtree_;
+  int rtree_min_op_count_ = 0;
+
   // bytes and ops from |drawPicture| and |drawDisplayList|
   size_t nested_bytes_ = 0;
   int nested_op_count_ = 0;
 
+  // Set when a saveLayer with a backdrop, or an opaque nested picture
+  // that might contain one, is recorded.
+  bool may_read_backdrop_ = false;
+
+  // Set when an image, or an attribute or nested picture that might hold
+  // one, which is backed by a GPU texture is recorded.
+  bool may_have_texture_images_ = false;
+
   SkRect cull_rect_;
   static constexpr SkRect kMaxCullRect_ =
       SkRect::MakeLTRB(-1E9F, -1E9F, 1E9F, 1E9F);
@@ -482,6 +517,15 @@ class DisplayListBuilder final : public virtual Dispatcher,
     UpdateLayerOpacityCompatibility(IsOpacityCompatible(mode));
   }
 
+  // Note whether an op or attribute may sample a texture-backed image,
+  // as indicated by |texture_backed|.
+  void CheckTextureImage(bool texture_backed) {
+    may_have_texture_images_ |= texture_backed;
+  }
+  void CheckTextureImage(const sk_sp<DlImage>& image) {
+    CheckTextureImage(image && image->isTextureBacked());
+  }
+
   void onSetAntiAlias(bool aa);
   void onSetDither(bool dither);
   void onSetInvertColors(bool invert);
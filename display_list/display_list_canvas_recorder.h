@@ -26,7 +26,11 @@ class DisplayListCanvasRecorder
       public SkRefCnt,
       DisplayListOpFlags {
  public:
-  explicit DisplayListCanvasRecorder(const SkRect& bounds);
+  // If |prepare_rtree| is true then the DisplayList that is built will
+  // contain an R-Tree of its rendering operations that can be used to
+  // cull them when it is rendered (see DisplayListBuilder).
+  explicit DisplayListCanvasRecorder(const SkRect& bounds,
+                                     bool prepare_rtree = false);
 
   const sk_sp<DisplayListBuilder> builder() { return builder_; }
 
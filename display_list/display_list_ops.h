@@ -50,6 +50,11 @@ enum class DisplayListCompare {
 // The DLOp base uses 4 bytes so each Op-specific struct gets 4 bytes
 // of data for "free" and works best when it packs well into an 8-byte
 // aligned size.
+//
+// A DisplayListBuilder constructed with |compact_encoding| relaxes this
+// so that ops which hold no pointers and no trailing data are only
+// aligned to a 4 byte boundary, making the 4 "free" bytes of padding
+// disappear for those ops. See DisplayListBuilder::Push for details.
 struct DLOp {
   DisplayListOpType type : 8;
   uint32_t size : 24;
@@ -365,6 +370,19 @@ struct TranslateOp final : DLOp {
 
   void dispatch(Dispatcher& dispatcher) const { dispatcher.translate(tx, ty); }
 };
+// 4 byte header + 4 byte payload packs into minimum 8 bytes
+// Only recorded by a compact DisplayListBuilder for integral offsets
+// that fit losslessly into 16 bits.
+struct TranslateInt16Op final : DLOp {
+  static const auto kType = DisplayListOpType::kTranslateInt16;
+
+  TranslateInt16Op(int16_t tx, int16_t ty) : tx(tx), ty(ty) {}
+
+  const int16_t tx;
+  const int16_t ty;
+
+  void dispatch(Dispatcher& dispatcher) const { dispatcher.translate(tx, ty); }
+};
 // 4 byte header + 8 byte payload uses 12 bytes but is rounded up to 16 bytes
 // (4 bytes unused)
 struct ScaleOp final : DLOp {
@@ -556,6 +574,35 @@ DEFINE_DRAW_1ARG_OP(Oval, SkRect, oval)
 DEFINE_DRAW_1ARG_OP(RRect, SkRRect, rrect)
 #undef DEFINE_DRAW_1ARG_OP
 
+// 4 byte header + 8 byte payload uses 12 bytes in a compact DisplayList
+// (rounded up to 16 bytes otherwise)
+// Only recorded by a compact DisplayListBuilder for integral rectangles
+// whose origin fits into 16 bits. The right and bottom edges are delta
+// encoded as an unsigned 16 bit width and height so that they can be
+// reconstructed exactly on dispatch.
+#define DEFINE_DRAW_INT16_RECT_OP(op_name)                                  \
+  struct Draw##op_name##Int16Op final : DLOp {                              \
+    static const auto kType = DisplayListOpType::kDraw##op_name##Int16;     \
+                                                                            \
+    Draw##op_name##Int16Op(int16_t left,                                    \
+                           int16_t top,                                     \
+                           uint16_t width,                                  \
+                           uint16_t height)                                 \
+        : left(left), top(top), width(width), height(height) {}             \
+                                                                            \
+    const int16_t left;                                                     \
+    const int16_t top;                                                      \
+    const uint16_t width;                                                   \
+    const uint16_t height;                                                  \
+                                                                            \
+    void dispatch(Dispatcher& dispatcher) const {                           \
+      dispatcher.draw##op_name(SkRect::MakeXYWH(left, top, width, height)); \
+    }                                                                       \
+  };
+DEFINE_DRAW_INT16_RECT_OP(Rect)
+DEFINE_DRAW_INT16_RECT_OP(Oval)
+#undef DEFINE_DRAW_INT16_RECT_OP
+
 // 4 byte header + 16 byte payload uses 20 bytes but is rounded up to 24 bytes
 // (4 bytes unused)
 struct DrawPathOp final : DLOp {
@@ -598,6 +645,26 @@ DEFINE_DRAW_2ARG_OP(Circle, SkPoint, center, SkScalar, radius)
 DEFINE_DRAW_2ARG_OP(DRRect, SkRRect, outer, SkRRect, inner)
 #undef DEFINE_DRAW_2ARG_OP
 
+// 4 byte header + 8 byte payload uses 12 bytes in a compact DisplayList
+// (rounded up to 16 bytes otherwise)
+// Only recorded by a compact DisplayListBuilder for integral end points
+// where p0 and the delta from p0 to p1 both fit into 16 bits.
+struct DrawLineInt16Op final : DLOp {
+  static const auto kType = DisplayListOpType::kDrawLineInt16;
+
+  DrawLineInt16Op(int16_t x0, int16_t y0, int16_t dx, int16_t dy)
+      : x0(x0), y0(y0), dx(dx), dy(dy) {}
+
+  const int16_t x0;
+  const int16_t y0;
+  const int16_t dx;
+  const int16_t dy;
+
+  void dispatch(Dispatcher& dispatcher) const {
+    dispatcher.drawLine(SkPoint::Make(x0, y0), SkPoint::Make(x0 + dx, y0 + dy));
+  }
+};
+
 // 4 byte header + 28 byte payload packs efficiently into 32 bytes
 struct DrawArcOp final : DLOp {
   static const auto kType = DisplayListOpType::kDrawArc;
@@ -97,6 +97,10 @@ class DlDashPathEffect final : public DlPathEffect {
     return reinterpret_cast<const SkScalar*>(this + 1);
   }
 
+  int count() const { return count_; }
+
+  SkScalar phase() const { return phase_; }
+
   std::optional<SkRect> effect_bounds(SkRect& rect) const override;
 
  protected:
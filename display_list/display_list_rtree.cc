@@ -0,0 +1,94 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_rtree.h"
+
+#include <algorithm>
+
+namespace flutter {
+
+DlRTree::DlRTree(const SkRect rects[], const int ids[], int N)
+    : leaf_count_(0) {
+  FML_DCHECK(N >= 0);
+  for (int i = 0; i < N; i++) {
+    if (!rects[i].isEmpty()) {
+      leaf_count_++;
+    }
+  }
+  if (leaf_count_ == 0) {
+    return;
+  }
+
+  // Compute the exact number of nodes so that the vector never
+  // reallocates while the interior nodes are being constructed.
+  int node_count = leaf_count_;
+  for (int level_count = leaf_count_; level_count > 1;) {
+    level_count = (level_count + kMaxChildren - 1) / kMaxChildren;
+    node_count += level_count;
+  }
+  nodes_.reserve(node_count);
+
+  for (int i = 0; i < N; i++) {
+    if (!rects[i].isEmpty()) {
+      FML_DCHECK(nodes_.empty() || nodes_.back().index <= ids[i]);
+      nodes_.push_back({rects[i], ids[i], 0});
+    }
+  }
+
+  // Build each level of interior nodes from runs of consecutive nodes
+  // of the level below until we end up with a single root node.
+  int level_start = 0;
+  int level_count = leaf_count_;
+  while (level_count > 1) {
+    int level_end = level_start + level_count;
+    for (int i = level_start; i < level_end; i += kMaxChildren) {
+      int child_count = std::min(kMaxChildren, level_end - i);
+      SkRect bounds = nodes_[i].bounds;
+      for (int j = 1; j < child_count; j++) {
+        bounds.join(nodes_[i + j].bounds);
+      }
+      nodes_.push_back({bounds, i, child_count});
+    }
+    level_start = level_end;
+    level_count = static_cast<int>(nodes_.size()) - level_start;
+  }
+  FML_DCHECK(static_cast<int>(nodes_.size()) == node_count);
+}
+
+void DlRTree::search(const SkRect& query, std::vector<int>* results) const {
+  FML_DCHECK(results != nullptr);
+  if (query.isEmpty() || nodes_.empty()) {
+    return;
+  }
+  const Node& root = nodes_.back();
+  if (root.bounds.intersects(query)) {
+    search(root, query, results);
+  }
+}
+
+void DlRTree::search(const Node& parent,
+                     const SkRect& query,
+                     std::vector<int>* results) const {
+  if (parent.child_count == 0) {
+    results->push_back(parent.index);
+    return;
+  }
+  const Node* child = &nodes_[parent.index];
+  const Node* end = child + parent.child_count;
+  for (; child < end; child++) {
+    if (child->bounds.intersects(query)) {
+      search(*child, query, results);
+    }
+  }
+}
+
+const SkRect& DlRTree::bounds() const {
+  if (nodes_.empty()) {
+    static constexpr SkRect kEmpty = SkRect::MakeEmpty();
+    return kEmpty;
+  }
+  return nodes_.back().bounds;
+}
+
+}  // namespace flutter
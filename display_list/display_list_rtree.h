@@ -0,0 +1,84 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_RTREE_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_RTREE_H_
+
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkRect.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
+
+namespace flutter {
+
+// An R-Tree that divides up a list of bounding rectangles into a hierarchy
+// of nodes that can be quickly searched for the rectangles that intersect
+// a given query rectangle.
+//
+// The tree is bulk loaded once at construction time from rectangles that
+// are supplied in the order that their associated operations are rendered
+// (such as the ops of a DisplayList) and the ordering of the rectangles is
+// preserved by the leaves of the tree so that searches will return their
+// results in that same rendering order without any additional sorting.
+//
+// Empty rectangles are omitted from the tree as they can never intersect
+// a query.
+class DlRTree : public SkRefCnt {
+ public:
+  // Construct an R-Tree from the list of |N| rectangles in |rects|, each
+  // identified by the id at the same index in |ids|. The ids are expected
+  // to be non-decreasing which is the case for ids that represent the
+  // index of an operation in a sequence of rendering operations.
+  DlRTree(const SkRect rects[], const int ids[], int N);
+
+  // Search the R-Tree for all of the rectangles that intersect the
+  // |query| rectangle and append their ids to |results|, in the order
+  // that the rectangles were supplied at construction time.
+  void search(const SkRect& query, std::vector<int>* results) const;
+
+  // The union of all of the rectangles in the tree.
+  const SkRect& bounds() const;
+
+  // The number of (non-empty) rectangles that are stored in the tree.
+  int leaf_count() const { return leaf_count_; }
+
+  // The number of nodes, both leaves and interior nodes, in the tree.
+  int node_count() const { return static_cast<int>(nodes_.size()); }
+
+  // The number of bytes of memory used by the tree.
+  size_t bytes_used() const {
+    return sizeof(DlRTree) + nodes_.capacity() * sizeof(Node);
+  }
+
+ private:
+  // The maximum number of children of each interior node. The rectangles
+  // recorded from a DisplayList tend to be spatially coherent along the
+  // op order so grouping consecutive leaves produces reasonably tight
+  // node bounds.
+  static constexpr int kMaxChildren = 8;
+
+  struct Node {
+    SkRect bounds;
+    // For a leaf node this is the id of the associated rectangle.
+    // For an interior node this is the index of its first child.
+    int index;
+    // The number of children of an interior node, or 0 for a leaf.
+    int child_count;
+  };
+
+  void search(const Node& parent,
+              const SkRect& query,
+              std::vector<int>* results) const;
+
+  std::vector<Node> nodes_;
+  int leaf_count_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DlRTree);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_RTREE_H_
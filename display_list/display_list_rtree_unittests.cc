@@ -0,0 +1,96 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_rtree.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(DisplayListRTree, NoItems) {
+  DlRTree tree(nullptr, nullptr, 0);
+  EXPECT_EQ(tree.leaf_count(), 0);
+  EXPECT_EQ(tree.node_count(), 0);
+  EXPECT_TRUE(tree.bounds().isEmpty());
+  std::vector<int> results;
+  tree.search(SkRect::MakeLTRB(-100, -100, 100, 100), &results);
+  EXPECT_TRUE(results.empty());
+}
+
+TEST(DisplayListRTree, EmptyRectsAreOmitted) {
+  SkRect rects[] = {
+      SkRect::MakeLTRB(10, 10, 20, 20),
+      SkRect::MakeLTRB(30, 30, 30, 40),
+      SkRect::MakeLTRB(50, 50, 60, 60),
+  };
+  int ids[] = {0, 1, 2};
+  DlRTree tree(rects, ids, 3);
+  EXPECT_EQ(tree.leaf_count(), 2);
+  EXPECT_EQ(tree.bounds(), SkRect::MakeLTRB(10, 10, 60, 60));
+  std::vector<int> results;
+  tree.search(SkRect::MakeLTRB(0, 0, 100, 100), &results);
+  EXPECT_EQ(results, std::vector<int>({0, 2}));
+}
+
+TEST(DisplayListRTree, SingleItem) {
+  SkRect rect = SkRect::MakeLTRB(10, 10, 20, 20);
+  int id = 7;
+  DlRTree tree(&rect, &id, 1);
+  EXPECT_EQ(tree.node_count(), 1);
+
+  std::vector<int> results;
+  tree.search(SkRect::MakeLTRB(0, 0, 10, 10), &results);
+  EXPECT_TRUE(results.empty());
+  tree.search(SkRect::MakeLTRB(15, 15, 25, 25), &results);
+  EXPECT_EQ(results, std::vector<int>({7}));
+}
+
+TEST(DisplayListRTree, ManyItemsSearchInInsertionOrder) {
+  // A 40x40 grid of 10x10 cells, each separated by a 10 pixel gap,
+  // which is enough items to produce several levels of interior nodes.
+  const int kGridSize = 40;
+  std::vector<SkRect> rects;
+  std::vector<int> ids;
+  for (int y = 0; y < kGridSize; y++) {
+    for (int x = 0; x < kGridSize; x++) {
+      rects.push_back(SkRect::MakeXYWH(x * 20, y * 20, 10, 10));
+      ids.push_back(static_cast<int>(ids.size()));
+    }
+  }
+  DlRTree tree(rects.data(), ids.data(), static_cast<int>(rects.size()));
+  EXPECT_EQ(tree.leaf_count(), kGridSize * kGridSize);
+  EXPECT_GT(tree.node_count(), tree.leaf_count());
+
+  for (int y = 0; y < kGridSize; y += 7) {
+    for (int x = 0; x < kGridSize; x += 5) {
+      // A query that overlaps a 2x2 group of cells starting at (x, y)
+      SkRect query = SkRect::MakeXYWH(x * 20 + 5, y * 20 + 5, 20, 20);
+      std::vector<int> expected;
+      for (size_t i = 0; i < rects.size(); i++) {
+        if (rects[i].intersects(query)) {
+          expected.push_back(ids[i]);
+        }
+      }
+      std::vector<int> results;
+      tree.search(query, &results);
+      EXPECT_EQ(results, expected) << "query at " << x << ", " << y;
+    }
+  }
+}
+
+TEST(DisplayListRTree, DuplicateIdsAreAllReturned) {
+  SkRect rects[] = {
+      SkRect::MakeLTRB(10, 10, 20, 20),
+      SkRect::MakeLTRB(15, 15, 25, 25),
+      SkRect::MakeLTRB(50, 50, 60, 60),
+  };
+  int ids[] = {3, 3, 4};
+  DlRTree tree(rects, ids, 3);
+  std::vector<int> results;
+  tree.search(SkRect::MakeLTRB(12, 12, 18, 18), &results);
+  EXPECT_EQ(results, std::vector<int>({3, 3}));
+}
+
+}  // namespace testing
+}  // namespace flutter
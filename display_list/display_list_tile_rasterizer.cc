@@ -0,0 +1,98 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_tile_rasterizer.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+
+namespace flutter {
+
+DisplayListTileRasterizer::DisplayListTileRasterizer(
+    std::shared_ptr<fml::ConcurrentTaskRunner> task_runner,
+    size_t worker_count,
+    int tile_size)
+    : task_runner_(std::move(task_runner)),
+      worker_count_(task_runner_ ? worker_count : 0),
+      tile_size_(tile_size) {
+  FML_DCHECK(tile_size_ > 0);
+}
+
+DisplayListTileRasterizer::~DisplayListTileRasterizer() = default;
+
+bool DisplayListTileRasterizer::CanRasterizeInTiles(
+    const DisplayList& display_list) {
+  return display_list.has_rtree() && !display_list.may_read_backdrop();
+}
+
+static void RasterizeRect(const DisplayList& display_list,
+                          const SkPixmap& pixels,
+                          const SkIRect& rect,
+                          const SkSurfaceProps& props,
+                          SkScalar opacity) {
+  SkPixmap subset;
+  SkBitmap bitmap;
+  if (!pixels.extractSubset(&subset, rect) || !bitmap.installPixels(subset)) {
+    return;
+  }
+  SkCanvas canvas(bitmap, props);
+  canvas.translate(-rect.fLeft, -rect.fTop);
+  display_list.RenderTo(&canvas, opacity);
+}
+
+bool DisplayListTileRasterizer::Rasterize(
+    const sk_sp<DisplayList>& display_list,
+    const SkPixmap& pixels,
+    const SkSurfaceProps& props,
+    SkScalar opacity) const {
+  if (!display_list || pixels.addr() == nullptr) {
+    return false;
+  }
+  TRACE_EVENT0("flutter", "DisplayListTileRasterizer::Rasterize");
+
+  const int columns = (pixels.width() + tile_size_ - 1) / tile_size_;
+  const int rows = (pixels.height() + tile_size_ - 1) / tile_size_;
+  const int tile_count = columns * rows;
+  if (worker_count_ == 0 || tile_count < 2 ||
+      !CanRasterizeInTiles(*display_list)) {
+    RasterizeRect(*display_list, pixels, pixels.bounds(), props, opacity);
+    return true;
+  }
+
+  // Tiles are handed out dynamically rather than being divided up front
+  // as the cost of the tiles of a typical frame varies widely.
+  std::atomic<int> next_tile = 0;
+  auto rasterize_tiles = [&]() {
+    TRACE_EVENT0("flutter", "DisplayListTileRasterizer::RasterizeTiles");
+    for (int tile = next_tile++; tile < tile_count; tile = next_tile++) {
+      int x = (tile % columns) * tile_size_;
+      int y = (tile / columns) * tile_size_;
+      SkIRect rect = SkIRect::MakeXYWH(x, y, tile_size_, tile_size_);
+      if (rect.intersect(pixels.bounds())) {
+        RasterizeRect(*display_list, pixels, rect, props, opacity);
+      }
+    }
+  };
+
+  // The calling thread renders tiles too, so one fewer task is needed.
+  size_t task_count =
+      std::min(worker_count_, static_cast<size_t>(tile_count - 1));
+  fml::CountDownLatch latch(task_count);
+  for (size_t i = 0; i < task_count; i++) {
+    task_runner_->PostTask([&rasterize_tiles, &latch]() {
+      rasterize_tiles();
+      latch.CountDown();
+    });
+  }
+  rasterize_tiles();
+  latch.Wait();
+  return true;
+}
+
+}  // namespace flutter
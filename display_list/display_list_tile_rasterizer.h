@@ -0,0 +1,78 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_TILE_RASTERIZER_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_TILE_RASTERIZER_H_
+
+#include <memory>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+#include "third_party/skia/include/core/SkSurfaceProps.h"
+
+namespace flutter {
+
+// Rasterizes a DisplayList into a block of CPU pixels using several
+// threads at once.
+//
+// The destination is divided into a grid of square tiles and each tile
+// is rendered by whichever thread claims it next, the calling thread
+// included, with a DisplayListCanvasDispatcher that writes directly into
+// the tile's portion of the destination pixels. The R-Tree of the
+// DisplayList is used to dispatch only those rendering ops that touch
+// each tile, so a DisplayList must have been built with an R-Tree to be
+// rendered in tiles.
+//
+// DisplayLists that have no R-Tree, or that may read back the pixels
+// surrounding their ops (see |DisplayList::may_read_backdrop|), and
+// destinations that fit in a single tile, are rendered on the calling
+// thread alone.
+class DisplayListTileRasterizer {
+ public:
+  static constexpr int kDefaultTileSize = 256;
+
+  // Constructs a rasterizer that renders tiles on the workers of the
+  // |task_runner| in addition to the calling thread. At most
+  // |worker_count| tasks will be posted to the |task_runner| for each
+  // DisplayList that is rendered.
+  //
+  // The |tile_size| should be a multiple of 8 so that dithered content
+  // lines up across the tile boundaries.
+  DisplayListTileRasterizer(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner,
+      size_t worker_count,
+      int tile_size = kDefaultTileSize);
+
+  ~DisplayListTileRasterizer();
+
+  // Renders the |display_list| on top of the existing contents of the
+  // |pixels| as if it were drawn with an identity transform on an
+  // SkCanvas with the indicated surface |props|.
+  //
+  // Returns false if the pixels could not be rendered into.
+  bool Rasterize(const sk_sp<DisplayList>& display_list,
+                 const SkPixmap& pixels,
+                 const SkSurfaceProps& props,
+                 SkScalar opacity = SK_Scalar1) const;
+
+  // Whether the |display_list| can be split into tiles by this class.
+  static bool CanRasterizeInTiles(const DisplayList& display_list);
+
+  size_t worker_count() const { return worker_count_; }
+
+  int tile_size() const { return tile_size_; }
+
+ private:
+  const std::shared_ptr<fml::ConcurrentTaskRunner> task_runner_;
+  const size_t worker_count_;
+  const int tile_size_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListTileRasterizer);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_TILE_RASTERIZER_H_
@@ -0,0 +1,120 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_tile_rasterizer.h"
+
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/display_list/display_list_image_filter.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+static constexpr int kTestWidth = 200;
+static constexpr int kTestHeight = 150;
+static constexpr int kTestTileSize = 32;
+
+static sk_sp<DisplayList> BuildTestDisplayList(bool prepare_rtree,
+                                               bool with_backdrop = false) {
+  DisplayListBuilder builder(SkRect::MakeWH(kTestWidth, kTestHeight), false,
+                             prepare_rtree);
+  builder.drawColor(SK_ColorWHITE, DlBlendMode::kSrc);
+  for (int i = 0; i < 20; i++) {
+    builder.setColor(0xFF000000 | (i * 12) << 16 | (255 - i * 12));
+    builder.drawRect(SkRect::MakeXYWH(i * 9, i * 7, 45, 30));
+  }
+  builder.save();
+  builder.translate(100, 40);
+  builder.clipRect(SkRect::MakeWH(70, 70), SkClipOp::kIntersect, false);
+  builder.setColor(SK_ColorGREEN);
+  builder.drawOval(SkRect::MakeLTRB(-20, -20, 90, 90));
+  builder.restore();
+  if (with_backdrop) {
+    DlBlurImageFilter blur(3, 3, DlTileMode::kClamp);
+    builder.saveLayer(nullptr, SaveLayerOptions::kNoAttributes, &blur);
+    builder.restore();
+  }
+  builder.setColor(SK_ColorMAGENTA);
+  builder.drawLine(SkPoint::Make(0, 149), SkPoint::Make(199, 0));
+  return builder.Build();
+}
+
+static sk_sp<SkSurface> Rasterize(const DisplayListTileRasterizer& rasterizer,
+                                  const sk_sp<DisplayList>& display_list) {
+  auto surface = SkSurface::MakeRasterN32Premul(kTestWidth, kTestHeight);
+  surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+  SkPixmap pixmap;
+  EXPECT_TRUE(surface->peekPixels(&pixmap));
+  EXPECT_TRUE(rasterizer.Rasterize(display_list, pixmap, surface->props()));
+  return surface;
+}
+
+static void ExpectSamePixels(const sk_sp<SkSurface>& a,
+                             const sk_sp<SkSurface>& b) {
+  SkPixmap pixmap_a;
+  SkPixmap pixmap_b;
+  ASSERT_TRUE(a->peekPixels(&pixmap_a));
+  ASSERT_TRUE(b->peekPixels(&pixmap_b));
+  ASSERT_EQ(pixmap_a.info(), pixmap_b.info());
+  for (int y = 0; y < pixmap_a.height(); y++) {
+    for (int x = 0; x < pixmap_a.width(); x++) {
+      ASSERT_EQ(*pixmap_a.addr32(x, y), *pixmap_b.addr32(x, y))
+          << "at " << x << ", " << y;
+    }
+  }
+}
+
+TEST(DisplayListTileRasterizer, TiledRenderingMatchesSingleThreaded) {
+  auto loop = fml::ConcurrentMessageLoop::Create(3);
+  DisplayListTileRasterizer tiled(loop->GetTaskRunner(), 3, kTestTileSize);
+  DisplayListTileRasterizer single(nullptr, 0);
+
+  auto display_list = BuildTestDisplayList(true);
+  ASSERT_TRUE(DisplayListTileRasterizer::CanRasterizeInTiles(*display_list));
+  ExpectSamePixels(Rasterize(tiled, display_list),
+                   Rasterize(single, display_list));
+}
+
+TEST(DisplayListTileRasterizer, DisplayListWithoutRTreeIsNotTiled) {
+  auto display_list = BuildTestDisplayList(false);
+  ASSERT_FALSE(DisplayListTileRasterizer::CanRasterizeInTiles(*display_list));
+
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  DisplayListTileRasterizer tiled(loop->GetTaskRunner(), 2, kTestTileSize);
+  DisplayListTileRasterizer single(nullptr, 0);
+  ExpectSamePixels(Rasterize(tiled, display_list),
+                   Rasterize(single, display_list));
+}
+
+TEST(DisplayListTileRasterizer, BackdropFilterPreventsTiling) {
+  auto display_list = BuildTestDisplayList(true, true);
+  ASSERT_TRUE(display_list->may_read_backdrop());
+  ASSERT_FALSE(DisplayListTileRasterizer::CanRasterizeInTiles(*display_list));
+
+  // The backdrop flag is inherited by DisplayLists that nest it.
+  DisplayListBuilder builder(SkRect::MakeWH(kTestWidth, kTestHeight), false,
+                             true);
+  builder.drawDisplayList(display_list);
+  auto nesting_display_list = builder.Build();
+  ASSERT_TRUE(nesting_display_list->may_read_backdrop());
+
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  DisplayListTileRasterizer tiled(loop->GetTaskRunner(), 2, kTestTileSize);
+  DisplayListTileRasterizer single(nullptr, 0);
+  ExpectSamePixels(Rasterize(tiled, display_list),
+                   Rasterize(single, display_list));
+}
+
+TEST(DisplayListTileRasterizer, RejectsMissingPixels) {
+  DisplayListTileRasterizer single(nullptr, 0);
+  SkPixmap pixmap;
+  SkSurfaceProps props;
+  ASSERT_FALSE(single.Rasterize(BuildTestDisplayList(true), pixmap, props));
+  ASSERT_FALSE(single.Rasterize(nullptr, pixmap, props));
+}
+
+}  // namespace testing
+}  // namespace flutter
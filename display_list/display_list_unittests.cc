@@ -1011,6 +1011,343 @@ TEST(DisplayList, SingleOpDisplayListsCompareToEachOther) {
   }
 }
 
+static constexpr SkRect kTestMaxCullRect =
+    SkRect::MakeLTRB(-1E9F, -1E9F, 1E9F, 1E9F);
+
+TEST(DisplayList, SingleOpCompactDisplayListsRecapturedAreEqual) {
+  for (auto& group : allGroups) {
+    for (size_t i = 0; i < group.variants.size(); i++) {
+      sk_sp<DisplayList> dl = group.variants[i].Build();
+      DisplayListBuilder compact_builder(kTestMaxCullRect, true);
+      group.variants[i].invoker(compact_builder);
+      sk_sp<DisplayList> compact = compact_builder.Build();
+      auto desc =
+          group.op_name + "(variant " + std::to_string(i + 1) + " compact)";
+      ASSERT_EQ(compact->op_count(false), dl->op_count(false)) << desc;
+      ASSERT_LE(compact->bytes(false), dl->bytes(false)) << desc;
+      ASSERT_EQ(compact->bounds(), dl->bounds()) << desc;
+      // Verify that recapturing the compact encoding into a default
+      // builder reproduces exactly the default encoding.
+      DisplayListBuilder builder;
+      compact->Dispatch(builder);
+      sk_sp<DisplayList> copy = builder.Build();
+      ASSERT_EQ(copy->bytes(false), dl->bytes(false)) << desc;
+      ASSERT_TRUE(copy->Equals(*dl)) << desc;
+      ASSERT_TRUE(dl->Equals(*copy)) << desc;
+    }
+  }
+}
+
+TEST(DisplayList, CompactEncodingQuantizesIntegralGeometry) {
+  DisplayListBuilder builder(kTestMaxCullRect, true);
+  builder.translate(10, -20);
+  builder.drawRect(SkRect::MakeLTRB(5, 5, 105, 55));
+  builder.drawOval(SkRect::MakeLTRB(-5, -5, 60000, 10));
+  builder.drawLine({0, 0}, {30, -40});
+  sk_sp<DisplayList> dl = builder.Build();
+  // 8 byte translate + 3 x 12 byte draw ops
+  ASSERT_EQ(dl->bytes(false), sizeof(DisplayList) + 8 + 3 * 12);
+  ASSERT_EQ(dl->op_count(false), 4u);
+
+  DisplayListBuilder expected_builder;
+  expected_builder.translate(10, -20);
+  expected_builder.drawRect(SkRect::MakeLTRB(5, 5, 105, 55));
+  expected_builder.drawOval(SkRect::MakeLTRB(-5, -5, 60000, 10));
+  expected_builder.drawLine({0, 0}, {30, -40});
+  sk_sp<DisplayList> expected = expected_builder.Build();
+  ASSERT_EQ(dl->bounds(), expected->bounds());
+
+  DisplayListBuilder copy_builder;
+  dl->Dispatch(copy_builder);
+  ASSERT_TRUE(copy_builder.Build()->Equals(*expected));
+}
+
+TEST(DisplayList, CompactEncodingKeepsNonIntegralGeometryExact) {
+  DisplayListBuilder builder(kTestMaxCullRect, true);
+  builder.translate(0.5, 20);
+  builder.drawRect(SkRect::MakeLTRB(5, 5, 105.5, 55));
+  builder.drawRect(SkRect::MakeLTRB(-40000, 5, 10, 55));
+  builder.drawLine({-0.0f, 0}, {30, 40});
+  sk_sp<DisplayList> dl = builder.Build();
+  // 12 byte translate + 2 x 20 byte rects + 20 byte line, all packed
+  // to 4 byte boundaries
+  ASSERT_EQ(dl->bytes(false), sizeof(DisplayList) + 12 + 2 * 20 + 20);
+
+  DisplayListBuilder expected_builder;
+  expected_builder.translate(0.5, 20);
+  expected_builder.drawRect(SkRect::MakeLTRB(5, 5, 105.5, 55));
+  expected_builder.drawRect(SkRect::MakeLTRB(-40000, 5, 10, 55));
+  expected_builder.drawLine({-0.0f, 0}, {30, 40});
+  sk_sp<DisplayList> expected = expected_builder.Build();
+
+  DisplayListBuilder copy_builder;
+  dl->Dispatch(copy_builder);
+  ASSERT_TRUE(copy_builder.Build()->Equals(*expected));
+}
+
+TEST(DisplayList, CompactEncodingRealignsPointerOps) {
+  DisplayListBuilder builder(kTestMaxCullRect, true);
+  builder.setColor(SK_ColorRED);
+  builder.drawRect(SkRect::MakeLTRB(5, 5, 105, 55));
+  builder.drawTextBlob(TestBlob1, 10, 10);
+  builder.saveLayer(nullptr, SaveLayerOptions::kNoAttributes,
+                    &kTestCFImageFilter1);
+  builder.drawRect(SkRect::MakeLTRB(5, 5, 10, 10));
+  builder.restore();
+  sk_sp<DisplayList> dl = builder.Build();
+
+  DisplayListBuilder expected_builder;
+  expected_builder.setColor(SK_ColorRED);
+  expected_builder.drawRect(SkRect::MakeLTRB(5, 5, 105, 55));
+  expected_builder.drawTextBlob(TestBlob1, 10, 10);
+  expected_builder.saveLayer(nullptr, SaveLayerOptions::kNoAttributes,
+                             &kTestCFImageFilter1);
+  expected_builder.drawRect(SkRect::MakeLTRB(5, 5, 10, 10));
+  expected_builder.restore();
+  sk_sp<DisplayList> expected = expected_builder.Build();
+
+  ASSERT_LT(dl->bytes(false), expected->bytes(false));
+  ASSERT_EQ(dl->op_count(false), expected->op_count(false));
+  ASSERT_EQ(dl->can_apply_group_opacity(), expected->can_apply_group_opacity());
+
+  DisplayListBuilder copy_builder;
+  dl->Dispatch(copy_builder);
+  ASSERT_TRUE(copy_builder.Build()->Equals(*expected));
+}
+
+TEST(DisplayList, TextureImagesAreTracked) {
+  {
+    // Raster images can be rendered on any thread.
+    DisplayListBuilder builder;
+    builder.drawImage(TestImage1, {10, 10}, kNearestSampling, false);
+    builder.setColorSource(&kTestSource1);
+    builder.drawRect({0, 0, 10, 10});
+    ASSERT_FALSE(builder.Build()->may_have_texture_images());
+  }
+  {
+    DisplayListBuilder builder;
+    builder.drawPicture(TestPicture1, nullptr, false);
+    auto display_list = builder.Build();
+    ASSERT_TRUE(display_list->may_have_texture_images());
+
+    DisplayListBuilder nesting_builder;
+    nesting_builder.drawDisplayList(display_list);
+    ASSERT_TRUE(nesting_builder.Build()->may_have_texture_images());
+  }
+  {
+    DisplayListBuilder builder;
+    builder.setImageFilter(&kTestComposeImageFilter1);
+    builder.drawRect({0, 0, 10, 10});
+    ASSERT_FALSE(builder.Build()->may_have_texture_images());
+  }
+  {
+    // Skia filters might wrap any kind of image.
+    DlUnknownImageFilter unknown_filter(
+        SkImageFilters::Blur(3, 3, SkTileMode::kClamp, nullptr));
+    DisplayListBuilder builder;
+    builder.setImageFilter(&unknown_filter);
+    builder.drawRect({0, 0, 10, 10});
+    ASSERT_TRUE(builder.Build()->may_have_texture_images());
+  }
+}
+
+TEST(DisplayList, RTreeIsOnlyPreparedWhenRequested) {
+  DisplayListBuilder builder(kTestMaxCullRect);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  ASSERT_FALSE(builder.Build()->has_rtree());
+
+  DisplayListBuilder rtree_builder(kTestMaxCullRect, false, true);
+  rtree_builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  sk_sp<DisplayList> dl = rtree_builder.Build();
+  ASSERT_TRUE(dl->has_rtree());
+  ASSERT_EQ(dl->rtree()->leaf_count(), 1);
+  ASSERT_EQ(dl->bounds(), SkRect::MakeLTRB(10, 10, 20, 20));
+}
+
+TEST(DisplayList, RTreeIsOnlyPreparedAboveMinOpCount) {
+  DisplayListBuilder small_builder(kTestMaxCullRect, false, true);
+  small_builder.set_rtree_min_op_count(3);
+  small_builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  small_builder.drawRect(SkRect::MakeLTRB(30, 10, 40, 20));
+  ASSERT_FALSE(small_builder.Build()->has_rtree());
+
+  DisplayListBuilder builder(kTestMaxCullRect, false, true);
+  builder.set_rtree_min_op_count(3);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  builder.drawRect(SkRect::MakeLTRB(30, 10, 40, 20));
+  builder.drawRect(SkRect::MakeLTRB(50, 10, 60, 20));
+  ASSERT_TRUE(builder.Build()->has_rtree());
+}
+
+TEST(DisplayList, RTreeCulledDispatchSkipsOpsOutsideCullRect) {
+  DisplayListBuilder builder(kTestMaxCullRect, false, true);
+  builder.setColor(SK_ColorRED);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  builder.setColor(SK_ColorBLUE);
+  builder.drawOval(SkRect::MakeLTRB(110, 10, 120, 20));
+  builder.translate(0, 100);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  sk_sp<DisplayList> dl = builder.Build();
+
+  DisplayListBuilder expected_builder;
+  expected_builder.setColor(SK_ColorRED);
+  expected_builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  expected_builder.setColor(SK_ColorBLUE);
+  expected_builder.translate(0, 100);
+  sk_sp<DisplayList> expected = expected_builder.Build();
+
+  DisplayListBuilder culled_builder;
+  dl->Dispatch(culled_builder, SkRect::MakeLTRB(0, 0, 50, 50));
+  ASSERT_TRUE(culled_builder.Build()->Equals(*expected));
+
+  // The rect drawn under the translation is found by its device bounds
+  DisplayListBuilder expected_translated_builder;
+  expected_translated_builder.setColor(SK_ColorRED);
+  expected_translated_builder.setColor(SK_ColorBLUE);
+  expected_translated_builder.translate(0, 100);
+  expected_translated_builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  sk_sp<DisplayList> expected_translated = expected_translated_builder.Build();
+
+  DisplayListBuilder translated_builder;
+  dl->Dispatch(translated_builder, SkRect::MakeLTRB(0, 100, 50, 150));
+  ASSERT_TRUE(translated_builder.Build()->Equals(*expected_translated));
+}
+
+TEST(DisplayList, RTreeCulledDispatchOfCoveringCullRectDispatchesAllOps) {
+  DisplayListBuilder builder(kTestMaxCullRect, false, true);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  builder.drawOval(SkRect::MakeLTRB(110, 10, 120, 20));
+  sk_sp<DisplayList> dl = builder.Build();
+
+  DisplayListBuilder culled_builder;
+  dl->Dispatch(culled_builder, SkRect::MakeLTRB(0, 0, 200, 200));
+  ASSERT_TRUE(culled_builder.Build()->Equals(*dl));
+}
+
+TEST(DisplayList, CulledDispatchWithoutRTreeDispatchesAllOps) {
+  DisplayListBuilder builder(kTestMaxCullRect);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  builder.drawOval(SkRect::MakeLTRB(110, 10, 120, 20));
+  sk_sp<DisplayList> dl = builder.Build();
+
+  DisplayListBuilder culled_builder;
+  dl->Dispatch(culled_builder, SkRect::MakeLTRB(0, 0, 50, 50));
+  ASSERT_TRUE(culled_builder.Build()->Equals(*dl));
+}
+
+TEST(DisplayList, RTreeCulledDispatchIncludesOpsSpreadByLayerFilter) {
+  DlBlurImageFilter blur(5.0, 5.0, DlTileMode::kDecal);
+  DisplayListBuilder builder(kTestMaxCullRect, false, true);
+  builder.setImageFilter(&blur);
+  builder.saveLayer(nullptr, true);
+  builder.setImageFilter(nullptr);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  builder.restore();
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  sk_sp<DisplayList> dl = builder.Build();
+
+  // The blur spreads the first rect into the cull rect, but the second
+  // rect is unfiltered and does not reach it.
+  DisplayListBuilder expected_builder;
+  expected_builder.setImageFilter(&blur);
+  expected_builder.saveLayer(nullptr, true);
+  expected_builder.setImageFilter(nullptr);
+  expected_builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  expected_builder.restore();
+  sk_sp<DisplayList> expected = expected_builder.Build();
+
+  DisplayListBuilder culled_builder;
+  dl->Dispatch(culled_builder, SkRect::MakeLTRB(22, 22, 30, 30));
+  ASSERT_TRUE(culled_builder.Build()->Equals(*expected));
+}
+
+TEST(DisplayList, RTreeCulledDispatchIncludesUnboundedOps) {
+  DisplayListBuilder builder(SkRect::MakeLTRB(0, 0, 100, 100), false, true);
+  builder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20));
+  builder.drawPaint();
+  sk_sp<DisplayList> dl = builder.Build();
+
+  DisplayListBuilder expected_builder;
+  expected_builder.drawPaint();
+  sk_sp<DisplayList> expected = expected_builder.Build();
+
+  DisplayListBuilder culled_builder;
+  dl->Dispatch(culled_builder, SkRect::MakeLTRB(50, 50, 60, 60));
+  ASSERT_TRUE(culled_builder.Build()->Equals(*expected));
+}
+
+static sk_sp<DisplayList> BuildRunTestList(int count, int insert_at = -1) {
+  DisplayListBuilder builder;
+  for (int i = 0; i < count; i++) {
+    if (i == insert_at) {
+      builder.drawCircle(SkPoint::Make(500, 500), 20);
+    }
+    builder.setColor(0xFF000000 | ((i + 1) * 0x010203));
+    builder.drawRect(SkRect::MakeXYWH(i * 3, i * 2, 10 + i % 7, 10 + i % 5));
+  }
+  return builder.Build();
+}
+
+TEST(DisplayList, OpRunsCoverAllOps) {
+  sk_sp<DisplayList> dl = BuildRunTestList(200);
+  const std::vector<DlOpRun>& runs = dl->op_runs();
+  ASSERT_GT(runs.size(), 1u);
+  size_t offset = 0;
+  uint32_t op_index = 0;
+  for (const DlOpRun& run : runs) {
+    ASSERT_EQ(run.offset, offset);
+    ASSERT_EQ(run.op_index, op_index);
+    ASSERT_GT(run.op_count, 0u);
+    offset += run.byte_count;
+    op_index += run.op_count;
+  }
+  ASSERT_EQ(offset, dl->bytes(false) - sizeof(DisplayList));
+  ASSERT_EQ(op_index, 400u);
+}
+
+TEST(DisplayList, OpRunsOfEqualListsMatch) {
+  sk_sp<DisplayList> dl1 = BuildRunTestList(200);
+  sk_sp<DisplayList> dl2 = BuildRunTestList(200);
+  ASSERT_EQ(dl1->op_runs().size(), dl2->op_runs().size());
+  for (size_t i = 0; i < dl1->op_runs().size(); i++) {
+    ASSERT_EQ(dl1->op_runs()[i].hash, dl2->op_runs()[i].hash);
+  }
+  DlReuseStats stats = dl2->ComputeReuse(*dl1);
+  ASSERT_TRUE(stats.all_reused());
+  ASSERT_TRUE(stats.identical);
+  ASSERT_EQ(stats.reused_byte_count, stats.byte_count);
+  ASSERT_EQ(stats.reused_op_count, 400u);
+}
+
+TEST(DisplayList, ComputeReuseFindsRunsAroundInsertedOp) {
+  sk_sp<DisplayList> dl1 = BuildRunTestList(200);
+  sk_sp<DisplayList> dl2 = BuildRunTestList(200, 100);
+  DlReuseStats stats = dl2->ComputeReuse(*dl1);
+  ASSERT_FALSE(stats.all_reused());
+  ASSERT_FALSE(stats.identical);
+  ASSERT_GT(stats.reused_run_count, 0u);
+  ASSERT_GT(stats.reused_fraction(), 0.75);
+  ASSERT_LT(stats.reused_byte_count, stats.byte_count);
+  ASSERT_EQ(stats.op_count, 401u);
+}
+
+TEST(DisplayList, ComputeReuseOfAppendedOpIsNotIdentical) {
+  sk_sp<DisplayList> previous = BuildRunTestList(50);
+
+  DisplayListBuilder builder;
+  for (int i = 0; i < 50; i++) {
+    builder.setColor(0xFF000000 | ((i + 1) * 0x010203));
+    builder.drawRect(SkRect::MakeXYWH(i * 3, i * 2, 10 + i % 7, 10 + i % 5));
+  }
+  builder.drawCircle(SkPoint::Make(500, 500), 20);
+  sk_sp<DisplayList> dl = builder.Build();
+  DlReuseStats stats = dl->ComputeReuse(*previous);
+  ASSERT_FALSE(stats.identical);
+  ASSERT_FALSE(stats.all_reused());
+  ASSERT_GT(stats.reused_byte_count, 0u);
+  ASSERT_FALSE(dl->Equals(previous));
+}
+
 TEST(DisplayList, FullRotationsAreNop) {
   DisplayListBuilder builder;
   builder.rotate(0);
@@ -259,8 +259,10 @@ void ClipBoundsDispatchHelper::reset(const SkRect* cull_rect) {
 }
 
 DisplayListBoundsCalculator::DisplayListBoundsCalculator(
-    const SkRect* cull_rect)
-    : ClipBoundsDispatchHelper(cull_rect) {
+    const SkRect* cull_rect,
+    bool record_op_bounds)
+    : ClipBoundsDispatchHelper(cull_rect),
+      record_op_bounds_(record_op_bounds) {
   layer_infos_.emplace_back(std::make_unique<LayerData>(nullptr));
   accumulator_ = layer_infos_.back()->layer_accumulator();
 }
@@ -325,11 +327,11 @@ void DisplayListBoundsCalculator::saveLayer(const SkRect* bounds,
       AccumulateUnbounded();
     }
 
-    layer_infos_.emplace_back(
-        std::make_unique<LayerData>(accumulator_, image_filter_));
+    layer_infos_.emplace_back(std::make_unique<LayerData>(
+        accumulator_, image_filter_, op_rects_.size()));
   } else {
     layer_infos_.emplace_back(
-        std::make_unique<LayerData>(accumulator_, nullptr));
+        std::make_unique<LayerData>(accumulator_, nullptr, op_rects_.size()));
   }
 
   accumulator_ = layer_infos_.back()->layer_accumulator();
@@ -373,6 +375,7 @@ void DisplayListBoundsCalculator::restore() {
         if (has_clip() && !layer_bounds.intersect(clip_bounds())) {
           layer_bounds.setEmpty();
         }
+        FilterOpBounds(layer_info->op_bounds_start(), filter.get());
       } else {
         // If the filter cannot compute bounds then it might take an
         // unbounded amount of space. This can sometimes happen if it
@@ -380,6 +383,7 @@ void DisplayListBoundsCalculator::restore() {
         // be bounded by the transparent pixels outside of the layer
         // drawable.
         is_unbounded = true;
+        FilterOpBounds(layer_info->op_bounds_start(), nullptr);
       }
     }
 
@@ -656,8 +660,10 @@ bool DisplayListBoundsCalculator::AdjustBoundsForPaint(
 void DisplayListBoundsCalculator::AccumulateUnbounded() {
   if (has_clip()) {
     accumulator_->accumulate(clip_bounds());
+    RecordOpBounds(clip_bounds());
   } else {
     layer_infos_.back()->set_unbounded();
+    RecordOpBounds(kUnboundedOpBounds);
   }
 }
 void DisplayListBoundsCalculator::AccumulateOpBounds(
@@ -673,9 +679,33 @@ void DisplayListBoundsCalculator::AccumulateBounds(SkRect& bounds) {
   matrix().mapRect(&bounds);
   if (!has_clip() || bounds.intersect(clip_bounds())) {
     accumulator_->accumulate(bounds);
+    RecordOpBounds(bounds);
+  }
+}
+void DisplayListBoundsCalculator::FilterOpBounds(size_t start,
+                                                 const DlImageFilter* filter) {
+  for (size_t i = start; i < op_rects_.size(); i++) {
+    SkRect& op_bounds = op_rects_[i];
+    SkIRect filter_bounds;
+    if (filter && filter->map_device_bounds(op_bounds.roundOut(), matrix(),
+                                            filter_bounds)) {
+      op_bounds.set(filter_bounds);
+      if (has_clip() && !op_bounds.intersect(clip_bounds())) {
+        op_bounds.setEmpty();
+      }
+    } else {
+      op_bounds = has_clip() ? clip_bounds() : kUnboundedOpBounds;
+    }
   }
 }
 
+sk_sp<DlRTree> DisplayListBoundsCalculator::BuildRTree() const {
+  FML_DCHECK(record_op_bounds_);
+  FML_DCHECK(op_rects_.size() == op_indices_.size());
+  return sk_make_sp<DlRTree>(op_rects_.data(), op_indices_.data(),
+                             static_cast<int>(op_rects_.size()));
+}
+
 bool DisplayListBoundsCalculator::paint_nops_on_transparency() {
   // SkImageFilter::canComputeFastBounds tests for transparency behavior
   // This test assumes that the blend mode checked down below will
@@ -10,6 +10,7 @@
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_blend_mode.h"
 #include "flutter/display_list/display_list_builder.h"
+#include "flutter/display_list/display_list_rtree.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkMaskFilter.h"
@@ -394,7 +395,17 @@ class DisplayListBoundsCalculator final
   // queried using |isUnbounded| if an alternate plan is available
   // for such cases.
   // The flag should never be set if a cull_rect is provided.
-  explicit DisplayListBoundsCalculator(const SkRect* cull_rect = nullptr);
+  //
+  // If |record_op_bounds| is true then the Calculator will also record
+  // the device bounds of each individual rendering operation, tagged
+  // with the index most recently supplied to |set_op_index|, so that
+  // they can be organized into an R-Tree using |BuildRTree|.
+  explicit DisplayListBoundsCalculator(const SkRect* cull_rect = nullptr,
+                                       bool record_op_bounds = false);
+
+  // Sets the index of the operation currently being dispatched so that
+  // it can be associated with any op bounds that it records.
+  void set_op_index(int op_index) { op_index_ = op_index; }
 
   void setStrokeCap(DlStrokeCap cap) override;
   void setStrokeJoin(DlStrokeJoin join) override;
@@ -497,6 +508,17 @@ class DisplayListBoundsCalculator final
     return accumulator_->bounds();
   }
 
+  // Returns an R-Tree of the bounds of all of the rendering operations
+  // that were recorded by a Calculator constructed with |record_op_bounds|
+  // set to true. Should only be called after the stream is fully
+  // dispatched.
+  //
+  // The recorded bounds are conservative. The ops rendered inside of a
+  // saveLayer with an ImageFilter are expanded by the filter and any op
+  // that could not compute its bounds is recorded with the bounds of the
+  // clip in effect, or an unlimited rect if there was no clip.
+  sk_sp<DlRTree> BuildRTree() const;
+
  private:
   // current accumulator based on saveLayer history
   BoundsAccumulator* accumulator_;
@@ -517,9 +539,16 @@ class DisplayListBoundsCalculator final
     // Some saveLayer calls will process their bounds by a
     // |DlImageFilter| when they are restored, but for most
     // saveLayer (and all save) calls the filter will be null.
+    // The |op_bounds_start| parameter is the number of op bounds that
+    // had been recorded before this layer was pushed so that the op
+    // bounds recorded within the layer can be adjusted by the filter.
     explicit LayerData(BoundsAccumulator* outer,
-                       std::shared_ptr<DlImageFilter> filter = nullptr)
-        : outer_(outer), filter_(filter), is_unbounded_(false) {}
+                       std::shared_ptr<DlImageFilter> filter = nullptr,
+                       size_t op_bounds_start = 0)
+        : outer_(outer),
+          filter_(filter),
+          op_bounds_start_(op_bounds_start),
+          is_unbounded_(false) {}
     ~LayerData() = default;
 
     // The accumulator to use while this layer is put in play by
@@ -533,6 +562,9 @@ class DisplayListBoundsCalculator final
     // The filter to apply to the layer bounds when it is restored
     std::shared_ptr<DlImageFilter> filter() { return filter_; }
 
+    // The index of the first op bounds recorded within this layer
+    size_t op_bounds_start() const { return op_bounds_start_; }
+
     // is_unbounded should be set to true if we ever encounter an operation
     // on a layer that either is unrestricted (|drawColor| or |drawPaint|)
     // or cannot compute its bounds (some effects and filters) and there
@@ -567,6 +599,7 @@ class DisplayListBoundsCalculator final
     BoundsAccumulator layer_accumulator_;
     BoundsAccumulator* outer_;
     std::shared_ptr<DlImageFilter> filter_;
+    size_t op_bounds_start_;
     bool is_unbounded_;
 
     FML_DISALLOW_COPY_AND_ASSIGN(LayerData);
@@ -574,6 +607,16 @@ class DisplayListBoundsCalculator final
 
   std::vector<std::unique_ptr<LayerData>> layer_infos_;
 
+  // The bounds recorded for ops that could not compute their bounds
+  // and which had no clip to contain them.
+  static constexpr SkRect kUnboundedOpBounds =
+      SkRect::MakeLTRB(-1E9F, -1E9F, 1E9F, 1E9F);
+
+  const bool record_op_bounds_;
+  int op_index_ = 0;
+  std::vector<SkRect> op_rects_;
+  std::vector<int> op_indices_;
+
   static constexpr SkScalar kMinStrokeWidth = 0.01;
 
   std::optional<DlBlendMode> blend_mode_ = DlBlendMode::kSrcOver;
@@ -617,6 +660,19 @@ class DisplayListBoundsCalculator final
   // Records the given bounds after transforming by the current matrix
   // and clipping against the current clip.
   void AccumulateBounds(SkRect& bounds);
+
+  // Records the final device bounds of the current op if the Calculator
+  // is recording op bounds.
+  void RecordOpBounds(const SkRect& device_bounds) {
+    if (record_op_bounds_) {
+      op_rects_.push_back(device_bounds);
+      op_indices_.push_back(op_index_);
+    }
+  }
+
+  // Adjusts the op bounds recorded since |start| for the filter of a
+  // saveLayer that is being restored.
+  void FilterOpBounds(size_t start, const DlImageFilter* filter);
 };
 
 }  // namespace flutter
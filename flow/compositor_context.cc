@@ -7,6 +7,7 @@
 #include <optional>
 #include "flutter/flow/layers/layer_tree.h"
 #include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPath.h"
 
 namespace flutter {
 
@@ -45,6 +46,22 @@ std::optional<SkRect> FrameDamage::ComputeClipRect(
   }
 }
 
+void FrameDamage::ClipCanvas(SkCanvas* canvas) const {
+  if (!damage_) {
+    return;
+  }
+  const auto& rects = damage_->buffer_damage_rects;
+  if (rects.size() < 2) {
+    canvas->clipRect(SkRect::Make(damage_->buffer_damage));
+    return;
+  }
+  SkPath path;
+  for (const auto& rect : rects) {
+    path.addRect(SkRect::Make(rect));
+  }
+  canvas->clipPath(path);
+}
+
 CompositorContext::CompositorContext()
     : raster_time_(fixed_refresh_rate_updater_),
       ui_time_(fixed_refresh_rate_updater_) {}
@@ -140,7 +157,7 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   // paints some raster cache.
   if (canvas()) {
     if (clip_rect) {
-      canvas()->clipRect(*clip_rect);
+      frame_damage->ClipCanvas(canvas());
     }
 
     if (needs_save_layer) {
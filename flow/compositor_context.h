@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "flutter/common/graphics/texture.h"
 #include "flutter/flow/diff_context.h"
@@ -67,7 +68,7 @@ class FrameDamage {
   // Adds additional damage (accumulated for double / triple buffering).
   // This is area that will be repainted alongside any changed part.
   void AddAdditonalDamage(const SkIRect& damage) {
-    additional_damage_.join(damage);
+    additional_damage_.push_back(damage);
   }
 
   // Specifies clip rect alignment.
@@ -93,8 +94,25 @@ class FrameDamage {
     return damage_ ? std::make_optional(damage_->buffer_damage) : std::nullopt;
   }
 
+  // See Damage::frame_damage_rects.
+  std::optional<std::vector<SkIRect>> GetFrameDamageRects() const {
+    return damage_ ? std::make_optional(damage_->frame_damage_rects)
+                   : std::nullopt;
+  }
+
+  // See Damage::buffer_damage_rects.
+  std::optional<std::vector<SkIRect>> GetBufferDamageRects() const {
+    return damage_ ? std::make_optional(damage_->buffer_damage_rects)
+                   : std::nullopt;
+  }
+
+  // Clips |canvas| to the buffer damage computed by |ComputeClipRect|. Each
+  // rect is clipped to on its own, so the area between rects that are far
+  // apart is left untouched.
+  void ClipCanvas(SkCanvas* canvas) const;
+
  private:
-  SkIRect additional_damage_ = SkIRect::MakeEmpty();
+  std::vector<SkIRect> additional_damage_;
   std::optional<Damage> damage_;
   const LayerTree* prev_layer_tree_ = nullptr;
   int vertical_clip_alignment_ = 1;
@@ -3,19 +3,223 @@
 // found in the LICENSE file.
 
 #include "flutter/flow/diff_context.h"
+
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
 #include "flutter/flow/layers/layer.h"
 
 namespace flutter {
 
+namespace {
+
+// The most rects damage is split into. Past that, the two rects whose union
+// adds the least area are merged.
+constexpr size_t kMaxDamageRects = 8;
+
+// The most tables and rect vectors kept around for reuse.
+constexpr size_t kMaxPooledObjects = 4;
+
+double Area(const SkRect& rect) {
+  return static_cast<double>(rect.width()) * rect.height();
+}
+
+double Area(const SkIRect& rect) {
+  return static_cast<double>(rect.width()) * rect.height();
+}
+
+// Adds |rect| to |rects|, merging it with the rects that it overlaps enough
+// that their union is not larger than the two of them.
+template <typename Rect>
+void AddDamageRect(std::vector<Rect>& rects, Rect rect) {
+  if (rect.isEmpty()) {
+    return;
+  }
+  for (size_t i = 0; i < rects.size();) {
+    Rect joined = rect;
+    joined.join(rects[i]);
+    if (Area(joined) <= Area(rect) + Area(rects[i])) {
+      // The union may now absorb rects that were checked already.
+      rect = joined;
+      rects.erase(rects.begin() + i);
+      i = 0;
+    } else {
+      ++i;
+    }
+  }
+  rects.push_back(rect);
+
+  if (rects.size() > kMaxDamageRects) {
+    size_t merge_a = 0;
+    size_t merge_b = 1;
+    double least_waste = std::numeric_limits<double>::max();
+    for (size_t a = 0; a < rects.size(); ++a) {
+      for (size_t b = a + 1; b < rects.size(); ++b) {
+        Rect joined = rects[a];
+        joined.join(rects[b]);
+        double waste = Area(joined) - Area(rects[a]) - Area(rects[b]);
+        if (waste < least_waste) {
+          least_waste = waste;
+          merge_a = a;
+          merge_b = b;
+        }
+      }
+    }
+    rects[merge_a].join(rects[merge_b]);
+    rects.erase(rects.begin() + merge_b);
+  }
+}
+
+}  // namespace
+
+struct PaintRegionMap::Table {
+  std::unordered_map<uint64_t, PaintRegion> regions;
+
+  // The table of the previous layer tree, for the layers that are not in
+  // |regions|.
+  std::shared_ptr<const Table> fallback;
+
+  // The number of tables in the chain of fallbacks.
+  size_t depth = 0;
+};
+
+// Keeps the tables and rect vectors of the layer trees that were released,
+// so that their allocations can be reused by the next frames. Layer trees
+// may be released on other threads than the one diffing them.
+class PaintRegionMap::Pool : public std::enable_shared_from_this<Pool> {
+ public:
+  std::shared_ptr<Table> AcquireTable() {
+    std::unique_ptr<Table> table;
+    {
+      std::scoped_lock lock(mutex_);
+      if (!tables_.empty()) {
+        table = std::move(tables_.back());
+        tables_.pop_back();
+      }
+    }
+    if (!table) {
+      table = std::make_unique<Table>();
+    }
+    std::weak_ptr<Pool> weak_pool = weak_from_this();
+    return std::shared_ptr<Table>(table.release(), [weak_pool](Table* table) {
+      // Releasing the regions and the fallback may release other tables and
+      // rects to the pool, so do it before taking the lock.
+      table->regions.clear();
+      table->fallback.reset();
+      table->depth = 0;
+      if (auto pool = weak_pool.lock()) {
+        std::scoped_lock lock(pool->mutex_);
+        if (pool->tables_.size() < kMaxPooledObjects) {
+          pool->tables_.emplace_back(table);
+          return;
+        }
+      }
+      delete table;
+    });
+  }
+
+  std::shared_ptr<std::vector<SkRect>> AcquireRects() {
+    std::unique_ptr<std::vector<SkRect>> rects;
+    {
+      std::scoped_lock lock(mutex_);
+      if (!rects_.empty()) {
+        rects = std::move(rects_.back());
+        rects_.pop_back();
+      }
+    }
+    if (!rects) {
+      rects = std::make_unique<std::vector<SkRect>>();
+    }
+    std::weak_ptr<Pool> weak_pool = weak_from_this();
+    return std::shared_ptr<std::vector<SkRect>>(
+        rects.release(), [weak_pool](std::vector<SkRect>* rects) {
+          rects->clear();
+          if (auto pool = weak_pool.lock()) {
+            std::scoped_lock lock(pool->mutex_);
+            if (pool->rects_.size() < kMaxPooledObjects) {
+              pool->rects_.emplace_back(rects);
+              return;
+            }
+          }
+          delete rects;
+        });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Table>> tables_;
+  std::vector<std::unique_ptr<std::vector<SkRect>>> rects_;
+};
+
+PaintRegionMap::PaintRegionMap() = default;
+
+PaintRegionMap::~PaintRegionMap() = default;
+
+PaintRegion PaintRegionMap::Find(uint64_t unique_id) const {
+  for (const Table* table = table_.get(); table;
+       table = table->fallback.get()) {
+    auto i = table->regions.find(unique_id);
+    if (i != table->regions.end()) {
+      return i->second;
+    }
+  }
+  return PaintRegion();
+}
+
+void PaintRegionMap::Set(uint64_t unique_id, const PaintRegion& region) {
+  if (!table_) {
+    if (!pool_) {
+      pool_ = std::make_shared<Pool>();
+    }
+    table_ = pool_->AcquireTable();
+  }
+  table_->regions[unique_id] = region;
+}
+
+size_t PaintRegionMap::size() const {
+  return table_ ? table_->regions.size() : 0;
+}
+
+bool PaintRegionMap::Reset(const PaintRegionMap& previous) {
+  if (&previous == this) {
+    // The layer tree is diffed against itself, so every paint region that is
+    // set is the one that is already there.
+    return table_ != nullptr;
+  }
+  if (previous.pool_) {
+    pool_ = previous.pool_;
+  } else if (!pool_) {
+    pool_ = std::make_shared<Pool>();
+  }
+  table_ = pool_->AcquireTable();
+  if (previous.table_ && previous.table_->depth < kMaxFallbackDepth) {
+    table_->fallback = previous.table_;
+    table_->depth = previous.table_->depth + 1;
+    return true;
+  }
+  return false;
+}
+
+std::shared_ptr<std::vector<SkRect>> PaintRegionMap::AcquireRects() {
+  if (!pool_) {
+    pool_ = std::make_shared<Pool>();
+  }
+  return pool_->AcquireRects();
+}
+
 DiffContext::DiffContext(SkISize frame_size,
                          double frame_device_pixel_ratio,
                          PaintRegionMap& this_frame_paint_region_map,
                          const PaintRegionMap& last_frame_paint_region_map)
-    : rects_(std::make_shared<std::vector<SkRect>>()),
-      frame_size_(frame_size),
+    : frame_size_(frame_size),
       frame_device_pixel_ratio_(frame_device_pixel_ratio),
       this_frame_paint_region_map_(this_frame_paint_region_map),
-      last_frame_paint_region_map_(last_frame_paint_region_map) {}
+      last_frame_paint_region_map_(last_frame_paint_region_map),
+      skip_retained_subtrees_(this_frame_paint_region_map_.Reset(
+          last_frame_paint_region_map_)) {
+  rects_ = this_frame_paint_region_map_.AcquireRects();
+}
 
 void DiffContext::BeginSubtree() {
   state_stack_.push_back(state_);
@@ -94,17 +298,36 @@ void DiffContext::AlignRect(SkIRect& rect,
 Damage DiffContext::ComputeDamage(const SkIRect& accumulated_buffer_damage,
                                   int horizontal_clip_alignment,
                                   int vertical_clip_alignment) const {
-  SkRect buffer_damage = SkRect::Make(accumulated_buffer_damage);
-  buffer_damage.join(damage_);
-  SkRect frame_damage(damage_);
+  return ComputeDamage(std::vector<SkIRect>{accumulated_buffer_damage},
+                       horizontal_clip_alignment, vertical_clip_alignment);
+}
+
+Damage DiffContext::ComputeDamage(
+    const std::vector<SkIRect>& accumulated_buffer_damage,
+    int horizontal_clip_alignment,
+    int vertical_clip_alignment) const {
+  SkRect damage = SkRect::MakeEmpty();
+  for (const auto& r : damage_) {
+    damage.join(r);
+  }
+  SkRect buffer_damage(damage);
+  std::vector<SkRect> buffer_damage_rects(damage_);
+  for (const auto& r : accumulated_buffer_damage) {
+    buffer_damage.join(SkRect::Make(r));
+    AddDamageRect(buffer_damage_rects, SkRect::Make(r));
+  }
+  SkRect frame_damage(damage);
+  std::vector<SkRect> frame_damage_rects(damage_);
 
   for (const auto& r : readbacks_) {
     SkRect rect = SkRect::Make(r.rect);
     if (rect.intersects(frame_damage)) {
       frame_damage.join(rect);
+      AddDamageRect(frame_damage_rects, rect);
     }
     if (rect.intersects(buffer_damage)) {
       buffer_damage.join(rect);
+      AddDamageRect(buffer_damage_rects, rect);
     }
   }
 
@@ -116,12 +339,30 @@ Damage DiffContext::ComputeDamage(const SkIRect& accumulated_buffer_damage,
   res.buffer_damage.intersect(frame_clip);
   res.frame_damage.intersect(frame_clip);
 
-  if (horizontal_clip_alignment > 1 || vertical_clip_alignment > 1) {
+  bool align = horizontal_clip_alignment > 1 || vertical_clip_alignment > 1;
+  if (align) {
     AlignRect(res.buffer_damage, horizontal_clip_alignment,
               vertical_clip_alignment);
     AlignRect(res.frame_damage, horizontal_clip_alignment,
               vertical_clip_alignment);
   }
+
+  auto finish_rects = [&](const std::vector<SkRect>& rects,
+                          std::vector<SkIRect>& result) {
+    for (const auto& r : rects) {
+      SkIRect rect = r.roundOut();
+      if (!rect.intersect(frame_clip)) {
+        continue;
+      }
+      if (align) {
+        AlignRect(rect, horizontal_clip_alignment, vertical_clip_alignment);
+      }
+      // Aligned rects may overlap, so they are merged again.
+      AddDamageRect(result, rect);
+    }
+  };
+  finish_rects(frame_damage_rects, res.frame_damage_rects);
+  finish_rects(buffer_damage_rects, res.buffer_damage_rects);
   return res;
 }
 
@@ -193,6 +434,19 @@ void DiffContext::AddExistingPaintRegion(const PaintRegion& region) {
   }
 }
 
+void DiffContext::PreserveRetainedLayerPaintRegion(
+    Layer* layer,
+    const PaintRegion& region) {
+  statistics_.AddRetainedSubtree();
+  if (skip_retained_subtrees_) {
+    // The paint regions of the layers inside of the subtree are found
+    // through the map of the previous frame.
+    SetLayerPaintRegion(layer, region);
+  } else {
+    layer->PreservePaintRegion(this);
+  }
+}
+
 void DiffContext::AddReadbackRegion(const SkIRect& rect) {
   Readback readback;
   readback.rect = rect;
@@ -213,28 +467,23 @@ PaintRegion DiffContext::CurrentSubtreeRegion() const {
 void DiffContext::AddDamage(const PaintRegion& damage) {
   FML_DCHECK(damage.is_valid());
   for (const auto& r : damage) {
-    damage_.join(r);
+    AddDamageRect(damage_, r);
   }
 }
 
 void DiffContext::AddDamage(const SkRect& rect) {
-  damage_.join(rect);
+  AddDamageRect(damage_, rect);
 }
 
 void DiffContext::SetLayerPaintRegion(const Layer* layer,
                                       const PaintRegion& region) {
-  this_frame_paint_region_map_[layer->unique_id()] = region;
+  this_frame_paint_region_map_.Set(layer->unique_id(), region);
 }
 
 PaintRegion DiffContext::GetOldLayerPaintRegion(const Layer* layer) const {
-  auto i = last_frame_paint_region_map_.find(layer->unique_id());
-  if (i != last_frame_paint_region_map_.end()) {
-    return i->second;
-  } else {
-    // This is valid when Layer::PreservePaintRegion is called for retained
-    // layer with zero sized parent clip (these layers are not diffed)
-    return PaintRegion();
-  }
+  // The region is not valid when Layer::PreservePaintRegion is called for
+  // retained layer with zero sized parent clip (these layers are not diffed)
+  return last_frame_paint_region_map_.Find(layer->unique_id());
 }
 
 void DiffContext::Statistics::LogStatistics() {
@@ -245,7 +494,10 @@ void DiffContext::Statistics::LogStatistics() {
                     deep_compare_pictures_, "SameInstancePictures",
                     same_instance_pictures_,
                     "DifferentInstanceButEqualPictures",
-                    different_instance_but_equal_pictures_);
+                    different_instance_but_equal_pictures_,
+                    "PartiallyReusedPictures", partially_reused_pictures_,
+                    "ReusedPictureBytes", reused_picture_bytes_,
+                    "RetainedSubtrees", retained_subtrees_);
 #endif  // !FLUTTER_RELEASE
 }
 
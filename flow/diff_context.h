@@ -6,7 +6,7 @@
 #define FLUTTER_FLOW_DIFF_CONTEXT_H_
 
 #include <functional>
-#include <map>
+#include <memory>
 #include <optional>
 #include <vector>
 #include "flutter/flow/paint_region.h"
@@ -34,10 +34,68 @@ struct Damage {
   // upfront may be useful for tile based GPUs.
   // Corresponds to "buffer damage" from EGL_KHR_partial_update.
   SkIRect buffer_damage;
+
+  // frame_damage split into a small set of rects, so that changes that are
+  // far apart do not have to repaint everything in between. frame_damage is
+  // the bounds of these rects.
+  std::vector<SkIRect> frame_damage_rects;
+
+  // buffer_damage split into a small set of rects. buffer_damage is the
+  // bounds of these rects.
+  std::vector<SkIRect> buffer_damage_rects;
 };
 
 // Layer Unique Id to PaintRegion
-using PaintRegionMap = std::map<uint64_t, PaintRegion>;
+//
+// A map only holds the paint regions of the layers that were diffed in its
+// layer tree, and of the retained layers that were skipped. Looking up any
+// other layer falls back to the map of the previous layer tree, which is
+// what lets the layers inside of a retained subtree be skipped without being
+// visited. The chain of fallbacks is kept short: once it reaches
+// kMaxFallbackDepth, the next diff preserves the paint region of every layer
+// of the retained subtrees again.
+//
+// The tables and the rects of the paint regions are recycled across frames.
+class PaintRegionMap {
+ public:
+  static constexpr size_t kMaxFallbackDepth = 8;
+
+  PaintRegionMap();
+
+  ~PaintRegionMap();
+
+  PaintRegionMap(PaintRegionMap&& other) = default;
+
+  PaintRegionMap& operator=(PaintRegionMap&& other) = default;
+
+  // Returns the paint region of the layer with |unique_id|, or an invalid
+  // paint region if there is none.
+  PaintRegion Find(uint64_t unique_id) const;
+
+  void Set(uint64_t unique_id, const PaintRegion& region);
+
+  // The number of paint regions held by this map itself, not counting the
+  // ones found through the map it falls back to.
+  size_t size() const;
+
+ private:
+  friend class DiffContext;
+
+  struct Table;
+  class Pool;
+
+  // Drops the paint regions of this map to start a diff against the layer
+  // tree of |previous|. Returns whether the map falls back to |previous|, in
+  // which case the layers of retained subtrees don't need to be visited.
+  bool Reset(const PaintRegionMap& previous);
+
+  std::shared_ptr<std::vector<SkRect>> AcquireRects();
+
+  std::shared_ptr<Pool> pool_;
+  std::shared_ptr<Table> table_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PaintRegionMap);
+};
 
 // Tracks state during tree diffing process and computes resulting damage
 class DiffContext {
@@ -117,6 +175,13 @@ class DiffContext {
   // or clips may result in different paint region.
   void AddExistingPaintRegion(const PaintRegion& region);
 
+  // Associates |region|, the paint region of a retained layer that was not
+  // diffed, with the layer and current layer tree. Unless the paint region
+  // maps have to be compacted, this is O(1): the paint regions of the layers
+  // inside of the retained subtree are found through the previous map.
+  void PreserveRetainedLayerPaintRegion(Layer* layer,
+                                        const PaintRegion& region);
+
   // The idea of readback region is that if any part of the readback region
   // needs to be repainted, then the whole readback region must be repainted;
   //
@@ -140,6 +205,12 @@ class DiffContext {
                        int horizontal_clip_alignment = 0,
                        int vertical_clip_alignment = 0) const;
 
+  // Same as above, with the previously accumulated damage given as a list
+  // of rects so that it does not have to be repainted as a whole.
+  Damage ComputeDamage(const std::vector<SkIRect>& additional_damage,
+                       int horizontal_clip_alignment = 0,
+                       int vertical_clip_alignment = 0) const;
+
   double frame_device_pixel_ratio() const { return frame_device_pixel_ratio_; };
 
   // Adds the region to current damage. Used for removed layers, where instead
@@ -177,6 +248,16 @@ class DiffContext {
       ++different_instance_but_equal_pictures_;
     };
 
+    // Picture that was replaced by a different picture which still shares
+    // |reused_bytes| worth of identical runs of ops with the old picture
+    void AddPartiallyReusedPicture(size_t reused_bytes) {
+      ++partially_reused_pictures_;
+      reused_picture_bytes_ += reused_bytes;
+    }
+
+    // Retained layer whose subtree was not diffed
+    void AddRetainedSubtree() { ++retained_subtrees_; }
+
     // Logs the statistics to trace counter
     void LogStatistics();
 
@@ -186,6 +267,9 @@ class DiffContext {
     int same_instance_pictures_ = 0;
     int deep_compare_pictures_ = 0;
     int different_instance_but_equal_pictures_ = 0;
+    int partially_reused_pictures_ = 0;
+    int64_t reused_picture_bytes_ = 0;
+    int retained_subtrees_ = 0;
   };
 
   Statistics& statistics() { return statistics_; }
@@ -228,11 +312,16 @@ class DiffContext {
   // Rect must be in device coordinates.
   SkRect ApplyFilterBoundsAdjustment(SkRect rect) const;
 
-  SkRect damage_ = SkRect::MakeEmpty();
+  // Damage is kept as a few rects; see Damage::frame_damage_rects.
+  std::vector<SkRect> damage_;
 
   PaintRegionMap& this_frame_paint_region_map_;
   const PaintRegionMap& last_frame_paint_region_map_;
 
+  // Whether |this_frame_paint_region_map_| falls back to
+  // |last_frame_paint_region_map_|.
+  bool skip_retained_subtrees_;
+
   void AddDamage(const SkRect& rect);
 
   void AlignRect(SkIRect& rect,
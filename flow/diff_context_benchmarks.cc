@@ -0,0 +1,121 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/diff_context.h"
+
+#include <memory>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
+#include "flutter/fml/message_loop.h"
+
+namespace flutter {
+namespace {
+
+constexpr int kWidth = 1080;
+constexpr int kHeight = 1920;
+constexpr int kCellSize = 60;
+constexpr int kColumns = kWidth / kCellSize;
+constexpr int kRows = kHeight / kCellSize;
+
+struct LayerTree {
+  std::shared_ptr<ContainerLayer> root = std::make_shared<ContainerLayer>();
+  PaintRegionMap paint_region_map;
+};
+
+std::shared_ptr<DisplayListLayer> CreateCell(
+    int index,
+    SkColor color,
+    const fml::RefPtr<SkiaUnrefQueue>& unref_queue) {
+  SkRect bounds = SkRect::MakeXYWH((index % kColumns) * kCellSize,
+                                   (index / kColumns) * kCellSize,
+                                   kCellSize - 4, kCellSize - 4);
+  DisplayListBuilder builder;
+  builder.setColor(color);
+  builder.drawRect(bounds);
+  return std::make_shared<DisplayListLayer>(
+      SkPoint::Make(0, 0), SkiaGPUObject(builder.Build(), unref_queue), false,
+      false);
+}
+
+Damage Diff(LayerTree& tree, const LayerTree& old_tree) {
+  SkISize size = SkISize::Make(kWidth, kHeight);
+  DiffContext context(size, 1, tree.paint_region_map,
+                      old_tree.paint_region_map);
+  context.PushCullRect(SkRect::Make(size));
+  tree.root->Diff(&context, old_tree.root.get());
+  return context.ComputeDamage(SkIRect::MakeEmpty());
+}
+
+double Area(const SkIRect& rect) {
+  return static_cast<double>(rect.width()) * rect.height();
+}
+
+}  // namespace
+
+// Diffs a grid of cells in which as many cells as the argument changed,
+// spread over the whole frame like the blinking cursors, spinners and
+// counters of a typical screen. The counters compare the pixels that are
+// repainted when the damage is a single rect with those that are repainted
+// when it is split into rects.
+static void BM_DiffScatteredUpdates(benchmark::State& state) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  auto unref_queue = fml::MakeRefCounted<SkiaUnrefQueue>(
+      fml::MessageLoop::GetCurrent().GetTaskRunner(),
+      fml::TimeDelta::FromSeconds(0));
+  const int cell_count = kColumns * kRows;
+  const int changed_count = state.range(0);
+
+  LayerTree empty;
+  LayerTree old_tree;
+  LayerTree tree;
+  std::vector<std::shared_ptr<DisplayListLayer>> cells;
+  for (int i = 0; i < cell_count; i++) {
+    cells.push_back(CreateCell(i, SK_ColorBLUE, unref_queue));
+    old_tree.root->Add(cells.back());
+  }
+  Diff(old_tree, empty);
+
+  // Spread the changed cells evenly, with a stride that is not a multiple of
+  // the row length so that they land in different columns.
+  const int stride = cell_count / changed_count + 1;
+  for (int i = 0; i < cell_count; i++) {
+    bool changed = i % stride == 0;
+    tree.root->Add(changed ? CreateCell(i, SK_ColorRED, unref_queue)
+                           : cells[i]);
+  }
+
+  Damage damage;
+  for ([[maybe_unused]] auto _ : state) {
+    damage = Diff(tree, old_tree);
+  }
+
+  double rect_pixels = 0;
+  for (const auto& rect : damage.frame_damage_rects) {
+    rect_pixels += Area(rect);
+  }
+  double bounds_pixels = Area(damage.frame_damage);
+  state.counters["bounds_pixels"] = bounds_pixels;
+  state.counters["rect_pixels"] = rect_pixels;
+  state.counters["rects"] = damage.frame_damage_rects.size();
+  state.counters["pixel_reduction"] =
+      rect_pixels > 0 ? bounds_pixels / rect_pixels : 1;
+
+  tree = LayerTree();
+  old_tree = LayerTree();
+  cells.clear();
+  unref_queue->Drain();
+}
+
+BENCHMARK(BM_DiffScatteredUpdates)
+    ->ArgName("changed")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Arg(32);
+
+}  // namespace flutter
@@ -32,5 +32,133 @@ TEST_F(DiffContextTest, ClipAlignment) {
   EXPECT_EQ(damage.buffer_damage, SkIRect::MakeLTRB(16, 16, 64, 64));
 }
 
+TEST_F(DiffContextTest, DamageIsSplitIntoRects) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 20, 20), 1)));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(900, 900, 910, 910), 1)));
+  // Overlaps the first rect enough to be merged with it.
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(15, 10, 25, 20), 1)));
+  auto damage = DiffLayerTree(t1, MockLayerTree());
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 910, 910));
+  ASSERT_EQ(damage.frame_damage_rects.size(), 2u);
+  EXPECT_EQ(damage.frame_damage_rects[0], SkIRect::MakeLTRB(10, 10, 25, 20));
+  EXPECT_EQ(damage.frame_damage_rects[1],
+            SkIRect::MakeLTRB(900, 900, 910, 910));
+
+  // Aligned rects that end up overlapping are merged.
+  damage = DiffLayerTree(t1, MockLayerTree(), SkIRect::MakeEmpty(), 64, 64);
+  ASSERT_EQ(damage.frame_damage_rects.size(), 2u);
+  EXPECT_EQ(damage.frame_damage_rects[0], SkIRect::MakeLTRB(0, 0, 64, 64));
+  EXPECT_EQ(damage.frame_damage_rects[1],
+            SkIRect::MakeLTRB(896, 896, 960, 960));
+}
+
+TEST_F(DiffContextTest, DamageRectsAreLimited) {
+  MockLayerTree t1;
+  for (int i = 0; i < 20; i++) {
+    SkScalar offset = i * 40;
+    t1.root()->Add(CreateDisplayListLayer(CreateDisplayList(
+        SkRect::MakeLTRB(offset, offset, offset + 10, offset + 10), 1)));
+  }
+  auto damage = DiffLayerTree(t1, MockLayerTree());
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(0, 0, 770, 770));
+  ASSERT_GT(damage.frame_damage_rects.size(), 1u);
+  ASSERT_LE(damage.frame_damage_rects.size(), 8u);
+  SkIRect bounds = SkIRect::MakeEmpty();
+  for (const auto& rect : damage.frame_damage_rects) {
+    bounds.join(rect);
+  }
+  EXPECT_EQ(bounds, damage.frame_damage);
+}
+
+TEST_F(DiffContextTest, BufferDamageIsSplitIntoRects) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 20, 20), 1)));
+  MockLayerTree empty;
+
+  DiffContext dc(t1.size(), 1, t1.paint_region_map(),
+                 empty.paint_region_map());
+  dc.PushCullRect(SkRect::MakeIWH(t1.size().width(), t1.size().height()));
+  t1.root()->Diff(&dc, empty.root());
+  std::vector<SkIRect> additional_damage = {
+      SkIRect::MakeLTRB(500, 0, 510, 10), SkIRect::MakeLTRB(0, 900, 10, 910)};
+  auto damage = dc.ComputeDamage(additional_damage);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 20, 20));
+  EXPECT_EQ(damage.buffer_damage, SkIRect::MakeLTRB(0, 0, 510, 910));
+  ASSERT_EQ(damage.buffer_damage_rects.size(), 3u);
+  EXPECT_EQ(damage.buffer_damage_rects[0], SkIRect::MakeLTRB(10, 10, 20, 20));
+  EXPECT_EQ(damage.buffer_damage_rects[1], SkIRect::MakeLTRB(500, 0, 510, 10));
+  EXPECT_EQ(damage.buffer_damage_rects[2], SkIRect::MakeLTRB(0, 900, 10, 910));
+}
+
+TEST_F(DiffContextTest, RetainedSubtreeIsNotVisited) {
+  auto layer_1 = CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 20, 20), 1));
+  auto layer_2 = CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(50, 50, 60, 60), 1));
+  auto retained = CreateContainerLayer({layer_1, layer_2});
+
+  MockLayerTree t1;
+  t1.root()->Add(retained);
+  DiffLayerTree(t1, MockLayerTree());
+
+  MockLayerTree t2;
+  t2.root()->Add(retained);
+  auto damage = DiffLayerTree(t2, t1);
+  EXPECT_TRUE(damage.frame_damage.isEmpty());
+  // Only the root and the retained layer have paint regions in t2, the
+  // layers inside of the retained layer are found in t1.
+  EXPECT_EQ(t2.paint_region_map().size(), 2u);
+
+  // A layer that replaces the retained one diffs its children against the
+  // layers that were skipped.
+  MockLayerTree t3;
+  auto replacement = CreateContainerLayer(layer_1);
+  replacement->AssignOldLayer(retained.get());
+  t3.root()->Add(replacement);
+  damage = DiffLayerTree(t3, t2);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(50, 50, 60, 60));
+
+  MockLayerTree t4;
+  damage = DiffLayerTree(t4, t3);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 20, 20));
+}
+
+TEST_F(DiffContextTest, PaintRegionFallbacksAreCompacted) {
+  auto layer_1 = CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 20, 20), 1));
+  auto layer_2 = CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(50, 50, 60, 60), 1));
+  auto retained = CreateContainerLayer({layer_1, layer_2});
+
+  MockLayerTree previous;
+  previous.root()->Add(retained);
+  DiffLayerTree(previous, MockLayerTree());
+
+  size_t compacted_count = 0;
+  for (size_t i = 0; i < 2 * PaintRegionMap::kMaxFallbackDepth + 2; i++) {
+    MockLayerTree tree;
+    tree.root()->Add(retained);
+    auto damage = DiffLayerTree(tree, previous);
+    EXPECT_TRUE(damage.frame_damage.isEmpty());
+    if (tree.paint_region_map().size() == 4u) {
+      // The paint regions of every layer were preserved.
+      compacted_count++;
+    } else {
+      EXPECT_EQ(tree.paint_region_map().size(), 2u);
+    }
+    previous = std::move(tree);
+  }
+  EXPECT_EQ(compacted_count, 2u);
+
+  MockLayerTree empty;
+  auto damage = DiffLayerTree(empty, previous);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 60, 60));
+}
+
 }  // namespace testing
 }  // namespace flutter
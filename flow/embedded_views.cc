@@ -4,6 +4,8 @@
 
 #include "flutter/flow/embedded_views.h"
 
+#include "flutter/flow/layers/layer_pool.h"
+
 namespace flutter {
 
 void ExternalViewEmbedder::SubmitFrame(GrDirectContext* context,
@@ -12,27 +14,27 @@ void ExternalViewEmbedder::SubmitFrame(GrDirectContext* context,
 };
 
 void MutatorsStack::PushClipRect(const SkRect& rect) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(rect);
+  std::shared_ptr<Mutator> element = LayerPool::Make<Mutator>(rect);
   vector_.push_back(element);
 };
 
 void MutatorsStack::PushClipRRect(const SkRRect& rrect) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(rrect);
+  std::shared_ptr<Mutator> element = LayerPool::Make<Mutator>(rrect);
   vector_.push_back(element);
 };
 
 void MutatorsStack::PushClipPath(const SkPath& path) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(path);
+  std::shared_ptr<Mutator> element = LayerPool::Make<Mutator>(path);
   vector_.push_back(element);
 };
 
 void MutatorsStack::PushTransform(const SkMatrix& matrix) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(matrix);
+  std::shared_ptr<Mutator> element = LayerPool::Make<Mutator>(matrix);
   vector_.push_back(element);
 };
 
 void MutatorsStack::PushOpacity(const int& alpha) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(alpha);
+  std::shared_ptr<Mutator> element = LayerPool::Make<Mutator>(alpha);
   vector_.push_back(element);
 };
 
@@ -90,7 +90,7 @@ void ContainerLayer::DiffChildren(DiffContext* context,
         // While we don't need to diff retained layers, we still need to
         // associate their paint region with current layer tree so that we can
         // retrieve it in next frame diff
-        layer->PreservePaintRegion(context);
+        context->PreserveRetainedLayerPaintRegion(layer.get(), paint_region);
       } else {
         layer->Diff(context, prev_layer.get());
       }
@@ -56,6 +56,24 @@ void DisplayListLayer::Diff(DiffContext* context, const Layer* old_layer) {
   context->SetLayerPaintRegion(this, context->CurrentSubtreeRegion());
 }
 
+// Records how much of the old picture survives in the new picture that is
+// replacing it, which is limited to small pictures just like deep compares.
+// This only feeds the timeline statistics, so release builds skip it.
+static void AddPictureReuse(DiffContext::Statistics& statistics,
+                            const DisplayList& new_display_list,
+                            const DisplayList& old_display_list) {
+#if !FLUTTER_RELEASE
+  if (new_display_list.bytes() > DisplayListLayer::kMaxBytesToCompare ||
+      old_display_list.bytes() > DisplayListLayer::kMaxBytesToCompare) {
+    return;
+  }
+  DlReuseStats reuse = new_display_list.ComputeReuse(old_display_list);
+  if (reuse.reused_byte_count > 0) {
+    statistics.AddPartiallyReusedPicture(reuse.reused_byte_count);
+  }
+#endif  // !FLUTTER_RELEASE
+}
+
 bool DisplayListLayer::Compare(DiffContext::Statistics& statistics,
                                const DisplayListLayer* l1,
                                const DisplayListLayer* l2) {
@@ -72,6 +90,7 @@ bool DisplayListLayer::Compare(DiffContext::Statistics& statistics,
   if (op_cnt_1 != op_cnt_2 || op_bytes_1 != op_bytes_2 ||
       dl1->bounds() != dl2->bounds()) {
     statistics.AddNewPicture();
+    AddPictureReuse(statistics, *dl1, *dl2);
     return false;
   }
 
@@ -82,11 +101,23 @@ bool DisplayListLayer::Compare(DiffContext::Statistics& statistics,
 
   statistics.AddDeepComparePicture();
 
+#if !FLUTTER_RELEASE
+  // The reuse walk decides equality as well, so the ops of the two
+  // pictures are only compared once.
+  DlReuseStats reuse = dl1->ComputeReuse(*dl2);
+  auto res = reuse.identical;
+#else
   auto res = dl1->Equals(*dl2);
+#endif  // !FLUTTER_RELEASE
   if (res) {
     statistics.AddDifferentInstanceButEqualPicture();
   } else {
     statistics.AddNewPicture();
+#if !FLUTTER_RELEASE
+    if (reuse.reused_byte_count > 0) {
+      statistics.AddPartiallyReusedPicture(reuse.reused_byte_count);
+    }
+#endif  // !FLUTTER_RELEASE
   }
   return res;
 }
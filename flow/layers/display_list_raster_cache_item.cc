@@ -168,10 +168,7 @@ bool DisplayListRasterCacheItem::TryToPrepareRasterCache(
       .checkerboard       = context.checkerboard_offscreen_layers,
       // clang-format on
   };
-  return context.raster_cache->UpdateCacheEntry(
-      GetId().value(), r_context,
-      [display_list = display_list_](SkCanvas* canvas) {
-        display_list->RenderTo(canvas);
-      });
+  return context.raster_cache->UpdateDisplayListCacheEntry(
+      GetId().value(), r_context, sk_ref_sp(display_list_));
 }
 }  // namespace flutter
@@ -0,0 +1,143 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_pool.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "flutter/fml/thread_local.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr size_t kSizeGranularity = 16;
+constexpr size_t kSizeClassCount =
+    LayerPool::kMaxPooledSize / kSizeGranularity;
+
+struct Node {
+  Node* next;
+};
+
+size_t SizeClass(size_t size) {
+  return (std::max<size_t>(size, 1) + kSizeGranularity - 1) /
+             kSizeGranularity -
+         1;
+}
+
+size_t SizeOfClass(size_t size_class) {
+  return (size_class + 1) * kSizeGranularity;
+}
+
+// The nodes that were freed, on any thread, and that no thread has taken
+// into its own free lists yet.
+std::atomic<Node*> returned_nodes[kSizeClassCount];
+// The size of all of the nodes in the free lists of all threads.
+std::atomic<size_t> pooled_bytes;
+std::atomic<size_t> heap_allocation_count;
+std::atomic<size_t> reuse_count;
+
+void DeleteNodes(Node* node, size_t size_class) {
+  while (node != nullptr) {
+    Node* next = node->next;
+    ::operator delete(node);
+    pooled_bytes.fetch_sub(SizeOfClass(size_class), std::memory_order_relaxed);
+    node = next;
+  }
+}
+
+// The free lists that only the thread that owns them allocates from.
+struct ThreadCache {
+  Node* free_nodes[kSizeClassCount] = {};
+
+  ~ThreadCache() { Clear(); }
+
+  void Clear() {
+    for (size_t i = 0; i < kSizeClassCount; i++) {
+      DeleteNodes(free_nodes[i], i);
+      free_nodes[i] = nullptr;
+    }
+  }
+};
+
+FML_THREAD_LOCAL fml::ThreadLocalUniquePtr<ThreadCache> tls_cache;
+
+ThreadCache& GetThreadCache() {
+  if (tls_cache.get() == nullptr) {
+    tls_cache.reset(new ThreadCache());
+  }
+  return *tls_cache.get();
+}
+
+}  // namespace
+
+void* LayerPool::Allocate(size_t size) {
+  if (size > kMaxPooledSize) {
+    heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(size);
+  }
+  const size_t size_class = SizeClass(size);
+  Node*& free_nodes = GetThreadCache().free_nodes[size_class];
+  if (free_nodes == nullptr) {
+    // Take everything the other threads freed at once, rather than a node at
+    // a time.
+    free_nodes = returned_nodes[size_class].exchange(nullptr,
+                                                     std::memory_order_acquire);
+  }
+  if (free_nodes == nullptr) {
+    heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(SizeOfClass(size_class));
+  }
+  Node* node = free_nodes;
+  free_nodes = node->next;
+  pooled_bytes.fetch_sub(SizeOfClass(size_class), std::memory_order_relaxed);
+  reuse_count.fetch_add(1, std::memory_order_relaxed);
+  return node;
+}
+
+void LayerPool::Free(void* node, size_t size) {
+  if (size > kMaxPooledSize) {
+    ::operator delete(node);
+    return;
+  }
+  const size_t size_class = SizeClass(size);
+  const size_t class_size = SizeOfClass(size_class);
+  if (pooled_bytes.fetch_add(class_size, std::memory_order_relaxed) +
+          class_size >
+      kMaxPooledBytes) {
+    pooled_bytes.fetch_sub(class_size, std::memory_order_relaxed);
+    ::operator delete(node);
+    return;
+  }
+  // Only whole lists are ever taken off |returned_nodes|, so pushing a node
+  // cannot be confused by a node that was taken and pushed again.
+  Node* returned = static_cast<Node*>(node);
+  std::atomic<Node*>& head = returned_nodes[size_class];
+  returned->next = head.load(std::memory_order_relaxed);
+  while (!head.compare_exchange_weak(returned->next, returned,
+                                     std::memory_order_release,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+LayerPool::Stats LayerPool::GetStats() {
+  return {
+      .heap_allocation_count =
+          heap_allocation_count.load(std::memory_order_relaxed),
+      .reuse_count = reuse_count.load(std::memory_order_relaxed),
+  };
+}
+
+void LayerPool::Trim() {
+  if (tls_cache.get() != nullptr) {
+    tls_cache.get()->Clear();
+  }
+  for (size_t i = 0; i < kSizeClassCount; i++) {
+    DeleteNodes(returned_nodes[i].exchange(nullptr, std::memory_order_acquire),
+                i);
+  }
+}
+
+}  // namespace flutter
@@ -0,0 +1,107 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYERS_LAYER_POOL_H_
+#define FLUTTER_FLOW_LAYERS_LAYER_POOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+// Recycles the memory of the layers, and of the mutators that preroll pushes
+// for them, from one frame to the next.
+//
+// Every frame the UI thread builds a new layer tree and the raster thread
+// frees the tree of an earlier frame. Instead of going back to the heap, the
+// freed nodes are kept in free lists by size, so that when the next tree has
+// the same shape as the previous ones it is built without touching the heap
+// at all. The raster thread hands freed nodes back with a single atomic
+// operation and the UI thread takes all of them at once when its own list
+// runs out, so neither thread waits on a lock.
+//
+// The pool does not own the objects. A layer made by the pool is destroyed
+// like any other layer once the last reference to it goes away, and it may
+// be retained across frames.
+class LayerPool {
+ public:
+  // Nodes larger than this come from the heap directly.
+  static constexpr size_t kMaxPooledSize = 512;
+
+  // Nodes are no longer kept once the free lists hold this many bytes.
+  static constexpr size_t kMaxPooledBytes = 2 * 1024 * 1024;
+
+  struct Stats {
+    // The number of nodes that were allocated from the heap.
+    size_t heap_allocation_count = 0;
+    // The number of nodes that were recycled from the free lists.
+    size_t reuse_count = 0;
+  };
+
+  // A stateless allocator for |std::allocate_shared| that allocates single
+  // objects from the pool.
+  template <typename T>
+  class Allocator {
+   public:
+    using value_type = T;
+
+    Allocator() = default;
+
+    template <typename U>
+    Allocator(const Allocator<U>&) {}  // NOLINT(google-explicit-constructor)
+
+    T* allocate(size_t n) {
+      if (n != 1 || alignof(T) > alignof(std::max_align_t)) {
+        return std::allocator<T>().allocate(n);
+      }
+      return static_cast<T*>(LayerPool::Allocate(sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+      if (n != 1 || alignof(T) > alignof(std::max_align_t)) {
+        std::allocator<T>().deallocate(p, n);
+        return;
+      }
+      LayerPool::Free(p, sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const Allocator<U>&) const {
+      return true;
+    }
+
+    template <typename U>
+    bool operator!=(const Allocator<U>&) const {
+      return false;
+    }
+  };
+
+  // The pooled equivalent of |std::make_shared|. The object and its
+  // reference counts share a single pooled node.
+  template <typename T, typename... Args>
+  static std::shared_ptr<T> Make(Args&&... args) {
+    return std::allocate_shared<T>(Allocator<T>(), std::forward<Args>(args)...);
+  }
+
+  static void* Allocate(size_t size);
+
+  static void Free(void* node, size_t size);
+
+  static Stats GetStats();
+
+  // Gives the nodes in the free lists of the calling thread and the nodes
+  // that were handed back by other threads back to the heap.
+  static void Trim();
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(LayerPool);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_LAYERS_LAYER_POOL_H_
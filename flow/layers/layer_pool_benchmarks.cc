@@ -0,0 +1,119 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_pool.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/flow/embedded_views.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/message_loop.h"
+
+namespace {
+
+std::atomic<size_t> heap_allocation_count;
+
+}  // namespace
+
+// Counts the allocations of the whole benchmark binary, so that the
+// benchmarks below can report the allocations per frame.
+void* operator new(size_t size) {
+  heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* result = std::malloc(size == 0 ? 1 : size);
+  FML_CHECK(result != nullptr);
+  return result;
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+namespace flutter {
+namespace {
+
+constexpr int kCellSize = 60;
+
+struct MakeShared {
+  template <typename T, typename... Args>
+  static std::shared_ptr<T> Shared(Args&&... args) {
+    return std::make_shared<T>(std::forward<Args>(args)...);
+  }
+};
+
+struct MakePooled {
+  template <typename T, typename... Args>
+  static std::shared_ptr<T> Shared(Args&&... args) {
+    return LayerPool::Make<T>(std::forward<Args>(args)...);
+  }
+};
+
+// Builds a tree the way the scene builder does, with a transform and a clip
+// around each picture, and pushes the mutators that preroll pushes for it.
+template <typename Maker>
+std::shared_ptr<ContainerLayer> BuildFrame(
+    int cell_count,
+    const sk_sp<DisplayList>& display_list,
+    const fml::RefPtr<SkiaUnrefQueue>& unref_queue) {
+  auto root = Maker::template Shared<ContainerLayer>();
+  MutatorsStack mutators;
+  for (int i = 0; i < cell_count; i++) {
+    SkMatrix matrix = SkMatrix::Translate(i * kCellSize, 0);
+    SkRect clip = SkRect::MakeWH(kCellSize, kCellSize);
+    auto transform = Maker::template Shared<TransformLayer>(matrix);
+    auto clip_rect =
+        Maker::template Shared<ClipRectLayer>(clip, Clip::hardEdge);
+    clip_rect->Add(Maker::template Shared<DisplayListLayer>(
+        SkPoint::Make(0, 0),
+        SkiaGPUObject<DisplayList>(display_list, unref_queue), false, false));
+    transform->Add(clip_rect);
+    root->Add(transform);
+
+    mutators.PushTransform(matrix);
+    mutators.PushClipRect(clip);
+    mutators.Pop();
+    mutators.Pop();
+  }
+  return root;
+}
+
+template <typename Maker>
+void BM_BuildLayerTree(benchmark::State& state) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  auto unref_queue = fml::MakeRefCounted<SkiaUnrefQueue>(
+      fml::MessageLoop::GetCurrent().GetTaskRunner(),
+      fml::TimeDelta::FromSeconds(0));
+  DisplayListBuilder builder;
+  builder.drawRect(SkRect::MakeWH(kCellSize, kCellSize));
+  sk_sp<DisplayList> display_list = builder.Build();
+  const int cell_count = state.range(0);
+
+  // Like the rasterizer, each frame frees the tree of the frame before it.
+  auto previous_frame =
+      BuildFrame<Maker>(cell_count, display_list, unref_queue);
+  const size_t start_count = heap_allocation_count.load();
+  for ([[maybe_unused]] auto _ : state) {
+    auto frame = BuildFrame<Maker>(cell_count, display_list, unref_queue);
+    previous_frame = std::move(frame);
+    unref_queue->Drain();
+  }
+  const size_t allocations = heap_allocation_count.load() - start_count;
+  state.counters["allocations_per_frame"] =
+      static_cast<double>(allocations) / state.iterations();
+  state.counters["layers_per_frame"] = cell_count * 3 + 1;
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_BuildLayerTree, MakeShared)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_BuildLayerTree, MakePooled)->Arg(100)->Arg(1000);
+
+}  // namespace flutter
@@ -0,0 +1,67 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_pool.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+struct TestNode {
+  explicit TestNode(int value) : value(value) {}
+  int value;
+};
+
+struct LargeTestNode {
+  char data[LayerPool::kMaxPooledSize + 1];
+};
+
+}  // namespace
+
+TEST(LayerPoolTest, RecyclesFreedNodes) {
+  LayerPool::Trim();
+  auto node = LayerPool::Make<TestNode>(1);
+  EXPECT_EQ(node->value, 1);
+  const TestNode* address = node.get();
+  const auto stats = LayerPool::GetStats();
+
+  node.reset();
+  node = LayerPool::Make<TestNode>(2);
+  EXPECT_EQ(node->value, 2);
+  EXPECT_EQ(node.get(), address);
+  EXPECT_EQ(LayerPool::GetStats().reuse_count, stats.reuse_count + 1);
+  EXPECT_EQ(LayerPool::GetStats().heap_allocation_count,
+            stats.heap_allocation_count);
+}
+
+TEST(LayerPoolTest, RecyclesNodesFreedOnOtherThreads) {
+  LayerPool::Trim();
+  auto node = LayerPool::Make<TestNode>(1);
+  const TestNode* address = node.get();
+
+  std::thread thread([node = std::move(node)]() mutable { node.reset(); });
+  thread.join();
+
+  node = LayerPool::Make<TestNode>(2);
+  EXPECT_EQ(node.get(), address);
+}
+
+TEST(LayerPoolTest, DoesNotPoolLargeNodes) {
+  LayerPool::Trim();
+  const auto stats = LayerPool::GetStats();
+  auto node = LayerPool::Make<LargeTestNode>();
+  node.reset();
+  node = LayerPool::Make<LargeTestNode>();
+  EXPECT_EQ(LayerPool::GetStats().reuse_count, stats.reuse_count);
+  EXPECT_EQ(LayerPool::GetStats().heap_allocation_count,
+            stats.heap_allocation_count + 2);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -4,6 +4,8 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <vector>
 
@@ -28,30 +30,109 @@ RasterCacheResult::RasterCacheResult(sk_sp<SkImage> image,
                                      const char* type)
     : image_(std::move(image)), logical_rect_(logical_rect), flow_(type) {}
 
+RasterCacheResult::RasterCacheResult(
+    std::unique_ptr<RasterCacheAtlas::Region> region,
+    const SkRect& logical_rect,
+    const char* type)
+    : region_(std::move(region)), logical_rect_(logical_rect), flow_(type) {}
+
 void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
   TRACE_EVENT0("flutter", "RasterCacheResult::draw");
   SkAutoCanvasRestore auto_restore(&canvas, true);
 
   SkRect bounds =
       RasterCacheUtil::GetDeviceBounds(logical_rect_, canvas.getTotalMatrix());
-  FML_DCHECK(std::abs(bounds.width() - image_->dimensions().width()) <= 1 &&
-             std::abs(bounds.height() - image_->dimensions().height()) <= 1);
+  SkISize dimensions = image_dimensions();
+  FML_DCHECK(std::abs(bounds.width() - dimensions.width()) <= 1 &&
+             std::abs(bounds.height() - dimensions.height()) <= 1);
   canvas.resetMatrix();
   flow_.Step();
+  if (region_) {
+    // Consecutive entries of the same page share a texture, so the backend
+    // can batch their draws.
+    canvas.drawImageRect(region_->page_image(), SkRect::Make(region_->bounds()),
+                         SkRect::MakeXYWH(bounds.fLeft, bounds.fTop,
+                                          dimensions.width(),
+                                          dimensions.height()),
+                         SkSamplingOptions(), paint,
+                         SkCanvas::kStrict_SrcRectConstraint);
+    return;
+  }
   canvas.drawImage(image_, bounds.fLeft, bounds.fTop, SkSamplingOptions(),
                    paint);
 }
 
+struct RasterCache::AsyncRasterization {
+  // Written on the raster thread before the job is posted.
+  const DisplayList* display_list;
+  SkMatrix matrix;
+  SkRect logical_rect;
+  sk_sp<SkColorSpace> dst_color_space;
+  const char* flow_type;
+  bool checkerboard;
+
+  // Set by the raster thread to tell the worker not to bother, and to drop
+  // the image if it has already started.
+  std::atomic<bool> abandoned = false;
+
+  // Set by the worker, with a release store that publishes |image|, once
+  // it no longer touches the |display_list|.
+  std::atomic<bool> done = false;
+  sk_sp<SkImage> image;
+
+  // Only set when the cache is destroyed before the worker is done, so that
+  // the |display_list| lives for as long as the job does.
+  sk_sp<DisplayList> display_list_ref;
+};
+
 RasterCache::RasterCache(size_t access_threshold,
                          size_t display_list_cache_limit_per_frame)
     : access_threshold_(access_threshold),
       display_list_cache_limit_per_frame_(display_list_cache_limit_per_frame),
-      checkerboard_images_(false) {}
+      checkerboard_images_(false),
+      eviction_policy_(std::make_unique<UnusedEntryEvictionPolicy>()) {}
+
+RasterCache::~RasterCache() {
+  // Workers may still be rendering DisplayLists that are about to be
+  // released. Rather than waiting for them, which may take long or never
+  // happen if the task is dropped, hand the DisplayLists over to the jobs.
+  Clear();
+  for (auto& pending : abandoned_rasterizations_) {
+    pending.job->display_list_ref = std::move(pending.display_list);
+  }
+}
+
+void RasterCache::SetEvictionPolicy(
+    std::unique_ptr<RasterCacheEvictionPolicy> policy) {
+  eviction_policy_ = policy ? std::move(policy)
+                            : std::make_unique<UnusedEntryEvictionPolicy>();
+}
+
+void RasterCache::SetAtlas(std::unique_ptr<RasterCacheAtlas> atlas) {
+  Clear();
+  atlas_ = std::move(atlas);
+}
+
+void RasterCache::SetAsyncTaskRunner(
+    std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) {
+  async_task_runner_ = std::move(task_runner);
+}
 
 /// @note Procedure doesn't copy all closures.
 std::unique_ptr<RasterCacheResult> RasterCache::Rasterize(
     const RasterCache::Context& context,
     const std::function<void(SkCanvas*)>& draw_function) {
+  sk_sp<SkImage> image = RasterizeImage(context, draw_function);
+  if (!image) {
+    return nullptr;
+  }
+  return std::make_unique<RasterCacheResult>(
+      std::move(image), context.logical_rect, context.flow_type);
+}
+
+sk_sp<SkImage> RasterCache::RasterizeImage(
+    const RasterCache::Context& context,
+    const std::function<void(SkCanvas*)>& draw_function) {
   TRACE_EVENT0("flutter", "RasterCachePopulate");
 
   SkRect dest_rect =
@@ -82,8 +163,37 @@ std::unique_ptr<RasterCacheResult> RasterCache::Rasterize(
     DrawCheckerboard(canvas, context.logical_rect);
   }
 
+  return surface->makeImageSnapshot();
+}
+
+std::unique_ptr<RasterCacheResult> RasterCache::RasterizeEntry(
+    const RasterCache::Context& context,
+    const std::function<void(SkCanvas*)>& draw_function) const {
+  if (!atlas_) {
+    return Rasterize(context, draw_function);
+  }
+  SkRect dest_rect =
+      RasterCacheUtil::GetDeviceBounds(context.logical_rect, context.matrix);
+  SkISize size = SkISize::Make(SkScalarCeilToInt(dest_rect.width()),
+                               SkScalarCeilToInt(dest_rect.height()));
+  std::unique_ptr<RasterCacheAtlas::Region> region =
+      atlas_->Allocate(size, context.gr_context, context.dst_color_space);
+  if (!region) {
+    return Rasterize(context, draw_function);
+  }
+
+  TRACE_EVENT0("flutter", "RasterCachePopulateAtlas");
+  atlas_->Draw(*region, [&context, &dest_rect,
+                         &draw_function](SkCanvas* canvas) {
+    canvas->translate(-dest_rect.left(), -dest_rect.top());
+    canvas->concat(context.matrix);
+    draw_function(canvas);
+    if (context.checkerboard) {
+      DrawCheckerboard(canvas, context.logical_rect);
+    }
+  });
   return std::make_unique<RasterCacheResult>(
-      surface->makeImageSnapshot(), context.logical_rect, context.flow_type);
+      std::move(region), context.logical_rect, context.flow_type);
 }
 
 bool RasterCache::UpdateCacheEntry(
@@ -94,7 +204,7 @@ bool RasterCache::UpdateCacheEntry(
   Entry& entry = cache_[key];
   entry.used_this_frame = true;
   if (!entry.image) {
-    entry.image = Rasterize(raster_cache_context, render_function);
+    entry.image = RasterizeEntry(raster_cache_context, render_function);
     if (entry.image != nullptr) {
       switch (id.type()) {
         case RasterCacheKeyType::kDisplayList: {
@@ -110,6 +220,119 @@ bool RasterCache::UpdateCacheEntry(
   return entry.image != nullptr;
 }
 
+bool RasterCache::UpdateDisplayListCacheEntry(
+    const RasterCacheKeyID& id,
+    const Context& raster_cache_context,
+    const sk_sp<DisplayList>& display_list) const {
+  FML_DCHECK(id.type() == RasterCacheKeyType::kDisplayList);
+  RasterCacheKey key = RasterCacheKey(id, raster_cache_context.matrix);
+  Entry& entry = cache_[key];
+  if (entry.cost == 0) {
+    // Remember what the entry costs to reproduce for the eviction policy.
+    GrDirectContext* gr_context = raster_cache_context.gr_context;
+    DisplayListComplexityCalculator* complexity_calculator =
+        gr_context ? DisplayListComplexityCalculator::GetForBackend(
+                         gr_context->backend())
+                   : DisplayListComplexityCalculator::GetForSoftware();
+    entry.cost = complexity_calculator->Compute(display_list.get());
+  }
+  if (!async_task_runner_ || display_list->may_have_texture_images()) {
+    return UpdateCacheEntry(id, raster_cache_context,
+                            [display_list](SkCanvas* canvas) {
+                              display_list->RenderTo(canvas);
+                            });
+  }
+
+  entry.used_this_frame = true;
+  if (entry.image) {
+    return true;
+  }
+  if (entry.pending.job) {
+    return FinishAsyncRasterization(entry, raster_cache_context.gr_context);
+  }
+
+  auto job = std::make_shared<AsyncRasterization>();
+  job->display_list = display_list.get();
+  job->matrix = raster_cache_context.matrix;
+  job->logical_rect = raster_cache_context.logical_rect;
+  job->dst_color_space = sk_ref_sp(raster_cache_context.dst_color_space);
+  job->flow_type = raster_cache_context.flow_type;
+  job->checkerboard = raster_cache_context.checkerboard;
+  entry.pending = {job, display_list};
+  display_list_cached_this_frame_++;
+
+  // The entry is drawn uncached until it is ready, so let work that
+  // something is waiting on, like decoding images, go first.
+  async_task_runner_->PostTask(
+      [job]() {
+        if (!job->abandoned.load(std::memory_order_relaxed)) {
+          TRACE_EVENT0("flutter", "RasterCacheAsyncPopulate");
+          RasterCache::Context context = {
+              // clang-format off
+              .gr_context         = nullptr,
+              .dst_color_space    = job->dst_color_space.get(),
+              .matrix             = job->matrix,
+              .logical_rect       = job->logical_rect,
+              .flow_type          = job->flow_type,
+              .checkerboard       = job->checkerboard,
+              // clang-format on
+          };
+          job->image = RasterizeImage(context, [&job](SkCanvas* canvas) {
+            job->display_list->RenderTo(canvas);
+          });
+          if (job->abandoned.load(std::memory_order_relaxed)) {
+            job->image = nullptr;
+          }
+        }
+        job->done.store(true, std::memory_order_release);
+      },
+      fml::ConcurrentTaskPriority::kBackground);
+  return false;
+}
+
+bool RasterCache::FinishAsyncRasterization(Entry& entry,
+                                           GrDirectContext* gr_context) const {
+  AsyncRasterization* job = entry.pending.job.get();
+  if (!job->done.load(std::memory_order_acquire)) {
+    return false;
+  }
+  sk_sp<SkImage> image = std::move(job->image);
+  std::unique_ptr<RasterCacheAtlas::Region> region;
+  if (image && atlas_) {
+    region = atlas_->Allocate(image->dimensions(), gr_context,
+                              job->dst_color_space.get());
+  }
+  if (region) {
+    // Drawing the image into the atlas uploads it as well.
+    atlas_->Draw(*region, [&image](SkCanvas* canvas) {
+      canvas->drawImage(image, 0, 0);
+    });
+    entry.image = std::make_unique<RasterCacheResult>(
+        std::move(region), job->logical_rect, job->flow_type);
+    image = nullptr;
+  } else if (image && gr_context) {
+    // Upload the image now rather than when it is first drawn.
+    image = image->makeTextureImage(gr_context, GrMipmapped::kNo,
+                                    SkBudgeted::kYes);
+  }
+  if (image) {
+    entry.image = std::make_unique<RasterCacheResult>(
+        std::move(image), job->logical_rect, job->flow_type);
+  }
+  entry.pending = {};
+  async_completed_this_frame_++;
+  return entry.image != nullptr;
+}
+
+void RasterCache::AbandonAsyncRasterization(PendingRasterization pending) {
+  async_metrics_.abandoned_count++;
+  if (pending.job->done.load(std::memory_order_acquire)) {
+    return;
+  }
+  pending.job->abandoned.store(true, std::memory_order_relaxed);
+  abandoned_rasterizations_.push_back(std::move(pending));
+}
+
 bool RasterCache::Touch(const RasterCacheKeyID& id,
                         const SkMatrix& matrix) const {
   RasterCacheKey cache_key = RasterCacheKey(id, matrix);
@@ -151,6 +374,12 @@ bool RasterCache::Draw(const RasterCacheKeyID& id,
   entry.access_count++;
   entry.used_this_frame = true;
 
+  if (!entry.image && entry.pending.job) {
+    GrRecordingContext* context = canvas.recordingContext();
+    FinishAsyncRasterization(entry,
+                             context ? context->asDirectContext() : nullptr);
+  }
+
   if (entry.image) {
     entry.image->draw(canvas, paint);
     return true;
@@ -167,41 +396,58 @@ void RasterCache::SweepOneCacheAfterFrame(RasterCacheKey::Map<Entry>& cache,
                                           RasterCacheMetrics& picture_metrics,
                                           RasterCacheMetrics& layer_metrics) {
   std::vector<RasterCacheKey::Map<Entry>::iterator> dead;
+  std::vector<RasterCacheKey::Map<Entry>::iterator> populated;
+  std::vector<RasterCacheEntryStats> stats;
 
   for (auto it = cache.begin(); it != cache.end(); ++it) {
     Entry& entry = it->second;
+    if (entry.used_this_frame) {
+      entry.frames_used++;
+      entry.frames_unused = 0;
+    } else {
+      entry.frames_unused++;
+    }
 
-    if (!entry.used_this_frame) {
+    if (entry.image) {
+      populated.push_back(it);
+      stats.push_back({
+          .bytes = static_cast<size_t>(entry.image->image_bytes()),
+          .cost = entry.cost,
+          .frames_used = entry.frames_used,
+          .frames_unused = entry.frames_unused,
+      });
+    } else if (!entry.used_this_frame) {
       dead.push_back(it);
-    } else if (entry.image) {
-      RasterCacheKeyKind kind = it->first.kind();
-      switch (kind) {
-        case RasterCacheKeyKind::kDisplayListMetrics:
-          picture_metrics.in_use_count++;
-          picture_metrics.in_use_bytes += entry.image->image_bytes();
-          break;
-        case RasterCacheKeyKind::kLayerMetrics:
-          layer_metrics.in_use_count++;
-          layer_metrics.in_use_bytes += entry.image->image_bytes();
-          break;
-      }
+    } else if (entry.pending.job) {
+      async_metrics_.pending_count++;
     }
     entry.used_this_frame = false;
   }
 
+  std::vector<bool> evict(stats.size(), false);
+  eviction_policy_->SelectEvictions(stats, evict);
+
+  for (size_t i = 0; i < populated.size(); i++) {
+    RasterCacheMetrics& metrics =
+        populated[i]->first.kind() == RasterCacheKeyKind::kLayerMetrics
+            ? layer_metrics
+            : picture_metrics;
+    if (evict[i]) {
+      metrics.eviction_count++;
+      metrics.eviction_bytes += stats[i].bytes;
+      dead.push_back(populated[i]);
+    } else if (stats[i].used_this_frame()) {
+      metrics.in_use_count++;
+      metrics.in_use_bytes += stats[i].bytes;
+    } else {
+      metrics.retained_count++;
+      metrics.retained_bytes += stats[i].bytes;
+    }
+  }
+
   for (auto it : dead) {
-    if (it->second.image) {
-      RasterCacheKeyKind kind = it->first.kind();
-      switch (kind) {
-        case RasterCacheKeyKind::kDisplayListMetrics:
-          picture_metrics.eviction_count++;
-          picture_metrics.eviction_bytes += it->second.image->image_bytes();
-          break;
-        case RasterCacheKeyKind::kLayerMetrics:
-          layer_metrics.eviction_count++;
-          layer_metrics.eviction_bytes += it->second.image->image_bytes();
-          break;
-      }
+    if (it->second.pending.job) {
+      AbandonAsyncRasterization(std::move(it->second.pending));
     }
     cache.erase(it);
   }
@@ -210,14 +456,39 @@ void RasterCache::SweepOneCacheAfterFrame(RasterCacheKey::Map<Entry>& cache,
 void RasterCache::CleanupAfterFrame() {
   picture_metrics_ = {};
   layer_metrics_ = {};
+  async_metrics_ = {};
+  async_metrics_.completed_count = async_completed_this_frame_;
+  async_completed_this_frame_ = 0;
   SweepOneCacheAfterFrame(cache_, picture_metrics_, layer_metrics_);
+  if (atlas_) {
+    atlas_->ReleaseEmptyPages();
+  }
+  // Release the DisplayLists of abandoned rasterizations once their
+  // workers are done with them.
+  abandoned_rasterizations_.erase(
+      std::remove_if(abandoned_rasterizations_.begin(),
+                     abandoned_rasterizations_.end(),
+                     [](const PendingRasterization& pending) {
+                       return pending.job->done.load(
+                           std::memory_order_acquire);
+                     }),
+      abandoned_rasterizations_.end());
   TraceStatsToTimeline();
 }
 
 void RasterCache::Clear() {
+  for (auto& item : cache_) {
+    if (item.second.pending.job) {
+      AbandonAsyncRasterization(std::move(item.second.pending));
+    }
+  }
   cache_.clear();
+  if (atlas_) {
+    atlas_->ReleaseEmptyPages();
+  }
   picture_metrics_ = {};
   layer_metrics_ = {};
+  async_metrics_ = {};
 }
 
 size_t RasterCache::GetCachedEntriesCount() const {
@@ -265,6 +536,23 @@ void RasterCache::TraceStatsToTimeline() const {
       "LayerMBytes", layer_metrics_.total_bytes() / kMegaByteSizeInBytes,  //
       "PictureCount", picture_metrics_.total_count(),                      //
       "PictureMBytes", picture_metrics_.total_bytes() / kMegaByteSizeInBytes);
+  if (async_task_runner_) {
+    FML_TRACE_COUNTER(
+        "flutter",                                                    //
+        "RasterCacheAsync", reinterpret_cast<int64_t>(this),          //
+        "PendingCount", async_metrics_.pending_count,                 //
+        "CompletedCount", async_metrics_.completed_count,             //
+        "AbandonedCount", async_metrics_.abandoned_count);
+  }
+  if (atlas_) {
+    FML_TRACE_COUNTER(
+        "flutter",                                                  //
+        "RasterCacheAtlas", reinterpret_cast<int64_t>(this),        //
+        "PageCount", atlas_->page_count(),                          //
+        "PageMBytes", atlas_->page_bytes() / kMegaByteSizeInBytes,  //
+        "RegionCount", atlas_->region_count(),                      //
+        "DefragmentCount", atlas_->defragment_count());
+  }
 
 #endif  // !FLUTTER_RELEASE
 }
@@ -7,11 +7,15 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_complexity.h"
+#include "flutter/flow/raster_cache_atlas.h"
+#include "flutter/flow/raster_cache_eviction_policy.h"
 #include "flutter/flow/raster_cache_key.h"
 #include "flutter/flow/raster_cache_util.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/trace_event.h"
@@ -33,20 +37,35 @@ class RasterCacheResult {
                     const SkRect& logical_rect,
                     const char* type);
 
+  // A result whose image is held by a |region| of a RasterCacheAtlas page.
+  RasterCacheResult(std::unique_ptr<RasterCacheAtlas::Region> region,
+                    const SkRect& logical_rect,
+                    const char* type);
+
   virtual ~RasterCacheResult() = default;
 
   virtual void draw(SkCanvas& canvas, const SkPaint* paint) const;
 
   virtual SkISize image_dimensions() const {
+    if (region_) {
+      return region_->dimensions();
+    }
     return image_ ? image_->dimensions() : SkISize::Make(0, 0);
   };
 
   virtual int64_t image_bytes() const {
+    if (region_) {
+      return SkImageInfo::MakeN32Premul(region_->dimensions())
+          .computeMinByteSize();
+    }
     return image_ ? image_->imageInfo().computeMinByteSize() : 0;
   };
 
+  bool is_in_atlas() const { return !!region_; }
+
  private:
   sk_sp<SkImage> image_;
+  std::unique_ptr<RasterCacheAtlas::Region> region_;
   SkRect logical_rect_;
   fml::tracing::TraceFlow flow_;
 };
@@ -77,19 +96,54 @@ struct RasterCacheMetrics {
    */
   size_t in_use_bytes = 0;
 
+  /**
+   * The number of cache entries with images that were not used in this
+   * frame but were kept by the eviction policy.
+   */
+  size_t retained_count = 0;
+
+  /**
+   * The size of all of the images kept without being used in this frame.
+   */
+  size_t retained_bytes = 0;
+
   /**
    * The total cache entries that had images during this frame whether
-   * they were used in the frame or held memory during the frame and then
-   * were evicted after it ended.
+   * they were used in the frame, were kept without being used, or held
+   * memory during the frame and then were evicted after it ended.
    */
-  size_t total_count() const { return in_use_count + eviction_count; }
+  size_t total_count() const {
+    return in_use_count + retained_count + eviction_count;
+  }
 
   /**
    * The size of all of the cached images during this frame whether
-   * they were used in the frame or held memory during the frame and then
-   * were evicted after it ended.
+   * they were used in the frame, were kept without being used, or held
+   * memory during the frame and then were evicted after it ended.
    */
-  size_t total_bytes() const { return in_use_bytes + eviction_bytes; }
+  size_t total_bytes() const {
+    return in_use_bytes + retained_bytes + eviction_bytes;
+  }
+};
+
+struct RasterCacheAsyncMetrics {
+  /**
+   * The number of cache entries still being rasterized on a worker thread
+   * at the end of this frame.
+   */
+  size_t pending_count = 0;
+
+  /**
+   * The number of cache entries whose asynchronous rasterization finished
+   * and was swapped into the cache in this frame.
+   */
+  size_t completed_count = 0;
+
+  /**
+   * The number of cache entries that were evicted in this frame before
+   * their asynchronous rasterization could be swapped into the cache.
+   */
+  size_t abandoned_count = 0;
 };
 
 class RasterCache {
@@ -112,7 +166,39 @@ class RasterCache {
       size_t picture_and_display_list_cache_limit_per_frame =
           RasterCacheUtil::kDefaultPictureAndDispLayListCacheLimitPerFrame);
 
-  virtual ~RasterCache() = default;
+  virtual ~RasterCache();
+
+  /**
+   * @brief Rasterize new DisplayList cache entries on the workers of the
+   * |task_runner| rather than on the raster thread, or go back to
+   * rasterizing them synchronously if the |task_runner| is null.
+   *
+   * An entry that is being rasterized asynchronously is not drawn from the
+   * cache, so its layer renders the DisplayList directly, until a frame
+   * after the worker has finished with it. The finished image is uploaded
+   * to the GPU, if there is one, when it is swapped into the cache.
+   */
+  void SetAsyncTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner);
+
+  bool async_rasterization_enabled() const { return !!async_task_runner_; }
+
+  /**
+   * @brief Replace the policy that decides which entries are evicted at
+   * the end of each frame. A null |policy| restores the default policy,
+   * which evicts every entry that was not used in the frame.
+   */
+  void SetEvictionPolicy(std::unique_ptr<RasterCacheEvictionPolicy> policy);
+
+  /**
+   * @brief Pack the images of small entries into the pages of the |atlas|
+   * so that they can be drawn without switching textures, or give every
+   * entry an image of its own if the |atlas| is null. This clears the
+   * cache.
+   */
+  void SetAtlas(std::unique_ptr<RasterCacheAtlas> atlas);
+
+  const RasterCacheAtlas* atlas() const { return atlas_.get(); }
 
   // Draws this item if it should be rendered from the cache and returns
   // true iff it was successfully drawn. Typically this should only fail
@@ -137,6 +223,9 @@ class RasterCache {
 
   const RasterCacheMetrics& picture_metrics() const { return picture_metrics_; }
   const RasterCacheMetrics& layer_metrics() const { return layer_metrics_; }
+  const RasterCacheAsyncMetrics& async_metrics() const {
+    return async_metrics_;
+  }
 
   size_t GetCachedEntriesCount() const;
 
@@ -204,13 +293,62 @@ class RasterCache {
       const Context& raster_cache_context,
       const std::function<void(SkCanvas*)>& render_function) const;
 
+  /**
+   * @brief Populate the entry for the |display_list| as |UpdateCacheEntry|
+   * does, or when asynchronous rasterization is enabled and the
+   * |display_list| does not sample any GPU textures, start rasterizing it
+   * on a worker thread.
+   * @return true iff the entry holds an image that can be drawn in this
+   * frame.
+   */
+  bool UpdateDisplayListCacheEntry(
+      const RasterCacheKeyID& id,
+      const Context& raster_cache_context,
+      const sk_sp<DisplayList>& display_list) const;
+
  private:
+  // The state of an entry that is being rasterized on a worker thread,
+  // which the worker shares with the raster thread.
+  struct AsyncRasterization;
+
+  // Held by the raster thread for each asynchronous rasterization along
+  // with the DisplayList being rasterized, which is only released once the
+  // worker is done with it so that it is freed on this thread. If the cache
+  // is destroyed first, the job keeps the DisplayList instead.
+  struct PendingRasterization {
+    std::shared_ptr<AsyncRasterization> job;
+    sk_sp<DisplayList> display_list;
+  };
+
   struct Entry {
     bool used_this_frame = false;
     size_t access_count = 0;
+    // The complexity score of a DisplayList entry, 0 for layers.
+    unsigned int cost = 0;
+    size_t frames_used = 0;
+    size_t frames_unused = 0;
     std::unique_ptr<RasterCacheResult> image;
+    PendingRasterization pending;
   };
 
+  static sk_sp<SkImage> RasterizeImage(
+      const RasterCache::Context& context,
+      const std::function<void(SkCanvas*)>& draw_function);
+
+  // Rasterizes into a region of the atlas when the entry is small enough,
+  // and otherwise into an image of its own.
+  std::unique_ptr<RasterCacheResult> RasterizeEntry(
+      const RasterCache::Context& context,
+      const std::function<void(SkCanvas*)>& draw_function) const;
+
+  // Moves the result of a finished asynchronous rasterization of the
+  // |entry| into its |image|. Returns false if it has not finished yet.
+  bool FinishAsyncRasterization(Entry& entry,
+                                GrDirectContext* gr_context) const;
+
+  // Lets go of the asynchronous rasterization of an evicted entry.
+  void AbandonAsyncRasterization(PendingRasterization pending);
+
   void SweepOneCacheAfterFrame(RasterCacheKey::Map<Entry>& cache,
                                RasterCacheMetrics& picture_metrics,
                                RasterCacheMetrics& layer_metrics);
@@ -220,8 +358,18 @@ class RasterCache {
   mutable size_t display_list_cached_this_frame_ = 0;
   RasterCacheMetrics layer_metrics_;
   RasterCacheMetrics picture_metrics_;
+  RasterCacheAsyncMetrics async_metrics_;
+  mutable size_t async_completed_this_frame_ = 0;
+  // Declared before the |cache_| so that it outlives the regions that the
+  // entries hold.
+  std::unique_ptr<RasterCacheAtlas> atlas_;
   mutable RasterCacheKey::Map<Entry> cache_;
   bool checkerboard_images_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> async_task_runner_;
+  std::unique_ptr<RasterCacheEvictionPolicy> eviction_policy_;
+  // Rasterizations whose entries were evicted while a worker was still
+  // rendering them.
+  std::vector<PendingRasterization> abandoned_rasterizations_;
 
   void TraceStatsToTimeline() const;
 
@@ -0,0 +1,303 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/raster_cache_atlas.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/gpu/GrDirectContext.h"
+#include "third_party/skia/src/core/SkIPoint16.h"   //nogncheck
+#include "third_party/skia/src/gpu/GrRectanizer.h"  //nogncheck
+
+namespace flutter {
+
+class RasterCacheAtlas::Page {
+ public:
+  Page(sk_sp<SkSurface> surface,
+       GrDirectContext* gr_context,
+       sk_sp<SkColorSpace> color_space)
+      : surface_(std::move(surface)),
+        gr_context_(gr_context),
+        color_space_(std::move(color_space)),
+        packer_(GrRectanizer::Factory(surface_->width(), surface_->height())) {
+  }
+
+  ~Page() { FML_DCHECK(regions_.empty()); }
+
+  bool Matches(GrDirectContext* gr_context,
+               const SkColorSpace* color_space) const {
+    return gr_context_ == gr_context &&
+           SkColorSpace::Equals(color_space_.get(), color_space);
+  }
+
+  bool Pack(const SkISize& size, SkIRect* bounds) {
+    SkIPoint16 location;
+    if (!packer_->addRect(size.width(), size.height(), &location)) {
+      return false;
+    }
+    *bounds = SkIRect::MakeXYWH(location.x(), location.y(), size.width(),
+                                size.height());
+    return true;
+  }
+
+  void Attach(Region* region) { regions_.push_back(region); }
+
+  void Detach(Region* region) {
+    auto it = std::find(regions_.begin(), regions_.end(), region);
+    FML_DCHECK(it != regions_.end());
+    *it = regions_.back();
+    regions_.pop_back();
+    if (regions_.empty()) {
+      // None of the packed space is in use anymore, so start over.
+      packer_->reset();
+    }
+  }
+
+  const std::vector<Region*>& regions() const { return regions_; }
+
+  std::vector<Region*> TakeRegions() {
+    std::vector<Region*> regions;
+    regions.swap(regions_);
+    return regions;
+  }
+
+  size_t live_area() const {
+    size_t area = 0;
+    for (const Region* region : regions_) {
+      area += region->bounds().width() * region->bounds().height();
+    }
+    return area;
+  }
+
+  size_t area() const { return surface_->width() * surface_->height(); }
+
+  size_t bytes() const { return surface_->imageInfo().computeMinByteSize(); }
+
+  SkCanvas* BeginDrawing() {
+    // Let go of the snapshot first so that drawing does not have to copy
+    // the whole page to preserve it.
+    snapshot_.reset();
+    return surface_->getCanvas();
+  }
+
+  const sk_sp<SkImage>& image() {
+    if (!snapshot_) {
+      snapshot_ = surface_->makeImageSnapshot();
+    }
+    return snapshot_;
+  }
+
+ private:
+  sk_sp<SkSurface> surface_;
+  GrDirectContext* gr_context_;
+  sk_sp<SkColorSpace> color_space_;
+  std::unique_ptr<GrRectanizer> packer_;
+  std::vector<Region*> regions_;
+  sk_sp<SkImage> snapshot_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Page);
+};
+
+RasterCacheAtlas::Region::~Region() {
+  page_->Detach(this);
+}
+
+sk_sp<SkImage> RasterCacheAtlas::Region::page_image() const {
+  return page_->image();
+}
+
+RasterCacheAtlas::RasterCacheAtlas(int page_size,
+                                   size_t max_page_count,
+                                   int max_entry_size)
+    : page_size_(page_size),
+      max_page_count_(max_page_count),
+      max_entry_size_(std::min(max_entry_size, page_size)) {}
+
+RasterCacheAtlas::~RasterCacheAtlas() = default;
+
+bool RasterCacheAtlas::CanHold(const SkISize& size) const {
+  return max_page_count_ > 0 && !size.isEmpty() &&
+         size.width() <= max_entry_size_ && size.height() <= max_entry_size_;
+}
+
+std::unique_ptr<RasterCacheAtlas::Page> RasterCacheAtlas::MakePage(
+    GrDirectContext* gr_context,
+    const SkColorSpace* color_space) const {
+  TRACE_EVENT0("flutter", "RasterCacheAtlas::MakePage");
+  const SkImageInfo image_info = SkImageInfo::MakeN32Premul(
+      page_size_, page_size_, sk_ref_sp(color_space));
+  sk_sp<SkSurface> surface =
+      gr_context ? SkSurface::MakeRenderTarget(gr_context, SkBudgeted::kYes,
+                                               image_info)
+                 : SkSurface::MakeRaster(image_info);
+  if (!surface) {
+    return nullptr;
+  }
+  return std::make_unique<Page>(std::move(surface), gr_context,
+                                sk_ref_sp(color_space));
+}
+
+std::unique_ptr<RasterCacheAtlas::Region> RasterCacheAtlas::AllocateInPages(
+    const SkISize& size,
+    GrDirectContext* gr_context,
+    const SkColorSpace* color_space) {
+  for (auto& page : pages_) {
+    SkIRect bounds;
+    if (page->Matches(gr_context, color_space) && page->Pack(size, &bounds)) {
+      auto region = std::unique_ptr<Region>(new Region(page.get(), bounds));
+      page->Attach(region.get());
+      return region;
+    }
+  }
+  return nullptr;
+}
+
+std::unique_ptr<RasterCacheAtlas::Region> RasterCacheAtlas::Allocate(
+    const SkISize& size,
+    GrDirectContext* gr_context,
+    const SkColorSpace* color_space) {
+  if (!CanHold(size)) {
+    return nullptr;
+  }
+  if (auto region = AllocateInPages(size, gr_context, color_space)) {
+    return region;
+  }
+  if (pages_.size() < max_page_count_) {
+    if (auto page = MakePage(gr_context, color_space)) {
+      pages_.push_back(std::move(page));
+      return AllocateInPages(size, gr_context, color_space);
+    }
+    return nullptr;
+  }
+  if (Defragment(size, gr_context, color_space)) {
+    return AllocateInPages(size, gr_context, color_space);
+  }
+  return nullptr;
+}
+
+bool RasterCacheAtlas::Defragment(const SkISize& size,
+                                  GrDirectContext* gr_context,
+                                  const SkColorSpace* color_space) {
+  std::vector<std::unique_ptr<Page>> old_pages;
+  size_t free_area = 0;
+  for (auto& page : pages_) {
+    if (page->Matches(gr_context, color_space)) {
+      free_area += page->area() - page->live_area();
+      old_pages.push_back(std::move(page));
+    }
+  }
+  pages_.erase(std::remove(pages_.begin(), pages_.end(), nullptr),
+               pages_.end());
+  // Copying the regions is not cheap, so only bother when it frees up a
+  // good part of a page rather than just enough for this one region.
+  size_t min_free_area =
+      std::max(static_cast<size_t>(size.width() * size.height()),
+               static_cast<size_t>(page_size_ * page_size_) / 4);
+  if (free_area < min_free_area) {
+    std::move(old_pages.begin(), old_pages.end(), std::back_inserter(pages_));
+    return false;
+  }
+
+  TRACE_EVENT0("flutter", "RasterCacheAtlas::Defragment");
+  defragment_count_++;
+
+  // Taller regions first, which packs much more tightly.
+  std::vector<std::pair<Region*, Page*>> regions;
+  for (auto& page : old_pages) {
+    for (Region* region : page->TakeRegions()) {
+      regions.emplace_back(region, page.get());
+    }
+  }
+  std::sort(regions.begin(), regions.end(), [](const auto& a, const auto& b) {
+    if (a.first->bounds().height() != b.first->bounds().height()) {
+      return a.first->bounds().height() > b.first->bounds().height();
+    }
+    return a.first->bounds().width() > b.first->bounds().width();
+  });
+
+  // The old pages are only released once their regions have been copied,
+  // so the pages briefly take up more memory than the atlas is allowed.
+  std::vector<std::unique_ptr<Page>> new_pages;
+  SkPaint copy_paint;
+  copy_paint.setBlendMode(SkBlendMode::kSrc);
+  for (auto& [region, old_page] : regions) {
+    SkIRect bounds;
+    Page* new_page = nullptr;
+    for (auto& page : new_pages) {
+      if (page->Pack(region->dimensions(), &bounds)) {
+        new_page = page.get();
+        break;
+      }
+    }
+    if (!new_page) {
+      auto page = MakePage(gr_context, color_space);
+      if (!page || !page->Pack(region->dimensions(), &bounds)) {
+        // Out of memory. Keep the region where it is, which leaves its old
+        // page alive.
+        old_page->Attach(region);
+        continue;
+      }
+      new_page = page.get();
+      new_pages.push_back(std::move(page));
+    }
+    new_page->BeginDrawing()->drawImageRect(
+        old_page->image(), SkRect::Make(region->bounds()), SkRect::Make(bounds),
+        SkSamplingOptions(), &copy_paint, SkCanvas::kStrict_SrcRectConstraint);
+    region->page_ = new_page;
+    region->bounds_ = bounds;
+    new_page->Attach(region);
+  }
+
+  for (auto& page : old_pages) {
+    if (!page->regions().empty()) {
+      pages_.push_back(std::move(page));
+    }
+  }
+  std::move(new_pages.begin(), new_pages.end(), std::back_inserter(pages_));
+  return true;
+}
+
+void RasterCacheAtlas::Draw(
+    const Region& region,
+    const std::function<void(SkCanvas*)>& draw_function) {
+  SkCanvas* canvas = region.page_->BeginDrawing();
+  SkAutoCanvasRestore auto_restore(canvas, true);
+  canvas->clipIRect(region.bounds());
+  canvas->clear(SK_ColorTRANSPARENT);
+  canvas->translate(region.bounds().left(), region.bounds().top());
+  draw_function(canvas);
+}
+
+void RasterCacheAtlas::ReleaseEmptyPages() {
+  pages_.erase(std::remove_if(pages_.begin(), pages_.end(),
+                              [](const std::unique_ptr<Page>& page) {
+                                return page->regions().empty();
+                              }),
+               pages_.end());
+}
+
+size_t RasterCacheAtlas::region_count() const {
+  size_t count = 0;
+  for (const auto& page : pages_) {
+    count += page->regions().size();
+  }
+  return count;
+}
+
+size_t RasterCacheAtlas::page_bytes() const {
+  size_t bytes = 0;
+  for (const auto& page : pages_) {
+    bytes += page->bytes();
+  }
+  return bytes;
+}
+
+}  // namespace flutter
@@ -0,0 +1,129 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_RASTER_CACHE_ATLAS_H_
+#define FLUTTER_FLOW_RASTER_CACHE_ATLAS_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkRect.h"
+#include "third_party/skia/include/core/SkSize.h"
+
+class GrDirectContext;
+class SkColorSpace;
+
+namespace flutter {
+
+// Packs the images of small raster cache entries into a few large pages so
+// that drawing many of them binds the same texture over and over instead of
+// switching textures, which lets the backend batch the draws.
+//
+// The packer of a page cannot reuse the space of the regions that are
+// released, so when every page is full the live regions of the pages are
+// copied into freshly packed pages. Must only be used on the raster thread.
+class RasterCacheAtlas {
+ public:
+  static constexpr int kDefaultPageSize = 1024;
+  static constexpr size_t kDefaultMaxPageCount = 4;
+  static constexpr int kDefaultMaxEntrySize = 256;
+
+  class Page;
+
+  // The part of a page that holds the image of one cache entry. The region
+  // is given back to its page when it is destroyed, which must happen
+  // before the atlas is destroyed.
+  class Region {
+   public:
+    ~Region();
+
+    // The bounds of the region within the image of its page. These change
+    // when the atlas is defragmented.
+    const SkIRect& bounds() const { return bounds_; }
+
+    SkISize dimensions() const { return bounds_.size(); }
+
+    // A snapshot of the page that currently holds the region.
+    sk_sp<SkImage> page_image() const;
+
+   private:
+    friend class RasterCacheAtlas;
+
+    Region(Page* page, const SkIRect& bounds)
+        : page_(page), bounds_(bounds) {}
+
+    Page* page_;
+    SkIRect bounds_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Region);
+  };
+
+  explicit RasterCacheAtlas(int page_size = kDefaultPageSize,
+                            size_t max_page_count = kDefaultMaxPageCount,
+                            int max_entry_size = kDefaultMaxEntrySize);
+
+  ~RasterCacheAtlas();
+
+  // Whether an entry of the given size should be packed into the atlas
+  // rather than be given an image of its own.
+  bool CanHold(const SkISize& size) const;
+
+  // Reserves a region of the given size in a page that is backed by the
+  // |gr_context|, or by memory if it is null, and uses the |color_space|.
+  // Returns null if the entry is too large for the atlas or if all of the
+  // pages are full even after defragmenting them.
+  std::unique_ptr<Region> Allocate(const SkISize& size,
+                                   GrDirectContext* gr_context,
+                                   const SkColorSpace* color_space);
+
+  // Clears the |region| and calls |draw_function| with a canvas whose
+  // origin is at the top left corner of the region and which is clipped to
+  // the region.
+  void Draw(const Region& region,
+            const std::function<void(SkCanvas*)>& draw_function);
+
+  // Lets go of the pages that no longer hold any regions.
+  void ReleaseEmptyPages();
+
+  size_t page_count() const { return pages_.size(); }
+  size_t region_count() const;
+  size_t defragment_count() const { return defragment_count_; }
+
+  // The memory held by all of the pages.
+  size_t page_bytes() const;
+
+  int page_size() const { return page_size_; }
+  size_t max_page_count() const { return max_page_count_; }
+
+ private:
+  std::unique_ptr<Page> MakePage(GrDirectContext* gr_context,
+                                 const SkColorSpace* color_space) const;
+
+  std::unique_ptr<Region> AllocateInPages(const SkISize& size,
+                                          GrDirectContext* gr_context,
+                                          const SkColorSpace* color_space);
+
+  // Repacks the live regions of the pages that match the |gr_context| and
+  // |color_space| into as few new pages as possible. Returns false if that
+  // cannot free up enough space for a region of |size|.
+  bool Defragment(const SkISize& size,
+                  GrDirectContext* gr_context,
+                  const SkColorSpace* color_space);
+
+  const int page_size_;
+  const size_t max_page_count_;
+  const int max_entry_size_;
+  std::vector<std::unique_ptr<Page>> pages_;
+  size_t defragment_count_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RasterCacheAtlas);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_RASTER_CACHE_ATLAS_H_
@@ -0,0 +1,147 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/raster_cache_atlas.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+
+namespace flutter {
+namespace testing {
+
+static std::unique_ptr<RasterCacheAtlas::Region> Allocate(
+    RasterCacheAtlas& atlas,
+    int width,
+    int height) {
+  return atlas.Allocate(SkISize::Make(width, height), nullptr, nullptr);
+}
+
+static void Fill(RasterCacheAtlas& atlas,
+                 const RasterCacheAtlas::Region& region,
+                 SkColor color) {
+  atlas.Draw(region, [color](SkCanvas* canvas) { canvas->drawColor(color); });
+}
+
+static SkColor PixelAt(const RasterCacheAtlas::Region& region, int x, int y) {
+  SkBitmap bitmap;
+  bitmap.allocPixels(SkImageInfo::MakeN32Premul(1, 1));
+  EXPECT_TRUE(region.page_image()->readPixels(
+      bitmap.pixmap(), region.bounds().left() + x, region.bounds().top() + y));
+  return bitmap.getColor(0, 0);
+}
+
+TEST(RasterCacheAtlas, SmallEntriesSharePages) {
+  RasterCacheAtlas atlas(256, 2, 128);
+  auto a = Allocate(atlas, 100, 100);
+  auto b = Allocate(atlas, 100, 50);
+  auto c = Allocate(atlas, 20, 30);
+  ASSERT_TRUE(a && b && c);
+  ASSERT_EQ(atlas.page_count(), 1u);
+  ASSERT_EQ(atlas.region_count(), 3u);
+  ASSERT_EQ(a->dimensions(), SkISize::Make(100, 100));
+  ASSERT_FALSE(SkIRect::Intersects(a->bounds(), b->bounds()));
+  ASSERT_FALSE(SkIRect::Intersects(a->bounds(), c->bounds()));
+  ASSERT_FALSE(SkIRect::Intersects(b->bounds(), c->bounds()));
+  ASSERT_EQ(a->page_image(), c->page_image());
+}
+
+TEST(RasterCacheAtlas, LargeEntriesAreNotHeld) {
+  RasterCacheAtlas atlas(256, 2, 128);
+  ASSERT_TRUE(atlas.CanHold(SkISize::Make(128, 128)));
+  ASSERT_FALSE(atlas.CanHold(SkISize::Make(129, 10)));
+  ASSERT_FALSE(atlas.CanHold(SkISize::Make(0, 10)));
+  ASSERT_EQ(Allocate(atlas, 10, 200), nullptr);
+  ASSERT_EQ(atlas.page_count(), 0u);
+
+  RasterCacheAtlas no_pages(256, 0);
+  ASSERT_FALSE(no_pages.CanHold(SkISize::Make(10, 10)));
+}
+
+TEST(RasterCacheAtlas, PagesWithoutRegionsAreReleased) {
+  RasterCacheAtlas atlas(64, 2);
+  auto a = Allocate(atlas, 64, 64);
+  auto b = Allocate(atlas, 64, 64);
+  ASSERT_EQ(atlas.page_count(), 2u);
+  ASSERT_EQ(atlas.page_bytes(), 2u * 64 * 64 * 4);
+
+  a.reset();
+  atlas.ReleaseEmptyPages();
+  ASSERT_EQ(atlas.page_count(), 1u);
+  ASSERT_EQ(atlas.region_count(), 1u);
+
+  b.reset();
+  atlas.ReleaseEmptyPages();
+  ASSERT_EQ(atlas.page_count(), 0u);
+}
+
+TEST(RasterCacheAtlas, MaxPageCountIsRespected) {
+  RasterCacheAtlas atlas(64, 1);
+  std::vector<std::unique_ptr<RasterCacheAtlas::Region>> regions;
+  for (int i = 0; i < 4; i++) {
+    regions.push_back(Allocate(atlas, 32, 32));
+    ASSERT_NE(regions.back(), nullptr);
+  }
+  ASSERT_EQ(Allocate(atlas, 32, 32), nullptr);
+  ASSERT_EQ(atlas.page_count(), 1u);
+  ASSERT_EQ(atlas.defragment_count(), 0u);
+}
+
+TEST(RasterCacheAtlas, DrawIsClippedToTheRegion) {
+  RasterCacheAtlas atlas(64, 1);
+  auto a = Allocate(atlas, 16, 16);
+  auto b = Allocate(atlas, 16, 16);
+  Fill(atlas, *a, SK_ColorRED);
+  Fill(atlas, *b, SK_ColorBLUE);
+  ASSERT_EQ(PixelAt(*a, 0, 0), SK_ColorRED);
+  ASSERT_EQ(PixelAt(*a, 15, 15), SK_ColorRED);
+  ASSERT_EQ(PixelAt(*b, 0, 0), SK_ColorBLUE);
+  ASSERT_EQ(PixelAt(*b, 15, 15), SK_ColorBLUE);
+}
+
+TEST(RasterCacheAtlas, FullPagesAreDefragmented) {
+  RasterCacheAtlas atlas(64, 1);
+  SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE,
+                      SK_ColorYELLOW};
+  std::vector<std::unique_ptr<RasterCacheAtlas::Region>> regions;
+  for (SkColor color : colors) {
+    regions.push_back(Allocate(atlas, 32, 32));
+    ASSERT_NE(regions.back(), nullptr);
+    Fill(atlas, *regions.back(), color);
+  }
+
+  // The packer of the page cannot reuse the space of released regions.
+  regions[0].reset();
+  regions[2].reset();
+  auto region = Allocate(atlas, 32, 32);
+  ASSERT_NE(region, nullptr);
+  ASSERT_EQ(atlas.defragment_count(), 1u);
+  ASSERT_EQ(atlas.page_count(), 1u);
+  ASSERT_EQ(atlas.region_count(), 3u);
+
+  // The live regions kept their pixels when they moved.
+  ASSERT_EQ(PixelAt(*regions[1], 0, 0), SK_ColorGREEN);
+  ASSERT_EQ(PixelAt(*regions[1], 31, 31), SK_ColorGREEN);
+  ASSERT_EQ(PixelAt(*regions[3], 0, 0), SK_ColorYELLOW);
+  ASSERT_EQ(PixelAt(*regions[3], 31, 31), SK_ColorYELLOW);
+  ASSERT_FALSE(SkIRect::Intersects(regions[1]->bounds(), region->bounds()));
+  ASSERT_FALSE(SkIRect::Intersects(regions[3]->bounds(), region->bounds()));
+}
+
+TEST(RasterCacheAtlas, PagesAreNotSharedAcrossColorSpaces) {
+  RasterCacheAtlas atlas(64, 2);
+  auto srgb = atlas.Allocate(SkISize::Make(8, 8), nullptr,
+                             SkColorSpace::MakeSRGB().get());
+  auto linear = atlas.Allocate(SkISize::Make(8, 8), nullptr,
+                               SkColorSpace::MakeSRGBLinear().get());
+  ASSERT_TRUE(srgb && linear);
+  ASSERT_EQ(atlas.page_count(), 2u);
+  ASSERT_NE(srgb->page_image(), linear->page_image());
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,72 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/raster_cache_eviction_policy.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+void UnusedEntryEvictionPolicy::SelectEvictions(
+    const std::vector<RasterCacheEntryStats>& entries,
+    std::vector<bool>& evict) {
+  FML_DCHECK(evict.size() == entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    evict[i] = !entries[i].used_this_frame();
+  }
+}
+
+CostAwareEvictionPolicy::CostAwareEvictionPolicy(size_t byte_budget,
+                                                 size_t max_unused_frames)
+    : byte_budget_(byte_budget), max_unused_frames_(max_unused_frames) {}
+
+double CostAwareEvictionPolicy::Score(const RasterCacheEntryStats& entry) {
+  // Layers have no complexity score, so they are valued as if they were
+  // as cheap to reproduce as the cheapest pictures.
+  double cost = std::max(entry.cost, 1u);
+  // Frequency counts for less the more an entry has already been used so
+  // that a long lived entry does not outweigh everything else forever.
+  double frequency = 1.0 + std::log2(1.0 + entry.frames_used);
+  double bytes = std::max<size_t>(entry.bytes, 1);
+  return cost * frequency / (bytes * (1.0 + entry.frames_unused));
+}
+
+void CostAwareEvictionPolicy::SelectEvictions(
+    const std::vector<RasterCacheEntryStats>& entries,
+    std::vector<bool>& evict) {
+  FML_DCHECK(evict.size() == entries.size());
+  size_t total_bytes = 0;
+  std::vector<size_t> candidates;
+  for (size_t i = 0; i < entries.size(); i++) {
+    const RasterCacheEntryStats& entry = entries[i];
+    if (entry.frames_unused > max_unused_frames_) {
+      evict[i] = true;
+      continue;
+    }
+    total_bytes += entry.bytes;
+    if (!entry.used_this_frame()) {
+      candidates.push_back(i);
+    }
+  }
+  if (total_bytes <= byte_budget_) {
+    return;
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [&entries](size_t a, size_t b) {
+              return Score(entries[a]) < Score(entries[b]);
+            });
+  for (size_t i : candidates) {
+    if (total_bytes <= byte_budget_) {
+      break;
+    }
+    evict[i] = true;
+    total_bytes -= entries[i].bytes;
+  }
+}
+
+}  // namespace flutter
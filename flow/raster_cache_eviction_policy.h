@@ -0,0 +1,105 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_RASTER_CACHE_EVICTION_POLICY_H_
+#define FLUTTER_FLOW_RASTER_CACHE_EVICTION_POLICY_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+// What the RasterCache knows about one of its populated entries at the end
+// of a frame.
+struct RasterCacheEntryStats {
+  // The size of the cached image.
+  size_t bytes = 0;
+
+  // The DisplayListComplexityCalculator score of the content of the entry,
+  // or 0 if the entry caches a layer whose cost is not known.
+  unsigned int cost = 0;
+
+  // The number of frames in which the entry has been used.
+  size_t frames_used = 0;
+
+  // The number of consecutive frames, up to and including this one, in
+  // which the entry has not been used. 0 if the entry was used in this
+  // frame.
+  size_t frames_unused = 0;
+
+  bool used_this_frame() const { return frames_unused == 0; }
+};
+
+// Decides which populated RasterCache entries to let go of at the end of
+// each frame. Entries without images are always evicted as soon as a
+// frame does not use them.
+class RasterCacheEvictionPolicy {
+ public:
+  RasterCacheEvictionPolicy() = default;
+
+  virtual ~RasterCacheEvictionPolicy() = default;
+
+  // Sets |evict|[i] to true for each of the |entries| that should be
+  // evicted. |evict| has the same size as |entries| and starts out false.
+  virtual void SelectEvictions(
+      const std::vector<RasterCacheEntryStats>& entries,
+      std::vector<bool>& evict) = 0;
+
+ private:
+  FML_DISALLOW_COPY_AND_ASSIGN(RasterCacheEvictionPolicy);
+};
+
+// Evicts every entry that was not used in the frame, which is the
+// historic behavior of the RasterCache.
+class UnusedEntryEvictionPolicy : public RasterCacheEvictionPolicy {
+ public:
+  UnusedEntryEvictionPolicy() = default;
+
+  void SelectEvictions(const std::vector<RasterCacheEntryStats>& entries,
+                       std::vector<bool>& evict) override;
+
+ private:
+  FML_DISALLOW_COPY_AND_ASSIGN(UnusedEntryEvictionPolicy);
+};
+
+// Keeps entries that are not being used for up to |max_unused_frames| as
+// long as all of the entries fit within |byte_budget|, so that expensive
+// pictures survive short periods off screen such as a tab switch.
+//
+// When the entries do not fit, the unused entries are ranked by the cost
+// of producing them and by how often they have been used, per byte of
+// memory that they hold, with a decay for each frame they go unused, and
+// are evicted from the lowest ranked up until the rest fit. Entries used
+// in the frame are never evicted, so they may go over the budget on their
+// own.
+class CostAwareEvictionPolicy : public RasterCacheEvictionPolicy {
+ public:
+  // Roughly 2 seconds at 60 frames per second.
+  static constexpr size_t kDefaultMaxUnusedFrames = 120;
+
+  explicit CostAwareEvictionPolicy(
+      size_t byte_budget,
+      size_t max_unused_frames = kDefaultMaxUnusedFrames);
+
+  void SelectEvictions(const std::vector<RasterCacheEntryStats>& entries,
+                       std::vector<bool>& evict) override;
+
+  // The value of keeping an entry per byte. Higher values are kept longer.
+  static double Score(const RasterCacheEntryStats& entry);
+
+  size_t byte_budget() const { return byte_budget_; }
+  size_t max_unused_frames() const { return max_unused_frames_; }
+
+ private:
+  const size_t byte_budget_;
+  const size_t max_unused_frames_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(CostAwareEvictionPolicy);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_RASTER_CACHE_EVICTION_POLICY_H_
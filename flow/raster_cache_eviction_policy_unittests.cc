@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/raster_cache_eviction_policy.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static RasterCacheEntryStats MakeStats(size_t bytes,
+                                       unsigned int cost,
+                                       size_t frames_used,
+                                       size_t frames_unused) {
+  return {
+      .bytes = bytes,
+      .cost = cost,
+      .frames_used = frames_used,
+      .frames_unused = frames_unused,
+  };
+}
+
+static std::vector<bool> SelectEvictions(
+    RasterCacheEvictionPolicy& policy,
+    const std::vector<RasterCacheEntryStats>& entries) {
+  std::vector<bool> evict(entries.size(), false);
+  policy.SelectEvictions(entries, evict);
+  return evict;
+}
+
+TEST(RasterCacheEvictionPolicy, UnusedEntryPolicyEvictsUnusedEntries) {
+  UnusedEntryEvictionPolicy policy;
+  std::vector<RasterCacheEntryStats> entries = {
+      MakeStats(100, 1000, 10, 0),
+      MakeStats(100, 1000, 10, 1),
+      MakeStats(1, 1, 1, 0),
+  };
+  std::vector<bool> expected = {false, true, false};
+  ASSERT_EQ(SelectEvictions(policy, entries), expected);
+}
+
+TEST(RasterCacheEvictionPolicy, CostAwarePolicyKeepsUnusedEntriesInBudget) {
+  CostAwareEvictionPolicy policy(1000);
+  std::vector<RasterCacheEntryStats> entries = {
+      MakeStats(400, 1000, 10, 0),
+      MakeStats(400, 1000, 10, 5),
+      MakeStats(200, 10, 1, 1),
+  };
+  std::vector<bool> expected = {false, false, false};
+  ASSERT_EQ(SelectEvictions(policy, entries), expected);
+}
+
+TEST(RasterCacheEvictionPolicy, CostAwarePolicyEvictsLongUnusedEntries) {
+  CostAwareEvictionPolicy policy(1000, 3);
+  std::vector<RasterCacheEntryStats> entries = {
+      MakeStats(10, 1000, 10, 3),
+      MakeStats(10, 1000, 10, 4),
+  };
+  std::vector<bool> expected = {false, true};
+  ASSERT_EQ(SelectEvictions(policy, entries), expected);
+}
+
+TEST(RasterCacheEvictionPolicy, CostAwarePolicyEvictsLowestScoresFirst) {
+  CostAwareEvictionPolicy policy(1000);
+  std::vector<RasterCacheEntryStats> entries = {
+      // Expensive, frequently used and recently seen.
+      MakeStats(400, 5000, 30, 1),
+      // Cheap to reproduce.
+      MakeStats(400, 10, 30, 1),
+      // Just as expensive as the first one but unused for longer.
+      MakeStats(400, 5000, 30, 20),
+  };
+  ASSERT_LT(CostAwareEvictionPolicy::Score(entries[1]),
+            CostAwareEvictionPolicy::Score(entries[2]));
+  ASSERT_LT(CostAwareEvictionPolicy::Score(entries[2]),
+            CostAwareEvictionPolicy::Score(entries[0]));
+
+  // Evicting the cheap entry brings the cache back within the budget.
+  std::vector<bool> expected = {false, true, false};
+  ASSERT_EQ(SelectEvictions(policy, entries), expected);
+
+  // A smaller budget also requires the stale entry to go.
+  CostAwareEvictionPolicy smaller_policy(500);
+  expected = {false, true, true};
+  ASSERT_EQ(SelectEvictions(smaller_policy, entries), expected);
+}
+
+TEST(RasterCacheEvictionPolicy, CostAwarePolicyNeverEvictsUsedEntries) {
+  CostAwareEvictionPolicy policy(100);
+  std::vector<RasterCacheEntryStats> entries = {
+      MakeStats(400, 1, 1, 0),
+      MakeStats(400, 1, 1, 0),
+      MakeStats(50, 5000, 100, 1),
+  };
+  std::vector<bool> expected = {false, false, true};
+  ASSERT_EQ(SelectEvictions(policy, entries), expected);
+}
+
+}  // namespace testing
+}  // namespace flutter
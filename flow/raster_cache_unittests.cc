@@ -2,15 +2,20 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <limits>
+
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_builder.h"
 #include "flutter/display_list/display_list_test_utils.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/raster_cache_item.h"
 #include "flutter/flow/testing/mock_raster_cache.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/waitable_event.h"
 #include "gtest/gtest.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPoint.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPaint.h"
 #include "third_party/skia/include/core/SkPicture.h"
@@ -327,6 +332,335 @@ TEST(RasterCache, SweepsRemoveUnusedDisplayLists) {
   ASSERT_FALSE(display_list_item.Draw(paint_context, &dummy_canvas, &paint));
 }
 
+TEST(RasterCache, CostAwareEvictionPolicyRetainsUnusedDisplayLists) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetEvictionPolicy(std::make_unique<CostAwareEvictionPolicy>(
+      std::numeric_limits<size_t>::max(), 2));
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas;
+  SkPaint paint;
+
+  PrerollContextHolder preroll_context_holder =
+      GetSamplePrerollContextHolder(&cache);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(&cache);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  cache.PrepareNewFrame();
+
+  DisplayListRasterCacheItem display_list_item(display_list.get(), SkPoint(),
+                                               true, false);
+
+  ASSERT_FALSE(DisplayListRasterCacheItemTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+
+  cache.CleanupAfterFrame();
+  cache.PrepareNewFrame();
+
+  ASSERT_TRUE(DisplayListRasterCacheItemTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  ASSERT_TRUE(display_list_item.Draw(paint_context, &dummy_canvas, &paint));
+
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.picture_metrics().in_use_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().retained_count, 0u);
+
+  // Two frames without an access keep the image around.
+  for (int i = 0; i < 2; i++) {
+    cache.PrepareNewFrame();
+    cache.CleanupAfterFrame();
+    ASSERT_EQ(cache.picture_metrics().in_use_count, 0u);
+    ASSERT_EQ(cache.picture_metrics().retained_count, 1u);
+  }
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(
+      cache.Draw(display_list_item.GetId().value(), dummy_canvas, &paint));
+  cache.CleanupAfterFrame();
+
+  // Three frames without an access exceed the maximum of the policy.
+  for (int i = 0; i < 3; i++) {
+    cache.PrepareNewFrame();
+    cache.CleanupAfterFrame();
+  }
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 1u);
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(
+      cache.Draw(display_list_item.GetId().value(), dummy_canvas, &paint));
+}
+
+// Caches the sample DisplayList, draws it from the cache at an offset and
+// returns the pixels that were drawn.
+static SkBitmap DrawSampleDisplayListFromCache(RasterCache& cache) {
+  SkMatrix matrix = SkMatrix::Translate(7, 3);
+
+  auto display_list = GetSampleDisplayList();
+
+  PrerollContextHolder preroll_context_holder =
+      GetSamplePrerollContextHolder(&cache);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(&cache);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item(display_list.get(), SkPoint(),
+                                               true, false);
+  cache.PrepareNewFrame();
+  EXPECT_FALSE(DisplayListRasterCacheItemTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  cache.CleanupAfterFrame();
+  cache.PrepareNewFrame();
+  EXPECT_TRUE(DisplayListRasterCacheItemTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(160, 120);
+  bitmap.eraseColor(SK_ColorTRANSPARENT);
+  SkCanvas canvas(bitmap);
+  canvas.setMatrix(matrix);
+  EXPECT_TRUE(cache.Draw(display_list_item.GetId().value(), canvas, nullptr));
+  cache.CleanupAfterFrame();
+  return bitmap;
+}
+
+TEST(RasterCache, AtlasEntriesDrawTheSameAsStandaloneEntries) {
+  flutter::RasterCache standalone_cache(1);
+  SkBitmap expected = DrawSampleDisplayListFromCache(standalone_cache);
+
+  flutter::RasterCache atlas_cache(1);
+  atlas_cache.SetAtlas(std::make_unique<RasterCacheAtlas>(256, 1));
+  SkBitmap actual = DrawSampleDisplayListFromCache(atlas_cache);
+  ASSERT_EQ(atlas_cache.atlas()->region_count(), 1u);
+  ASSERT_EQ(atlas_cache.picture_metrics().in_use_count, 1u);
+  // 80w * 80h * 4bpp
+  ASSERT_EQ(atlas_cache.picture_metrics().in_use_bytes, 25600u);
+
+  for (int y = 0; y < expected.height(); y++) {
+    for (int x = 0; x < expected.width(); x++) {
+      ASSERT_EQ(expected.getColor(x, y), actual.getColor(x, y))
+          << "at " << x << ", " << y;
+    }
+  }
+
+  // Evicting the entry gives its page back.
+  atlas_cache.PrepareNewFrame();
+  atlas_cache.CleanupAfterFrame();
+  ASSERT_EQ(atlas_cache.atlas()->region_count(), 0u);
+  ASSERT_EQ(atlas_cache.atlas()->page_count(), 0u);
+}
+
+// Waits until the single worker of the |task_runner| has run every task
+// that was posted before this call.
+static void FlushWorker(
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& task_runner) {
+  fml::AutoResetWaitableEvent flushed;
+  task_runner->PostTask([&flushed]() { flushed.Signal(); });
+  flushed.Wait();
+}
+
+TEST(RasterCache, AsyncRasterizationSwapsInFinishedEntries) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetAsyncTaskRunner(task_runner);
+  ASSERT_TRUE(cache.async_rasterization_enabled());
+
+  SkMatrix matrix = SkMatrix::I();
+  auto display_list = GetSampleDisplayList();
+  ASSERT_FALSE(display_list->may_have_texture_images());
+
+  SkCanvas dummy_canvas;
+  SkPaint paint;
+
+  PrerollContextHolder preroll_context_holder =
+      GetSamplePrerollContextHolder(&cache);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(&cache);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  cache.PrepareNewFrame();
+  DisplayListRasterCacheItem display_list_item(display_list.get(), SkPoint(),
+                                               true, false);
+  ASSERT_FALSE(DisplayListRasterCacheItemTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  ASSERT_FALSE(display_list_item.Draw(paint_context, &dummy_canvas, &paint));
+  cache.CleanupAfterFrame();
+
+  // Hold the worker so that the entry is still pending at the end of the
+  // frame in which it was queued.
+  fml::AutoResetWaitableEvent release_worker;
+  task_runner->PostTask([&release_worker]() { release_worker.Wait(); });
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(DisplayListRasterCacheItemTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  ASSERT_FALSE(display_list_item.Draw(paint_context, &dummy_canvas, &paint));
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.async_metrics().pending_count, 1u);
+  ASSERT_EQ(cache.async_metrics().completed_count, 0u);
+  ASSERT_EQ(cache.picture_metrics().total_count(), 0u);
+
+  release_worker.Signal();
+  FlushWorker(task_runner);
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(DisplayListRasterCacheItemTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  ASSERT_TRUE(display_list_item.Draw(paint_context, &dummy_canvas, &paint));
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.async_metrics().pending_count, 0u);
+  ASSERT_EQ(cache.async_metrics().completed_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+  // 150w * 100h * 4bpp
+  ASSERT_EQ(cache.picture_metrics().total_bytes(), 25600u);
+}
+
+TEST(RasterCache, AsyncRasterizationOfEvictedEntryIsAbandoned) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetAsyncTaskRunner(task_runner);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto display_list = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas;
+  SkPaint paint;
+
+  PrerollContextHolder preroll_context_holder =
+      GetSamplePrerollContextHolder(&cache);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(&cache);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  cache.PrepareNewFrame();
+  DisplayListRasterCacheItem display_list_item(display_list.get(), SkPoint(),
+                                               true, false);
+  ASSERT_FALSE(DisplayListRasterCacheItemTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  ASSERT_FALSE(display_list_item.Draw(paint_context, &dummy_canvas, &paint));
+  cache.CleanupAfterFrame();
+
+  fml::AutoResetWaitableEvent release_worker;
+  task_runner->PostTask([&release_worker]() { release_worker.Wait(); });
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(DisplayListRasterCacheItemTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.async_metrics().pending_count, 1u);
+
+  // A frame that does not use the entry evicts it while it is pending.
+  cache.PrepareNewFrame();
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.async_metrics().pending_count, 0u);
+  ASSERT_EQ(cache.async_metrics().abandoned_count, 1u);
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 0u);
+
+  release_worker.Signal();
+  FlushWorker(task_runner);
+
+  cache.PrepareNewFrame();
+  ASSERT_FALSE(
+      cache.Draw(display_list_item.GetId().value(), dummy_canvas, &paint));
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.async_metrics().completed_count, 0u);
+  ASSERT_EQ(cache.async_metrics().abandoned_count, 0u);
+}
+
+TEST(RasterCache, DestructionDoesNotWaitForAsyncRasterization) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+  SkMatrix matrix = SkMatrix::I();
+  auto display_list = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas;
+  SkPaint paint;
+
+  // Hold the worker so that the entry is still pending when the cache is
+  // destroyed.
+  fml::AutoResetWaitableEvent release_worker;
+  task_runner->PostTask([&release_worker]() { release_worker.Wait(); });
+
+  {
+    size_t threshold = 1;
+    flutter::RasterCache cache(threshold);
+    cache.SetAsyncTaskRunner(task_runner);
+
+    PrerollContextHolder preroll_context_holder =
+        GetSamplePrerollContextHolder(&cache);
+    PaintContextHolder paint_context_holder =
+        GetSamplePaintContextHolder(&cache);
+    auto& preroll_context = preroll_context_holder.preroll_context;
+    auto& paint_context = paint_context_holder.paint_context;
+
+    DisplayListRasterCacheItem display_list_item(display_list.get(),
+                                                 SkPoint(), true, false);
+    for (int i = 0; i < 2; i++) {
+      cache.PrepareNewFrame();
+      ASSERT_FALSE(DisplayListRasterCacheItemTryToRasterCache(
+          display_list_item, preroll_context, paint_context, matrix));
+      ASSERT_FALSE(
+          display_list_item.Draw(paint_context, &dummy_canvas, &paint));
+      cache.CleanupAfterFrame();
+    }
+    ASSERT_EQ(cache.async_metrics().pending_count, 1u);
+  }
+
+  // The job still runs, and lets go of its result, once the worker is free.
+  release_worker.Signal();
+  FlushWorker(task_runner);
+}
+
+TEST(RasterCache, DisplayListWithTextureImagesIsRasterizedSynchronously) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetAsyncTaskRunner(loop->GetTaskRunner());
+
+  SkMatrix matrix = SkMatrix::I();
+  // Nested pictures cannot be inspected for texture images.
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(150, 100))
+      ->drawRect(SkRect::MakeXYWH(10, 10, 80, 80), SkPaint());
+  DisplayListBuilder builder(SkRect::MakeWH(150, 100));
+  builder.drawPicture(recorder.finishRecordingAsPicture(), nullptr, false);
+  auto display_list = builder.Build();
+  ASSERT_TRUE(display_list->may_have_texture_images());
+
+  SkCanvas dummy_canvas;
+  SkPaint paint;
+
+  PrerollContextHolder preroll_context_holder =
+      GetSamplePrerollContextHolder(&cache);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(&cache);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  cache.PrepareNewFrame();
+  DisplayListRasterCacheItem display_list_item(display_list.get(), SkPoint(),
+                                               true, false);
+  ASSERT_FALSE(DisplayListRasterCacheItemTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  ASSERT_FALSE(display_list_item.Draw(paint_context, &dummy_canvas, &paint));
+  cache.CleanupAfterFrame();
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(DisplayListRasterCacheItemTryToRasterCache(
+      display_list_item, preroll_context, paint_context, matrix));
+  ASSERT_TRUE(display_list_item.Draw(paint_context, &dummy_canvas, &paint));
+  cache.CleanupAfterFrame();
+  ASSERT_EQ(cache.async_metrics().pending_count, 0u);
+  ASSERT_EQ(cache.async_metrics().completed_count, 0u);
+}
+
 TEST(RasterCache, ComputeDeviceRectBasedOnFractionalTranslation) {
   SkRect logical_rect = SkRect::MakeLTRB(0, 0, 300.2, 300.3);
   SkMatrix ctm = SkMatrix::MakeAll(2.0, 0, 0, 0, 2.0, 0, 0, 0, 1);
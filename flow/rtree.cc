@@ -4,50 +4,271 @@
 
 #include "rtree.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <list>
+#include <utility>
 
 #include "flutter/fml/logging.h"
 #include "third_party/skia/include/core/SkBBHFactory.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLUTTER_RTREE_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define FLUTTER_RTREE_NEON 1
+#endif
+
 namespace flutter {
 
-RTree::RTree() : bbh_{SkRTreeFactory{}()}, all_ops_count_(0) {}
+namespace {
+
+struct Entry {
+  SkRect bounds;
+  int32_t id;
+};
+
+}  // namespace
+
+RTree::RTree() : leaf_node_count_(0), all_ops_count_(0) {}
+
+// Packs the |entries| into nodes of up to |RTree::kNodeWidth| entries using
+// the Sort-Tile-Recursive algorithm: the entries are sorted into vertical
+// slices by their centers and each slice is then sorted top to bottom, so
+// that runs of consecutive entries are close together.
+template <typename Node>
+static void PackLevel(std::vector<Entry>* entries, std::vector<Node>* nodes) {
+  constexpr int kWidth = RTree::kNodeWidth;
+  const size_t count = entries->size();
+  const size_t node_count = (count + kWidth - 1) / kWidth;
+  const size_t slice_count = static_cast<size_t>(
+      std::ceil(std::sqrt(static_cast<double>(node_count))));
+  const size_t slice_size = slice_count * kWidth;
+
+  std::sort(entries->begin(), entries->end(),
+            [](const Entry& a, const Entry& b) {
+              return a.bounds.centerX() < b.bounds.centerX();
+            });
+  for (size_t start = 0; start < count; start += slice_size) {
+    auto end = entries->begin() + std::min(count, start + slice_size);
+    std::sort(entries->begin() + start, end,
+              [](const Entry& a, const Entry& b) {
+                return a.bounds.centerY() < b.bounds.centerY();
+              });
+  }
+
+  constexpr float kInfinity = std::numeric_limits<float>::infinity();
+  for (size_t start = 0; start < count; start += kWidth) {
+    Node node;
+    for (int i = 0; i < kWidth; i++) {
+      if (start + i < count) {
+        const Entry& entry = (*entries)[start + i];
+        node.left[i] = entry.bounds.fLeft;
+        node.top[i] = entry.bounds.fTop;
+        node.right[i] = entry.bounds.fRight;
+        node.bottom[i] = entry.bounds.fBottom;
+        node.child[i] = entry.id;
+      } else {
+        node.left[i] = node.top[i] = kInfinity;
+        node.right[i] = node.bottom[i] = -kInfinity;
+        node.child[i] = -1;
+      }
+    }
+    nodes->push_back(node);
+  }
+}
 
 void RTree::insert(const SkRect boundsArray[],
                    const SkBBoxHierarchy::Metadata metadata[],
                    int N) {
   FML_DCHECK(0 == all_ops_count_);
-  bbh_->insert(boundsArray, metadata, N);
+  FML_DCHECK(N >= 0);
+  all_ops_count_ = N;
+  is_draw_op_.assign(N, false);
+
+  std::vector<Entry> entries;
+  entries.reserve(N);
   for (int i = 0; i < N; i++) {
+    SkRect bounds = boundsArray[i];
+    bounds.sort();
+    if (bounds.isEmpty()) {
+      continue;
+    }
+    entries.push_back({bounds, i});
     if (metadata != nullptr && metadata[i].isDraw) {
-      draw_op_[i] = boundsArray[i];
+      is_draw_op_[i] = true;
     }
   }
-  all_ops_count_ = N;
+  if (entries.empty()) {
+    return;
+  }
+
+  // Each level holds a quarter as many nodes as the level below it.
+  size_t node_count = 0;
+  for (size_t level = entries.size(); level > 1;) {
+    level = (level + kNodeWidth - 1) / kNodeWidth;
+    node_count += level;
+  }
+  nodes_.reserve(std::max<size_t>(node_count, 1));
+
+  PackLevel(&entries, &nodes_);
+  leaf_node_count_ = static_cast<int>(nodes_.size());
+
+  // Build each level of interior nodes from the bounds of the nodes of
+  // the level below until we end up with a single root node.
+  size_t level_start = 0;
+  while (nodes_.size() - level_start > 1) {
+    size_t level_end = nodes_.size();
+    entries.clear();
+    for (size_t i = level_start; i < level_end; i++) {
+      const Node& node = nodes_[i];
+      SkRect bounds = SkRect::MakeEmpty();
+      for (int j = 0; j < kNodeWidth && node.child[j] >= 0; j++) {
+        bounds.join(SkRect::MakeLTRB(node.left[j], node.top[j], node.right[j],
+                                     node.bottom[j]));
+      }
+      entries.push_back({bounds, static_cast<int32_t>(i)});
+    }
+    PackLevel(&entries, &nodes_);
+    level_start = level_end;
+  }
 }
 
 void RTree::insert(const SkRect boundsArray[], int N) {
   insert(boundsArray, nullptr, N);
 }
 
+uint32_t RTree::IntersectMask(const Node& node, const SkRect& query) {
+#if defined(FLUTTER_RTREE_SSE2)
+  static_assert(kNodeWidth == 4, "One SSE register holds a node");
+  __m128 hits = _mm_and_ps(
+      _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(node.left),
+                              _mm_set1_ps(query.fRight)),
+                 _mm_cmplt_ps(_mm_set1_ps(query.fLeft),
+                              _mm_loadu_ps(node.right))),
+      _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(node.top),
+                              _mm_set1_ps(query.fBottom)),
+                 _mm_cmplt_ps(_mm_set1_ps(query.fTop),
+                              _mm_loadu_ps(node.bottom))));
+  return static_cast<uint32_t>(_mm_movemask_ps(hits));
+#elif defined(FLUTTER_RTREE_NEON)
+  static_assert(kNodeWidth == 4, "One NEON register holds a node");
+  uint32x4_t hits = vandq_u32(
+      vandq_u32(vcltq_f32(vld1q_f32(node.left), vdupq_n_f32(query.fRight)),
+                vcltq_f32(vdupq_n_f32(query.fLeft), vld1q_f32(node.right))),
+      vandq_u32(vcltq_f32(vld1q_f32(node.top), vdupq_n_f32(query.fBottom)),
+                vcltq_f32(vdupq_n_f32(query.fTop), vld1q_f32(node.bottom))));
+  static const uint32_t kLaneBits[4] = {1, 2, 4, 8};
+  return vaddvq_u32(vandq_u32(hits, vld1q_u32(kLaneBits)));
+#else
+  uint32_t mask = 0;
+  for (int i = 0; i < kNodeWidth; i++) {
+    if (node.left[i] < query.fRight && query.fLeft < node.right[i] &&
+        node.top[i] < query.fBottom && query.fTop < node.bottom[i]) {
+      mask |= 1u << i;
+    }
+  }
+  return mask;
+#endif
+}
+
 void RTree::search(const SkRect& query, std::vector<int>* results) const {
-  bbh_->search(query, results);
+  size_t start = results->size();
+  visit(query, [results](int index, const SkRect&) {
+    results->push_back(index);
+  });
+  std::sort(results->begin() + start, results->end());
+}
+
+void RTree::search(const SkRect queries[],
+                   int count,
+                   std::vector<int> results[]) const {
+  if (nodes_.empty()) {
+    return;
+  }
+  std::vector<size_t> starts(count);
+  for (int q = 0; q < count; q++) {
+    starts[q] = results[q].size();
+  }
+
+  // The queries are processed in groups of up to 32, with a bit mask of
+  // the queries of the group that overlap each node on the stack.
+  constexpr int kGroupSize = 32;
+  for (int group = 0; group < count; group += kGroupSize) {
+    int group_count = std::min(kGroupSize, count - group);
+    uint32_t group_mask = 0;
+    for (int q = 0; q < group_count; q++) {
+      if (!queries[group + q].isEmpty()) {
+        group_mask |= 1u << q;
+      }
+    }
+
+    std::array<std::pair<int32_t, uint32_t>, kMaxStackDepth> stack;
+    int stack_size = 0;
+    if (group_mask != 0) {
+      stack[stack_size++] = {static_cast<int32_t>(nodes_.size()) - 1,
+                             group_mask};
+    }
+    while (stack_size > 0) {
+      auto [node_index, query_mask] = stack[--stack_size];
+      const Node& node = nodes_[node_index];
+      uint32_t entry_queries[kNodeWidth] = {};
+      for (int q = 0; query_mask != 0; q++, query_mask >>= 1) {
+        if ((query_mask & 1) == 0) {
+          continue;
+        }
+        uint32_t mask = IntersectMask(node, queries[group + q]);
+        for (int i = 0; mask != 0; i++, mask >>= 1) {
+          if (mask & 1) {
+            entry_queries[i] |= 1u << q;
+          }
+        }
+      }
+      bool is_leaf = node_index < leaf_node_count_;
+      for (int i = 0; i < kNodeWidth; i++) {
+        if (entry_queries[i] == 0) {
+          continue;
+        }
+        if (is_leaf) {
+          uint32_t mask = entry_queries[i];
+          for (int q = 0; mask != 0; q++, mask >>= 1) {
+            if (mask & 1) {
+              results[group + q].push_back(node.child[i]);
+            }
+          }
+        } else {
+          FML_DCHECK(stack_size < kMaxStackDepth);
+          stack[stack_size++] = {node.child[i], entry_queries[i]};
+        }
+      }
+    }
+  }
+
+  for (int q = 0; q < count; q++) {
+    std::sort(results[q].begin() + starts[q], results[q].end());
+  }
 }
 
 std::list<SkRect> RTree::searchNonOverlappingDrawnRects(
     const SkRect& query) const {
-  // Get the indexes for the operations that intersect with the query rect.
-  std::vector<int> intermediary_results;
-  search(query, &intermediary_results);
-
-  std::list<SkRect> final_results;
-  for (int index : intermediary_results) {
-    auto draw_op = draw_op_.find(index);
+  // Get the operations that draw something and intersect with the query
+  // rect, in the order in which they were recorded.
+  std::vector<std::pair<int, SkRect>> intermediary_results;
+  visit(query, [this, &intermediary_results](int index, const SkRect& rect) {
     // Ignore records that don't draw anything.
-    if (draw_op == draw_op_.end()) {
-      continue;
+    if (is_draw_op_[index]) {
+      intermediary_results.emplace_back(index, rect);
     }
-    auto current_record_rect = draw_op->second;
+  });
+  std::sort(intermediary_results.begin(), intermediary_results.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  std::list<SkRect> final_results;
+  for (const auto& intermediary_result : intermediary_results) {
+    const SkRect& current_record_rect = intermediary_result.second;
     auto replaced_existing_rect = false;
     // // If the current record rect intersects with any of the rects in the
     // // result list, then join them, and update the rect in final_results.
@@ -82,7 +303,8 @@ std::list<SkRect> RTree::searchNonOverlappingDrawnRects(
 }
 
 size_t RTree::bytesUsed() const {
-  return bbh_->bytesUsed();
+  return sizeof(*this) + nodes_.capacity() * sizeof(Node) +
+         is_draw_op_.capacity() / 8;
 }
 
 RTreeFactory::RTreeFactory() {
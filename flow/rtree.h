@@ -5,28 +5,57 @@
 #ifndef FLUTTER_FLOW_RTREE_H_
 #define FLUTTER_FLOW_RTREE_H_
 
+#include <array>
+#include <cstdint>
 #include <list>
-#include <map>
+#include <vector>
 
+#include "flutter/fml/logging.h"
 #include "third_party/skia/include/core/SkBBHFactory.h"
 #include "third_party/skia/include/core/SkTypes.h"
 
 namespace flutter {
 /**
- * An R-Tree implementation that forwards calls to an SkRTree.
+ * A packed, bulk-loaded R-Tree.
+ *
+ * All of the rects are inserted in a single call, which sorts them into
+ * nodes of |kNodeWidth| entries using the Sort-Tile-Recursive algorithm.
+ * The entries of each node are stored as arrays of lefts, tops, rights and
+ * bottoms so that a query is tested against all of the entries of a node
+ * with a handful of SIMD instructions where SSE2 or NEON is available.
  *
  * This implementation provides a searchNonOverlappingDrawnRects method,
  * which can be used to query the rects for the operations recorded in the tree.
  */
 class RTree : public SkBBoxHierarchy {
  public:
+  static constexpr int kNodeWidth = 4;
+
   RTree();
 
   void insert(const SkRect[],
               const SkBBoxHierarchy::Metadata[],
               int N) override;
   void insert(const SkRect[], int N) override;
+
+  // Finds the indices of the rects that intersect the query rect, in
+  // increasing order as required for SkPicture playback.
   void search(const SkRect& query, std::vector<int>* results) const override;
+
+  // Runs a search for each of the |count| queries in a single walk of the
+  // tree, appending the matching indices for |queries[i]| to |results[i]|
+  // in increasing order. This is cheaper than |count| separate searches
+  // when the queries are near each other.
+  void search(const SkRect queries[],
+              int count,
+              std::vector<int> results[]) const;
+
+  // Calls |visitor(index, bounds)| for each rect that intersects the query
+  // rect without allocating any memory. The rects are visited in the
+  // spatial order of the tree rather than in the order of insertion.
+  template <typename Visitor>
+  void visit(const SkRect& query, Visitor&& visitor) const;
+
   size_t bytesUsed() const override;
 
   // Finds the rects in the tree that represent drawing operations and intersect
@@ -41,13 +70,64 @@ class RTree : public SkBBoxHierarchy {
   int getCount() const { return all_ops_count_; }
 
  private:
-  // A map containing the draw operation rects keyed off the operation index
-  // in the insert call.
-  std::map<int, SkRect> draw_op_;
-  sk_sp<SkBBoxHierarchy> bbh_;
+  // The entries of a node, stored as a structure of arrays. Unused entries
+  // have inverted infinite bounds so that they never intersect a query.
+  struct alignas(16) Node {
+    float left[kNodeWidth];
+    float top[kNodeWidth];
+    float right[kNodeWidth];
+    float bottom[kNodeWidth];
+    // The index of the child node of each entry, or for the nodes of the
+    // bottom level, the index of the inserted rect.
+    int32_t child[kNodeWidth];
+  };
+
+  // Deep enough for the stack of a depth first walk of any tree that can
+  // be indexed with an int.
+  static constexpr int kMaxStackDepth = 64;
+
+  // Returns a bit mask of the entries of the |node| that intersect the
+  // |query|, with bit i set for entry i.
+  static uint32_t IntersectMask(const Node& node, const SkRect& query);
+
+  // The nodes of each level of the tree, bottom level first, so that the
+  // root is the last node and all nodes below |leaf_node_count_| hold
+  // the inserted rects.
+  std::vector<Node> nodes_;
+  int leaf_node_count_;
+  std::vector<bool> is_draw_op_;
   int all_ops_count_;
 };
 
+template <typename Visitor>
+void RTree::visit(const SkRect& query, Visitor&& visitor) const {
+  if (nodes_.empty() || query.isEmpty()) {
+    return;
+  }
+  std::array<int32_t, kMaxStackDepth> stack;
+  int stack_size = 0;
+  stack[stack_size++] = static_cast<int32_t>(nodes_.size()) - 1;
+  while (stack_size > 0) {
+    int32_t node_index = stack[--stack_size];
+    const Node& node = nodes_[node_index];
+    uint32_t mask = IntersectMask(node, query);
+    bool is_leaf = node_index < leaf_node_count_;
+    for (int i = 0; mask != 0; i++, mask >>= 1) {
+      if ((mask & 1) == 0) {
+        continue;
+      }
+      if (is_leaf) {
+        visitor(static_cast<int>(node.child[i]),
+                SkRect::MakeLTRB(node.left[i], node.top[i], node.right[i],
+                                 node.bottom[i]));
+      } else {
+        FML_DCHECK(stack_size < kMaxStackDepth);
+        stack[stack_size++] = node.child[i];
+      }
+    }
+  }
+}
+
 class RTreeFactory : public SkBBHFactory {
  public:
   RTreeFactory();
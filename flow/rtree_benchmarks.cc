@@ -0,0 +1,193 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/rtree.h"
+
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkRRect.h"
+
+namespace flutter {
+namespace {
+
+constexpr SkScalar kWidth = 1080;
+constexpr SkScalar kRowHeight = 72;
+
+// Captures the bounds that a picture recorder inserts into its bounding
+// box hierarchy so that the same bounds can be inserted into each kind of
+// tree that is being measured.
+class BoundsCapture : public SkBBoxHierarchy {
+ public:
+  void insert(const SkRect rects[], const Metadata metadata[], int N) override {
+    rects_.assign(rects, rects + N);
+    if (metadata != nullptr) {
+      metadata_.assign(metadata, metadata + N);
+    } else {
+      metadata_.assign(N, {true});
+    }
+  }
+  void insert(const SkRect rects[], int N) override {
+    insert(rects, nullptr, N);
+  }
+  void search(const SkRect& query, std::vector<int>* results) const override {}
+  size_t bytesUsed() const override { return 0; }
+
+  const std::vector<SkRect>& rects() const { return rects_; }
+  const std::vector<Metadata>& metadata() const { return metadata_; }
+
+ private:
+  std::vector<SkRect> rects_;
+  std::vector<Metadata> metadata_;
+};
+
+class BoundsCaptureFactory : public SkBBHFactory {
+ public:
+  BoundsCaptureFactory() : capture_(sk_make_sp<BoundsCapture>()) {}
+  sk_sp<SkBBoxHierarchy> operator()() const override { return capture_; }
+  const sk_sp<BoundsCapture>& capture() const { return capture_; }
+
+ private:
+  sk_sp<BoundsCapture> capture_;
+};
+
+// Records a long scrolling list whose rows hold an avatar, a couple of
+// lines of text and a divider, much like a typical application list, and
+// returns the bounds of the recorded operations.
+sk_sp<BoundsCapture> GetListPictureBounds(int row_count) {
+  BoundsCaptureFactory factory;
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(
+      SkRect::MakeWH(kWidth, kRowHeight * row_count), &factory);
+  SkPaint paint;
+  for (int row = 0; row < row_count; row++) {
+    canvas->save();
+    canvas->translate(0, row * kRowHeight);
+    canvas->clipRect(SkRect::MakeWH(kWidth, kRowHeight));
+    paint.setColor(row % 2 ? SK_ColorWHITE : 0xFFF5F5F5);
+    canvas->drawRect(SkRect::MakeWH(kWidth, kRowHeight), paint);
+    paint.setColor(0xFF2196F3);
+    canvas->drawOval(SkRect::MakeXYWH(16, 12, 48, 48), paint);
+    paint.setColor(SK_ColorBLACK);
+    canvas->drawRect(SkRect::MakeXYWH(80, 14, 300 + (row * 37) % 400, 18),
+                     paint);
+    paint.setColor(SK_ColorGRAY);
+    canvas->drawRect(SkRect::MakeXYWH(80, 40, 200 + (row * 53) % 500, 14),
+                     paint);
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(980, 20, 80, 32),
+                                          16, 16),
+                      paint);
+    canvas->drawLine(80, kRowHeight - 1, kWidth, kRowHeight - 1, paint);
+    canvas->restore();
+  }
+  recorder.finishRecordingAsPicture();
+  return factory.capture();
+}
+
+// A viewport sized query for each scroll offset of the list.
+std::vector<SkRect> GetViewportQueries(int row_count) {
+  std::vector<SkRect> queries;
+  SkScalar height = kRowHeight * row_count;
+  for (SkScalar y = 0; y + 1920 <= height; y += 97) {
+    queries.push_back(SkRect::MakeXYWH(0, y, kWidth, 1920));
+  }
+  return queries;
+}
+
+sk_sp<SkBBoxHierarchy> MakeTree(bool skia_rtree, const BoundsCapture& bounds) {
+  sk_sp<SkBBoxHierarchy> tree;
+  if (skia_rtree) {
+    tree = SkRTreeFactory()();
+  } else {
+    tree = sk_make_sp<RTree>();
+  }
+  tree->insert(bounds.rects().data(), bounds.metadata().data(),
+               static_cast<int>(bounds.rects().size()));
+  return tree;
+}
+
+void BM_RTreeInsert(benchmark::State& state, bool skia_rtree) {
+  sk_sp<BoundsCapture> bounds =
+      GetListPictureBounds(static_cast<int>(state.range(0)));
+  for ([[maybe_unused]] auto _ : state) {
+    benchmark::DoNotOptimize(MakeTree(skia_rtree, *bounds));
+  }
+  state.counters["Ops"] = bounds->rects().size();
+}
+
+void BM_RTreeSearch(benchmark::State& state, bool skia_rtree) {
+  int row_count = static_cast<int>(state.range(0));
+  sk_sp<SkBBoxHierarchy> tree =
+      MakeTree(skia_rtree, *GetListPictureBounds(row_count));
+  std::vector<SkRect> queries = GetViewportQueries(row_count);
+  std::vector<int> results;
+  size_t query = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    results.clear();
+    tree->search(queries[query], &results);
+    benchmark::DoNotOptimize(results.data());
+    query = (query + 1) % queries.size();
+  }
+}
+
+void BM_RTreeBatchSearch(benchmark::State& state) {
+  int row_count = static_cast<int>(state.range(0));
+  sk_sp<SkBBoxHierarchy> tree =
+      MakeTree(false, *GetListPictureBounds(row_count));
+  const RTree* rtree = static_cast<const RTree*>(tree.get());
+  std::vector<SkRect> queries = GetViewportQueries(row_count);
+  std::vector<std::vector<int>> results(queries.size());
+  for ([[maybe_unused]] auto _ : state) {
+    for (auto& result : results) {
+      result.clear();
+    }
+    rtree->search(queries.data(), static_cast<int>(queries.size()),
+                  results.data());
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.counters["Queries"] = queries.size();
+}
+
+void BM_RTreeVisit(benchmark::State& state) {
+  int row_count = static_cast<int>(state.range(0));
+  sk_sp<SkBBoxHierarchy> tree =
+      MakeTree(false, *GetListPictureBounds(row_count));
+  const RTree* rtree = static_cast<const RTree*>(tree.get());
+  std::vector<SkRect> queries = GetViewportQueries(row_count);
+  size_t query = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    int hits = 0;
+    rtree->visit(queries[query], [&hits](int, const SkRect&) { hits++; });
+    benchmark::DoNotOptimize(hits);
+    query = (query + 1) % queries.size();
+  }
+}
+
+void BM_RTreeSearchNonOverlappingDrawnRects(benchmark::State& state) {
+  int row_count = static_cast<int>(state.range(0));
+  sk_sp<SkBBoxHierarchy> tree =
+      MakeTree(false, *GetListPictureBounds(row_count));
+  const RTree* rtree = static_cast<const RTree*>(tree.get());
+  std::vector<SkRect> queries = GetViewportQueries(row_count);
+  size_t query = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    benchmark::DoNotOptimize(
+        rtree->searchNonOverlappingDrawnRects(queries[query]));
+    query = (query + 1) % queries.size();
+  }
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_RTreeInsert, SkRTree, true)->Range(64, 4096);
+BENCHMARK_CAPTURE(BM_RTreeInsert, FlutterRTree, false)->Range(64, 4096);
+BENCHMARK_CAPTURE(BM_RTreeSearch, SkRTree, true)->Range(64, 4096);
+BENCHMARK_CAPTURE(BM_RTreeSearch, FlutterRTree, false)->Range(64, 4096);
+BENCHMARK(BM_RTreeBatchSearch)->Range(64, 4096);
+BENCHMARK(BM_RTreeVisit)->Range(64, 4096);
+BENCHMARK(BM_RTreeSearchNonOverlappingDrawnRects)->Range(64, 4096);
+
+}  // namespace flutter
@@ -4,6 +4,8 @@
 
 #include "rtree.h"
 
+#include <algorithm>
+
 #include "flutter/testing/testing.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
@@ -231,5 +233,100 @@ TEST(RTree, searchNonOverlappingDrawnRectsJoinRectsWhenIntersectedCase3) {
   ASSERT_EQ(*hits.begin(), SkRect::MakeLTRB(50, 50, 620, 300));
 }
 
+static std::vector<SkRect> MakeGridRects(int grid_size) {
+  // A grid of 10x10 cells, each separated by a 10 pixel gap, which is
+  // enough rects to produce several levels of interior nodes.
+  std::vector<SkRect> rects;
+  for (int y = 0; y < grid_size; y++) {
+    for (int x = 0; x < grid_size; x++) {
+      rects.push_back(SkRect::MakeXYWH(x * 20, y * 20, 10, 10));
+    }
+  }
+  return rects;
+}
+
+TEST(RTree, SearchReturnsIndicesInInsertionOrder) {
+  std::vector<SkRect> rects = MakeGridRects(40);
+  auto rtree = sk_make_sp<RTree>();
+  rtree->insert(rects.data(), static_cast<int>(rects.size()));
+  ASSERT_EQ(static_cast<int>(rects.size()), rtree->getCount());
+
+  for (int y = 0; y < 40; y += 7) {
+    for (int x = 0; x < 40; x += 5) {
+      // A query that overlaps a 2x2 group of cells starting at (x, y).
+      SkRect query = SkRect::MakeXYWH(x * 20 + 5, y * 20 + 5, 20, 20);
+      std::vector<int> expected;
+      for (size_t i = 0; i < rects.size(); i++) {
+        if (rects[i].intersects(query)) {
+          expected.push_back(static_cast<int>(i));
+        }
+      }
+      std::vector<int> results;
+      rtree->search(query, &results);
+      EXPECT_EQ(results, expected) << "query at " << x << ", " << y;
+    }
+  }
+}
+
+TEST(RTree, EmptyRectsAreNeverFound) {
+  SkRect rects[] = {
+      SkRect::MakeLTRB(10, 10, 20, 20),
+      SkRect::MakeLTRB(30, 30, 30, 40),
+      SkRect::MakeLTRB(60, 60, 50, 50),
+  };
+  auto rtree = sk_make_sp<RTree>();
+  rtree->insert(rects, 3);
+  ASSERT_EQ(3, rtree->getCount());
+
+  // Inverted rects are sorted, as they are by SkRTree.
+  std::vector<int> results;
+  rtree->search(SkRect::MakeLTRB(0, 0, 100, 100), &results);
+  EXPECT_EQ(results, std::vector<int>({0, 2}));
+
+  results.clear();
+  rtree->search(SkRect::MakeEmpty(), &results);
+  EXPECT_TRUE(results.empty());
+}
+
+TEST(RTree, BatchSearchMatchesSingleSearches) {
+  std::vector<SkRect> rects = MakeGridRects(30);
+  auto rtree = sk_make_sp<RTree>();
+  rtree->insert(rects.data(), static_cast<int>(rects.size()));
+
+  // More queries than fit in a single group of the batch search.
+  std::vector<SkRect> queries;
+  for (int i = 0; i < 50; i++) {
+    queries.push_back(SkRect::MakeXYWH(i * 11, i * 7, 35 + i, 25));
+  }
+  queries.push_back(SkRect::MakeEmpty());
+  std::vector<std::vector<int>> batch_results(queries.size());
+  rtree->search(queries.data(), static_cast<int>(queries.size()),
+                batch_results.data());
+  for (size_t i = 0; i < queries.size(); i++) {
+    std::vector<int> results;
+    rtree->search(queries[i], &results);
+    EXPECT_EQ(batch_results[i], results) << "query " << i;
+  }
+  EXPECT_TRUE(batch_results.back().empty());
+}
+
+TEST(RTree, VisitReportsBoundsOfEachHit) {
+  std::vector<SkRect> rects = MakeGridRects(20);
+  auto rtree = sk_make_sp<RTree>();
+  rtree->insert(rects.data(), static_cast<int>(rects.size()));
+
+  SkRect query = SkRect::MakeLTRB(95, 95, 205, 165);
+  std::vector<int> visited;
+  rtree->visit(query, [&](int index, const SkRect& bounds) {
+    EXPECT_EQ(bounds, rects[index]);
+    EXPECT_TRUE(bounds.intersects(query));
+    visited.push_back(index);
+  });
+  std::vector<int> results;
+  rtree->search(query, &results);
+  std::sort(visited.begin(), visited.end());
+  EXPECT_EQ(visited, results);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -16,7 +16,8 @@ SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
                            FramebufferInfo framebuffer_info,
                            const SubmitCallback& submit_callback,
                            std::unique_ptr<GLContextResult> context_result,
-                           bool display_list_fallback)
+                           bool display_list_fallback,
+                           bool display_list_rtree)
     : surface_(surface),
       framebuffer_info_(std::move(framebuffer_info)),
       submit_callback_(submit_callback),
@@ -27,7 +28,8 @@ SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
   } else if (display_list_fallback) {
     dl_recorder_ = sk_make_sp<DisplayListCanvasRecorder>(
         SkRect::MakeWH(std::numeric_limits<SkScalar>::max(),
-                       std::numeric_limits<SkScalar>::max()));
+                       std::numeric_limits<SkScalar>::max()),
+        display_list_rtree);
     canvas_ = dl_recorder_.get();
   }
 }
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/display_list/display_list_canvas_recorder.h"
@@ -54,11 +55,16 @@ class SurfaceFrame {
     std::optional<SkIRect> existing_damage;
   };
 
+  // If |display_list_fallback| is true and there is no |surface| then the
+  // frame is recorded into a DisplayList that the |submit_callback| can
+  // retrieve with |BuildDisplayList|. If |display_list_rtree| is also true
+  // then that DisplayList will contain an R-Tree of its rendering ops.
   SurfaceFrame(sk_sp<SkSurface> surface,
                FramebufferInfo framebuffer_info,
                const SubmitCallback& submit_callback,
                std::unique_ptr<GLContextResult> context_result = nullptr,
-               bool display_list_fallback = false);
+               bool display_list_fallback = false,
+               bool display_list_rtree = false);
 
   struct SubmitInfo {
     // The frame damage for frame n is the difference between frame n and
@@ -74,6 +80,14 @@ class SurfaceFrame {
     // Corresponds to EGL_KHR_partial_update
     std::optional<SkIRect> buffer_damage;
 
+    // The frame damage split into rects that may be far apart. Their bounds
+    // are the |frame_damage|.
+    std::optional<std::vector<SkIRect>> frame_damage_rects;
+
+    // The buffer damage split into rects that may be far apart. Drawing was
+    // clipped to these rects. Their bounds are the |buffer_damage|.
+    std::optional<std::vector<SkIRect>> buffer_damage_rects;
+
     // Time at which this frame is scheduled to be presented. This is a hint
     // that can be passed to the platform to drop queued frames.
     std::optional<fml::TimePoint> presentation_time;
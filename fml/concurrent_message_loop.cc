@@ -5,25 +5,98 @@
 #include "flutter/fml/concurrent_message_loop.h"
 
 #include <algorithm>
+#include <deque>
 
 #include "flutter/fml/thread.h"
 #include "flutter/fml/trace_event.h"
 
 namespace fml {
 
+// The tasks queued for one worker. The worker and the workers that steal
+// from it both take the oldest task of the highest priority, so stealing
+// does not reorder tasks of the same priority much.
+class ConcurrentMessageLoop::WorkerQueue {
+ public:
+  WorkerQueue() = default;
+
+  void Push(const fml::closure& task, ConcurrentTaskPriority priority) {
+    const size_t index = static_cast<size_t>(priority);
+    std::scoped_lock lock(mutex_);
+    tasks_[index].push_back(task);
+    counts_[index]++;
+  }
+
+  fml::closure Pop(size_t priority) {
+    // Avoid taking the lock of every worker when looking for tasks to steal.
+    if (counts_[priority] == 0) {
+      return nullptr;
+    }
+    std::scoped_lock lock(mutex_);
+    auto& tasks = tasks_[priority];
+    if (tasks.empty()) {
+      return nullptr;
+    }
+    fml::closure task = std::move(tasks.front());
+    tasks.pop_front();
+    counts_[priority]--;
+    return task;
+  }
+
+  // Tasks that must run on this worker, which are never stolen.
+  void PushThreadTask(const fml::closure& task) {
+    std::scoped_lock lock(mutex_);
+    thread_tasks_.push_back(task);
+    has_thread_tasks_ = true;
+  }
+
+  bool HasThreadTasks() const { return has_thread_tasks_; }
+
+  std::vector<fml::closure> TakeThreadTasks() {
+    std::vector<fml::closure> thread_tasks;
+    if (has_thread_tasks_) {
+      std::scoped_lock lock(mutex_);
+      std::swap(thread_tasks, thread_tasks_);
+      has_thread_tasks_ = false;
+    }
+    return thread_tasks;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::array<std::deque<fml::closure>, kPriorityCount> tasks_;
+  std::array<std::atomic_size_t, kPriorityCount> counts_ = {};
+  std::vector<fml::closure> thread_tasks_;
+  std::atomic_bool has_thread_tasks_ = false;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(WorkerQueue);
+};
+
 std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
-    size_t worker_count) {
+    size_t worker_count,
+    Scheduling scheduling) {
   return std::shared_ptr<ConcurrentMessageLoop>{
-      new ConcurrentMessageLoop(worker_count)};
+      new ConcurrentMessageLoop(worker_count, scheduling)};
 }
 
-ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
-    : worker_count_(std::max<size_t>(worker_count, 1ul)) {
+ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count,
+                                             Scheduling scheduling)
+    : worker_count_(std::max<size_t>(worker_count, 1ul)),
+      scheduling_(scheduling) {
+  if (scheduling_ == Scheduling::kWorkStealing) {
+    for (size_t i = 0; i < worker_count_; ++i) {
+      worker_queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+  }
+
   for (size_t i = 0; i < worker_count_; ++i) {
     workers_.emplace_back([i, this]() {
       fml::Thread::SetCurrentThreadName(fml::Thread::ThreadConfig(
           std::string{"io.worker." + std::to_string(i + 1)}));
-      WorkerMain();
+      if (scheduling_ == Scheduling::kWorkStealing) {
+        WorkStealingWorkerMain(i);
+      } else {
+        WorkerMain();
+      }
     });
   }
 
@@ -43,15 +116,27 @@ size_t ConcurrentMessageLoop::GetWorkerCount() const {
   return worker_count_;
 }
 
+ConcurrentMessageLoop::Scheduling ConcurrentMessageLoop::GetScheduling()
+    const {
+  return scheduling_;
+}
+
 std::shared_ptr<ConcurrentTaskRunner> ConcurrentMessageLoop::GetTaskRunner() {
   return std::make_shared<ConcurrentTaskRunner>(weak_from_this());
 }
 
-void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
+void ConcurrentMessageLoop::PostTask(const fml::closure& task,
+                                     ConcurrentTaskPriority priority,
+                                     size_t affinity) {
   if (!task) {
     return;
   }
 
+  if (scheduling_ == Scheduling::kWorkStealing) {
+    PostWorkStealingTask(task, priority, affinity);
+    return;
+  }
+
   std::unique_lock lock(tasks_mutex_);
 
   // Don't just drop tasks on the floor in case of shutdown.
@@ -64,7 +149,7 @@ void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
     return;
   }
 
-  tasks_.push(task);
+  tasks_[static_cast<size_t>(priority)].push(task);
 
   // Unlock the mutex before notifying the condition variable because that mutex
   // has to be acquired on the other thread anyway. Waiting in this scope till
@@ -78,19 +163,14 @@ void ConcurrentMessageLoop::WorkerMain() {
   while (true) {
     std::unique_lock lock(tasks_mutex_);
     tasks_condition_.wait(lock, [&]() {
-      return !tasks_.empty() || shutdown_ || HasThreadTasksLocked();
+      return HasTasksLocked() || shutdown_ || HasThreadTasksLocked();
     });
 
     // Shutdown cannot be read with the task mutex unlocked.
     bool shutdown_now = shutdown_;
-    fml::closure task;
+    fml::closure task = PopTaskLocked();
     std::vector<fml::closure> thread_tasks;
 
-    if (!tasks_.empty()) {
-      task = tasks_.front();
-      tasks_.pop();
-    }
-
     if (HasThreadTasksLocked()) {
       thread_tasks = GetThreadTasksLocked();
       FML_DCHECK(!HasThreadTasksLocked());
@@ -117,6 +197,105 @@ void ConcurrentMessageLoop::WorkerMain() {
   }
 }
 
+void ConcurrentMessageLoop::PostWorkStealingTask(
+    const fml::closure& task,
+    ConcurrentTaskPriority priority,
+    size_t affinity) {
+  // The workers do not exit while a task is being posted here. This count
+  // and |shutdown_| are both sequentially consistent, so either this thread
+  // sees the shutdown, or the workers see the task and run it before they
+  // exit.
+  posting_count_++;
+
+  // Don't just drop tasks on the floor in case of shutdown.
+  if (shutdown_) {
+    posting_count_--;
+    FML_DLOG(WARNING)
+        << "Tried to post a task to shutdown concurrent message "
+           "loop. The task will be executed on the callers thread.";
+    task();
+    return;
+  }
+
+  size_t worker = affinity;
+  if (worker == kNoAffinity) {
+    // Tasks posted by a worker are likely to use the same data as the task
+    // that posted them, so keep them on that worker unless they are stolen.
+    auto found = std::find(worker_thread_ids_.begin(), worker_thread_ids_.end(),
+                           std::this_thread::get_id());
+    worker = found != worker_thread_ids_.end()
+                 ? found - worker_thread_ids_.begin()
+                 : next_worker_++;
+  }
+
+  // Count the task before queuing it so that the count never drops below
+  // the number of queued tasks. This and the sleeping worker count are read
+  // in the opposite order by the workers going to sleep, so either this
+  // thread sees a sleeping worker or that worker sees the task.
+  queued_task_count_++;
+  worker_queues_[worker % worker_count_]->Push(task, priority);
+  posting_count_--;
+
+  if (sleeping_worker_count_ > 0) {
+    // A worker that is about to wait still holds the mutex, so the
+    // notification cannot get lost between its check and its wait.
+    {
+      std::scoped_lock lock(tasks_mutex_);
+    }
+    tasks_condition_.notify_one();
+  }
+}
+
+fml::closure ConcurrentMessageLoop::TakeTask(size_t index) {
+  if (queued_task_count_ == 0) {
+    return nullptr;
+  }
+  for (size_t priority = 0; priority < kPriorityCount; ++priority) {
+    for (size_t i = 0; i < worker_count_; ++i) {
+      auto& queue = worker_queues_[(index + i) % worker_count_];
+      if (fml::closure task = queue->Pop(priority)) {
+        queued_task_count_--;
+        return task;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void ConcurrentMessageLoop::WorkStealingWorkerMain(size_t index) {
+  WorkerQueue& queue = *worker_queues_[index];
+  while (true) {
+    for (const auto& thread_task : queue.TakeThreadTasks()) {
+      thread_task();
+    }
+
+    if (fml::closure task = TakeTask(index)) {
+      TRACE_EVENT0("flutter", "ConcurrentWorkerTask");
+      task();
+      continue;
+    }
+
+    if (shutdown_) {
+      // Run the tasks that were posted before the shutdown, including the
+      // ones still being queued, before exiting. Posting a task counts it
+      // as queued before it stops counting itself as posting.
+      if (posting_count_ == 0 && queued_task_count_ == 0 &&
+          !queue.HasThreadTasks()) {
+        break;
+      }
+      std::this_thread::yield();
+      continue;
+    }
+
+    std::unique_lock lock(tasks_mutex_);
+    sleeping_worker_count_++;
+    tasks_condition_.wait(lock, [&]() {
+      return queued_task_count_ > 0 || shutdown_ || queue.HasThreadTasks();
+    });
+    sleeping_worker_count_--;
+  }
+}
+
 void ConcurrentMessageLoop::Terminate() {
   std::scoped_lock lock(tasks_mutex_);
   shutdown_ = true;
@@ -128,6 +307,15 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
     return;
   }
 
+  if (scheduling_ == Scheduling::kWorkStealing) {
+    for (auto& queue : worker_queues_) {
+      queue->PushThreadTask(task);
+    }
+    std::scoped_lock lock(tasks_mutex_);
+    tasks_condition_.notify_all();
+    return;
+  }
+
   std::scoped_lock lock(tasks_mutex_);
   for (const auto& worker_thread_id : worker_thread_ids_) {
     thread_tasks_[worker_thread_id].emplace_back(task);
@@ -135,6 +323,22 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
   tasks_condition_.notify_all();
 }
 
+bool ConcurrentMessageLoop::HasTasksLocked() const {
+  return std::any_of(tasks_.begin(), tasks_.end(),
+                     [](const auto& tasks) { return !tasks.empty(); });
+}
+
+fml::closure ConcurrentMessageLoop::PopTaskLocked() {
+  for (auto& tasks : tasks_) {
+    if (!tasks.empty()) {
+      fml::closure task = std::move(tasks.front());
+      tasks.pop();
+      return task;
+    }
+  }
+  return nullptr;
+}
+
 bool ConcurrentMessageLoop::HasThreadTasksLocked() const {
   return thread_tasks_.count(std::this_thread::get_id()) > 0;
 }
@@ -155,12 +359,18 @@ ConcurrentTaskRunner::ConcurrentTaskRunner(
 ConcurrentTaskRunner::~ConcurrentTaskRunner() = default;
 
 void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
+  PostTask(task, ConcurrentTaskPriority::kNormal);
+}
+
+void ConcurrentTaskRunner::PostTask(const fml::closure& task,
+                                    ConcurrentTaskPriority priority,
+                                    size_t affinity) {
   if (!task) {
     return;
   }
 
   if (auto loop = weak_loop_.lock()) {
-    loop->PostTask(task);
+    loop->PostTask(task, priority, affinity);
     return;
   }
 
@@ -5,10 +5,15 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <array>
+#include <atomic>
 #include <condition_variable>
+#include <limits>
 #include <map>
+#include <memory>
 #include <queue>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -18,16 +23,44 @@ namespace fml {
 
 class ConcurrentTaskRunner;
 
+/// The order in which the workers pick up the tasks that are waiting to run.
+/// The workers start the waiting tasks of a higher priority before those of
+/// a lower priority.
+enum class ConcurrentTaskPriority {
+  /// Work that something on screen is waiting for, like decoding a visible
+  /// image.
+  kHigh,
+  kNormal,
+  /// Work that can wait for everything else, like preparing caches ahead of
+  /// time.
+  kBackground,
+};
+
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
+  enum class Scheduling {
+    /// All of the workers take tasks from one queue.
+    kSharedQueue,
+    /// Each worker has a queue of its own and takes tasks from the queues of
+    /// the other workers when its own runs dry, so that posting and taking
+    /// tasks do not all contend on one lock.
+    kWorkStealing,
+  };
+
+  /// Passed as the affinity of a task to let the loop pick the worker.
+  static constexpr size_t kNoAffinity = std::numeric_limits<size_t>::max();
+
   static std::shared_ptr<ConcurrentMessageLoop> Create(
-      size_t worker_count = std::thread::hardware_concurrency());
+      size_t worker_count = std::thread::hardware_concurrency(),
+      Scheduling scheduling = Scheduling::kSharedQueue);
 
   ~ConcurrentMessageLoop();
 
   size_t GetWorkerCount() const;
 
+  Scheduling GetScheduling() const;
+
   std::shared_ptr<ConcurrentTaskRunner> GetTaskRunner();
 
   void Terminate();
@@ -37,20 +70,51 @@ class ConcurrentMessageLoop
  private:
   friend ConcurrentTaskRunner;
 
+  static constexpr size_t kPriorityCount = 3;
+
+  class WorkerQueue;
+
   size_t worker_count_ = 0;
+  const Scheduling scheduling_;
   std::vector<std::thread> workers_;
   std::mutex tasks_mutex_;
   std::condition_variable tasks_condition_;
-  std::queue<fml::closure> tasks_;
+  std::array<std::queue<fml::closure>, kPriorityCount> tasks_;
   std::vector<std::thread::id> worker_thread_ids_;
   std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
+  std::atomic_bool shutdown_ = false;
+
+  // Only used with |Scheduling::kWorkStealing|.
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+  std::atomic_size_t next_worker_ = 0;
+  // The number of tasks in the worker queues that any worker may take.
+  std::atomic_size_t queued_task_count_ = 0;
+  std::atomic_size_t sleeping_worker_count_ = 0;
+  // The number of threads that are posting a task right now.
+  std::atomic_size_t posting_count_ = 0;
 
-  explicit ConcurrentMessageLoop(size_t worker_count);
+  ConcurrentMessageLoop(size_t worker_count, Scheduling scheduling);
 
   void WorkerMain();
 
-  void PostTask(const fml::closure& task);
+  void WorkStealingWorkerMain(size_t index);
+
+  void PostTask(const fml::closure& task,
+                ConcurrentTaskPriority priority,
+                size_t affinity);
+
+  void PostWorkStealingTask(const fml::closure& task,
+                            ConcurrentTaskPriority priority,
+                            size_t affinity);
+
+  // Takes the next task for the worker at |index|, from its own queue if it
+  // has one of the highest priority that is waiting and from the queues of
+  // the other workers otherwise.
+  fml::closure TakeTask(size_t index);
+
+  bool HasTasksLocked() const;
+
+  fml::closure PopTaskLocked();
 
   bool HasThreadTasksLocked() const;
 
@@ -67,6 +131,14 @@ class ConcurrentTaskRunner : public BasicTaskRunner {
 
   void PostTask(const fml::closure& task) override;
 
+  /// Posts a task that runs before the waiting tasks of a lower |priority|.
+  /// With |ConcurrentMessageLoop::Scheduling::kWorkStealing| the task is
+  /// queued for the worker with the index |affinity| modulo the worker count,
+  /// which runs it unless another worker runs out of tasks first.
+  void PostTask(const fml::closure& task,
+                ConcurrentTaskPriority priority,
+                size_t affinity = ConcurrentMessageLoop::kNoAffinity);
+
  private:
   friend ConcurrentMessageLoop;
 
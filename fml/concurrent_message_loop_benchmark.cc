@@ -0,0 +1,171 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace fml {
+namespace benchmarking {
+
+static constexpr size_t kWorkerCount = 4;
+
+static ConcurrentMessageLoop::Scheduling GetScheduling(
+    const benchmark::State& state) {
+  return state.range(0) == 0
+             ? ConcurrentMessageLoop::Scheduling::kSharedQueue
+             : ConcurrentMessageLoop::Scheduling::kWorkStealing;
+}
+
+// Stands in for the work of a small task, like decoding a tiny image.
+static void DoWork(int iterations) {
+  int value = 0;
+  for (int i = 0; i < iterations; i++) {
+    benchmark::DoNotOptimize(value += i);
+  }
+}
+
+// Reports percentiles of the time tasks waited between being posted and
+// starting to run.
+static void ReportLatencies(benchmark::State& state,
+                            std::vector<int64_t>& latencies_us) {
+  if (latencies_us.empty()) {
+    return;
+  }
+  std::sort(latencies_us.begin(), latencies_us.end());
+  auto percentile = [&](double p) {
+    return static_cast<double>(
+        latencies_us[static_cast<size_t>(p * (latencies_us.size() - 1))]);
+  };
+  state.counters["p50_us"] = percentile(0.5);
+  state.counters["p99_us"] = percentile(0.99);
+  state.counters["max_us"] = static_cast<double>(latencies_us.back());
+}
+
+// One thread posts many small tasks at once, like a frame posting the
+// decode of every image that became visible.
+static void BM_ConcurrentLoopFanOut(benchmark::State& state) {
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount, GetScheduling(state));
+  auto task_runner = loop->GetTaskRunner();
+  const size_t task_count = state.range(1);
+  std::vector<int64_t> latencies_us;
+
+  for ([[maybe_unused]] auto _ : state) {
+    CountDownLatch latch(task_count);
+    std::vector<int64_t> iteration_latencies_us(task_count);
+    for (size_t i = 0; i < task_count; i++) {
+      const fml::TimePoint posted = fml::TimePoint::Now();
+      task_runner->PostTask([&, i, posted]() {
+        iteration_latencies_us[i] =
+            (fml::TimePoint::Now() - posted).ToMicroseconds();
+        DoWork(1000);
+        latch.CountDown();
+      });
+    }
+    latch.Wait();
+    latencies_us.insert(latencies_us.end(), iteration_latencies_us.begin(),
+                        iteration_latencies_us.end());
+  }
+
+  state.SetItemsProcessed(state.iterations() * task_count);
+  ReportLatencies(state, latencies_us);
+}
+
+// Tasks that fan out further from the workers, like tiles being rasterized
+// for each of several layers.
+static void BM_ConcurrentLoopNestedFanOut(benchmark::State& state) {
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount, GetScheduling(state));
+  auto task_runner = loop->GetTaskRunner();
+  const size_t root_count = 16;
+  const size_t child_count = state.range(1);
+
+  for ([[maybe_unused]] auto _ : state) {
+    CountDownLatch latch(root_count * (child_count + 1));
+    for (size_t i = 0; i < root_count; i++) {
+      task_runner->PostTask([&]() {
+        for (size_t j = 0; j < child_count; j++) {
+          task_runner->PostTask([&]() {
+            DoWork(1000);
+            latch.CountDown();
+          });
+        }
+        latch.CountDown();
+      });
+    }
+    latch.Wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * root_count * (child_count + 1));
+}
+
+// How long a task waits for the workers to get through a backlog of
+// background work, when it is posted with the priority given by the second
+// argument.
+static void BM_ConcurrentLoopLatencyBehindBackgroundWork(
+    benchmark::State& state) {
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount, GetScheduling(state));
+  auto task_runner = loop->GetTaskRunner();
+  const auto priority = static_cast<ConcurrentTaskPriority>(state.range(1));
+  const size_t background_count = 256;
+  std::vector<int64_t> latencies_us;
+
+  for ([[maybe_unused]] auto _ : state) {
+    CountDownLatch latch(background_count + 1);
+    for (size_t i = 0; i < background_count; i++) {
+      task_runner->PostTask(
+          [&]() {
+            DoWork(10000);
+            latch.CountDown();
+          },
+          ConcurrentTaskPriority::kBackground);
+    }
+    const fml::TimePoint posted = fml::TimePoint::Now();
+    task_runner->PostTask(
+        [&, posted]() {
+          latencies_us.push_back(
+              (fml::TimePoint::Now() - posted).ToMicroseconds());
+          latch.CountDown();
+        },
+        priority);
+    latch.Wait();
+  }
+
+  ReportLatencies(state, latencies_us);
+}
+
+static void FanOutArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"work_stealing", "tasks"});
+  for (int64_t scheduling : {0, 1}) {
+    for (int64_t tasks : {16, 256, 4096}) {
+      benchmark->Args({scheduling, tasks});
+    }
+  }
+}
+
+static void PriorityArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"work_stealing", "priority"});
+  for (int64_t scheduling : {0, 1}) {
+    for (auto priority : {ConcurrentTaskPriority::kHigh,
+                          ConcurrentTaskPriority::kBackground}) {
+      benchmark->Args({scheduling, static_cast<int64_t>(priority)});
+    }
+  }
+}
+
+BENCHMARK(BM_ConcurrentLoopFanOut)->Apply(FanOutArguments)->UseRealTime();
+BENCHMARK(BM_ConcurrentLoopNestedFanOut)
+    ->Apply(FanOutArguments)
+    ->UseRealTime();
+BENCHMARK(BM_ConcurrentLoopLatencyBehindBackgroundWork)
+    ->Apply(PriorityArguments)
+    ->UseRealTime();
+
+}  // namespace benchmarking
+}  // namespace fml
@@ -4,6 +4,7 @@
 
 #include <cstring>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "flutter/fml/build_config.h"
@@ -312,6 +313,7 @@ TEST(FileTest, MappingDontNeedSafeTest) {
     ASSERT_TRUE(mapping.IsValid());
     ASSERT_EQ(mapping.GetMutableMapping(), nullptr);
     ASSERT_TRUE(mapping.IsDontNeedSafe());
+    ASSERT_TRUE(mapping.IsSharedFileBacked());
   }
 
   {
@@ -322,8 +324,53 @@ TEST(FileTest, MappingDontNeedSafeTest) {
     ASSERT_TRUE(mapping.IsValid());
     ASSERT_NE(mapping.GetMutableMapping(), nullptr);
     ASSERT_FALSE(mapping.IsDontNeedSafe());
+    ASSERT_FALSE(mapping.IsSharedFileBacked());
   }
   ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "my_contents"));
+
+  fml::DataMapping data(std::vector<uint8_t>{1, 2, 3});
+  ASSERT_FALSE(data.IsSharedFileBacked());
+}
+
+TEST(FileTest, MappingAdviceTest) {
+  fml::ScopedTemporaryDirectory dir;
+
+  {
+    auto file = fml::OpenFile(dir.fd(), "my_contents", true,
+                              fml::FilePermission::kReadWrite);
+    WriteStringToFile(file, "some content");
+  }
+
+  const size_t mapped_bytes = fml::Mapping::GetFileMappedBytes();
+  {
+    auto file = fml::OpenFile(dir.fd(), "my_contents", false,
+                              fml::FilePermission::kRead);
+    fml::FileMapping mapping(file);
+    ASSERT_TRUE(mapping.IsValid());
+    ASSERT_GE(fml::Mapping::GetFileMappedBytes(), mapped_bytes + 12u);
+#if !FML_OS_WIN
+    ASSERT_TRUE(mapping.Advise(fml::Mapping::Advice::kWillNeed));
+    ASSERT_TRUE(mapping.Advise(fml::Mapping::Advice::kSequential));
+    ASSERT_TRUE(mapping.Advise(fml::Mapping::Advice::kDontNeed));
+#endif  // !FML_OS_WIN
+    // The contents are read in again after they were dropped.
+    ASSERT_EQ(std::string(reinterpret_cast<const char*>(mapping.GetMapping()),
+                          mapping.GetSize()),
+              "some content");
+  }
+
+  {
+    auto file = fml::OpenFile(dir.fd(), "my_contents", false,
+                              fml::FilePermission::kReadWrite);
+    fml::FileMapping mapping(file, {fml::FileMapping::Protection::kRead,
+                                    fml::FileMapping::Protection::kWrite});
+    ASSERT_TRUE(mapping.IsValid());
+    ASSERT_FALSE(mapping.Advise(fml::Mapping::Advice::kDontNeed));
+  }
+  ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "my_contents"));
+
+  fml::DataMapping data(std::vector<uint8_t>{1, 2, 3});
+  ASSERT_FALSE(data.Advise(fml::Mapping::Advice::kWillNeed));
 }
 
 TEST(FileTest, FileTestsWork) {
@@ -5,10 +5,40 @@
 #include "flutter/fml/mapping.h"
 
 #include <algorithm>
+#include <atomic>
 #include <sstream>
 
 namespace fml {
 
+// Mapping
+
+static std::atomic<size_t> gFileMappedBytes = 0;
+static std::atomic<size_t> gCopiedBytes = 0;
+
+bool Mapping::IsSharedFileBacked() const {
+  return false;
+}
+
+bool Mapping::Advise(Advice advice) const {
+  return false;
+}
+
+size_t Mapping::GetFileMappedBytes() {
+  return gFileMappedBytes.load(std::memory_order_relaxed);
+}
+
+size_t Mapping::GetCopiedBytes() {
+  return gCopiedBytes.load(std::memory_order_relaxed);
+}
+
+void Mapping::RecordCopiedBytes(size_t bytes) {
+  gCopiedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void Mapping::RecordFileMappedBytes(size_t bytes) {
+  gFileMappedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
 // FileMapping
 
 uint8_t* FileMapping::GetMutableMapping() {
@@ -32,6 +32,44 @@ class Mapping {
   // Generally true for file-mapped memory and false for anonymous memory.
   virtual bool IsDontNeedSafe() const = 0;
 
+  // Whether the mapping is a read only mapping of a file that it keeps
+  // mapped for as long as it lives. Such a mapping can be used in place by
+  // whoever takes ownership of it rather than being copied, since its pages
+  // are backed by the file instead of the memory of the process.
+  virtual bool IsSharedFileBacked() const;
+
+  enum class Advice {
+    // The whole mapping is about to be read, so its pages may be read in
+    // ahead of the first access.
+    kWillNeed,
+    // The mapping will be read from start to end, so pages may be read in
+    // further ahead of the accesses and dropped soon after them.
+    kSequential,
+    // The mapping will not be read for a while, so the pages that were read
+    // in may be dropped until they are accessed again. Only given for
+    // mappings that are |IsDontNeedSafe|.
+    kDontNeed,
+  };
+
+  // Hints to the OS how the mapping is going to be accessed. The contents of
+  // the mapping are the same whether the hint is given or not. Returns false
+  // if the hint could not be given, which is always the case for mappings
+  // that are not backed by a file.
+  virtual bool Advise(Advice advice) const;
+
+  // The total size of the file mappings created so far.
+  static size_t GetFileMappedBytes();
+
+  // The total size of the data, such as asset and image bytes, that was
+  // copied into buffers owned by the engine. Added to with
+  // |RecordCopiedBytes|.
+  static size_t GetCopiedBytes();
+
+  static void RecordCopiedBytes(size_t bytes);
+
+ protected:
+  static void RecordFileMappedBytes(size_t bytes);
+
  private:
   FML_DISALLOW_COPY_AND_ASSIGN(Mapping);
 };
@@ -72,6 +110,12 @@ class FileMapping final : public Mapping {
   // |Mapping|
   bool IsDontNeedSafe() const override;
 
+  // |Mapping|
+  bool IsSharedFileBacked() const override;
+
+  // |Mapping|
+  bool Advise(Advice advice) const override;
+
   uint8_t* GetMutableMapping();
 
   bool IsValid() const;
@@ -10,6 +10,7 @@
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <thread>
 
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/task_source.h"
@@ -41,9 +42,58 @@ class TaskSourceGradeHolder {
 FML_THREAD_LOCAL ThreadLocalUniquePtr<TaskSourceGradeHolder>
     tls_task_source_grade;
 
+struct IncomingTaskList::Node {
+  DelayedTask task;
+  Node* next;
+};
+
+IncomingTaskList::~IncomingTaskList() {
+  Clear();
+}
+
+void IncomingTaskList::Push(const DelayedTask& task) {
+  Node* node = new Node{task, head_.load(std::memory_order_relaxed)};
+  // Sequentially consistent, along with the exchange in |MoveTo|, so that
+  // the poster and a concurrent merge or unmerge agree on who wakes up which
+  // loop. See |MessageLoopTaskQueues::RegisterTask|.
+  while (!head_.compare_exchange_weak(node->next, node,
+                                      std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+  }
+}
+
+fml::TimePoint IncomingTaskList::MoveTo(TaskSource& task_source) {
+  fml::TimePoint earliest = fml::TimePoint::Max();
+  Node* node = head_.exchange(nullptr, std::memory_order_seq_cst);
+  while (node) {
+    // The order of the tasks is kept by their sequence numbers, so it does
+    // not matter that the list hands them out last in first out.
+    earliest = std::min(earliest, node->task.GetTargetTime());
+    task_source.RegisterTask(node->task);
+    Node* next = node->next;
+    delete node;
+    node = next;
+  }
+  return earliest;
+}
+
+void IncomingTaskList::Clear() {
+  Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+  while (node) {
+    Node* next = node->next;
+    delete node;
+    node = next;
+  }
+}
+
 TaskQueueEntry::TaskQueueEntry(TaskQueueId created_for_arg)
-    : subsumed_by(_kUnmerged), created_for(created_for_arg) {
-  wakeable = NULL;
+    : wakeable(nullptr),
+      subsumed_by(_kUnmerged),
+      created_for(created_for_arg),
+      wake_time(fml::TimePoint::Max()),
+      secondary_paused(false),
+      disposed(false),
+      active_posters(0) {
   task_observers = TaskObservers();
   task_source = std::make_unique<TaskSource>(created_for);
 }
@@ -60,37 +110,174 @@ fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::GetInstance() {
 
 TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
   std::lock_guard guard(queue_mutex_);
-  TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_);
-  ++task_queue_id_counter_;
-  queue_entries_[loop_id] = std::make_unique<TaskQueueEntry>(loop_id);
+  ReclaimDisposedEntriesUnlocked();
+  TaskQueueId loop_id = _kUnmerged;
+  if (!free_queue_ids_.empty()) {
+    loop_id = free_queue_ids_.back();
+    free_queue_ids_.pop_back();
+  } else {
+    loop_id = TaskQueueId(task_queue_id_counter_);
+    ++task_queue_id_counter_;
+  }
+  const size_t block_index = loop_id / kEntriesPerBlock;
+  FML_CHECK(block_index < kMaxEntryBlocks) << "Too many task queues.";
+  EntryBlock* block = entry_blocks_[block_index].load();
+  if (!block) {
+    block = new EntryBlock();
+    entry_blocks_[block_index].store(block, std::memory_order_release);
+  }
+  (*block)[loop_id % kEntriesPerBlock].store(new TaskQueueEntry(loop_id),
+                                             std::memory_order_release);
   return loop_id;
 }
 
 MessageLoopTaskQueues::MessageLoopTaskQueues()
-    : task_queue_id_counter_(0), order_(0) {}
+    : entry_blocks_(),
+      epoch_(0),
+      epoch_readers_(),
+      task_queue_id_counter_(0),
+      order_(0) {}
+
+MessageLoopTaskQueues::~MessageLoopTaskQueues() {
+  for (auto& slot : entry_blocks_) {
+    EntryBlock* block = slot.load();
+    if (!block) {
+      break;
+    }
+    for (auto& entry : *block) {
+      delete entry.load();
+    }
+    delete block;
+  }
+}
+
+TaskQueueEntry* MessageLoopTaskQueues::GetEntry(TaskQueueId queue_id) const {
+  TaskQueueEntry* entry = FindEntry(queue_id);
+  FML_CHECK(entry) << "Unknown task queue.";
+  return entry;
+}
+
+TaskQueueEntry* MessageLoopTaskQueues::FindEntry(TaskQueueId queue_id) const {
+  const size_t block_index = queue_id / kEntriesPerBlock;
+  if (block_index >= kMaxEntryBlocks) {
+    return nullptr;
+  }
+  EntryBlock* block =
+      entry_blocks_[block_index].load(std::memory_order_acquire);
+  if (!block) {
+    return nullptr;
+  }
+  return (*block)[queue_id % kEntriesPerBlock].load(std::memory_order_acquire);
+}
+
+namespace {
+
+// Marks an entry as used by a thread that posts a task without holding the
+// lock, for as long as it is in scope.
+class ScopedEntryUse {
+ public:
+  explicit ScopedEntryUse(TaskQueueEntry* entry) : entry_(entry) {
+    entry_->active_posters.fetch_add(1);
+  }
+
+  ~ScopedEntryUse() { entry_->active_posters.fetch_sub(1); }
+
+  // Both this and the count above are sequentially consistent, so either
+  // this sees that the TaskQueue is disposed, or |Dispose| waits for this
+  // scope to end.
+  bool IsDisposed() const { return entry_->disposed.load(); }
+
+ private:
+  TaskQueueEntry* entry_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ScopedEntryUse);
+};
+
+}  // namespace
+
+// Keeps the entries that are looked up without holding the lock from being
+// freed for as long as it is in scope.
+// See |MessageLoopTaskQueues::ReclaimDisposedEntriesUnlocked|.
+class MessageLoopTaskQueues::ScopedEntryAccess {
+ public:
+  explicit ScopedEntryAccess(MessageLoopTaskQueues& queues)
+      : readers_(queues.epoch_readers_[queues.epoch_.load() % 2]) {
+    readers_.fetch_add(1);
+  }
+
+  ~ScopedEntryAccess() { readers_.fetch_sub(1); }
 
-MessageLoopTaskQueues::~MessageLoopTaskQueues() = default;
+ private:
+  std::atomic<size_t>& readers_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ScopedEntryAccess);
+};
 
 void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
   std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
-  auto& subsumed_set = queue_entry->owner_of;
-  for (auto& subsumed : subsumed_set) {
-    queue_entries_.erase(subsumed);
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  FML_DCHECK(queue_entry->subsumed_by.load() == _kUnmerged);
+  auto erase = [this](TaskQueueId id) {
+    EntryBlock* block = entry_blocks_[id / kEntriesPerBlock].load();
+    TaskQueueEntry* entry = (*block)[id % kEntriesPerBlock].exchange(nullptr);
+    entry->disposed.store(true);
+    // Threads that looked the entry up before it was removed may still be
+    // posting to it or waking up its loop, which is about to go away.
+    while (entry->active_posters.load() > 0) {
+      std::this_thread::yield();
+    }
+    entry->wakeable.store(nullptr);
+    entry->incoming_tasks.Clear();
+    entry->task_source->ShutDown();
+    entry->task_observers.clear();
+    // Read the epoch only after the entry was removed from its slot.
+    disposed_entries_.push_back(
+        {epoch_.load(), id, std::unique_ptr<TaskQueueEntry>(entry)});
+  };
+  for (auto& subsumed : queue_entry->owner_of) {
+    erase(subsumed);
+  }
+  // Erase owner queue_id at last to avoid its owner_of from being invalid
+  erase(queue_id);
+  ReclaimDisposedEntriesUnlocked();
+}
+
+void MessageLoopTaskQueues::ReclaimDisposedEntriesUnlocked() {
+  if (disposed_entries_.empty()) {
+    return;
+  }
+  // Move the epoch on as far as the threads that are still looking up
+  // entries allow. The readers of the current epoch do not hold it back, so
+  // this cannot be starved by threads that keep posting tasks.
+  for (size_t i = 0; i < 2; i++) {
+    const size_t epoch = epoch_.load();
+    if (epoch_readers_[(epoch + 1) % 2].load() > 0) {
+      break;
+    }
+    epoch_.store(epoch + 1);
+  }
+  // A thread that still uses an entry must have started reading in the epoch
+  // the entry was removed in or before, and it keeps the epoch from moving
+  // on twice since then. Threads that start later find the slot empty.
+  const size_t epoch = epoch_.load();
+  while (!disposed_entries_.empty() &&
+         disposed_entries_.front().epoch + 2 <= epoch) {
+    free_queue_ids_.push_back(disposed_entries_.front().queue_id);
+    disposed_entries_.pop_front();
   }
-  // Erase owner queue_id at last to avoid &subsumed_set from being invalid
-  queue_entries_.erase(queue_id);
 }
 
 void MessageLoopTaskQueues::DisposeTasks(TaskQueueId queue_id) {
   std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  FML_DCHECK(queue_entry->subsumed_by.load() == _kUnmerged);
   auto& subsumed_set = queue_entry->owner_of;
+  queue_entry->incoming_tasks.Clear();
   queue_entry->task_source->ShutDown();
   for (auto& subsumed : subsumed_set) {
-    queue_entries_.at(subsumed)->task_source->ShutDown();
+    TaskQueueEntry* subsumed_entry = GetEntry(subsumed);
+    subsumed_entry->incoming_tasks.Clear();
+    subsumed_entry->task_source->ShutDown();
   }
 }
 
@@ -104,75 +291,150 @@ void MessageLoopTaskQueues::RegisterTask(
     const fml::closure& task,
     fml::TimePoint target_time,
     fml::TaskSourceGrade task_source_grade) {
-  std::lock_guard guard(queue_mutex_);
   size_t order = order_++;
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  queue_entry->task_source->RegisterTask(
+  ScopedEntryAccess access(*this);
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  ScopedEntryUse queue_use(queue_entry);
+  if (queue_use.IsDisposed()) {
+    // Disposed concurrently, which would have dropped the task anyway.
+    return;
+  }
+  queue_entry->incoming_tasks.Push(
       {order, task, target_time, task_source_grade});
-  TaskQueueId loop_to_wake = queue_id;
-  if (queue_entry->subsumed_by != _kUnmerged) {
-    loop_to_wake = queue_entry->subsumed_by;
+
+  // The task is picked up when the secondary tasks are resumed.
+  if (task_source_grade == TaskSourceGrade::kDartMicroTasks &&
+      queue_entry->secondary_paused.load()) {
+    return;
   }
 
-  // This can happen when the secondary tasks are paused.
-  if (HasPendingTasksUnlocked(loop_to_wake)) {
-    WakeUpUnlocked(loop_to_wake, GetNextWakeTimeUnlocked(loop_to_wake));
+  // Pushing the task, this read, and the store to |subsumed_by| and the
+  // exchange of the incoming tasks in |Merge| and |Unmerge| are all
+  // sequentially consistent. So either this reads the new owner, or the
+  // merge or unmerge moves the task and wakes up the loop itself.
+  TaskQueueId loop_to_wake = queue_entry->subsumed_by.load();
+  if (loop_to_wake == _kUnmerged) {
+    WakeUpLoop(queue_entry, LowerWakeTime(queue_entry, target_time));
+    return;
+  }
+  // The owner may have been disposed after an unmerge that this did not see,
+  // in which case the unmerge has woken up the loop of this TaskQueue.
+  TaskQueueEntry* loop_entry = FindEntry(loop_to_wake);
+  if (!loop_entry) {
+    return;
+  }
+  ScopedEntryUse loop_use(loop_entry);
+  if (!loop_use.IsDisposed()) {
+    WakeUpLoop(loop_entry, LowerWakeTime(loop_entry, target_time));
   }
 }
 
 bool MessageLoopTaskQueues::HasPendingTasks(TaskQueueId queue_id) const {
   std::lock_guard guard(queue_mutex_);
+  MoveIncomingTasksUnlocked(queue_id);
   return HasPendingTasksUnlocked(queue_id);
 }
 
 fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
                                                      fml::TimePoint from_time) {
   std::lock_guard guard(queue_mutex_);
+  MoveIncomingTasksUnlocked(queue_id);
   if (!HasPendingTasksUnlocked(queue_id)) {
     return nullptr;
   }
-  TaskSource::TopTask top = PeekNextTaskUnlocked(queue_id);
-
-  if (!HasPendingTasksUnlocked(queue_id)) {
-    WakeUpUnlocked(queue_id, fml::TimePoint::Max());
-  } else {
-    WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
-  }
+  WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
 
+  // Only peek once the wake up has moved the tasks that came in meanwhile,
+  // which reorders the task heaps.
+  TaskSource::TopTask top = PeekNextTaskUnlocked(queue_id);
   if (top.task.GetTargetTime() > from_time) {
     return nullptr;
   }
   fml::closure invocation = top.task.GetTask();
-  queue_entries_.at(top.task_queue_id)
-      ->task_source->PopTask(top.task.GetTaskSourceGrade());
+  const auto task_source_grade = top.task.GetTaskSourceGrade();
+  GetEntry(top.task_queue_id)->task_source->PopTask(task_source_grade);
+  ResetWakeTimeUnlocked(queue_id);
   {
     std::scoped_lock creation(creation_mutex_);
-    const auto task_source_grade = top.task.GetTaskSourceGrade();
     tls_task_source_grade.reset(new TaskSourceGradeHolder{task_source_grade});
   }
   return invocation;
 }
 
+fml::TimePoint MessageLoopTaskQueues::LowerWakeTime(TaskQueueEntry* entry,
+                                                    fml::TimePoint time) {
+  fml::TimePoint wake_time = entry->wake_time.load();
+  while (time < wake_time &&
+         !entry->wake_time.compare_exchange_weak(wake_time, time)) {
+  }
+  return std::min(wake_time, time);
+}
+
+void MessageLoopTaskQueues::WakeUpLoop(TaskQueueEntry* entry,
+                                       fml::TimePoint time) {
+  Wakeable* wakeable = entry->wakeable.load();
+  if (!wakeable) {
+    return;
+  }
+  wakeable->WakeUp(time);
+  // Another thread may have lowered the wake time and woken up the loop
+  // before this thread did, which would have pushed its wake up back.
+  for (fml::TimePoint wake_time = entry->wake_time.load(); wake_time < time;
+       wake_time = entry->wake_time.load()) {
+    time = wake_time;
+    wakeable->WakeUp(time);
+  }
+}
+
 void MessageLoopTaskQueues::WakeUpUnlocked(TaskQueueId queue_id,
                                            fml::TimePoint time) const {
-  if (queue_entries_.at(queue_id)->wakeable) {
-    queue_entries_.at(queue_id)->wakeable->WakeUp(time);
+  TaskQueueEntry* entry = GetEntry(queue_id);
+  // Publish the time before looking for more tasks. Tasks that are posted
+  // afterwards lower it themselves.
+  entry->wake_time.store(time);
+  fml::TimePoint incoming_time = MoveIncomingTasksUnlocked(queue_id);
+  WakeUpLoop(entry, LowerWakeTime(entry, std::min(time, incoming_time)));
+}
+
+void MessageLoopTaskQueues::ResetWakeTimeUnlocked(TaskQueueId queue_id) const {
+  TaskQueueEntry* entry = GetEntry(queue_id);
+  fml::TimePoint time = HasPendingTasksUnlocked(queue_id)
+                            ? GetNextWakeTimeUnlocked(queue_id)
+                            : fml::TimePoint::Max();
+  entry->wake_time.store(time);
+  fml::TimePoint incoming_time = MoveIncomingTasksUnlocked(queue_id);
+  if (incoming_time < time) {
+    WakeUpLoop(entry, LowerWakeTime(entry, incoming_time));
   }
 }
 
+fml::TimePoint MessageLoopTaskQueues::MoveIncomingTasksUnlocked(
+    TaskQueueId queue_id) const {
+  TaskQueueEntry* entry = GetEntry(queue_id);
+  fml::TimePoint earliest = entry->incoming_tasks.MoveTo(*entry->task_source);
+  for (TaskQueueId subsumed : entry->owner_of) {
+    TaskQueueEntry* subsumed_entry = GetEntry(subsumed);
+    earliest = std::min(
+        earliest,
+        subsumed_entry->incoming_tasks.MoveTo(*subsumed_entry->task_source));
+  }
+  return earliest;
+}
+
 size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
   std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  if (queue_entry->subsumed_by != _kUnmerged) {
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  if (queue_entry->subsumed_by.load() != _kUnmerged) {
     return 0;
   }
+  MoveIncomingTasksUnlocked(queue_id);
 
   size_t total_tasks = 0;
   total_tasks += queue_entry->task_source->GetNumPendingTasks();
 
   auto& subsumed_set = queue_entry->owner_of;
   for (auto& subsumed : subsumed_set) {
-    const auto& subsumed_entry = queue_entries_.at(subsumed);
+    TaskQueueEntry* subsumed_entry = GetEntry(subsumed);
     total_tasks += subsumed_entry->task_source->GetNumPendingTasks();
   }
   return total_tasks;
@@ -183,13 +445,13 @@ void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
                                             const fml::closure& callback) {
   std::lock_guard guard(queue_mutex_);
   FML_DCHECK(callback != nullptr) << "Observer callback must be non-null.";
-  queue_entries_.at(queue_id)->task_observers[key] = callback;
+  GetEntry(queue_id)->task_observers[key] = callback;
 }
 
 void MessageLoopTaskQueues::RemoveTaskObserver(TaskQueueId queue_id,
                                                intptr_t key) {
   std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_observers.erase(key);
+  GetEntry(queue_id)->task_observers.erase(key);
 }
 
 std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
@@ -197,17 +459,18 @@ std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
   std::lock_guard guard(queue_mutex_);
   std::vector<fml::closure> observers;
 
-  if (queue_entries_.at(queue_id)->subsumed_by != _kUnmerged) {
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  if (queue_entry->subsumed_by.load() != _kUnmerged) {
     return observers;
   }
 
-  for (const auto& observer : queue_entries_.at(queue_id)->task_observers) {
+  for (const auto& observer : queue_entry->task_observers) {
     observers.push_back(observer.second);
   }
 
-  auto& subsumed_set = queue_entries_.at(queue_id)->owner_of;
+  auto& subsumed_set = queue_entry->owner_of;
   for (auto& subsumed : subsumed_set) {
-    for (const auto& observer : queue_entries_.at(subsumed)->task_observers) {
+    for (const auto& observer : GetEntry(subsumed)->task_observers) {
       observers.push_back(observer.second);
     }
   }
@@ -218,9 +481,9 @@ std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
 void MessageLoopTaskQueues::SetWakeable(TaskQueueId queue_id,
                                         fml::Wakeable* wakeable) {
   std::lock_guard guard(queue_mutex_);
-  FML_CHECK(!queue_entries_.at(queue_id)->wakeable)
-      << "Wakeable can only be set once.";
-  queue_entries_.at(queue_id)->wakeable = wakeable;
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  FML_CHECK(!queue_entry->wakeable.load()) << "Wakeable can only be set once.";
+  queue_entry->wakeable.store(wakeable);
 }
 
 bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
@@ -228,8 +491,8 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
     return true;
   }
   std::lock_guard guard(queue_mutex_);
-  auto& owner_entry = queue_entries_.at(owner);
-  auto& subsumed_entry = queue_entries_.at(subsumed);
+  TaskQueueEntry* owner_entry = GetEntry(owner);
+  TaskQueueEntry* subsumed_entry = GetEntry(subsumed);
   auto& subsumed_set = owner_entry->owner_of;
   if (subsumed_set.find(subsumed) != subsumed_set.end()) {
     return true;
@@ -239,11 +502,12 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   // merged with other different queues.
 
   // Ensure owner_entry->subsumed_by being _kUnmerged
-  if (owner_entry->subsumed_by != _kUnmerged) {
+  if (owner_entry->subsumed_by.load() != _kUnmerged) {
     FML_LOG(WARNING) << "Thread merging failed: owner_entry was already "
                         "subsumed by others, owner="
                      << owner << ", subsumed=" << subsumed
-                     << ", owner->subsumed_by=" << owner_entry->subsumed_by;
+                     << ", owner->subsumed_by="
+                     << owner_entry->subsumed_by.load();
     return false;
   }
   // Ensure subsumed_entry->owner_of being empty
@@ -255,18 +519,19 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
     return false;
   }
   // Ensure subsumed_entry->subsumed_by being _kUnmerged
-  if (subsumed_entry->subsumed_by != _kUnmerged) {
+  if (subsumed_entry->subsumed_by.load() != _kUnmerged) {
     FML_LOG(WARNING) << "Thread merging failed: subsumed_entry was already "
                         "subsumed by others, owner="
                      << owner << ", subsumed=" << subsumed
                      << ", subsumed->subsumed_by="
-                     << subsumed_entry->subsumed_by;
+                     << subsumed_entry->subsumed_by.load();
     return false;
   }
   // All checking is OK, set merged state.
   owner_entry->owner_of.insert(subsumed);
-  subsumed_entry->subsumed_by = owner;
+  subsumed_entry->subsumed_by.store(owner);
 
+  MoveIncomingTasksUnlocked(owner);
   if (HasPendingTasksUnlocked(owner)) {
     WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
   }
@@ -276,21 +541,22 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
 
 bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
   std::lock_guard guard(queue_mutex_);
-  const auto& owner_entry = queue_entries_.at(owner);
+  TaskQueueEntry* owner_entry = GetEntry(owner);
   if (owner_entry->owner_of.empty()) {
     FML_LOG(WARNING)
         << "Thread unmerging failed: owner_entry doesn't own anyone, owner="
         << owner << ", subsumed=" << subsumed;
     return false;
   }
-  if (owner_entry->subsumed_by != _kUnmerged) {
+  if (owner_entry->subsumed_by.load() != _kUnmerged) {
     FML_LOG(WARNING)
         << "Thread unmerging failed: owner_entry was subsumed by others, owner="
         << owner << ", subsumed=" << subsumed
-        << ", owner_entry->subsumed_by=" << owner_entry->subsumed_by;
+        << ", owner_entry->subsumed_by=" << owner_entry->subsumed_by.load();
     return false;
   }
-  if (queue_entries_.at(subsumed)->subsumed_by == _kUnmerged) {
+  TaskQueueEntry* subsumed_entry = GetEntry(subsumed);
+  if (subsumed_entry->subsumed_by.load() == _kUnmerged) {
     FML_LOG(WARNING) << "Thread unmerging failed: subsumed_entry wasn't "
                         "subsumed by others, owner="
                      << owner << ", subsumed=" << subsumed;
@@ -303,13 +569,15 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
     return false;
   }
 
-  queue_entries_.at(subsumed)->subsumed_by = _kUnmerged;
+  subsumed_entry->subsumed_by.store(_kUnmerged);
   owner_entry->owner_of.erase(subsumed);
 
+  MoveIncomingTasksUnlocked(owner);
   if (HasPendingTasksUnlocked(owner)) {
     WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
   }
 
+  MoveIncomingTasksUnlocked(subsumed);
   if (HasPendingTasksUnlocked(subsumed)) {
     WakeUpUnlocked(subsumed, GetNextWakeTimeUnlocked(subsumed));
   }
@@ -323,25 +591,32 @@ bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
   if (owner == _kUnmerged || subsumed == _kUnmerged) {
     return false;
   }
-  auto& subsumed_set = queue_entries_.at(owner)->owner_of;
+  auto& subsumed_set = GetEntry(owner)->owner_of;
   return subsumed_set.find(subsumed) != subsumed_set.end();
 }
 
 std::set<TaskQueueId> MessageLoopTaskQueues::GetSubsumedTaskQueueId(
     TaskQueueId owner) const {
   std::lock_guard guard(queue_mutex_);
-  return queue_entries_.at(owner)->owner_of;
+  return GetEntry(owner)->owner_of;
 }
 
 void MessageLoopTaskQueues::PauseSecondarySource(TaskQueueId queue_id) {
   std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_source->PauseSecondary();
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  queue_entry->task_source->PauseSecondary();
+  queue_entry->secondary_paused.store(true);
 }
 
 void MessageLoopTaskQueues::ResumeSecondarySource(TaskQueueId queue_id) {
   std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_source->ResumeSecondary();
-  // Schedule a wake as needed.
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  queue_entry->task_source->ResumeSecondary();
+  queue_entry->secondary_paused.store(
+      queue_entry->task_source->IsSecondaryPaused());
+  // Schedule a wake as needed. This also picks up the secondary tasks that
+  // were posted while paused.
+  MoveIncomingTasksUnlocked(queue_id);
   if (HasPendingTasksUnlocked(queue_id)) {
     WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
   }
@@ -351,8 +626,8 @@ void MessageLoopTaskQueues::ResumeSecondarySource(TaskQueueId queue_id) {
 // Owning queues will consider both their and their subsumed tasks.
 bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
     TaskQueueId queue_id) const {
-  const auto& entry = queue_entries_.at(queue_id);
-  bool is_subsumed = entry->subsumed_by != _kUnmerged;
+  TaskQueueEntry* entry = GetEntry(queue_id);
+  bool is_subsumed = entry->subsumed_by.load() != _kUnmerged;
   if (is_subsumed) {
     return false;
   }
@@ -364,7 +639,7 @@ bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
   auto& subsumed_set = entry->owner_of;
   return std::any_of(
       subsumed_set.begin(), subsumed_set.end(), [&](const auto& subsumed) {
-        return !queue_entries_.at(subsumed)->task_source->IsEmpty();
+        return !GetEntry(subsumed)->task_source->IsEmpty();
       });
 }
 
@@ -376,7 +651,7 @@ fml::TimePoint MessageLoopTaskQueues::GetNextWakeTimeUnlocked(
 TaskSource::TopTask MessageLoopTaskQueues::PeekNextTaskUnlocked(
     TaskQueueId owner) const {
   FML_DCHECK(HasPendingTasksUnlocked(owner));
-  const auto& entry = queue_entries_.at(owner);
+  TaskQueueEntry* entry = GetEntry(owner);
   if (entry->owner_of.empty()) {
     FML_CHECK(!entry->task_source->IsEmpty());
     return entry->task_source->Top();
@@ -399,7 +674,7 @@ TaskSource::TopTask MessageLoopTaskQueues::PeekNextTaskUnlocked(
   top_task_updater(owner_tasks);
 
   for (TaskQueueId subsumed : entry->owner_of) {
-    TaskSource* subsumed_tasks = queue_entries_.at(subsumed)->task_source.get();
+    TaskSource* subsumed_tasks = GetEntry(subsumed)->task_source.get();
     top_task_updater(subsumed_tasks);
   }
   // At least one task at the top because PeekNextTaskUnlocked() is called after
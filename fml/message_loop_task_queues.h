@@ -5,7 +5,11 @@
 #ifndef FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 #define FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 
+#include <array>
+#include <atomic>
+#include <deque>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <vector>
@@ -23,6 +27,36 @@ namespace fml {
 
 static const TaskQueueId _kUnmerged = TaskQueueId(TaskQueueId::kUnmerged);
 
+/// A lock-free list of the tasks that have been posted to a TaskQueue but
+/// not yet moved into the heaps of its \p fml::TaskSource.
+///
+/// Any number of threads may push tasks concurrently. Only the thread that
+/// holds the lock of the \p fml::MessageLoopTaskQueues may take them, and it
+/// takes all of them at once, so the list never has to deal with tasks
+/// being removed from under a producer.
+class IncomingTaskList {
+ public:
+  IncomingTaskList() = default;
+
+  ~IncomingTaskList();
+
+  void Push(const DelayedTask& task);
+
+  /// Moves all of the tasks into the |task_source| and returns the earliest
+  /// target time among them, or \p fml::TimePoint::Max if there were none.
+  fml::TimePoint MoveTo(TaskSource& task_source);
+
+  /// Drops all of the tasks.
+  void Clear();
+
+ private:
+  struct Node;
+
+  std::atomic<Node*> head_ = nullptr;
+
+  FML_DISALLOW_COPY_ASSIGN_AND_MOVE(IncomingTaskList);
+};
+
 /// A collection of tasks and observers associated with one TaskQueue.
 ///
 /// Often a TaskQueue has a one-to-one relationship with a fml::MessageLoop,
@@ -31,20 +65,48 @@ static const TaskQueueId _kUnmerged = TaskQueueId(TaskQueueId::kUnmerged);
 class TaskQueueEntry {
  public:
   using TaskObservers = std::map<intptr_t, fml::closure>;
-  Wakeable* wakeable;
+  std::atomic<Wakeable*> wakeable;
   TaskObservers task_observers;
+
+  /// The tasks of this TaskQueue ordered by their target time. Only accessed
+  /// while holding the lock of the \p fml::MessageLoopTaskQueues.
   std::unique_ptr<TaskSource> task_source;
 
+  /// The tasks that were posted without taking the lock and that have not
+  /// been moved into the |task_source| yet.
+  IncomingTaskList incoming_tasks;
+
   /// Set of the TaskQueueIds which is owned by this TaskQueue. If the set is
   /// empty, this TaskQueue does not own any other TaskQueues.
   std::set<TaskQueueId> owner_of;
 
   /// Identifies the TaskQueue that subsumes this TaskQueue. If it is _kUnmerged
   /// it indicates that this TaskQueue is not owned by any other TaskQueue.
-  TaskQueueId subsumed_by;
+  /// Only modified while holding the lock, but read without it when tasks are
+  /// posted to find the loop to wake up.
+  std::atomic<TaskQueueId> subsumed_by;
 
   TaskQueueId created_for;
 
+  /// The time the loop of this TaskQueue was last asked to wake up at for
+  /// the tasks of this TaskQueue and the ones it owns. Posting a task lowers
+  /// it without taking the lock. It may be earlier than the next task, which
+  /// leads to a spurious wake up, but is never later.
+  std::atomic<fml::TimePoint> wake_time;
+
+  /// Whether the secondary tasks of the |task_source| are paused, for posting
+  /// tasks without taking the lock.
+  std::atomic<bool> secondary_paused;
+
+  /// Set once the TaskQueue is disposed. The entry itself is only freed once
+  /// no thread posting tasks can hold on to it anymore.
+  std::atomic<bool> disposed;
+
+  /// The number of threads that are posting a task to this TaskQueue or
+  /// waking up its loop without holding the lock. Disposing the TaskQueue
+  /// waits for them before it drops the tasks and lets go of the loop.
+  std::atomic<size_t> active_posters;
+
   explicit TaskQueueEntry(TaskQueueId created_for);
 
  private:
@@ -60,6 +122,12 @@ enum class FlushType {
 /// fml::MessageLoops.
 ///
 /// This also wakes up the loop at the required times.
+///
+/// Posting a task only pushes it onto the lock-free \p fml::IncomingTaskList
+/// of its TaskQueue, so threads posting tasks do not contend with each other
+/// or with the loops running them. Everything else, including moving the
+/// posted tasks into the heaps the loops take them from, happens while
+/// holding a lock.
 /// \see fml::MessageLoop
 /// \see fml::Wakeable
 class MessageLoopTaskQueues
@@ -140,23 +208,79 @@ class MessageLoopTaskQueues
  private:
   class MergedQueuesRunner;
 
+  class ScopedEntryAccess;
+
   MessageLoopTaskQueues();
 
   ~MessageLoopTaskQueues();
 
+  // Queue ids are handed out in order, and the ids of disposed TaskQueues are
+  // reused, so the entries are kept in blocks that are indexed by the id and
+  // are never moved, which lets threads find the entry to post a task to
+  // without taking the lock.
+  static constexpr size_t kEntriesPerBlock = 1024;
+  static constexpr size_t kMaxEntryBlocks = 16384;
+  using EntryBlock = std::array<std::atomic<TaskQueueEntry*>, kEntriesPerBlock>;
+
+  TaskQueueEntry* GetEntry(TaskQueueId queue_id) const;
+
+  // Like |GetEntry|, but returns null if the TaskQueue has been disposed.
+  TaskQueueEntry* FindEntry(TaskQueueId queue_id) const;
+
   void WakeUpUnlocked(TaskQueueId queue_id, fml::TimePoint time) const;
 
+  // Lowers the |wake_time| of the |entry| to |time| if it is later and
+  // returns the resulting wake time. Does not need the lock.
+  static fml::TimePoint LowerWakeTime(TaskQueueEntry* entry,
+                                      fml::TimePoint time);
+
+  // Wakes up the loop of the |entry| at |time| or at an earlier time that
+  // was published to its |wake_time| concurrently. Does not need the lock.
+  static void WakeUpLoop(TaskQueueEntry* entry, fml::TimePoint time);
+
+  // Records the time of the next task of |queue_id| as its wake time once a
+  // task has been taken, so that tasks posted later are not compared against
+  // the time of a task that already ran. The loop is only woken up again if
+  // tasks that are due earlier were posted in the meantime.
+  void ResetWakeTimeUnlocked(TaskQueueId queue_id) const;
+
+  // Moves the tasks posted to |queue_id| and the queues it owns into their
+  // task sources and returns the earliest target time among them.
+  fml::TimePoint MoveIncomingTasksUnlocked(TaskQueueId queue_id) const;
+
   bool HasPendingTasksUnlocked(TaskQueueId queue_id) const;
 
   TaskSource::TopTask PeekNextTaskUnlocked(TaskQueueId owner) const;
 
   fml::TimePoint GetNextWakeTimeUnlocked(TaskQueueId queue_id) const;
 
+  // Frees the entries of disposed TaskQueues that no thread posting tasks can
+  // still hold on to, and makes their ids available again.
+  void ReclaimDisposedEntriesUnlocked();
+
   static std::mutex creation_mutex_;
   static fml::RefPtr<MessageLoopTaskQueues> instance_;
 
   mutable std::mutex queue_mutex_;
-  std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
+  std::array<std::atomic<EntryBlock*>, kMaxEntryBlocks> entry_blocks_;
+
+  // Threads that look up entries without holding the lock count themselves
+  // in the reader count of the epoch they started in. The epoch only moves
+  // on once the readers of the epoch before the current one are gone, so an
+  // entry that was removed from its slot in some epoch can no longer be in
+  // use two epochs later.
+  std::atomic<size_t> epoch_;
+  std::array<std::atomic<size_t>, 2> epoch_readers_;
+
+  struct DisposedEntry {
+    size_t epoch;
+    TaskQueueId queue_id;
+    std::unique_ptr<TaskQueueEntry> entry;
+  };
+  // The entries of disposed TaskQueues, by the epoch they were removed in.
+  std::deque<DisposedEntry> disposed_entries_;
+  // The ids of the TaskQueues whose entries were freed.
+  std::vector<TaskQueueId> free_queue_ids_;
 
   size_t task_queue_id_counter_;
 
@@ -66,5 +66,79 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
 
 BENCHMARK(BM_RegisterAndGetTasks);
 
+// Several threads post tasks to one task queue while the thread that owns it
+// runs them, like the platform and worker threads posting to the UI thread.
+static void BM_MultiProducerSingleConsumer(benchmark::State& state) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  const int num_producers = state.range(0);
+  const int num_tasks_per_producer = 1000;
+  const int num_tasks = num_producers * num_tasks_per_producer;
+
+  for ([[maybe_unused]] auto _ : state) {
+    const TaskQueueId queue_id = task_queue->CreateTaskQueue();
+    const fml::TimePoint past = fml::TimePoint::Now();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_producers; i++) {
+      threads.emplace_back([&task_queue, queue_id, past]() {
+        for (int j = 0; j < num_tasks_per_producer; j++) {
+          task_queue->RegisterTask(
+              queue_id, [] {}, past);
+        }
+      });
+    }
+
+    int num_invocations = 0;
+    while (num_invocations < num_tasks) {
+      fml::closure invocation =
+          task_queue->GetNextTaskToRun(queue_id, fml::TimePoint::Max());
+      if (invocation) {
+        invocation();
+        num_invocations++;
+      }
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    task_queue->Dispose(queue_id);
+  }
+  state.SetItemsProcessed(state.iterations() * num_tasks);
+}
+
+BENCHMARK(BM_MultiProducerSingleConsumer)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+
+// Threads posting tasks without anyone running them, either all to the same
+// task queue or each to its own, which measures the contention between
+// threads that only post tasks.
+static void BM_RegisterTasks(benchmark::State& state) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  static const TaskQueueId shared_queue_id = task_queue->CreateTaskQueue();
+  const bool shared = state.range(0) != 0;
+  const TaskQueueId queue_id =
+      shared ? shared_queue_id : task_queue->CreateTaskQueue();
+  const fml::TimePoint past = fml::TimePoint::Now();
+
+  for ([[maybe_unused]] auto _ : state) {
+    task_queue->RegisterTask(
+        queue_id, [] {}, past);
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  // All of the threads are done posting tasks by the time any of them gets
+  // here.
+  if (!shared) {
+    task_queue->Dispose(queue_id);
+  } else if (state.thread_index() == 0) {
+    task_queue->DisposeTasks(queue_id);
+  }
+}
+
+BENCHMARK(BM_RegisterTasks)->ArgName("shared")->Arg(0)->ThreadRange(1, 16);
+BENCHMARK(BM_RegisterTasks)->ArgName("shared")->Arg(1)->ThreadRange(1, 16);
+
 }  // namespace benchmarking
 }  // namespace fml
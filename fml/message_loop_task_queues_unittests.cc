@@ -7,6 +7,7 @@
 #include "flutter/fml/message_loop_task_queues.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <thread>
 
@@ -412,6 +413,55 @@ TEST(MessageLoopTaskQueue, ConcurrentQueueAndTaskCreatingCounts) {
   ASSERT_EQ(pending_tasks, kThreadCount * kThreadTaskCount);
 }
 
+//------------------------------------------------------------------------------
+/// Verifies that tasks posted concurrently with the loop taking tasks are all
+/// run exactly once and that the loop is woken up for them.
+///
+TEST(MessageLoopTaskQueue, ConcurrentRegisterAndGetNextTaskToRun) {
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queues->CreateTaskQueue();
+
+  constexpr size_t kThreadCount = 4;
+  constexpr size_t kThreadTaskCount = 1000;
+
+  std::atomic<size_t> wakes = 0;
+  auto wakeable = std::make_unique<TestWakeable>(
+      [&wakes](fml::TimePoint wake_time) { ++wakes; });
+  task_queues->SetWakeable(queue_id, wakeable.get());
+
+  std::vector<size_t> runs(kThreadCount * kThreadTaskCount, 0);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadCount; i++) {
+    threads.emplace_back([&, i]() {
+      for (size_t j = 0; j < kThreadTaskCount; j++) {
+        const size_t index = i * kThreadTaskCount + j;
+        task_queues->RegisterTask(
+            queue_id, [&runs, index]() { runs[index]++; },
+            ChronoTicksSinceEpoch());
+      }
+    });
+  }
+
+  size_t run_count = 0;
+  while (run_count < kThreadCount * kThreadTaskCount) {
+    fml::closure task =
+        task_queues->GetNextTaskToRun(queue_id, fml::TimePoint::Max());
+    if (task) {
+      task();
+      run_count++;
+    }
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_FALSE(task_queues->HasPendingTasks(queue_id));
+  ASSERT_TRUE(std::all_of(runs.begin(), runs.end(),
+                          [](size_t count) { return count == 1; }));
+  ASSERT_GE(wakes.load(), kThreadCount * kThreadTaskCount);
+}
+
 TEST(MessageLoopTaskQueue, RegisterTaskWakesUpOwnerQueue) {
   auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
   auto platform_queue = task_queue->CreateTaskQueue();
@@ -450,5 +500,53 @@ TEST(MessageLoopTaskQueue, RegisterTaskWakesUpOwnerQueue) {
   ASSERT_EQ(time1, wakes[2]);
 }
 
+TEST(MessageLoopTaskQueue, DisposedOwnerIsNotWokenUpByConcurrentPosts) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto raster_queue = task_queue->CreateTaskQueue();
+  auto raster_wakeable = std::make_unique<TestWakeable>([](fml::TimePoint) {});
+  task_queue->SetWakeable(raster_queue, raster_wakeable.get());
+
+  std::atomic_bool done = false;
+  std::thread poster([&]() {
+    while (!done.load()) {
+      task_queue->RegisterTask(
+          raster_queue, []() {}, ChronoTicksSinceEpoch());
+    }
+  });
+
+  for (int i = 0; i < 100; i++) {
+    auto platform_queue = task_queue->CreateTaskQueue();
+    std::atomic_bool platform_loop_alive = true;
+    auto platform_wakeable =
+        std::make_unique<TestWakeable>([&](fml::TimePoint) {
+          ASSERT_TRUE(platform_loop_alive.load());
+        });
+    task_queue->SetWakeable(platform_queue, platform_wakeable.get());
+
+    ASSERT_TRUE(task_queue->Merge(platform_queue, raster_queue));
+    ASSERT_TRUE(task_queue->Unmerge(platform_queue, raster_queue));
+    task_queue->Dispose(platform_queue);
+    // Posts that still saw the merge must be done with the loop by now.
+    platform_loop_alive = false;
+  }
+
+  done = true;
+  poster.join();
+  task_queue->Dispose(raster_queue);
+}
+
+TEST(MessageLoopTaskQueue, ReusesIdsOfDisposedQueues) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  task_queue->RegisterTask(
+      queue_id, []() {}, ChronoTicksSinceEpoch());
+  task_queue->Dispose(queue_id);
+  // No thread is posting a task, so the entry is freed right away.
+  auto new_queue_id = task_queue->CreateTaskQueue();
+  ASSERT_EQ(new_queue_id, queue_id);
+  ASSERT_FALSE(task_queue->HasPendingTasks(new_queue_id));
+  task_queue->Dispose(new_queue_id);
+}
+
 }  // namespace testing
 }  // namespace fml
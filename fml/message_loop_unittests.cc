@@ -6,6 +6,7 @@
 
 #include "flutter/fml/message_loop.h"
 
+#include <atomic>
 #include <iostream>
 #include <thread>
 
@@ -317,3 +318,130 @@ TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   latch.Wait();
   ASSERT_GE(thread_ids.size(), 1u);
 }
+
+TEST(MessageLoop, WorkStealingConcurrentMessageLoopRunsAllTasks) {
+  auto loop = fml::ConcurrentMessageLoop::Create(
+      4u, fml::ConcurrentMessageLoop::Scheduling::kWorkStealing);
+  ASSERT_EQ(loop->GetScheduling(),
+            fml::ConcurrentMessageLoop::Scheduling::kWorkStealing);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kCount = 1000;
+  fml::CountDownLatch latch(kCount * 2);
+  std::atomic_size_t run_count = 0;
+  for (size_t i = 0; i < kCount; ++i) {
+    task_runner->PostTask(
+        [&]() {
+          run_count++;
+          // Tasks posted by a worker are queued for that worker.
+          task_runner->PostTask([&]() {
+            run_count++;
+            latch.CountDown();
+          });
+          // Only once the task runner let go of the loop, which must not be
+          // destroyed on a worker.
+          latch.CountDown();
+        },
+        fml::ConcurrentTaskPriority::kNormal, i);
+  }
+  latch.Wait();
+  ASSERT_EQ(run_count, kCount * 2);
+}
+
+TEST(MessageLoop, WorkStealingConcurrentMessageLoopStealsFromBusyWorkers) {
+  auto loop = fml::ConcurrentMessageLoop::Create(
+      2u, fml::ConcurrentMessageLoop::Scheduling::kWorkStealing);
+  auto task_runner = loop->GetTaskRunner();
+  fml::AutoResetWaitableEvent blocked_started, release_blocked, stolen_done;
+  std::thread::id blocked_thread, stolen_thread;
+  task_runner->PostTask(
+      [&]() {
+        blocked_thread = std::this_thread::get_id();
+        blocked_started.Signal();
+        release_blocked.Wait();
+      },
+      fml::ConcurrentTaskPriority::kNormal, 0);
+  blocked_started.Wait();
+  // Queued for the blocked worker, so it only runs if the other one steals
+  // it.
+  task_runner->PostTask(
+      [&]() {
+        stolen_thread = std::this_thread::get_id();
+        stolen_done.Signal();
+      },
+      fml::ConcurrentTaskPriority::kNormal, 0);
+  stolen_done.Wait();
+  ASSERT_NE(blocked_thread, stolen_thread);
+  release_blocked.Signal();
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsHigherPriorityTasksFirst) {
+  for (auto scheduling :
+       {fml::ConcurrentMessageLoop::Scheduling::kSharedQueue,
+        fml::ConcurrentMessageLoop::Scheduling::kWorkStealing}) {
+    auto loop = fml::ConcurrentMessageLoop::Create(1u, scheduling);
+    auto task_runner = loop->GetTaskRunner();
+    fml::AutoResetWaitableEvent blocked_started, release_blocked;
+    fml::CountDownLatch latch(3);
+    std::vector<fml::ConcurrentTaskPriority> order;
+    task_runner->PostTask([&]() {
+      blocked_started.Signal();
+      release_blocked.Wait();
+    });
+    blocked_started.Wait();
+    for (auto priority : {fml::ConcurrentTaskPriority::kBackground,
+                          fml::ConcurrentTaskPriority::kNormal,
+                          fml::ConcurrentTaskPriority::kHigh}) {
+      task_runner->PostTask(
+          [&order, &latch, priority]() {
+            order.push_back(priority);
+            latch.CountDown();
+          },
+          priority);
+    }
+    release_blocked.Signal();
+    latch.Wait();
+    std::vector<fml::ConcurrentTaskPriority> expected = {
+        fml::ConcurrentTaskPriority::kHigh,
+        fml::ConcurrentTaskPriority::kNormal,
+        fml::ConcurrentTaskPriority::kBackground,
+    };
+    ASSERT_EQ(order, expected);
+  }
+}
+
+TEST(MessageLoop, WorkStealingConcurrentMessageLoopRunsTasksPostedAtShutdown) {
+  for (int i = 0; i < 100; ++i) {
+    auto loop = fml::ConcurrentMessageLoop::Create(
+        2u, fml::ConcurrentMessageLoop::Scheduling::kWorkStealing);
+    auto task_runner = loop->GetTaskRunner();
+    const size_t kCount = 100;
+    std::atomic_size_t run_count = 0;
+    std::thread poster([&]() {
+      for (size_t j = 0; j < kCount; ++j) {
+        task_runner->PostTask([&run_count]() { run_count++; });
+      }
+    });
+    loop->Terminate();
+    poster.join();
+    // Every task either ran on a worker before it exited or on the thread
+    // that posted it.
+    loop.reset();
+    ASSERT_EQ(run_count, kCount);
+  }
+}
+
+TEST(MessageLoop, WorkStealingConcurrentMessageLoopPostsTaskToAllWorkers) {
+  const size_t kWorkerCount = 3;
+  auto loop = fml::ConcurrentMessageLoop::Create(
+      kWorkerCount, fml::ConcurrentMessageLoop::Scheduling::kWorkStealing);
+  fml::CountDownLatch latch(kWorkerCount);
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  loop->PostTaskToAllWorkers([&]() {
+    std::scoped_lock lock(thread_ids_mutex);
+    thread_ids.insert(std::this_thread::get_id());
+    latch.CountDown();
+  });
+  latch.Wait();
+  ASSERT_EQ(thread_ids.size(), kWorkerCount);
+}
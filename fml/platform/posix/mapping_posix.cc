@@ -83,6 +83,7 @@ FileMapping::FileMapping(const fml::UniqueFD& handle,
   if (is_writable) {
     mutable_mapping_ = mapping_;
   }
+  RecordFileMappedBytes(size_);
 }
 
 FileMapping::~FileMapping() {
@@ -103,6 +104,32 @@ bool FileMapping::IsDontNeedSafe() const {
   return mutable_mapping_ == nullptr;
 }
 
+bool FileMapping::IsSharedFileBacked() const {
+  return mapping_ != nullptr && mutable_mapping_ == nullptr;
+}
+
+bool FileMapping::Advise(Advice advice) const {
+  if (mapping_ == nullptr) {
+    return false;
+  }
+  int posix_advice = MADV_NORMAL;
+  switch (advice) {
+    case Advice::kWillNeed:
+      posix_advice = MADV_WILLNEED;
+      break;
+    case Advice::kSequential:
+      posix_advice = MADV_SEQUENTIAL;
+      break;
+    case Advice::kDontNeed:
+      if (!IsDontNeedSafe()) {
+        return false;
+      }
+      posix_advice = MADV_DONTNEED;
+      break;
+  }
+  return ::madvise(mapping_, size_, posix_advice) == 0;
+}
+
 bool FileMapping::IsValid() const {
   return valid_;
 }
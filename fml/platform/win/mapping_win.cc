@@ -99,6 +99,7 @@ FileMapping::FileMapping(const fml::UniqueFD& fd,
   if (IsWritable(protections)) {
     mutable_mapping_ = mapping_;
   }
+  RecordFileMappedBytes(size_);
 }
 
 FileMapping::~FileMapping() {
@@ -119,6 +120,16 @@ bool FileMapping::IsDontNeedSafe() const {
   return mutable_mapping_ == nullptr;
 }
 
+bool FileMapping::IsSharedFileBacked() const {
+  return mapping_ != nullptr && mutable_mapping_ == nullptr;
+}
+
+bool FileMapping::Advise(Advice advice) const {
+  // Windows reads file mappings in on demand and has no equivalent of these
+  // hints that is available on all of the supported versions.
+  return false;
+}
+
 bool FileMapping::IsValid() const {
   return valid_;
 }
@@ -71,6 +71,10 @@ class TaskSource {
   /// Resume providing tasks from secondary task heap.
   void ResumeSecondary();
 
+  /// Returns true if there are outstanding requests to pause the secondary
+  /// task heap.
+  bool IsSecondaryPaused() const;
+
  private:
   const fml::TaskQueueId task_queue_id_;
   fml::DelayedTaskQueue primary_task_queue_;
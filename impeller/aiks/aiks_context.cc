@@ -37,11 +37,11 @@ bool AiksContext::Render(const Picture& picture, RenderTarget& render_target) {
     return false;
   }
 
-  if (picture.pass) {
-    return picture.pass->Render(*content_context_, render_target);
+  if (picture.pass && !picture.pass->Render(*content_context_, render_target)) {
+    return false;
   }
 
-  return true;
+  return content_context_->FinishFrame();
 }
 
 }  // namespace impeller
@@ -31,6 +31,7 @@ std::shared_ptr<Contents> Paint::CreateContentsForEntity(Path path,
       solid_stroke->SetStrokeMiter(stroke_miter);
       solid_stroke->SetStrokeCap(stroke_cap);
       solid_stroke->SetStrokeJoin(stroke_join);
+      solid_stroke->SetStrokeDashes(stroke_dashes, stroke_dash_phase);
       return solid_stroke;
     }
   }
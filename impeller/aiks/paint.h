@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "flutter/fml/macros.h"
 #include "impeller/entity/contents/contents.h"
@@ -36,6 +37,8 @@ struct Paint {
   SolidStrokeContents::Cap stroke_cap = SolidStrokeContents::Cap::kButt;
   SolidStrokeContents::Join stroke_join = SolidStrokeContents::Join::kMiter;
   Scalar stroke_miter = 4.0;
+  std::vector<Scalar> stroke_dashes;
+  Scalar stroke_dash_phase = 0.0;
   Style style = Style::kFill;
   Entity::BlendMode blend_mode = Entity::BlendMode::kSourceOver;
 
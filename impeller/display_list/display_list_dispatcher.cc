@@ -279,8 +279,20 @@ void DisplayListDispatcher::setBlender(sk_sp<SkBlender> blender) {
 
 // |flutter::Dispatcher|
 void DisplayListDispatcher::setPathEffect(const flutter::DlPathEffect* effect) {
-  // Needs https://github.com/flutter/flutter/issues/95434
-  UNIMPLEMENTED;
+  paint_.stroke_dashes.clear();
+  paint_.stroke_dash_phase = 0.0;
+  if (!effect) {
+    return;
+  }
+  const flutter::DlDashPathEffect* dash = effect->asDash();
+  if (!dash) {
+    // Needs https://github.com/flutter/flutter/issues/95434
+    UNIMPLEMENTED;
+    return;
+  }
+  paint_.stroke_dashes.assign(dash->intervals(),
+                              dash->intervals() + dash->count());
+  paint_.stroke_dash_phase = dash->phase();
 }
 
 static FilterContents::BlurStyle ToBlurStyle(SkBlurStyle blur_style) {
@@ -144,11 +144,17 @@ static std::unique_ptr<PipelineT> CreateDefaultPipeline(
 }
 
 ContentContext::ContentContext(std::shared_ptr<Context> context)
-    : context_(std::move(context)) {
+    : context_(std::move(context)),
+      tessellator_(std::make_shared<Tessellator>()),
+      stroke_generator_(std::make_shared<StrokeGenerator>()),
+      transients_buffer_(HostBuffer::Create()) {
+  transients_buffer_->SetLabel("ContentContext Transients");
   if (!context_ || !context_->IsValid()) {
     return;
   }
 
+  text_render_context_ = TextRenderContext::Create(context_);
+
   gradient_fill_pipelines_[{}] =
       CreateDefaultPipeline<GradientFillPipeline>(*context_);
   solid_fill_pipelines_[{}] =
@@ -247,6 +253,7 @@ std::shared_ptr<Texture> ContentContext::MakeSubpass(
     return nullptr;
   }
   sub_renderpass->SetLabel("OffscreenContentsPass");
+  sub_renderpass->SetTransientsBuffer(transients_buffer_);
 
   if (!subpass_callback(*this, *sub_renderpass)) {
     return nullptr;
@@ -267,4 +274,47 @@ std::shared_ptr<Context> ContentContext::GetContext() const {
   return context_;
 }
 
+std::shared_ptr<Tessellator> ContentContext::GetTessellator() const {
+  return tessellator_;
+}
+
+std::shared_ptr<StrokeGenerator> ContentContext::GetStrokeGenerator() const {
+  return stroke_generator_;
+}
+
+std::shared_ptr<TextRenderContext> ContentContext::GetTextRenderContext()
+    const {
+  return text_render_context_;
+}
+
+std::shared_ptr<HostBuffer> ContentContext::GetTransientsBuffer() const {
+  return transients_buffer_;
+}
+
+bool ContentContext::FinishFrame() const {
+  auto fence = transients_buffer_->FinishFrame();
+
+  // Command buffers complete in the order they are submitted, so this one
+  // completes after all the ones that read the transients of the frame.
+  // If the device fails, whether it is done with the transients is unknown,
+  // so the fence is abandoned and the blocks of the frame are not reused.
+  auto command_buffer = context_->CreateRenderCommandBuffer();
+  if (!command_buffer) {
+    fence->Abandon();
+    return false;
+  }
+  command_buffer->SetLabel("ContentContext Frame Fence");
+  if (!command_buffer->SubmitCommands([fence](CommandBuffer::Status status) {
+        if (status == CommandBuffer::Status::kCompleted) {
+          fence->Signal();
+        } else {
+          fence->Abandon();
+        }
+      })) {
+    fence->Abandon();
+    return false;
+  }
+  return true;
+}
+
 }  // namespace impeller
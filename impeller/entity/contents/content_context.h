@@ -31,6 +31,7 @@
 #include "impeller/entity/blend.vert.h"
 #include "impeller/entity/border_mask_blur.frag.h"
 #include "impeller/entity/border_mask_blur.vert.h"
+#include "impeller/entity/contents/stroke_generator.h"
 #include "impeller/entity/entity.h"
 #include "impeller/entity/gaussian_blur.frag.h"
 #include "impeller/entity/gaussian_blur.vert.h"
@@ -47,6 +48,9 @@
 #include "impeller/entity/vertices.frag.h"
 #include "impeller/entity/vertices.vert.h"
 #include "impeller/renderer/formats.h"
+#include "impeller/renderer/host_buffer.h"
+#include "impeller/tessellator/tessellator.h"
+#include "impeller/typographer/text_render_context.h"
 
 namespace impeller {
 
@@ -262,6 +266,27 @@ class ContentContext {
 
   std::shared_ptr<Context> GetContext() const;
 
+  /// @brief  The tessellator that the contents fill their paths with, which
+  ///         keeps its scratch memory from one path to the next.
+  std::shared_ptr<Tessellator> GetTessellator() const;
+
+  /// @brief  The generator that the contents stroke their paths with, which
+  ///         keeps its scratch memory from one path to the next.
+  std::shared_ptr<StrokeGenerator> GetStrokeGenerator() const;
+
+  /// @brief  The text render context that glyph atlases are created with,
+  ///         which keeps rendered glyphs from one frame to the next.
+  std::shared_ptr<TextRenderContext> GetTextRenderContext() const;
+
+  /// @brief  The host buffer that the passes of a frame emplace their
+  ///         transients into, which keeps its blocks from one frame to the
+  ///         next.
+  std::shared_ptr<HostBuffer> GetTransientsBuffer() const;
+
+  /// @brief  Finishes the frame of the transients buffer. Its blocks are
+  ///         reused once the commands submitted so far have completed.
+  bool FinishFrame() const;
+
   using SubpassCallback =
       std::function<bool(const ContentContext&, RenderPass&)>;
 
@@ -272,6 +297,10 @@ class ContentContext {
 
  private:
   std::shared_ptr<Context> context_;
+  std::shared_ptr<Tessellator> tessellator_;
+  std::shared_ptr<StrokeGenerator> stroke_generator_;
+  std::shared_ptr<TextRenderContext> text_render_context_;
+  std::shared_ptr<HostBuffer> transients_buffer_;
 
   template <class T>
   using Variants = std::unordered_map<ContentContextOptions,
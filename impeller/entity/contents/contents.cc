@@ -25,6 +25,11 @@ ContentContextOptions OptionsFromPassAndEntity(const RenderPass& pass,
   return opts;
 }
 
+SmoothingApproximation SmoothingFromEntity(const Entity& entity) {
+  return SmoothingApproximation(
+      1.0 / entity.GetTransformation().GetMaxBasisLength(), 0.0, 0.0);
+}
+
 Contents::Contents() = default;
 
 Contents::~Contents() = default;
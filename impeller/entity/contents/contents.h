@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "flutter/fml/macros.h"
+#include "impeller/geometry/path_component.h"
 #include "impeller/geometry/rect.h"
 #include "impeller/renderer/snapshot.h"
 #include "impeller/renderer/texture.h"
@@ -26,6 +27,10 @@ ContentContextOptions OptionsFromPass(const RenderPass& pass);
 ContentContextOptions OptionsFromPassAndEntity(const RenderPass& pass,
                                                const Entity& entity);
 
+/// The approximation that flattens curves to within a quarter of a pixel
+/// when they are drawn with the transformation of |entity|.
+SmoothingApproximation SmoothingFromEntity(const Entity& entity);
+
 class Contents {
  public:
   Contents();
@@ -52,13 +52,13 @@ bool LinearGradientContents::Render(const ContentContext& renderer,
 
   auto vertices_builder = VertexBufferBuilder<VS::PerVertexData>();
   {
-    auto result =
-        Tessellator{}.Tessellate(path_.GetFillType(), path_.CreatePolyline(),
-                                 [&vertices_builder](Point point) {
-                                   VS::PerVertexData vtx;
-                                   vtx.vertices = point;
-                                   vertices_builder.AppendVertex(vtx);
-                                 });
+    auto result = renderer.GetTessellator()->Tessellate(
+        path_, SmoothingFromEntity(entity),
+        [&vertices_builder](Point point) {
+          VS::PerVertexData vtx;
+          vtx.vertices = point;
+          vertices_builder.AppendVertex(vtx);
+        });
 
     if (result == Tessellator::Result::kInputError) {
       return true;
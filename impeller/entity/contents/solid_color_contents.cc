@@ -41,14 +41,17 @@ std::optional<Rect> SolidColorContents::GetCoverage(
   return path_.GetTransformedBoundingBox(entity.GetTransformation());
 };
 
-VertexBuffer SolidColorContents::CreateSolidFillVertices(const Path& path,
-                                                         HostBuffer& buffer) {
+VertexBuffer SolidColorContents::CreateSolidFillVertices(
+    Tessellator& tessellator,
+    const Path& path,
+    const SmoothingApproximation& smoothing,
+    HostBuffer& buffer) {
   using VS = SolidFillPipeline::VertexShader;
 
   VertexBufferBuilder<VS::PerVertexData> vtx_builder;
 
-  auto tesselation_result = Tessellator{}.Tessellate(
-      path.GetFillType(), path.CreatePolyline(), [&vtx_builder](auto point) {
+  auto tesselation_result = tessellator.Tessellate(
+      path, smoothing, [&vtx_builder](auto point) {
         VS::PerVertexData vtx;
         vtx.vertices = point;
         vtx_builder.AppendVertex(vtx);
@@ -72,10 +75,11 @@ bool SolidColorContents::Render(const ContentContext& renderer,
   cmd.stencil_reference = entity.GetStencilDepth();
 
   cmd.BindVertices(CreateSolidFillVertices(
+      *renderer.GetTessellator(),
       cover_
           ? PathBuilder{}.AddRect(Size(pass.GetRenderTargetSize())).TakePath()
           : path_,
-      pass.GetTransientsBuffer()));
+      SmoothingFromEntity(entity), pass.GetTransientsBuffer()));
 
   VS::FrameInfo frame_info;
   frame_info.mvp = Matrix::MakeOrthographic(pass.GetRenderTargetSize()) *
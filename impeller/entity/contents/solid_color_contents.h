@@ -17,6 +17,7 @@ namespace impeller {
 
 class Path;
 class HostBuffer;
+class Tessellator;
 struct VertexBuffer;
 
 class SolidColorContents final : public Contents {
@@ -27,8 +28,11 @@ class SolidColorContents final : public Contents {
 
   static std::unique_ptr<SolidColorContents> Make(Path path, Color color);
 
-  static VertexBuffer CreateSolidFillVertices(const Path& path,
-                                              HostBuffer& buffer);
+  static VertexBuffer CreateSolidFillVertices(
+      Tessellator& tessellator,
+      const Path& path,
+      const SmoothingApproximation& smoothing,
+      HostBuffer& buffer);
 
   void SetPath(Path path);
 
@@ -4,45 +4,22 @@
 
 #pragma once
 
-#include <functional>
 #include <memory>
 #include <vector>
 
 #include "flutter/fml/macros.h"
 #include "impeller/entity/contents/contents.h"
-#include "impeller/entity/solid_stroke.vert.h"
+#include "impeller/entity/contents/stroke_generator.h"
 #include "impeller/geometry/color.h"
-#include "impeller/geometry/path_component.h"
 #include "impeller/geometry/point.h"
 
 namespace impeller {
 
 class SolidStrokeContents final : public Contents {
  public:
-  enum class Cap {
-    kButt,
-    kRound,
-    kSquare,
-  };
-
-  enum class Join {
-    kMiter,
-    kRound,
-    kBevel,
-  };
-
-  using CapProc = std::function<void(
-      VertexBufferBuilder<SolidStrokeVertexShader::PerVertexData>& vtx_builder,
-      const Point& position,
-      const Point& normal,
-      const SmoothingApproximation& smoothing)>;
-  using JoinProc = std::function<void(
-      VertexBufferBuilder<SolidStrokeVertexShader::PerVertexData>& vtx_builder,
-      const Point& position,
-      const Point& start_normal,
-      const Point& end_normal,
-      Scalar miter_limit,
-      const SmoothingApproximation& smoothing)>;
+  using Cap = StrokeGenerator::Cap;
+
+  using Join = StrokeGenerator::Join;
 
   SolidStrokeContents();
 
@@ -70,6 +47,13 @@ class SolidStrokeContents final : public Contents {
 
   Join GetStrokeJoin();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Dashes the stroke with the alternating "on" and "off"
+  ///             intervals, starting each contour at the phase into them. An
+  ///             empty list of intervals strokes without dashes.
+  ///
+  void SetStrokeDashes(std::vector<Scalar> intervals, Scalar phase);
+
   // |Contents|
   std::optional<Rect> GetCoverage(const Entity& entity) const override;
 
@@ -85,11 +69,11 @@ class SolidStrokeContents final : public Contents {
   Scalar stroke_size_ = 0.0;
   Scalar miter_limit_ = 4.0;
 
-  Cap cap_;
-  CapProc cap_proc_;
+  Cap cap_ = Cap::kButt;
+  Join join_ = Join::kMiter;
 
-  Join join_;
-  JoinProc join_proc_;
+  std::vector<Scalar> dash_intervals_;
+  Scalar dash_phase_ = 0.0;
 
   FML_DISALLOW_COPY_AND_ASSIGN(SolidStrokeContents);
 };
@@ -0,0 +1,502 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/contents/stroke_generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "flutter/fml/logging.h"
+
+namespace impeller {
+
+// The maximum distance in device pixels between a round cap or join and the
+// segments it is subdivided into.
+static const Scalar kArcTolerance = 0.25;
+static const Scalar kMaxArcSegments = 1024;
+
+// Dashing falls back to a solid stroke beyond this many dashes, so that a
+// tiny pattern on a huge path can not run out of memory. Matches Skia.
+static const size_t kMaxDashCount = 1000000;
+
+StrokeGenerator::StrokeGenerator() {
+  SetDeviceStrokeWidth(1.0);
+}
+
+StrokeGenerator::~StrokeGenerator() = default;
+
+void StrokeGenerator::SetCap(Cap cap) {
+  cap_ = cap;
+}
+
+void StrokeGenerator::SetJoin(Join join) {
+  join_ = join;
+}
+
+void StrokeGenerator::SetMiterLimit(Scalar miter_limit) {
+  miter_limit_ = miter_limit;
+}
+
+void StrokeGenerator::SetDashes(const std::vector<Scalar>& intervals,
+                                Scalar phase) {
+  dash_intervals_.clear();
+  dash_phase_ = 0.0;
+
+  if (intervals.size() % 2 != 0) {
+    return;
+  }
+  Scalar pattern_length = 0.0;
+  for (const auto interval : intervals) {
+    if (!(interval >= 0.0)) {
+      return;
+    }
+    pattern_length += interval;
+  }
+  if (!(pattern_length > 0.0) || !std::isfinite(pattern_length)) {
+    return;
+  }
+
+  dash_intervals_.assign(intervals.begin(), intervals.end());
+  if (std::isfinite(phase)) {
+    dash_phase_ = std::fmod(phase, pattern_length);
+    if (dash_phase_ < 0.0) {
+      dash_phase_ += pattern_length;
+    }
+  }
+}
+
+void StrokeGenerator::SetDeviceStrokeWidth(Scalar width) {
+  // The angle of an arc whose chord stays within the tolerance of it.
+  const Scalar radius = width / 2;
+  arc_step_ =
+      2 * std::acos(std::clamp(1 - kArcTolerance / radius, -1.0f, 1.0f));
+  arc_step_cos_ = std::cos(arc_step_);
+  arc_step_sin_ = std::sin(arc_step_);
+  // The turn at which the outer corners of two segments are the tolerance
+  // apart.
+  straight_join_dot_ = std::cos(std::min(kArcTolerance / radius, kPi));
+}
+
+bool StrokeGenerator::HasDashes() const {
+  return !dash_intervals_.empty();
+}
+
+bool StrokeGenerator::IsStraightJoin(const Point& start_normal,
+                                     const Point& end_normal) const {
+  return start_normal.Dot(end_normal) > straight_join_dot_;
+}
+
+static Point ComputeNormal(const Point& from, const Point& to) {
+  const Point direction = (to - from).Normalize();
+  return {-direction.y, direction.x};
+}
+
+static void AppendVertex(StrokeGenerator::VertexType*& vertex,
+                         const Point& position,
+                         const Point& normal,
+                         Scalar pen_down) {
+  vertex->vertex_position = position;
+  vertex->vertex_normal = normal;
+  vertex->pen_down = pen_down;
+  vertex++;
+}
+
+// The angle between either normal of a join and the middle of the join.
+static Scalar ComputeJoinHalfAngle(const Point& start_normal,
+                                   const Point& end_normal) {
+  return std::acos(std::clamp(start_normal.Dot(end_normal), -1.0f, 1.0f)) / 2;
+}
+
+size_t StrokeGenerator::ComputeArcSegmentCount(Scalar angle) const {
+  const Scalar segments = std::ceil(angle / arc_step_);
+  // Also catches the NaN of a stroke without any width.
+  if (!(segments >= 1)) {
+    return 1;
+  }
+  return static_cast<size_t>(std::min(segments, kMaxArcSegments));
+}
+
+size_t StrokeGenerator::ComputeCapVertexCount() const {
+  switch (cap_) {
+    case Cap::kButt:
+      return 0;
+    case Cap::kRound:
+      return 2 + 2 * ComputeArcSegmentCount(kPiOver2);
+    case Cap::kSquare:
+      return 4;
+  }
+  FML_UNREACHABLE();
+}
+
+size_t StrokeGenerator::ComputeJoinVertexCount(const Point& start_normal,
+                                               const Point& end_normal) const {
+  if (IsStraightJoin(start_normal, end_normal)) {
+    return 0;
+  }
+  switch (join_) {
+    case Join::kBevel:
+      return 3;
+    case Join::kMiter:
+      return 4;
+    case Join::kRound:
+      return 3 + 2 * ComputeArcSegmentCount(
+                         ComputeJoinHalfAngle(start_normal, end_normal));
+  }
+  FML_UNREACHABLE();
+}
+
+void StrokeGenerator::AddCap(VertexType*& vertex,
+                             const Point& position,
+                             const Point& normal) const {
+  const Point forward(normal.y, -normal.x);
+  switch (cap_) {
+    case Cap::kButt:
+      return;
+    case Cap::kRound: {
+      AppendVertex(vertex, position, normal, 1.0);
+      AppendVertex(vertex, position, -normal, 1.0);
+      // Sweeps both quarter circles of the cap from the sides to the front.
+      const size_t count = ComputeArcSegmentCount(kPiOver2);
+      Scalar arc_cos = 1.0;
+      Scalar arc_sin = 0.0;
+      for (size_t i = 1; i < count; i++) {
+        const Scalar next_cos =
+            arc_cos * arc_step_cos_ - arc_sin * arc_step_sin_;
+        arc_sin = arc_sin * arc_step_cos_ + arc_cos * arc_step_sin_;
+        arc_cos = next_cos;
+        AppendVertex(vertex, position, normal * arc_cos + forward * arc_sin,
+                     1.0);
+        AppendVertex(vertex, position, -normal * arc_cos + forward * arc_sin,
+                     1.0);
+      }
+      AppendVertex(vertex, position, forward, 1.0);
+      AppendVertex(vertex, position, forward, 1.0);
+      return;
+    }
+    case Cap::kSquare:
+      AppendVertex(vertex, position, normal, 1.0);
+      AppendVertex(vertex, position, -normal, 1.0);
+      AppendVertex(vertex, position, normal + forward, 1.0);
+      AppendVertex(vertex, position, -normal + forward, 1.0);
+      return;
+  }
+}
+
+void StrokeGenerator::AddJoin(VertexType*& vertex,
+                              const Point& position,
+                              const Point& start_normal,
+                              const Point& end_normal) const {
+  if (IsStraightJoin(start_normal, end_normal)) {
+    return;
+  }
+
+  // Every join starts with the bevel on the outer side of the turn.
+  const Scalar dir = start_normal.Cross(end_normal) > 0 ? -1 : 1;
+  const Point start = start_normal * dir;
+  const Point end = end_normal * dir;
+  AppendVertex(vertex, position, {}, 1.0);
+  AppendVertex(vertex, position, start, 1.0);
+  AppendVertex(vertex, position, end, 1.0);
+
+  switch (join_) {
+    case Join::kBevel:
+      return;
+    case Join::kMiter: {
+      // 1 for no joint (straight line), 0 for max joint (180 degrees).
+      const Scalar alignment = (start_normal.Dot(end_normal) + 1) / 2;
+      const Point miter_point = (start + end) / 2 / alignment;
+      if (alignment > 0 &&
+          miter_point.GetLengthSquared() <= miter_limit_ * miter_limit_) {
+        AppendVertex(vertex, position, miter_point, 1.0);
+      } else {
+        // Stays a bevel when we exceed the miter limit. Repeating its last
+        // vertex saves checking the limit when counting the vertices.
+        AppendVertex(vertex, position, end, 1.0);
+      }
+      return;
+    }
+    case Join::kRound: {
+      Point middle = start + end;
+      if (ScalarNearlyEqual(middle.GetLengthSquared(), 0)) {
+        // The path turns around, so the join is a half circle in front.
+        middle = Point(start_normal.y, -start_normal.x);
+      }
+      middle = middle.Normalize();
+      // Sweeps the arc from both of its ends towards the middle.
+      const Point start_tangent =
+          (middle - start * start.Dot(middle)).Normalize();
+      const Point end_tangent = (middle - end * end.Dot(middle)).Normalize();
+      const size_t count = ComputeArcSegmentCount(
+          ComputeJoinHalfAngle(start_normal, end_normal));
+      Scalar arc_cos = 1.0;
+      Scalar arc_sin = 0.0;
+      for (size_t i = 1; i < count; i++) {
+        const Scalar next_cos =
+            arc_cos * arc_step_cos_ - arc_sin * arc_step_sin_;
+        arc_sin = arc_sin * arc_step_cos_ + arc_cos * arc_step_sin_;
+        arc_cos = next_cos;
+        AppendVertex(vertex, position,
+                     start * arc_cos + start_tangent * arc_sin, 1.0);
+        AppendVertex(vertex, position, end * arc_cos + end_tangent * arc_sin,
+                     1.0);
+      }
+      AppendVertex(vertex, position, middle, 1.0);
+      AppendVertex(vertex, position, middle, 1.0);
+      return;
+    }
+  }
+}
+
+size_t StrokeGenerator::ComputeVertexCount(
+    const Path::Polyline& polyline) const {
+  const size_t cap_vertex_count = ComputeCapVertexCount();
+  size_t vertex_count = 0;
+  bool has_contours = false;
+
+  for (size_t contour_i = 0; contour_i < polyline.contours.size();
+       contour_i++) {
+    size_t start, end;
+    std::tie(start, end) = polyline.GetContourPointBounds(contour_i);
+    if (end - start < 2) {
+      continue;  // This contour has no renderable content.
+    }
+    const bool is_closed = polyline.contours[contour_i].is_closed;
+
+    if (has_contours) {
+      vertex_count += 4;  // Picking up the pen.
+    }
+    has_contours = true;
+
+    vertex_count += 4 * (end - start - 1);
+    if (!is_closed) {
+      vertex_count += 2 * cap_vertex_count;
+    }
+
+    Point normal = ComputeNormal(polyline.points[start],
+                                 polyline.points[start + 1]);
+    const Point contour_first_normal = normal;
+    for (size_t point_i = start + 1; point_i < end - 1; point_i++) {
+      const Point next_normal = ComputeNormal(polyline.points[point_i],
+                                              polyline.points[point_i + 1]);
+      vertex_count += ComputeJoinVertexCount(normal, next_normal);
+      normal = next_normal;
+    }
+    if (is_closed) {
+      vertex_count += ComputeJoinVertexCount(normal, contour_first_normal);
+    }
+  }
+
+  return vertex_count;
+}
+
+size_t StrokeGenerator::GenerateVertices(const Path::Polyline& polyline,
+                                         VertexType* vertices) const {
+  VertexType* vertex = vertices;
+  const auto& points = polyline.points;
+  bool has_contours = false;
+  size_t previous_end = 0;
+
+  for (size_t contour_i = 0; contour_i < polyline.contours.size();
+       contour_i++) {
+    size_t start, end;
+    std::tie(start, end) = polyline.GetContourPointBounds(contour_i);
+    if (end - start < 2) {
+      continue;  // This contour has no renderable content.
+    }
+
+    if (has_contours) {
+      // We're drawing a triangle strip, so we need to "pick up the pen" by
+      // appending transparent vertices between the end of the previous contour
+      // and the beginning of the new contour.
+      // Append two transparent vertices when "picking up" the pen so that the
+      // triangle drawn when moving to the beginning of the new contour will
+      // have zero volume. This is necessary because strokes with a transparent
+      // color affect the stencil buffer to prevent overdraw.
+      AppendVertex(vertex, points[previous_end - 1], {}, 0.0);
+      AppendVertex(vertex, points[previous_end - 1], {}, 0.0);
+      // Append two vertices at the beginning of the new contour so that the
+      // next appended vertex will create a triangle with zero volume.
+      AppendVertex(vertex, points[start], {}, 0.0);
+      AppendVertex(vertex, points[start], {}, 1.0);
+    }
+    has_contours = true;
+    previous_end = end;
+
+    const bool is_closed = polyline.contours[contour_i].is_closed;
+    Point normal = ComputeNormal(points[start], points[start + 1]);
+    const Point contour_first_normal = normal;
+
+    // Generate start cap.
+    if (!is_closed) {
+      AddCap(vertex, points[start], -normal);
+    }
+
+    // Generate contour geometry.
+    for (size_t point_i = start + 1; point_i < end; point_i++) {
+      // Generate line rect.
+      AppendVertex(vertex, points[point_i - 1], normal, 1.0);
+      AppendVertex(vertex, points[point_i - 1], -normal, 1.0);
+      AppendVertex(vertex, points[point_i], normal, 1.0);
+      AppendVertex(vertex, points[point_i], -normal, 1.0);
+
+      if (point_i < end - 1) {
+        // Generate join from the current line to the next line.
+        const Point next_normal =
+            ComputeNormal(points[point_i], points[point_i + 1]);
+        AddJoin(vertex, points[point_i], normal, next_normal);
+        normal = next_normal;
+      }
+    }
+
+    // Generate end cap or join.
+    if (!is_closed) {
+      AddCap(vertex, points[end - 1], normal);
+    } else {
+      AddJoin(vertex, points[start], normal, contour_first_normal);
+    }
+  }
+
+  return vertex - vertices;
+}
+
+void StrokeGenerator::DashPolyline(const Path::Polyline& polyline,
+                                   Path::Polyline& dashed) const {
+  if (!HasDashes()) {
+    dashed = polyline;
+    return;
+  }
+
+  dashed.points.clear();
+  dashed.contours.clear();
+  const auto& points = polyline.points;
+
+  for (size_t contour_i = 0; contour_i < polyline.contours.size();
+       contour_i++) {
+    size_t start, end;
+    std::tie(start, end) = polyline.GetContourPointBounds(contour_i);
+    if (end - start < 2) {
+      continue;  // This contour has no renderable content.
+    }
+
+    // Every contour starts the pattern at the phase.
+    size_t interval = 0;
+    Scalar remaining = dash_intervals_[0];
+    Scalar phase = dash_phase_;
+    while (phase >= remaining) {
+      phase -= remaining;
+      interval = (interval + 1) % dash_intervals_.size();
+      remaining = dash_intervals_[interval];
+    }
+    remaining -= phase;
+
+    const size_t first_dash = dashed.contours.size();
+    const bool starts_on = interval % 2 == 0;
+    if (starts_on) {
+      dashed.contours.push_back({dashed.points.size(), false});
+      dashed.points.push_back(points[start]);
+    }
+    auto extend_dash = [&dashed](const Point& point) {
+      if (dashed.points.back() != point) {
+        dashed.points.push_back(point);
+      }
+    };
+
+    for (size_t point_i = start + 1; point_i < end; point_i++) {
+      const Point from = points[point_i - 1];
+      const Point delta = points[point_i] - from;
+      const Scalar length = delta.GetLength();
+      Scalar position = 0.0;
+      while (length - position > remaining) {
+        position += remaining;
+        const Point point = from + delta * (position / length);
+        if (interval % 2 == 0) {
+          extend_dash(point);
+        } else {
+          if (dashed.contours.size() >= kMaxDashCount) {
+            dashed = polyline;
+            return;
+          }
+          dashed.contours.push_back({dashed.points.size(), false});
+          dashed.points.push_back(point);
+        }
+        interval = (interval + 1) % dash_intervals_.size();
+        remaining = dash_intervals_[interval];
+      }
+      remaining -= length - position;
+      if (interval % 2 == 0) {
+        extend_dash(points[point_i]);
+      }
+    }
+
+    const bool ends_on = interval % 2 == 0;
+    if (!polyline.contours[contour_i].is_closed || !starts_on || !ends_on) {
+      continue;
+    }
+    if (dashed.contours.size() - first_dash == 1) {
+      // The pattern never turned off, so the contour stays closed.
+      dashed.contours.back().is_closed = true;
+      continue;
+    }
+    // Joins the last dash with the first one across the start of the contour
+    // by moving the points of the first dash to the end.
+    const size_t first_start = dashed.contours[first_dash].start_index;
+    const size_t first_length =
+        dashed.contours[first_dash + 1].start_index - first_start;
+    std::rotate(dashed.points.begin() + first_start,
+                dashed.points.begin() + first_start + first_length,
+                dashed.points.end());
+    dashed.contours.erase(dashed.contours.begin() + first_dash);
+    for (size_t i = first_dash; i < dashed.contours.size(); i++) {
+      dashed.contours[i].start_index -= first_length;
+    }
+    // The first dash starts where the last one ends.
+    const auto first_point = dashed.points.end() - first_length;
+    if (*first_point == *(first_point - 1)) {
+      dashed.points.erase(first_point);
+    }
+  }
+}
+
+VertexBuffer StrokeGenerator::CreateVertexBuffer(
+    const Path& path,
+    const SmoothingApproximation& smoothing,
+    HostBuffer& buffer) {
+  path.CreatePolyline(polyline_, smoothing);
+  const Path::Polyline* polyline = &polyline_;
+  if (HasDashes()) {
+    DashPolyline(polyline_, dashed_polyline_);
+    polyline = &dashed_polyline_;
+  }
+
+  const size_t vertex_count = ComputeVertexCount(*polyline);
+  if (vertex_count == 0) {
+    return {};  // Nothing to render.
+  }
+
+  auto vertex_view =
+      buffer.Emplace(vertex_count * sizeof(VertexType), alignof(VertexType),
+                     [&](uint8_t* data) {
+                       [[maybe_unused]] const size_t written = GenerateVertices(
+                           *polyline, reinterpret_cast<VertexType*>(data));
+                       FML_DCHECK(written == vertex_count);
+                     });
+  auto index_view = buffer.Emplace(
+      vertex_count * sizeof(uint32_t), alignof(uint32_t), [&](uint8_t* data) {
+        auto indices = reinterpret_cast<uint32_t*>(data);
+        std::iota(indices, indices + vertex_count, 0u);
+      });
+  if (!vertex_view || !index_view) {
+    return {};
+  }
+
+  VertexBuffer vertex_buffer;
+  vertex_buffer.vertex_buffer = vertex_view;
+  vertex_buffer.index_buffer = index_view;
+  vertex_buffer.index_count = vertex_count;
+  vertex_buffer.index_type = IndexType::k32bit;
+  return vertex_buffer;
+}
+
+}  // namespace impeller
@@ -0,0 +1,147 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "impeller/entity/solid_stroke.vert.h"
+#include "impeller/geometry/path.h"
+#include "impeller/geometry/path_component.h"
+#include "impeller/geometry/scalar.h"
+#include "impeller/renderer/host_buffer.h"
+#include "impeller/renderer/vertex_buffer.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Generates the triangle strip of a stroked path on the CPU.
+///
+///             Vertices are positioned on the path and carry a unit normal
+///             that the solid stroke vertex shader scales by half the stroke
+///             width, so the output does not depend on the stroke width.
+///
+///             The generator keeps its scratch polylines from one path to the
+///             next and writes vertices directly into the host buffer, so
+///             stroking a path does not allocate once it has warmed up.
+///
+class StrokeGenerator {
+ public:
+  enum class Cap {
+    kButt,
+    kRound,
+    kSquare,
+  };
+
+  enum class Join {
+    kMiter,
+    kRound,
+    kBevel,
+  };
+
+  using VertexType = SolidStrokeVertexShader::PerVertexData;
+
+  StrokeGenerator();
+
+  ~StrokeGenerator();
+
+  void SetCap(Cap cap);
+
+  void SetJoin(Join join);
+
+  void SetMiterLimit(Scalar miter_limit);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the dash pattern of the stroke.
+  ///
+  /// @param[in]  intervals  Alternating lengths of the "on" and "off" parts of
+  ///                        the pattern, starting with an "on" part. An empty,
+  ///                        odd sized, negative or zero length pattern strokes
+  ///                        the path without dashes.
+  /// @param[in]  phase      The distance into the pattern that every contour
+  ///                        starts at.
+  ///
+  void SetDashes(const std::vector<Scalar>& intervals, Scalar phase);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the stroke width in device pixels, which decides how
+  ///             finely round caps and joins are subdivided.
+  ///
+  void SetDeviceStrokeWidth(Scalar width);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Flattens, dashes and strokes the path into the host buffer.
+  ///
+  /// @return     The vertex buffer, which is invalid when the path has nothing
+  ///             to stroke.
+  ///
+  VertexBuffer CreateVertexBuffer(const Path& path,
+                                  const SmoothingApproximation& smoothing,
+                                  HostBuffer& buffer);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Computes the exact number of vertices that `GenerateVertices`
+  ///             writes for the polyline.
+  ///
+  size_t ComputeVertexCount(const Path::Polyline& polyline) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Writes the triangle strip of the polyline to `vertices`, which
+  ///             must have room for `ComputeVertexCount` vertices.
+  ///
+  /// @return     The number of vertices written.
+  ///
+  size_t GenerateVertices(const Path::Polyline& polyline,
+                          VertexType* vertices) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Splits the polyline into open contours along the dash
+  ///             pattern. Does nothing but copy the polyline when there is no
+  ///             dash pattern.
+  ///
+  void DashPolyline(const Path::Polyline& polyline,
+                    Path::Polyline& dashed) const;
+
+ private:
+  Cap cap_ = Cap::kButt;
+  Join join_ = Join::kMiter;
+  Scalar miter_limit_ = 4.0;
+  std::vector<Scalar> dash_intervals_;
+  Scalar dash_phase_ = 0.0;
+  // The angle of one segment of round caps and joins.
+  Scalar arc_step_ = 0.0;
+  Scalar arc_step_cos_ = 0.0;
+  Scalar arc_step_sin_ = 0.0;
+  // Joins are left out between segments that turn less than this, where they
+  // would cover nothing but the seam between them.
+  Scalar straight_join_dot_ = 0.0;
+
+  Path::Polyline polyline_;
+  Path::Polyline dashed_polyline_;
+
+  bool HasDashes() const;
+
+  bool IsStraightJoin(const Point& start_normal, const Point& end_normal) const;
+
+  size_t ComputeArcSegmentCount(Scalar angle) const;
+
+  size_t ComputeCapVertexCount() const;
+
+  size_t ComputeJoinVertexCount(const Point& start_normal,
+                                const Point& end_normal) const;
+
+  void AddCap(VertexType*& vertex,
+              const Point& position,
+              const Point& normal) const;
+
+  void AddJoin(VertexType*& vertex,
+               const Point& position,
+               const Point& start_normal,
+               const Point& end_normal) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(StrokeGenerator);
+};
+
+}  // namespace impeller
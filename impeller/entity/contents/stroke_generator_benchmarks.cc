@@ -0,0 +1,116 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+
+#include <cmath>
+
+#include "impeller/entity/contents/stroke_generator.h"
+#include "impeller/geometry/path_builder.h"
+
+namespace impeller {
+namespace {
+
+using Cap = StrokeGenerator::Cap;
+using Join = StrokeGenerator::Join;
+
+// A line chart with tens of thousands of segments.
+Path CreateLineChart() {
+  PathBuilder builder;
+  builder.MoveTo({0, 200});
+  for (int i = 1; i <= 20000; i++) {
+    builder.LineTo({i * 0.05f, 200 + 80 * std::sin(i * 0.01f) *
+                                         std::cos(i * 0.37f)});
+  }
+  return builder.TakePath();
+}
+
+// Thousands of small sparklines.
+Path CreateSparklines() {
+  PathBuilder builder;
+  for (int line = 0; line < 2000; line++) {
+    const Point origin((line % 40) * 50.0f, (line / 40) * 20.0f);
+    builder.MoveTo(origin);
+    for (int i = 1; i <= 16; i++) {
+      builder.LineTo(origin + Point(i * 3.0f, 8 * std::sin(line + i * 0.7f)));
+    }
+  }
+  return builder.TakePath();
+}
+
+// Rounded outlines, whose curves are flattened before stroking.
+Path CreateRoundedRects() {
+  PathBuilder builder;
+  for (int i = 0; i < 1000; i++) {
+    builder.AddRoundedRect(
+        Rect::MakeXYWH((i % 40) * 50.0f, (i / 40) * 50.0f, 40, 40), 8);
+  }
+  return builder.TakePath();
+}
+
+void BM_Stroke(benchmark::State& state,
+               Path (*create_path)(),
+               Cap cap,
+               Join join,
+               bool dashed) {
+  const Path path = create_path();
+
+  StrokeGenerator generator;
+  generator.SetCap(cap);
+  generator.SetJoin(join);
+  generator.SetDeviceStrokeWidth(4);
+  if (dashed) {
+    generator.SetDashes({6, 3}, 0);
+  }
+
+  size_t vertex_count = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    auto host_buffer = HostBuffer::Create();
+    auto vertex_buffer = generator.CreateVertexBuffer(path, {}, *host_buffer);
+    vertex_count = vertex_buffer.index_count;
+  }
+  state.counters["vertices"] = vertex_count;
+  state.SetItemsProcessed(state.iterations() * vertex_count);
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_Stroke,
+                  line_chart_butt_miter,
+                  CreateLineChart,
+                  Cap::kButt,
+                  Join::kMiter,
+                  false);
+BENCHMARK_CAPTURE(BM_Stroke,
+                  line_chart_round_round,
+                  CreateLineChart,
+                  Cap::kRound,
+                  Join::kRound,
+                  false);
+BENCHMARK_CAPTURE(BM_Stroke,
+                  line_chart_dashed,
+                  CreateLineChart,
+                  Cap::kButt,
+                  Join::kBevel,
+                  true);
+BENCHMARK_CAPTURE(BM_Stroke,
+                  sparklines_butt_miter,
+                  CreateSparklines,
+                  Cap::kButt,
+                  Join::kMiter,
+                  false);
+BENCHMARK_CAPTURE(BM_Stroke,
+                  sparklines_round_round,
+                  CreateSparklines,
+                  Cap::kRound,
+                  Join::kRound,
+                  false);
+BENCHMARK_CAPTURE(BM_Stroke,
+                  rounded_rects_square_bevel,
+                  CreateRoundedRects,
+                  Cap::kSquare,
+                  Join::kBevel,
+                  false);
+
+}  // namespace impeller
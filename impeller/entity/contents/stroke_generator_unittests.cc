@@ -0,0 +1,193 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "flutter/testing/testing.h"
+#include "gtest/gtest.h"
+#include "impeller/entity/contents/stroke_generator.h"
+#include "impeller/geometry/geometry_unittests.h"
+#include "impeller/geometry/path_builder.h"
+
+namespace impeller {
+namespace testing {
+
+using VertexType = StrokeGenerator::VertexType;
+
+static std::vector<VertexType> GenerateVertices(
+    const StrokeGenerator& generator,
+    const Path::Polyline& polyline) {
+  std::vector<VertexType> vertices(generator.ComputeVertexCount(polyline));
+  EXPECT_EQ(generator.GenerateVertices(polyline, vertices.data()),
+            vertices.size());
+  return vertices;
+}
+
+TEST(StrokeGeneratorTest, VertexCountMatchesGeneratedVertices) {
+  const auto polyline = PathBuilder{}
+                            .MoveTo({0, 0})
+                            .LineTo({100, 0})
+                            .LineTo({100, 100})
+                            .LineTo({110, 0})
+                            .LineTo({120, 100.1})
+                            .MoveTo({200, 0})
+                            .LineTo({300, 0})
+                            .LineTo({200, 0})
+                            .AddCircle({50, 50}, 40)
+                            .AddRoundedRect(Rect::MakeXYWH(0, 0, 80, 40), 10)
+                            .TakePath()
+                            .CreatePolyline();
+
+  for (auto cap : {StrokeGenerator::Cap::kButt, StrokeGenerator::Cap::kRound,
+                   StrokeGenerator::Cap::kSquare}) {
+    for (auto join :
+         {StrokeGenerator::Join::kMiter, StrokeGenerator::Join::kRound,
+          StrokeGenerator::Join::kBevel}) {
+      for (auto width : {0.1f, 10.0f, 400.0f}) {
+        StrokeGenerator generator;
+        generator.SetCap(cap);
+        generator.SetJoin(join);
+        generator.SetDeviceStrokeWidth(width);
+        GenerateVertices(generator, polyline);
+
+        generator.SetDashes({10, 5}, 3);
+        Path::Polyline dashed;
+        generator.DashPolyline(polyline, dashed);
+        GenerateVertices(generator, dashed);
+      }
+    }
+  }
+}
+
+TEST(StrokeGeneratorTest, RoundCapsAndJoinsStayOnTheCircle) {
+  const auto polyline = PathBuilder{}
+                            .MoveTo({0, 0})
+                            .LineTo({100, 0})
+                            .LineTo({50, 80})
+                            .LineTo({60, 0})
+                            .TakePath()
+                            .CreatePolyline();
+  StrokeGenerator generator;
+  generator.SetCap(StrokeGenerator::Cap::kRound);
+  generator.SetJoin(StrokeGenerator::Join::kRound);
+
+  generator.SetDeviceStrokeWidth(10);
+  const size_t narrow_vertex_count = generator.ComputeVertexCount(polyline);
+  generator.SetDeviceStrokeWidth(100);
+  const auto vertices = GenerateVertices(generator, polyline);
+  // The caps and joins of wider strokes are subdivided more finely.
+  ASSERT_GT(vertices.size(), narrow_vertex_count);
+  for (const auto& vertex : vertices) {
+    const Scalar length = vertex.vertex_normal.GetLength();
+    if (length != 0) {
+      ASSERT_NEAR(length, 1.0, 1e-4);
+    }
+  }
+}
+
+TEST(StrokeGeneratorTest, MiterJoinsFallBackToBevelsBeyondTheLimit) {
+  const auto polyline = PathBuilder{}
+                            .MoveTo({0, 0})
+                            .LineTo({100, 0})
+                            .LineTo({100, 100})
+                            .TakePath()
+                            .CreatePolyline();
+  StrokeGenerator generator;
+
+  generator.SetMiterLimit(4);
+  auto vertices = GenerateVertices(generator, polyline);
+  // Two segments and a join in between.
+  ASSERT_EQ(vertices.size(), 12u);
+  ASSERT_POINT_NEAR(vertices[7].vertex_normal, Point(1, -1));
+
+  generator.SetMiterLimit(1);
+  vertices = GenerateVertices(generator, polyline);
+  ASSERT_EQ(vertices.size(), 12u);
+  ASSERT_POINT_NEAR(vertices[7].vertex_normal, vertices[6].vertex_normal);
+}
+
+TEST(StrokeGeneratorTest, DashesOpenContours) {
+  const auto polyline =
+      PathBuilder{}.AddLine({0, 0}, {100, 0}).TakePath().CreatePolyline();
+  StrokeGenerator generator;
+  generator.SetDashes({10, 20}, 25);
+  Path::Polyline dashed;
+  generator.DashPolyline(polyline, dashed);
+
+  // 5 off, 10 on, 20 off, 10 on, 20 off, 10 on, 20 off, 5 on.
+  ASSERT_EQ(dashed.contours.size(), 4u);
+  ASSERT_EQ(dashed.points.size(), 8u);
+  ASSERT_POINT_NEAR(dashed.points[0], Point(5, 0));
+  ASSERT_POINT_NEAR(dashed.points[1], Point(15, 0));
+  ASSERT_POINT_NEAR(dashed.points[6], Point(95, 0));
+  ASSERT_POINT_NEAR(dashed.points[7], Point(100, 0));
+  for (const auto& contour : dashed.contours) {
+    ASSERT_FALSE(contour.is_closed);
+  }
+}
+
+TEST(StrokeGeneratorTest, DashesAcrossTheStartOfClosedContours) {
+  const auto polyline = PathBuilder{}
+                            .AddRect(Rect::MakeXYWH(0, 0, 100, 100))
+                            .TakePath()
+                            .CreatePolyline();
+  StrokeGenerator generator;
+  // The perimeter is 8 patterns long, so the last dash continues into the
+  // first one around the top left corner.
+  generator.SetDashes({30, 20}, 10);
+  Path::Polyline dashed;
+  generator.DashPolyline(polyline, dashed);
+
+  ASSERT_EQ(dashed.contours.size(), 8u);
+  size_t start, end;
+  std::tie(start, end) = dashed.GetContourPointBounds(7);
+  ASSERT_EQ(end - start, 3u);
+  ASSERT_POINT_NEAR(dashed.points[start], Point(0, 10));
+  ASSERT_POINT_NEAR(dashed.points[start + 1], Point(0, 0));
+  ASSERT_POINT_NEAR(dashed.points[start + 2], Point(20, 0));
+}
+
+TEST(StrokeGeneratorTest, InvalidDashesStrokeSolid) {
+  const auto polyline = PathBuilder{}
+                            .AddRect(Rect::MakeXYWH(0, 0, 100, 100))
+                            .TakePath()
+                            .CreatePolyline();
+  for (const auto& intervals : std::vector<std::vector<Scalar>>{
+           {}, {10}, {10, -5}, {0, 0}, {10, 5, 10}}) {
+    StrokeGenerator generator;
+    generator.SetDashes(intervals, 0);
+    Path::Polyline dashed;
+    generator.DashPolyline(polyline, dashed);
+    ASSERT_EQ(dashed.points.size(), polyline.points.size());
+    ASSERT_EQ(dashed.contours.size(), 1u);
+    ASSERT_TRUE(dashed.contours[0].is_closed);
+  }
+}
+
+TEST(StrokeGeneratorTest, CreatesVertexBufferInPlace) {
+  const auto path = PathBuilder{}
+                        .AddLine({0, 0}, {100, 0})
+                        .AddCircle({50, 50}, 20)
+                        .TakePath();
+  StrokeGenerator generator;
+  auto host_buffer = HostBuffer::Create();
+
+  const auto vertex_buffer =
+      generator.CreateVertexBuffer(path, {}, *host_buffer);
+  ASSERT_TRUE(vertex_buffer);
+  ASSERT_EQ(vertex_buffer.index_count,
+            vertex_buffer.vertex_buffer.range.length / sizeof(VertexType));
+  ASSERT_EQ(vertex_buffer.index_type, IndexType::k32bit);
+  auto indices = reinterpret_cast<const uint32_t*>(
+      host_buffer->GetContents(vertex_buffer.index_buffer));
+  ASSERT_NE(indices, nullptr);
+  ASSERT_EQ(indices[vertex_buffer.index_count - 1],
+            vertex_buffer.index_count - 1);
+
+  // Nothing to stroke.
+  ASSERT_FALSE(generator.CreateVertexBuffer(Path{}, {}, *host_buffer));
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -34,9 +34,12 @@ void TextContents::SetGlyphAtlas(std::shared_ptr<LazyGlyphAtlas> atlas) {
 }
 
 std::shared_ptr<GlyphAtlas> TextContents::ResolveAtlas(
-    std::shared_ptr<Context> context) const {
+    const std::shared_ptr<TextRenderContext>& text_context) const {
   if (auto lazy_atlas = std::get_if<std::shared_ptr<LazyGlyphAtlas>>(&atlas_)) {
-    return lazy_atlas->get()->CreateOrGetGlyphAtlas(context);
+    if (!text_context) {
+      return nullptr;
+    }
+    return lazy_atlas->get()->CreateOrGetGlyphAtlas(*text_context);
   }
 
   if (auto atlas = std::get_if<std::shared_ptr<GlyphAtlas>>(&atlas_)) {
@@ -65,7 +68,7 @@ bool TextContents::Render(const ContentContext& renderer,
     return true;
   }
 
-  auto atlas = ResolveAtlas(renderer.GetContext());
+  auto atlas = ResolveAtlas(renderer.GetTextRenderContext());
 
   if (!atlas || !atlas->IsValid()) {
     VALIDATION_LOG << "Cannot render glyphs without prepared atlas.";
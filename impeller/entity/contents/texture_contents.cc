@@ -74,8 +74,8 @@ bool TextureContents::Render(const ContentContext& renderer,
 
   VertexBufferBuilder<VS::PerVertexData> vertex_builder;
   {
-    const auto tess_result = Tessellator{}.Tessellate(
-        path_.GetFillType(), path_.CreatePolyline(),
+    const auto tess_result = renderer.GetTessellator()->Tessellate(
+        path_, SmoothingFromEntity(entity),
         [this, &vertex_builder, &coverage_rect, &texture_size](Point vtx) {
           VS::PerVertexData data;
           data.vertices = vtx;
@@ -158,6 +158,7 @@ bool EntityPass::Render(ContentContext& renderer,
     command_buffer->SetLabel("EntityPass Root Command Buffer");
     auto render_pass = command_buffer->CreateRenderPass(render_target);
     render_pass->SetLabel("EntityPass Root Render Pass");
+    render_pass->SetTransientsBuffer(renderer.GetTransientsBuffer());
 
     {
       auto size_rect =
@@ -353,7 +354,8 @@ bool EntityPass::OnRender(ContentContext& renderer,
   TRACE_EVENT0("impeller", "EntityPass::OnRender");
 
   auto context = renderer.GetContext();
-  InlinePassContext pass_context(context, render_target);
+  InlinePassContext pass_context(context, render_target,
+                                 renderer.GetTransientsBuffer());
   if (!pass_context.IsValid()) {
     return false;
   }
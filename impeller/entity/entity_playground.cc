@@ -22,7 +22,8 @@ bool EntityPlayground::OpenPlaygroundHere(Entity entity) {
     return false;
   }
   SinglePassCallback callback = [&](RenderPass& pass) -> bool {
-    return entity.Render(content_context, pass);
+    auto result = entity.Render(content_context, pass);
+    return content_context.FinishFrame() && result;
   };
   return Playground::OpenPlaygroundHere(callback);
 }
@@ -37,7 +38,8 @@ bool EntityPlayground::OpenPlaygroundHere(EntityPlaygroundCallback callback) {
     return false;
   }
   SinglePassCallback pass_callback = [&](RenderPass& pass) -> bool {
-    return callback(content_context, pass);
+    auto result = callback(content_context, pass);
+    return content_context.FinishFrame() && result;
   };
   return Playground::OpenPlaygroundHere(pass_callback);
 }
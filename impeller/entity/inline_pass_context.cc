@@ -8,9 +8,13 @@
 
 namespace impeller {
 
-InlinePassContext::InlinePassContext(std::shared_ptr<Context> context,
-                                     RenderTarget render_target)
-    : context_(context), render_target_(render_target) {}
+InlinePassContext::InlinePassContext(
+    std::shared_ptr<Context> context,
+    RenderTarget render_target,
+    std::shared_ptr<HostBuffer> transients_buffer)
+    : context_(context),
+      render_target_(render_target),
+      transients_buffer_(std::move(transients_buffer)) {}
 
 InlinePassContext::~InlinePassContext() {
   EndPass();
@@ -91,6 +95,7 @@ std::shared_ptr<RenderPass> InlinePassContext::GetRenderPass(
     pass_->SetLabel(
         "EntityPass Render Pass: Depth=" + std::to_string(pass_depth) +
         " Count=" + std::to_string(pass_count_));
+    pass_->SetTransientsBuffer(transients_buffer_);
 
     ++pass_count_;
   }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "impeller/renderer/context.h"
+#include "impeller/renderer/host_buffer.h"
 #include "impeller/renderer/render_pass.h"
 #include "impeller/renderer/render_target.h"
 
@@ -13,7 +14,8 @@ namespace impeller {
 class InlinePassContext {
  public:
   InlinePassContext(std::shared_ptr<Context> context,
-                    RenderTarget render_target);
+                    RenderTarget render_target,
+                    std::shared_ptr<HostBuffer> transients_buffer);
   ~InlinePassContext();
 
   bool IsValid() const;
@@ -27,6 +29,7 @@ class InlinePassContext {
  private:
   std::shared_ptr<Context> context_;
   RenderTarget render_target_;
+  std::shared_ptr<HostBuffer> transients_buffer_;
   std::shared_ptr<CommandBuffer> command_buffer_;
   std::shared_ptr<RenderPass> pass_;
   uint32_t pass_count_ = 0;
@@ -0,0 +1,47 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+
+#include "impeller/geometry/path.h"
+#include "impeller/geometry/path_builder.h"
+
+namespace impeller {
+namespace {
+
+// A rounded rect and a line chart of cubics, as animated UIs redraw them.
+Path CreatePath() {
+  PathBuilder builder;
+  builder.AddRoundedRect(Rect::MakeXYWH(10, 10, 300, 200), 24);
+  builder.MoveTo({0, 100});
+  for (int i = 0; i < 50; i++) {
+    const Scalar x = i * 8;
+    builder.CubicCurveTo({x + 3, 40}, {x + 5, 160}, {x + 8, 100});
+  }
+  return builder.TakePath();
+}
+
+void BM_Polyline(benchmark::State& state, bool reuse_polyline) {
+  const Path path = CreatePath();
+  const Scalar scale = state.range(0);
+  const SmoothingApproximation approximation(1.0 / scale, 0.0, 0.0);
+
+  Path::Polyline polyline;
+  for ([[maybe_unused]] auto _ : state) {
+    if (reuse_polyline) {
+      path.CreatePolyline(polyline, approximation);
+    } else {
+      polyline = path.CreatePolyline(approximation);
+    }
+    benchmark::DoNotOptimize(polyline.points.data());
+  }
+  state.counters["points"] = polyline.points.size();
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_Polyline, new, false)->Arg(1)->Arg(4);
+BENCHMARK_CAPTURE(BM_Polyline, reused, true)->Arg(1)->Arg(4);
+
+}  // namespace impeller
@@ -4,6 +4,7 @@
 
 #include "impeller/geometry/geometry_unittests.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "flutter/testing/testing.h"
@@ -1168,6 +1169,71 @@ TEST(GeometryTest, PathPolylineDuplicatesAreRemovedForSameContour) {
   ASSERT_EQ(polyline.points[6], Point(0, 100));
 }
 
+// The largest distance from the curve to its polyline, which starts at the
+// first point of the curve.
+template <class T>
+static Scalar GetMaxPolylineDistance(const T& component,
+                                     const std::vector<Point>& polyline) {
+  Scalar max_distance = 0;
+  for (int i = 0; i <= 1000; i++) {
+    Point point = component.Solve(i / 1000.0);
+    Scalar distance = std::numeric_limits<Scalar>::max();
+    Point start = component.p1;
+    for (const auto& end : polyline) {
+      Point segment = end - start;
+      Scalar t = segment.GetLengthSquared() == 0
+                     ? 0
+                     : std::clamp((point - start).Dot(segment) /
+                                      segment.GetLengthSquared(),
+                                  0.0f, 1.0f);
+      distance = std::min(distance, point.GetDistance(start + segment * t));
+      start = end;
+    }
+    max_distance = std::max(max_distance, distance);
+  }
+  return max_distance;
+}
+
+TEST(GeometryTest, CurvePolylinesStayWithinTolerance) {
+  CubicPathComponent cubic({10, 10}, {200, 350}, {350, 20}, {40, 400});
+  QuadraticPathComponent quad({10, 10}, {200, 350}, {350, 20});
+  size_t previous_cubic_size = 0;
+  for (Scalar scale : {10.0, 1.0, 0.1}) {
+    SmoothingApproximation approximation(scale, 0, 0);
+    auto cubic_polyline = cubic.CreatePolyline(approximation);
+    ASSERT_LE(GetMaxPolylineDistance(cubic, cubic_polyline), scale / 4);
+    ASSERT_GT(cubic_polyline.size(), previous_cubic_size);
+    ASSERT_EQ(cubic_polyline.back(), cubic.p2);
+    previous_cubic_size = cubic_polyline.size();
+
+    auto quad_polyline = quad.CreatePolyline(approximation);
+    ASSERT_LE(GetMaxPolylineDistance(quad, quad_polyline), scale / 4);
+    ASSERT_EQ(quad_polyline.back(), quad.p2);
+  }
+}
+
+TEST(GeometryTest, PathCreatePolylineReusesPolyline) {
+  Path path = PathBuilder{}
+                  .AddCircle({100, 100}, 50)
+                  .MoveTo({0, 0})
+                  .QuadraticCurveTo({50, 0}, {50, 50})
+                  .TakePath();
+  Path::Polyline expected = path.CreatePolyline();
+
+  Path::Polyline polyline;
+  path.CreatePolyline(polyline);
+  ASSERT_EQ(polyline.points, expected.points);
+  ASSERT_EQ(polyline.contours.size(), expected.contours.size());
+  const Point* points = polyline.points.data();
+
+  // A smaller path replaces the contents without reallocating.
+  PathBuilder{}.AddRect(Rect::MakeLTRB(0, 0, 10, 10)).TakePath().CreatePolyline(
+      polyline);
+  ASSERT_EQ(polyline.points.data(), points);
+  ASSERT_EQ(polyline.contours.size(), 1u);
+  ASSERT_EQ(polyline.points.size(), 5u);
+}
+
 TEST(GeometryTest, VerticesConstructorAndGetters) {
   std::vector<Point> points = {Point(1, 2), Point(2, 3), Point(3, 4)};
   std::vector<uint16_t> indices = {0, 1, 2};
@@ -224,39 +224,47 @@ bool Path::UpdateContourComponentAtIndex(size_t index,
 Path::Polyline Path::CreatePolyline(
     const SmoothingApproximation& approximation) const {
   Polyline polyline;
+  CreatePolyline(polyline, approximation);
+  return polyline;
+}
 
-  std::optional<Point> previous_contour_point;
-  auto collect_points = [&polyline, &previous_contour_point](
-                            const std::vector<Point>& collection) {
-    if (collection.empty()) {
-      return;
-    }
-
-    polyline.points.reserve(polyline.points.size() + collection.size());
-
-    for (const auto& point : collection) {
-      if (previous_contour_point.has_value() &&
-          previous_contour_point.value() == point) {
-        // Slip over duplicate points in the same contour.
+void Path::CreatePolyline(Polyline& polyline,
+                          const SmoothingApproximation& approximation) const {
+  polyline.points.clear();
+  polyline.contours.clear();
+
+  // The components append their points straight to the polyline, which are
+  // then compacted to slip over duplicate points in the same contour.
+  size_t contour_start_index = 0;
+  auto skip_duplicate_points = [&polyline,
+                                &contour_start_index](size_t start_index) {
+    auto& points = polyline.points;
+    size_t end_index = start_index;
+    for (size_t i = start_index; i < points.size(); i++) {
+      if (end_index > contour_start_index &&
+          points[end_index - 1] == points[i]) {
         continue;
       }
-      previous_contour_point = point;
-      polyline.points.push_back(point);
+      points[end_index++] = points[i];
     }
+    points.resize(end_index);
   };
 
   for (size_t component_i = 0; component_i < components_.size();
        component_i++) {
     const auto& component = components_[component_i];
+    const size_t start_index = polyline.points.size();
     switch (component.type) {
       case ComponentType::kLinear:
-        collect_points(linears_[component.index].CreatePolyline());
+        linears_[component.index].AppendPolylinePoints(polyline.points);
         break;
       case ComponentType::kQuadratic:
-        collect_points(quads_[component.index].CreatePolyline(approximation));
+        quads_[component.index].AppendPolylinePoints(approximation,
+                                                     polyline.points);
         break;
       case ComponentType::kCubic:
-        collect_points(cubics_[component.index].CreatePolyline(approximation));
+        cubics_[component.index].AppendPolylinePoints(approximation,
+                                                      polyline.points);
         break;
       case ComponentType::kContour:
         if (component_i == components_.size() - 1) {
@@ -267,12 +275,12 @@ Path::Polyline Path::CreatePolyline(
         const auto& contour = contours_[component.index];
         polyline.contours.push_back({.start_index = polyline.points.size(),
                                      .is_closed = contour.is_closed});
-        previous_contour_point = std::nullopt;
-        collect_points({contour.destination});
+        contour_start_index = polyline.points.size();
+        polyline.points.push_back(contour.destination);
         break;
     }
+    skip_duplicate_points(start_index);
   }
-  return polyline;
 }
 
 std::optional<Rect> Path::GetBoundingBox() const {
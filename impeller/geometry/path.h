@@ -119,6 +119,12 @@ class Path {
   Polyline CreatePolyline(
       const SmoothingApproximation& approximation = {}) const;
 
+  /// Like |CreatePolyline|, but replaces the contents of |polyline| and
+  /// reuses its memory, so that paths flattened every frame don't allocate
+  /// once the polyline has grown large enough.
+  void CreatePolyline(Polyline& polyline,
+                      const SmoothingApproximation& approximation = {}) const;
+
   std::optional<Rect> GetBoundingBox() const;
 
   std::optional<Rect> GetTransformedBoundingBox(const Matrix& transform) const;
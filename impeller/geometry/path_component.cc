@@ -4,6 +4,7 @@
 
 #include "path_component.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace impeller {
@@ -11,6 +12,10 @@ namespace impeller {
 static const size_t kRecursionLimit = 32;
 static const Scalar kCurveCollinearityEpsilon = 1e-30;
 static const Scalar kCurveAngleToleranceEpsilon = 0.01;
+// The distance from the true curve that flattened curves stay within, in
+// multiples of the scale of the |SmoothingApproximation|.
+static const Scalar kCurveTolerance = 0.25;
+static const Scalar kMaxCurveSegments = 1024;
 
 /*
  *  Based on: https://en.wikipedia.org/wiki/B%C3%A9zier_curve#Specific_cases
@@ -67,6 +72,34 @@ std::vector<Point> LinearPathComponent::CreatePolyline() const {
   return {p2};
 }
 
+void LinearPathComponent::AppendPolylinePoints(
+    std::vector<Point>& points) const {
+  points.emplace_back(p2);
+}
+
+static bool UsesRecursiveSubdivision(
+    const SmoothingApproximation& approximation) {
+  return approximation.angle_tolerance != 0 || approximation.cusp_limit != 0;
+}
+
+/*
+ *  The number of line segments that keep a Bézier curve of the given degree
+ *  within the tolerance of the approximation, by Wang's formula. The largest
+ *  second difference of the control points bounds how far the curve bends.
+ */
+static size_t ComputeSegmentCount(size_t degree,
+                                  Scalar max_second_difference,
+                                  const SmoothingApproximation& approximation) {
+  const Scalar tolerance = kCurveTolerance * approximation.scale;
+  const Scalar segments = std::ceil(std::sqrt(
+      degree * (degree - 1) * max_second_difference / (8 * tolerance)));
+  // Also catches the NaN of a curve without any bend and a zero tolerance.
+  if (!(segments >= 1)) {
+    return 1;
+  }
+  return static_cast<size_t>(std::min(segments, kMaxCurveSegments));
+}
+
 std::vector<Point> LinearPathComponent::Extrema() const {
   return {p1, p2};
 }
@@ -87,8 +120,36 @@ Point QuadraticPathComponent::SolveDerivative(Scalar time) const {
 
 std::vector<Point> QuadraticPathComponent::CreatePolyline(
     const SmoothingApproximation& approximation) const {
-  CubicPathComponent elevated(*this);
-  return elevated.CreatePolyline(approximation);
+  std::vector<Point> points;
+  AppendPolylinePoints(approximation, points);
+  return points;
+}
+
+void QuadraticPathComponent::AppendPolylinePoints(
+    const SmoothingApproximation& approximation,
+    std::vector<Point>& points) const {
+  if (UsesRecursiveSubdivision(approximation)) {
+    CubicPathComponent elevated(*this);
+    elevated.AppendPolylinePoints(approximation, points);
+    return;
+  }
+
+  /*
+   *  Evaluates a t^2 + b t + p1 at evenly spaced times. Every point is
+   *  computed on its own, so that the compiler can vectorize the loop.
+   */
+  const Point a = p1 - cp * 2 + p2;
+  const Point b = (cp - p1) * 2;
+  const size_t count = ComputeSegmentCount(2, a.GetLength(), approximation);
+  const Scalar step = 1.0 / count;
+  const size_t start = points.size();
+  points.resize(start + count);
+  Point* output = points.data() + start;
+  for (size_t i = 1; i < count; i++) {
+    const Scalar t = i * step;
+    output[i - 1] = (a * t + b) * t + p1;
+  }
+  output[count - 1] = p2;
 }
 
 std::vector<Point> QuadraticPathComponent::Extrema() const {
@@ -339,11 +400,44 @@ static void CubicPathSmoothenRecursive(const SmoothingApproximation& approx,
 std::vector<Point> CubicPathComponent::CreatePolyline(
     const SmoothingApproximation& approximation) const {
   std::vector<Point> points;
-  CubicPathSmoothenRecursive(approximation, points, p1, cp1, cp2, p2, 0);
-  points.emplace_back(p2);
+  AppendPolylinePoints(approximation, points);
   return points;
 }
 
+void CubicPathComponent::AppendPolylinePoints(
+    const SmoothingApproximation& approximation,
+    std::vector<Point>& points) const {
+  if (UsesRecursiveSubdivision(approximation)) {
+    CubicPathSmoothenRecursive(approximation, points, p1, cp1, cp2, p2, 0);
+    points.emplace_back(p2);
+    return;
+  }
+
+  /*
+   *  Evaluates a t^3 + b t^2 + c t + p1 at evenly spaced times. Every point
+   *  is computed on its own, so that the compiler can vectorize the loop.
+   */
+  const Point second_difference_1 = p1 - cp1 * 2 + cp2;
+  const Point second_difference_2 = cp1 - cp2 * 2 + p2;
+  const size_t count = ComputeSegmentCount(
+      3,
+      std::max(second_difference_1.GetLength(),
+               second_difference_2.GetLength()),
+      approximation);
+  const Point a = p2 - p1 + (cp1 - cp2) * 3;
+  const Point b = second_difference_1 * 3;
+  const Point c = (cp1 - p1) * 3;
+  const Scalar step = 1.0 / count;
+  const size_t start = points.size();
+  points.resize(start + count);
+  Point* output = points.data() + start;
+  for (size_t i = 1; i < count; i++) {
+    const Scalar t = i * step;
+    output[i - 1] = ((a * t + b) * t + c) * t + p1;
+  }
+  output[count - 1] = p2;
+}
+
 static inline bool NearEqual(Scalar a, Scalar b, Scalar epsilon) {
   return (a > (b - epsilon)) && (a < (b + epsilon));
 }
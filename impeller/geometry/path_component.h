@@ -22,12 +22,20 @@ struct SmoothingApproximation {
   ///
   /// Values approaching 0.0 will generate smoother looking curves with a
   /// greater number of vertices, and will be more expensive to calculate.
+  ///
+  /// Unless an angle tolerance or cusp limit is given, curves are flattened
+  /// to within a quarter of this distance of the true curve, which is a
+  /// quarter of a pixel when this is the inverse of the scale of the
+  /// transform the path is drawn with.
   Scalar scale;
 
   /// The tolerance value in radians for calculating sharp angles.
   ///
   /// Values approaching 0.0 will provide more accurate approximation of sharp
   /// turns. A 0.0 value means angle conditions are not considered at all.
+  ///
+  /// Curves are subdivided recursively when either this or the cusp limit is
+  /// not 0.0, which is much slower.
   Scalar angle_tolerance;
 
   /// An angle in radians at which to introduce bevel cuts.
@@ -65,6 +73,9 @@ struct LinearPathComponent {
 
   std::vector<Point> CreatePolyline() const;
 
+  /// Appends the points of |CreatePolyline| to |points|.
+  void AppendPolylinePoints(std::vector<Point>& points) const;
+
   std::vector<Point> Extrema() const;
 
   bool operator==(const LinearPathComponent& other) const {
@@ -89,6 +100,10 @@ struct QuadraticPathComponent {
   std::vector<Point> CreatePolyline(
       const SmoothingApproximation& approximation) const;
 
+  /// Appends the points of |CreatePolyline| to |points|.
+  void AppendPolylinePoints(const SmoothingApproximation& approximation,
+                            std::vector<Point>& points) const;
+
   std::vector<Point> Extrema() const;
 
   bool operator==(const QuadraticPathComponent& other) const {
@@ -120,6 +135,10 @@ struct CubicPathComponent {
   std::vector<Point> CreatePolyline(
       const SmoothingApproximation& approximation) const;
 
+  /// Appends the points of |CreatePolyline| to |points|.
+  void AppendPolylinePoints(const SmoothingApproximation& approximation,
+                            std::vector<Point>& points) const;
+
   std::vector<Point> Extrema() const;
 
   bool operator==(const CubicPathComponent& other) const {
@@ -4,6 +4,7 @@
 
 #include "impeller/renderer/backend/gles/device_buffer_gles.h"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
@@ -55,7 +56,17 @@ bool DeviceBufferGLES::CopyHostBuffer(const uint8_t* source,
 
   std::memmove(backing_store_->GetBuffer() + offset,
                source + source_range.offset, source_range.length);
-  ++generation_;
+  if (source_range.length == 0u) {
+    return true;
+  }
+  if (dirty_range_.has_value()) {
+    const auto begin = std::min(dirty_range_->offset, offset);
+    const auto end = std::max(dirty_range_->offset + dirty_range_->length,
+                              offset + source_range.length);
+    dirty_range_ = Range{begin, end - begin};
+  } else {
+    dirty_range_ = Range{offset, source_range.length};
+  }
 
   return true;
 }
@@ -85,12 +96,31 @@ bool DeviceBufferGLES::BindAndUploadDataIfNecessary(BindingType type) const {
 
   gl.BindBuffer(target_type, buffer.value());
 
-  if (upload_generation_ != generation_) {
+  const auto length = backing_store_->GetLength();
+  if (!storage_allocated_) {
+    // Allocate the storage once, and only upload the data along with it if
+    // all of it has been written.
+    const bool upload_all =
+        dirty_range_.has_value() && dirty_range_.value() == Range{0u, length};
     TRACE_EVENT1("impeller", "BufferData", "Bytes",
-                 std::to_string(backing_store_->GetLength()).c_str());
-    gl.BufferData(target_type, backing_store_->GetLength(),
-                  backing_store_->GetBuffer(), GL_STATIC_DRAW);
-    upload_generation_ = generation_;
+                 std::to_string(upload_all ? length : 0u).c_str());
+    gl.BufferData(target_type, length,
+                  upload_all ? backing_store_->GetBuffer() : nullptr,
+                  GL_STATIC_DRAW);
+    storage_allocated_ = true;
+    if (upload_all) {
+      dirty_range_.reset();
+    }
+  }
+
+  // Buffers like the blocks of a host buffer are written a little at a time,
+  // so only the range written since the last upload is uploaded.
+  if (dirty_range_.has_value()) {
+    TRACE_EVENT1("impeller", "BufferSubData", "Bytes",
+                 std::to_string(dirty_range_->length).c_str());
+    gl.BufferSubData(target_type, dirty_range_->offset, dirty_range_->length,
+                     backing_store_->GetBuffer() + dirty_range_->offset);
+    dirty_range_.reset();
   }
 
   return true;
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
 #include "flutter/fml/macros.h"
 #include "impeller/base/allocation.h"
@@ -39,8 +40,9 @@ class DeviceBufferGLES final
   ReactorGLES::Ref reactor_;
   HandleGLES handle_;
   mutable std::shared_ptr<Allocation> backing_store_;
-  mutable uint32_t generation_ = 0;
-  mutable uint32_t upload_generation_ = 0;
+  // The range of the backing store written since the last upload.
+  mutable std::optional<Range> dirty_range_;
+  mutable bool storage_allocated_ = false;
 
   // |DeviceBuffer|
   bool CopyHostBuffer(const uint8_t* source,
@@ -0,0 +1,216 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/testing/testing.h"
+#include "impeller/base/allocation.h"
+#include "impeller/renderer/backend/gles/device_buffer_gles.h"
+#include "impeller/renderer/backend/gles/proc_table_gles.h"
+#include "impeller/renderer/backend/gles/reactor_gles.h"
+#include "impeller/renderer/host_buffer.h"
+
+namespace impeller {
+namespace testing {
+
+namespace {
+
+// A GL function that does nothing.
+template <class T>
+struct NoOpGLProc;
+
+template <class R, class... Args>
+struct NoOpGLProc<R(Args...)> {
+  static R Call(Args...) { return R(); }
+};
+
+struct BufferUpload {
+  GLintptr offset;
+  GLsizeiptr length;
+  bool has_data;
+};
+
+std::vector<BufferUpload> gUploads;
+GLuint gLastBufferName = 0u;
+
+void MockGenBuffers(GLsizei n, GLuint* buffers) {
+  for (GLsizei i = 0; i < n; i++) {
+    buffers[i] = ++gLastBufferName;
+  }
+}
+
+const GLubyte* MockGetString(GLenum name) {
+  switch (name) {
+    case GL_VERSION:
+      return reinterpret_cast<const GLubyte*>("OpenGL ES 3.0");
+    case GL_SHADING_LANGUAGE_VERSION:
+      return reinterpret_cast<const GLubyte*>("OpenGL ES GLSL ES 3.0");
+    default:
+      return reinterpret_cast<const GLubyte*>("");
+  }
+}
+
+void MockBufferData(GLenum target,
+                    GLsizeiptr size,
+                    const void* data,
+                    GLenum usage) {
+  gUploads.push_back({0, size, data != nullptr});
+}
+
+void MockBufferSubData(GLenum target,
+                       GLintptr offset,
+                       GLsizeiptr size,
+                       const void* data) {
+  gUploads.push_back({offset, size, data != nullptr});
+}
+
+std::unique_ptr<ProcTableGLES> CreateMockProcTable() {
+  std::map<std::string, void*> procs;
+#define IMPELLER_PROC(name) \
+  procs["gl" #name] =       \
+      reinterpret_cast<void*>(&NoOpGLProc<decltype(gl##name)>::Call)
+  FOR_EACH_IMPELLER_PROC(IMPELLER_PROC);
+  IMPELLER_PROC(GetError);
+#undef IMPELLER_PROC
+  procs["glGenBuffers"] = reinterpret_cast<void*>(&MockGenBuffers);
+  procs["glGetString"] = reinterpret_cast<void*>(&MockGetString);
+  procs["glBufferData"] = reinterpret_cast<void*>(&MockBufferData);
+  procs["glBufferSubData"] = reinterpret_cast<void*>(&MockBufferSubData);
+  return std::make_unique<ProcTableGLES>(
+      [procs](const char* function_name) -> void* {
+        auto found = procs.find(function_name);
+        return found == procs.end() ? nullptr : found->second;
+      });
+}
+
+class MockWorker final : public ReactorGLES::Worker {
+ public:
+  // |ReactorGLES::Worker|
+  bool CanReactorReactOnCurrentThreadNow(
+      const ReactorGLES& reactor) const override {
+    return true;
+  }
+};
+
+class MockAllocatorGLES final : public Allocator {
+ public:
+  explicit MockAllocatorGLES(ReactorGLES::Ref reactor)
+      : reactor_(std::move(reactor)) {}
+
+  // |Allocator|
+  std::shared_ptr<DeviceBuffer> CreateBuffer(StorageMode mode,
+                                             size_t length) override {
+    auto backing_store = std::make_shared<Allocation>();
+    if (!backing_store->Truncate(length)) {
+      return nullptr;
+    }
+    return std::make_shared<DeviceBufferGLES>(
+        reactor_, std::move(backing_store), length, mode);
+  }
+
+  // |Allocator|
+  std::shared_ptr<Texture> CreateTexture(
+      StorageMode mode,
+      const TextureDescriptor& desc) override {
+    return nullptr;
+  }
+
+ private:
+  ReactorGLES::Ref reactor_;
+};
+
+class DeviceBufferGLESTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    gUploads.clear();
+    reactor_ = std::make_shared<ReactorGLES>(CreateMockProcTable());
+    ASSERT_TRUE(reactor_->IsValid());
+    worker_ = std::make_shared<MockWorker>();
+    reactor_->AddWorker(worker_);
+  }
+
+  static size_t UploadedBytes() {
+    size_t bytes = 0u;
+    for (const auto& upload : gUploads) {
+      if (upload.has_data) {
+        bytes += upload.length;
+      }
+    }
+    return bytes;
+  }
+
+  ReactorGLES::Ref reactor_;
+  std::shared_ptr<MockWorker> worker_;
+};
+
+}  // namespace
+
+TEST_F(DeviceBufferGLESTest, UploadsOnlyTheRangeWrittenSinceTheLastUpload) {
+  MockAllocatorGLES allocator(reactor_);
+  auto buffer = allocator.CreateBuffer(StorageMode::kHostVisible, 1024u);
+  ASSERT_TRUE(buffer);
+  const auto& buffer_gles = DeviceBufferGLES::Cast(*buffer);
+
+  uint8_t data[64] = {};
+  ASSERT_TRUE(buffer->CopyHostBuffer(data, Range{0u, 64u}, 0u));
+  ASSERT_TRUE(buffer_gles.BindAndUploadDataIfNecessary(
+      DeviceBufferGLES::BindingType::kArrayBuffer));
+  ASSERT_EQ(UploadedBytes(), 64u);
+
+  ASSERT_TRUE(buffer->CopyHostBuffer(data, Range{0u, 16u}, 128u));
+  ASSERT_TRUE(buffer->CopyHostBuffer(data, Range{0u, 16u}, 96u));
+  ASSERT_TRUE(buffer_gles.BindAndUploadDataIfNecessary(
+      DeviceBufferGLES::BindingType::kArrayBuffer));
+  ASSERT_EQ(UploadedBytes(), 64u + 48u);
+  ASSERT_EQ(gUploads.back().offset, 96);
+
+  // Nothing was written since the last upload.
+  ASSERT_TRUE(buffer_gles.BindAndUploadDataIfNecessary(
+      DeviceBufferGLES::BindingType::kArrayBuffer));
+  ASSERT_EQ(UploadedBytes(), 64u + 48u);
+}
+
+TEST_F(DeviceBufferGLESTest, UploadsAFullyWrittenBufferWithItsStorage) {
+  MockAllocatorGLES allocator(reactor_);
+  auto buffer = allocator.CreateBuffer(StorageMode::kHostVisible, 256u);
+  ASSERT_TRUE(buffer);
+
+  uint8_t data[256] = {};
+  ASSERT_TRUE(buffer->CopyHostBuffer(data, Range{0u, 256u}, 0u));
+  ASSERT_TRUE(DeviceBufferGLES::Cast(*buffer).BindAndUploadDataIfNecessary(
+      DeviceBufferGLES::BindingType::kArrayBuffer));
+  ASSERT_EQ(gUploads.size(), 1u);
+  ASSERT_EQ(UploadedBytes(), 256u);
+}
+
+TEST_F(DeviceBufferGLESTest, HostBufferBlocksUploadOnlyEmplacedData) {
+  MockAllocatorGLES allocator(reactor_);
+  auto host_buffer = HostBuffer::Create();
+
+  uint8_t data[100] = {};
+  auto view = host_buffer->Emplace(data, sizeof(data), 1u);
+  auto device_buffer = view.buffer->GetDeviceBuffer(allocator);
+  ASSERT_TRUE(device_buffer);
+  ASSERT_TRUE(DeviceBufferGLES::Cast(*device_buffer)
+                  .BindAndUploadDataIfNecessary(
+                      DeviceBufferGLES::BindingType::kArrayBuffer));
+  ASSERT_EQ(UploadedBytes(), 100u);
+
+  auto next_view = host_buffer->Emplace(data, 50u, 1u);
+  ASSERT_EQ(next_view.buffer, view.buffer);
+  device_buffer = next_view.buffer->GetDeviceBuffer(allocator);
+  ASSERT_TRUE(device_buffer);
+  ASSERT_TRUE(DeviceBufferGLES::Cast(*device_buffer)
+                  .BindAndUploadDataIfNecessary(
+                      DeviceBufferGLES::BindingType::kArrayBuffer));
+  ASSERT_EQ(UploadedBytes(), 150u);
+  ASSERT_LT(UploadedBytes(), HostBuffer::kBlockSize);
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -4,6 +4,7 @@
 
 #include "impeller/renderer/backend/gles/texture_gles.h"
 
+#include <cstring>
 #include <optional>
 
 #include "flutter/fml/mapping.h"
@@ -259,6 +260,80 @@ bool TextureGLES::OnSetContents(std::shared_ptr<const fml::Mapping> mapping,
   return contents_initialized_;
 }
 
+// |Texture|
+bool TextureGLES::OnSetRegionContents(const uint8_t* contents,
+                                      size_t bytes_per_row,
+                                      IRect region,
+                                      size_t slice) {
+  if (GetType() != Type::kTexture || is_wrapped_) {
+    VALIDATION_LOG << "Cannot set the contents of a region of this texture.";
+    return false;
+  }
+
+  // The region is updated in place, so the texture must already have storage.
+  if (!contents_initialized_) {
+    VALIDATION_LOG << "Cannot set the contents of a region of a texture whose "
+                      "contents were never set.";
+    return false;
+  }
+
+  const auto& tex_descriptor = GetTextureDescriptor();
+  if (tex_descriptor.type != TextureType::kTexture2D || slice != 0) {
+    VALIDATION_LOG << "Only regions of 2D textures can be uploaded.";
+    return false;
+  }
+
+  // OpenGL ES 2 cannot unpack rows with a stride, and the upload happens
+  // later on the reactor. Copy the region into tightly packed rows.
+  const size_t row_length =
+      region.size.width * BytesPerPixelForPixelFormat(tex_descriptor.format);
+  auto allocation = std::make_shared<Allocation>();
+  if (!allocation->Truncate(row_length * region.size.height, false)) {
+    return false;
+  }
+  for (int64_t row = 0; row < region.size.height; row++) {
+    ::memmove(allocation->GetBuffer() + row * row_length,
+              contents + row * bytes_per_row, row_length);
+  }
+
+  auto data = std::make_shared<TexImage2DData>(
+      tex_descriptor.format, CreateMappingFromAllocation(allocation));
+  if (!data || !data->IsValid()) {
+    VALIDATION_LOG << "Invalid texture format.";
+    return false;
+  }
+
+  ReactorGLES::Operation texture_upload = [handle = handle_,  //
+                                           data,              //
+                                           region             //
+  ](const auto& reactor) {
+    auto gl_handle = reactor.GetGLHandle(handle);
+    if (!gl_handle.has_value()) {
+      VALIDATION_LOG
+          << "Texture was collected before it could be uploaded to the GPU.";
+      return;
+    }
+    const auto& gl = reactor.GetProcTable();
+    gl.BindTexture(GL_TEXTURE_2D, gl_handle.value());
+    TRACE_EVENT1("impeller", "TexSubImage2DUpload", "Bytes",
+                 std::to_string(data->data->GetSize()).c_str());
+    gl.PixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    gl.TexSubImage2D(GL_TEXTURE_2D,            // target
+                     0u,                       // LOD level
+                     region.origin.x,          // x offset
+                     region.origin.y,          // y offset
+                     region.size.width,        // width
+                     region.size.height,       // height
+                     data->external_format,    // external format
+                     data->type,               // type
+                     data->data->GetMapping()  // data
+    );
+    gl.PixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  };
+
+  return reactor_->AddOperation(texture_upload);
+}
+
 // |Texture|
 ISize TextureGLES::GetSize() const {
   return GetTextureDescriptor().size;
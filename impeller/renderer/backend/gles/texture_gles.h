@@ -73,6 +73,12 @@ class TextureGLES final : public Texture,
   bool OnSetContents(std::shared_ptr<const fml::Mapping> mapping,
                      size_t slice) override;
 
+  // |Texture|
+  bool OnSetRegionContents(const uint8_t* contents,
+                           size_t bytes_per_row,
+                           IRect region,
+                           size_t slice) override;
+
   // |Texture|
   bool IsValid() const override;
 
@@ -70,6 +70,31 @@ bool TextureMTL::OnSetContents(const uint8_t* contents,
   return true;
 }
 
+// |Texture|
+bool TextureMTL::OnSetRegionContents(const uint8_t* contents,
+                                     size_t bytes_per_row,
+                                     IRect region,
+                                     size_t slice) {
+  if (!IsValid()) {
+    return false;
+  }
+
+  const auto mtl_region = MTLRegionMake2D(region.origin.x,    //
+                                          region.origin.y,    //
+                                          region.size.width,  //
+                                          region.size.height  //
+  );
+  [texture_ replaceRegion:mtl_region                          //
+              mipmapLevel:0u                                  //
+                    slice:slice                               //
+                withBytes:contents                            //
+              bytesPerRow:bytes_per_row                       //
+            bytesPerImage:bytes_per_row * region.size.height  //
+  ];
+
+  return true;
+}
+
 ISize TextureMTL::GetSize() const {
   return {static_cast<ISize::Type>(texture_.width),
           static_cast<ISize::Type>(texture_.height)};
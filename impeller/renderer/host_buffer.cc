@@ -5,15 +5,106 @@
 #include "impeller/renderer/host_buffer.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
 
 #include "impeller/renderer/allocator.h"
+#include "impeller/renderer/buffer.h"
 #include "impeller/renderer/buffer_view.h"
 #include "impeller/renderer/device_buffer.h"
 
 namespace impeller {
 
+class HostBuffer::Block final : public Buffer {
+ public:
+  Block(size_t capacity, const std::string& label)
+      : data_(new uint8_t[capacity]), capacity_(capacity), label_(label) {}
+
+  // |Buffer|
+  ~Block() override = default;
+
+  uint8_t* GetData() const { return data_.get(); }
+
+  size_t GetCapacity() const { return capacity_; }
+
+  size_t GetLength() const { return length_; }
+
+  void SetLength(size_t length) {
+    FML_DCHECK(length <= capacity_);
+    length_ = length;
+  }
+
+  void Reset(const std::string& label) {
+    length_ = 0u;
+    uploaded_length_ = 0u;
+    if (label_ != label) {
+      label_ = label;
+      if (device_buffer_) {
+        device_buffer_->SetLabel(label_);
+      }
+    }
+  }
+
+  // |Buffer|
+  std::shared_ptr<const DeviceBuffer> GetDeviceBuffer(
+      Allocator& allocator) const override {
+    if (!device_buffer_) {
+      // Allocate for the whole block so that the device buffer can be reused
+      // as long as the block is.
+      device_buffer_ =
+          allocator.CreateBuffer(StorageMode::kHostVisible, capacity_);
+      if (!device_buffer_) {
+        return nullptr;
+      }
+      device_buffer_->SetLabel(label_);
+      uploaded_length_ = 0u;
+    }
+    // Data is only ever appended to a block, so only the data emplaced since
+    // the last upload needs to be copied.
+    if (uploaded_length_ < length_) {
+      if (!device_buffer_->CopyHostBuffer(
+              data_.get(), Range{uploaded_length_, length_ - uploaded_length_},
+              uploaded_length_)) {
+        return nullptr;
+      }
+      uploaded_length_ = length_;
+    }
+    return device_buffer_;
+  }
+
+ private:
+  const std::unique_ptr<uint8_t[]> data_;
+  const size_t capacity_;
+  size_t length_ = 0u;
+  std::string label_;
+  mutable std::shared_ptr<DeviceBuffer> device_buffer_;
+  mutable size_t uploaded_length_ = 0u;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Block);
+};
+
+HostBuffer::Fence::Fence() = default;
+
+HostBuffer::Fence::~Fence() = default;
+
+void HostBuffer::Fence::Signal() {
+  signaled_ = true;
+}
+
+bool HostBuffer::Fence::IsSignaled() const {
+  return signaled_;
+}
+
+void HostBuffer::Fence::Abandon() {
+  abandoned_ = true;
+}
+
+bool HostBuffer::Fence::IsAbandoned() const {
+  return abandoned_;
+}
+
 std::shared_ptr<HostBuffer> HostBuffer::Create() {
   return std::shared_ptr<HostBuffer>(new HostBuffer());
 }
@@ -29,45 +120,143 @@ void HostBuffer::SetLabel(std::string label) {
 BufferView HostBuffer::Emplace(const void* buffer,
                                size_t length,
                                size_t align) {
-  if (align == 0 || (GetLength() % align) == 0) {
-    return Emplace(buffer, length);
+  BufferView view;
+  auto data = Reserve(length, align, view);
+  if (!data) {
+    return {};
+  }
+  if (buffer) {
+    ::memmove(data, buffer, length);
+  }
+  return view;
+}
+
+BufferView HostBuffer::Emplace(size_t length,
+                               size_t align,
+                               const EmplaceProc& cb) {
+  BufferView view;
+  auto data = Reserve(length, align, view);
+  if (!data) {
+    return {};
+  }
+  if (cb) {
+    cb(data);
   }
+  return view;
+}
+
+uint8_t* HostBuffer::Reserve(size_t length, size_t align, BufferView& view) {
+  align = std::max<size_t>(align, 1u);
 
-  {
-    auto pad = Emplace(nullptr, align - (GetLength() % align));
-    if (!pad) {
-      return {};
+  auto block = frame_blocks_.empty() ? nullptr : frame_blocks_.back();
+  size_t offset = 0u;
+  if (block) {
+    offset = (block->GetLength() + align - 1u) / align * align;
+  }
+  if (!block || offset + length > block->GetCapacity()) {
+    block = AcquireBlock(length);
+    if (!block) {
+      return nullptr;
     }
+    frame_blocks_.push_back(block);
+    offset = 0u;
   }
 
-  return Emplace(buffer, length);
+  emplaced_bytes_ += offset + length - block->GetLength();
+  block->SetLength(offset + length);
+  view = BufferView{block, Range{offset, length}};
+  return block->GetData() + offset;
 }
 
-BufferView HostBuffer::Emplace(const void* buffer, size_t length) {
-  auto old_length = GetLength();
-  if (!Truncate(old_length + length)) {
-    return {};
+std::shared_ptr<HostBuffer::Block> HostBuffer::AcquireBlock(size_t length) {
+  // Data that does not fit a block gets one of its own that is not reused.
+  if (length > kBlockSize) {
+    allocated_block_count_++;
+    return std::make_shared<Block>(length, label_);
   }
-  generation_++;
-  if (buffer) {
-    ::memmove(GetBuffer() + old_length, buffer, length);
+
+  ReclaimRetiredBlocks();
+  if (!free_blocks_.empty()) {
+    auto block = std::move(free_blocks_.back());
+    free_blocks_.pop_back();
+    block->Reset(label_);
+    return block;
   }
-  return BufferView{shared_from_this(), Range{old_length, length}};
+
+  allocated_block_count_++;
+  return std::make_shared<Block>(kBlockSize, label_);
 }
 
-std::shared_ptr<const DeviceBuffer> HostBuffer::GetDeviceBuffer(
-    Allocator& allocator) const {
-  if (generation_ == device_buffer_generation_) {
-    return device_buffer_;
+void HostBuffer::ReclaimRetiredBlocks() {
+  while (!retired_frames_.empty()) {
+    const auto& fence = retired_frames_.front().fence;
+    // The blocks of an abandoned frame are dropped, so that the frames after
+    // it do not wait for a fence that is never signaled.
+    if (fence->IsAbandoned()) {
+      retired_frames_.pop_front();
+      continue;
+    }
+    if (!fence->IsSignaled()) {
+      break;
+    }
+    for (auto& block : retired_frames_.front().blocks) {
+      // Blocks that buffer views still refer to are left to them.
+      if (block.use_count() == 1 && block->GetCapacity() == kBlockSize) {
+        free_blocks_.push_back(std::move(block));
+      }
+    }
+    retired_frames_.pop_front();
   }
-  auto new_buffer = allocator.CreateBufferWithCopy(GetBuffer(), GetLength());
-  if (!new_buffer) {
-    return nullptr;
+}
+
+const uint8_t* HostBuffer::GetContents(const BufferView& view) const {
+  for (const auto& block : frame_blocks_) {
+    if (view.buffer == block) {
+      return block->GetData() + view.range.offset;
+    }
+  }
+  return nullptr;
+}
+
+size_t HostBuffer::GetLength() const {
+  return emplaced_bytes_;
+}
+
+size_t HostBuffer::GetReservedLength() const {
+  size_t length = 0u;
+  for (const auto& block : frame_blocks_) {
+    length += block->GetCapacity();
+  }
+  return length;
+}
+
+HostBuffer::Stats HostBuffer::GetStats() const {
+  Stats stats;
+  stats.emplaced_bytes = emplaced_bytes_;
+  stats.frame_block_count = frame_blocks_.size();
+  stats.allocated_block_count = allocated_block_count_;
+  return stats;
+}
+
+std::shared_ptr<HostBuffer::Fence> HostBuffer::FinishFrame() {
+  FML_TRACE_COUNTER("impeller", "HostBuffer",
+                    reinterpret_cast<int64_t>(this),          //
+                    "EmplacedBytes", emplaced_bytes_,         //
+                    "FrameBlocks", frame_blocks_.size(),      //
+                    "AllocatedBlocks", allocated_block_count_);
+
+  // Keep no more free blocks around than a frame like this one needs.
+  if (free_blocks_.size() > frame_blocks_.size()) {
+    free_blocks_.resize(frame_blocks_.size());
+  }
+
+  auto fence = std::make_shared<Fence>();
+  if (!frame_blocks_.empty()) {
+    retired_frames_.push_back({fence, std::move(frame_blocks_)});
+    frame_blocks_.clear();
   }
-  new_buffer->SetLabel(label_);
-  device_buffer_generation_ = generation_;
-  device_buffer_ = std::move(new_buffer);
-  return device_buffer_;
+  emplaced_bytes_ = 0u;
+  return fence;
 }
 
 }  // namespace impeller
@@ -5,26 +5,77 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "flutter/fml/macros.h"
-#include "impeller/base/allocation.h"
-#include "impeller/renderer/buffer.h"
 #include "impeller/renderer/buffer_view.h"
 #include "impeller/renderer/platform.h"
 
 namespace impeller {
 
-class HostBuffer final : public std::enable_shared_from_this<HostBuffer>,
-                         public Allocation,
-                         public Buffer {
+//------------------------------------------------------------------------------
+/// @brief      An arena for data that the host emplaces for the device to read,
+///             like uniforms and vertices.
+///
+///             Data is emplaced into fixed size blocks that are never
+///             reallocated, so emplacing does not move or copy data that is
+///             already in the buffer. Each block is uploaded to the device
+///             once, and after that only the data emplaced since.
+///
+///             A host buffer may be used for many frames. Finishing a frame
+///             retires its blocks behind a fence, and they are reused for a
+///             later frame once the fence is signaled and no buffer view
+///             refers to them anymore.
+///
+class HostBuffer final {
  public:
+  static constexpr size_t kBlockSize = 256u * 1024u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Signaled once the device is done reading the data of a frame.
+  ///             Abandoned instead if the device may never be done with it,
+  ///             in which case the blocks of the frame are dropped rather
+  ///             than reused.
+  ///
+  class Fence {
+   public:
+    Fence();
+
+    ~Fence();
+
+    void Signal();
+
+    bool IsSignaled() const;
+
+    void Abandon();
+
+    bool IsAbandoned() const;
+
+   private:
+    std::atomic_bool signaled_ = false;
+    std::atomic_bool abandoned_ = false;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Fence);
+  };
+
+  struct Stats {
+    /// The bytes emplaced in the current frame, including alignment padding.
+    size_t emplaced_bytes = 0u;
+    /// The blocks that hold data of the current frame.
+    size_t frame_block_count = 0u;
+    /// The blocks allocated since the host buffer was created.
+    size_t allocated_block_count = 0u;
+  };
+
   static std::shared_ptr<HostBuffer> Create();
 
-  // |Buffer|
-  virtual ~HostBuffer();
+  ~HostBuffer();
 
   void SetLabel(std::string label);
 
@@ -95,17 +146,73 @@ class HostBuffer final : public std::enable_shared_from_this<HostBuffer>,
                                    size_t length,
                                    size_t align);
 
+  using EmplaceProc = std::function<void(uint8_t* buffer)>;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reserve space on the host buffer and let the callback write
+  ///             the data into it directly.
+  ///
+  /// @param[in]  length  The length of the data.
+  /// @param[in]  align   The alignment of the data.
+  /// @param[in]  cb      The callback, which is handed the reserved space.
+  ///
+  /// @return     The buffer view.
+  ///
+  [[nodiscard]] BufferView Emplace(size_t length,
+                                   size_t align,
+                                   const EmplaceProc& cb);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Find the host copy of data emplaced onto this buffer.
+  ///
+  /// @return     The data, or `nullptr` if the view does not refer to this
+  ///             buffer.
+  ///
+  const uint8_t* GetContents(const BufferView& view) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The bytes emplaced in the current frame, including alignment
+  ///             padding.
+  ///
+  size_t GetLength() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The bytes reserved by the blocks that hold data of the
+  ///             current frame.
+  ///
+  size_t GetReservedLength() const;
+
+  Stats GetStats() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Finish the current frame. Data emplaced after this call goes
+  ///             into blocks that the device is done with.
+  ///
+  /// @return     The fence to signal once the device is done reading the data
+  ///             of the finished frame, or to abandon if that fails.
+  ///
+  std::shared_ptr<Fence> FinishFrame();
+
  private:
-  mutable std::shared_ptr<DeviceBuffer> device_buffer_;
-  mutable size_t device_buffer_generation_ = 0u;
-  size_t generation_ = 1u;
+  class Block;
+
+  struct RetiredFrame {
+    std::shared_ptr<Fence> fence;
+    std::vector<std::shared_ptr<Block>> blocks;
+  };
+
   std::string label_;
+  std::vector<std::shared_ptr<Block>> frame_blocks_;
+  std::deque<RetiredFrame> retired_frames_;
+  std::vector<std::shared_ptr<Block>> free_blocks_;
+  size_t emplaced_bytes_ = 0u;
+  size_t allocated_block_count_ = 0u;
+
+  uint8_t* Reserve(size_t length, size_t align, BufferView& view);
 
-  // |Buffer|
-  std::shared_ptr<const DeviceBuffer> GetDeviceBuffer(
-      Allocator& allocator) const override;
+  std::shared_ptr<Block> AcquireBlock(size_t length);
 
-  [[nodiscard]] BufferView Emplace(const void* buffer, size_t length);
+  void ReclaimRetiredBlocks();
 
   HostBuffer();
 
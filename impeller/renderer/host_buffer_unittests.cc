@@ -75,5 +75,109 @@ TEST(HostBufferTest, CanEmplaceWithAlignment) {
   }
 }
 
+TEST(HostBufferTest, EmplaceProcWritesIntoReservedSpace) {
+  auto buffer = HostBuffer::Create();
+
+  auto view = buffer->Emplace(4u, 4u, [](uint8_t* data) {
+    for (uint8_t i = 0; i < 4u; i++) {
+      data[i] = i + 1u;
+    }
+  });
+  ASSERT_TRUE(view);
+  ASSERT_EQ(view.range, Range(0u, 4u));
+
+  auto contents = buffer->GetContents(view);
+  ASSERT_NE(contents, nullptr);
+  ASSERT_EQ(contents[0], 1u);
+  ASSERT_EQ(contents[3], 4u);
+  ASSERT_EQ(HostBuffer::Create()->GetContents(view), nullptr);
+}
+
+TEST(HostBufferTest, FillsBlocksWithoutMovingData) {
+  auto buffer = HostBuffer::Create();
+
+  auto first = buffer->Emplace(nullptr, HostBuffer::kBlockSize - 8u, 1u);
+  auto second = buffer->Emplace(nullptr, 16u, 1u);
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+  ASSERT_NE(first.buffer, second.buffer);
+  ASSERT_EQ(second.range, Range(0u, 16u));
+  ASSERT_EQ(buffer->GetLength(), HostBuffer::kBlockSize + 8u);
+  ASSERT_EQ(buffer->GetReservedLength(), 2u * HostBuffer::kBlockSize);
+
+  // Data that does not fit a block gets one of its own.
+  auto large = buffer->Emplace(nullptr, HostBuffer::kBlockSize + 1u, 1u);
+  ASSERT_TRUE(large);
+  ASSERT_EQ(large.range, Range(0u, HostBuffer::kBlockSize + 1u));
+  ASSERT_EQ(buffer->GetStats().frame_block_count, 3u);
+  ASSERT_EQ(buffer->GetStats().allocated_block_count, 3u);
+}
+
+TEST(HostBufferTest, ReusesBlocksOnceFenceIsSignaled) {
+  auto buffer = HostBuffer::Create();
+
+  const Buffer* first_block = nullptr;
+  {
+    auto view = buffer->Emplace(nullptr, 16u, 1u);
+    first_block = view.buffer.get();
+  }
+  auto fence = buffer->FinishFrame();
+  ASSERT_EQ(buffer->GetLength(), 0u);
+  ASSERT_EQ(buffer->GetStats().frame_block_count, 0u);
+
+  // The device may still be reading the blocks of the finished frame.
+  {
+    auto view = buffer->Emplace(nullptr, 16u, 1u);
+    ASSERT_NE(view.buffer.get(), first_block);
+    ASSERT_EQ(buffer->GetStats().allocated_block_count, 2u);
+  }
+  fence->Signal();
+  buffer->FinishFrame()->Signal();
+
+  {
+    auto view = buffer->Emplace(nullptr, 16u, 1u);
+    ASSERT_EQ(view.range, Range(0u, 16u));
+    ASSERT_EQ(buffer->GetLength(), 16u);
+    ASSERT_EQ(buffer->GetStats().allocated_block_count, 2u);
+  }
+}
+
+TEST(HostBufferTest, DoesNotReuseBlocksThatViewsReferTo) {
+  auto buffer = HostBuffer::Create();
+
+  auto view = buffer->Emplace(nullptr, 16u, 1u);
+  buffer->FinishFrame()->Signal();
+
+  auto next_view = buffer->Emplace(nullptr, 16u, 1u);
+  ASSERT_NE(next_view.buffer, view.buffer);
+  ASSERT_EQ(buffer->GetStats().allocated_block_count, 2u);
+}
+
+TEST(HostBufferTest, DropsBlocksOfAbandonedFrames) {
+  auto buffer = HostBuffer::Create();
+
+  {
+    auto view = buffer->Emplace(nullptr, 16u, 1u);
+  }
+  auto abandoned_fence = buffer->FinishFrame();
+  const Buffer* second_block = nullptr;
+  {
+    auto view = buffer->Emplace(nullptr, 16u, 1u);
+    second_block = view.buffer.get();
+  }
+  auto fence = buffer->FinishFrame();
+  ASSERT_EQ(buffer->GetStats().allocated_block_count, 2u);
+
+  // The frames after an abandoned one do not wait for it, but the blocks of
+  // the abandoned frame are not reused.
+  abandoned_fence->Abandon();
+  fence->Signal();
+  auto view = buffer->Emplace(nullptr, 16u, 1u);
+  ASSERT_EQ(view.buffer.get(), second_block);
+  auto next_view = buffer->Emplace(nullptr, HostBuffer::kBlockSize, 1u);
+  ASSERT_NE(next_view.buffer, view.buffer);
+  ASSERT_EQ(buffer->GetStats().allocated_block_count, 3u);
+}
+
 }  // namespace  testing
 }  // namespace impeller
@@ -24,11 +24,21 @@ HostBuffer& RenderPass::GetTransientsBuffer() {
   return *transients_buffer_;
 }
 
+void RenderPass::SetTransientsBuffer(std::shared_ptr<HostBuffer> buffer) {
+  if (!buffer) {
+    return;
+  }
+  transients_buffer_ = std::move(buffer);
+  owns_transients_buffer_ = false;
+}
+
 void RenderPass::SetLabel(std::string label) {
   if (label.empty()) {
     return;
   }
-  transients_buffer_->SetLabel(SPrintF("%s Transients", label.c_str()));
+  if (owns_transients_buffer_) {
+    transients_buffer_->SetLabel(SPrintF("%s Transients", label.c_str()));
+  }
   OnSetLabel(std::move(label));
 }
 
@@ -37,6 +37,16 @@ class RenderPass {
 
   HostBuffer& GetTransientsBuffer();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Emplace the transients of this pass into a host buffer shared
+  ///             with other passes instead of one owned by this pass. The
+  ///             owner of the shared buffer is responsible for finishing its
+  ///             frames.
+  ///
+  /// @param[in]  buffer  The shared host buffer.
+  ///
+  void SetTransientsBuffer(std::shared_ptr<HostBuffer> buffer);
+
   //----------------------------------------------------------------------------
   /// @brief      Record a command for subsequent encoding to the underlying
   ///             command buffer. No work is encoded into the command buffer at
@@ -62,6 +72,7 @@ class RenderPass {
  protected:
   const RenderTarget render_target_;
   std::shared_ptr<HostBuffer> transients_buffer_;
+  bool owns_transients_buffer_ = true;
   std::vector<Command> commands_;
 
   RenderPass(RenderTarget target);
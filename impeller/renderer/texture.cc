@@ -42,6 +42,33 @@ bool Texture::SetContents(std::shared_ptr<const fml::Mapping> mapping,
   return true;
 }
 
+bool Texture::SetRegionContents(const uint8_t* contents,
+                                size_t bytes_per_row,
+                                IRect region,
+                                size_t slice) {
+  if (!IsSliceValid(slice)) {
+    VALIDATION_LOG << "Invalid slice for texture.";
+    return false;
+  }
+  if (!contents || region.IsEmpty()) {
+    return false;
+  }
+  if (!IRect::MakeSize(desc_.size).Contains(region)) {
+    VALIDATION_LOG << "Region is out of the bounds of the texture.";
+    return false;
+  }
+  if (bytes_per_row <
+      region.size.width * BytesPerPixelForPixelFormat(desc_.format)) {
+    VALIDATION_LOG << "Rows are too short for the region.";
+    return false;
+  }
+  if (!OnSetRegionContents(contents, bytes_per_row, region, slice)) {
+    return false;
+  }
+  intent_ = TextureIntent::kUploadFromHost;
+  return true;
+}
+
 const TextureDescriptor& Texture::GetTextureDescriptor() const {
   return desc_;
 }
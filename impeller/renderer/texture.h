@@ -8,6 +8,7 @@
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/mapping.h"
+#include "impeller/geometry/rect.h"
 #include "impeller/geometry/size.h"
 #include "impeller/renderer/formats.h"
 #include "impeller/renderer/texture_descriptor.h"
@@ -27,6 +28,20 @@ class Texture {
   [[nodiscard]] bool SetContents(std::shared_ptr<const fml::Mapping> mapping,
                                  size_t slice = 0);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Replace the contents of a region of the base mip level and
+  ///             leave the rest of the texture untouched.
+  ///
+  /// @param[in]  contents       The pixels of the region.
+  /// @param[in]  bytes_per_row  The stride between the rows of `contents`.
+  /// @param[in]  region         The region of the texture to replace.
+  /// @param[in]  slice          The slice of the texture to replace.
+  ///
+  [[nodiscard]] bool SetRegionContents(const uint8_t* contents,
+                                       size_t bytes_per_row,
+                                       IRect region,
+                                       size_t slice = 0);
+
   virtual bool IsValid() const = 0;
 
   virtual ISize GetSize() const = 0;
@@ -48,6 +63,11 @@ class Texture {
       std::shared_ptr<const fml::Mapping> mapping,
       size_t slice) = 0;
 
+  [[nodiscard]] virtual bool OnSetRegionContents(const uint8_t* contents,
+                                                 size_t bytes_per_row,
+                                                 IRect region,
+                                                 size_t slice) = 0;
+
  private:
   TextureIntent intent_ = TextureIntent::kRenderToTexture;
   const TextureDescriptor desc_;
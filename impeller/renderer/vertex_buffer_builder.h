@@ -6,6 +6,7 @@
 
 #include <initializer_list>
 #include <map>
+#include <numeric>
 #include <vector>
 
 #include "flutter/fml/macros.h"
@@ -116,10 +117,13 @@ class VertexBufferBuilder {
   }
 
   BufferView CreateIndexBufferView(HostBuffer& buffer) const {
-    const auto index_buffer = CreateIndexBuffer();
-    return buffer.Emplace(index_buffer.data(),
-                          index_buffer.size() * sizeof(IndexType),
-                          alignof(IndexType));
+    const auto index_count = vertices_.size();
+    return buffer.Emplace(index_count * sizeof(IndexType), alignof(IndexType),
+                          [index_count](uint8_t* data) {
+                            auto indices = reinterpret_cast<IndexType*>(data);
+                            std::iota(indices, indices + index_count,
+                                      IndexType{0});
+                          });
   }
 
   BufferView CreateIndexBufferView(Allocator& allocator) const {
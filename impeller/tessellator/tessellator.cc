@@ -4,15 +4,168 @@
 
 #include "impeller/tessellator/tessellator.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <tuple>
+
 #include "third_party/libtess2/Include/tesselator.h"
 
 namespace impeller {
 
-Tessellator::Tessellator() = default;
+namespace {
 
-Tessellator::~Tessellator() = default;
+// Ear clipping takes quadratic time, so larger contours that are neither
+// convex nor monotone are left to libtess2.
+constexpr size_t kMaxEarClippingPoints = 64;
+
+// Twice the signed area of the triangle |a|, |b|, |c|, which is positive if it
+// turns counterclockwise in a y-up coordinate system.
+Scalar Cross(const Point& a, const Point& b, const Point& c) {
+  return (b - a).Cross(c - a);
+}
 
-static int ToTessWindingRule(FillType fill_type) {
+int Sign(Scalar value) {
+  return (value > 0) - (value < 0);
+}
+
+// libtess2 orients the contours so that a single one that does not cross
+// itself has a winding number of 1 on its inside, which these fill types all
+// fill.
+bool FillsSimpleContour(FillType fill_type) {
+  switch (fill_type) {
+    case FillType::kOdd:
+    case FillType::kNonZero:
+    case FillType::kPositive:
+      return true;
+    case FillType::kNegative:
+    case FillType::kAbsGeqTwo:
+      return false;
+  }
+  return false;
+}
+
+void CountSignChange(int sign, int& first, int& last, int& changes) {
+  if (sign == 0) {
+    return;
+  }
+  if (first == 0) {
+    first = sign;
+  } else if (sign != last) {
+    changes++;
+  }
+  last = sign;
+}
+
+// Whether |points| turn the same way at every point and go around only once,
+// which is when a fan from the first point covers exactly their inside.
+bool IsConvex(const std::vector<Point>& points) {
+  const size_t count = points.size();
+  int turn = 0;
+  int first_x = 0, last_x = 0, x_changes = 0;
+  int first_y = 0, last_y = 0, y_changes = 0;
+  for (size_t i = 0; i < count; i++) {
+    const Point edge = points[(i + 1) % count] - points[i];
+    const Point next_edge = points[(i + 2) % count] - points[(i + 1) % count];
+    const Scalar cross = edge.Cross(next_edge);
+    if (cross == 0) {
+      if (edge.Dot(next_edge) < 0) {
+        return false;
+      }
+    } else if (turn == 0) {
+      turn = Sign(cross);
+    } else if (Sign(cross) != turn) {
+      return false;
+    }
+    CountSignChange(Sign(edge.x), first_x, last_x, x_changes);
+    CountSignChange(Sign(edge.y), first_y, last_y, y_changes);
+  }
+  if (first_x != last_x) {
+    x_changes++;
+  }
+  if (first_y != last_y) {
+    y_changes++;
+  }
+  return turn != 0 && x_changes <= 2 && y_changes <= 2;
+}
+
+void EmitFan(const std::vector<Point>& points,
+             const Tessellator::VertexCallback& callback) {
+  for (size_t i = 1; i + 1 < points.size(); i++) {
+    if (Cross(points[0], points[i], points[i + 1]) == 0) {
+      continue;
+    }
+    callback(points[0]);
+    callback(points[i]);
+    callback(points[i + 1]);
+  }
+}
+
+Scalar GetOrientation(const std::vector<Point>& points) {
+  Scalar area = 0;
+  for (size_t i = 0; i < points.size(); i++) {
+    area += points[i].Cross(points[(i + 1) % points.size()]);
+  }
+  return Sign(area);
+}
+
+bool IsOnSegment(const Point& a, const Point& b, const Point& point) {
+  return std::min(a.x, b.x) <= point.x && point.x <= std::max(a.x, b.x) &&
+         std::min(a.y, b.y) <= point.y && point.y <= std::max(a.y, b.y);
+}
+
+bool SegmentsTouch(const Point& a,
+                   const Point& b,
+                   const Point& c,
+                   const Point& d) {
+  const int c_side = Sign(Cross(a, b, c));
+  const int d_side = Sign(Cross(a, b, d));
+  const int a_side = Sign(Cross(c, d, a));
+  const int b_side = Sign(Cross(c, d, b));
+  if (c_side * d_side < 0 && a_side * b_side < 0) {
+    return true;
+  }
+  return (c_side == 0 && IsOnSegment(a, b, c)) ||
+         (d_side == 0 && IsOnSegment(a, b, d)) ||
+         (a_side == 0 && IsOnSegment(c, d, a)) ||
+         (b_side == 0 && IsOnSegment(c, d, b));
+}
+
+// Whether |point| is inside of the triangle |a|, |b|, |c| that turns the way
+// of |orientation|, or on its edges.
+bool IsInTriangle(const Point& a,
+                  const Point& b,
+                  const Point& c,
+                  Scalar orientation,
+                  const Point& point) {
+  return Cross(a, b, point) * orientation >= 0 &&
+         Cross(b, c, point) * orientation >= 0 &&
+         Cross(c, a, point) * orientation >= 0;
+}
+
+// Whether no two edges of |points| touch other than adjacent edges at the
+// point they share.
+bool IsSimple(const std::vector<Point>& points) {
+  const size_t count = points.size();
+  for (size_t i = 0; i < count; i++) {
+    const Point& a = points[i];
+    const Point& b = points[(i + 1) % count];
+    const Point& c = points[(i + 2) % count];
+    if (Cross(a, b, c) == 0 && (b - a).Dot(c - b) < 0) {
+      return false;
+    }
+    // The last edge is adjacent to the first one.
+    const size_t end = i == 0 ? count - 1 : count;
+    for (size_t j = i + 2; j < end; j++) {
+      if (SegmentsTouch(a, b, points[j], points[(j + 1) % count])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int ToTessWindingRule(FillType fill_type) {
   switch (fill_type) {
     case FillType::kOdd:
       return TESS_WINDING_ODD;
@@ -28,15 +181,120 @@ static int ToTessWindingRule(FillType fill_type) {
   return TESS_WINDING_ODD;
 }
 
-static void DestroyTessellator(TESStesselator* tessellator) {
-  if (tessellator != nullptr) {
-    ::tessDeleteTess(tessellator);
+}  // namespace
+
+//------------------------------------------------------------------------------
+/// Hands out the memory of a libtess2 tessellation from blocks that are kept
+/// for the next one. Nothing is freed before the arena is reset, which
+/// reclaims the tessellator and everything it allocated at once.
+///
+class Tessellator::Arena {
+ public:
+  Arena() {
+    allocator_.memalloc = [](void* arena, unsigned int size) {
+      return static_cast<Arena*>(arena)->Allocate(size);
+    };
+    allocator_.memrealloc = [](void* arena, void* data, unsigned int size) {
+      return static_cast<Arena*>(arena)->Reallocate(data, size);
+    };
+    allocator_.memfree = [](void* arena, void* data) {};
+    allocator_.userData = this;
   }
-}
+
+  TESSalloc* GetAllocator() { return &allocator_; }
+
+  void Reset() {
+    size_t retained_size = 0;
+    for (const Block& block : blocks_) {
+      retained_size += block.size;
+    }
+    // Gives back the memory of an unusually large tessellation.
+    if (retained_size > kMaxRetainedSize) {
+      blocks_.clear();
+    }
+    block_index_ = 0;
+    offset_ = 0;
+    last_allocation_ = nullptr;
+  }
+
+ private:
+  struct Block {
+    std::unique_ptr<std::max_align_t[]> memory;
+    size_t size;
+  };
+
+  // The size of an allocation is kept in front of it for reallocations.
+  static constexpr size_t kAlignment = sizeof(std::max_align_t);
+  static_assert(kAlignment >= sizeof(size_t));
+  static constexpr size_t kBlockSize = 64 * 1024;
+  static constexpr size_t kMaxRetainedSize = 1024 * 1024;
+
+  TESSalloc allocator_ = {};
+  std::vector<Block> blocks_;
+  size_t block_index_ = 0;
+  size_t offset_ = 0;
+  uint8_t* last_allocation_ = nullptr;
+
+  static size_t Align(size_t size) {
+    return (size + kAlignment - 1) / kAlignment * kAlignment;
+  }
+
+  void* Allocate(size_t size) {
+    const size_t needed = kAlignment + Align(size);
+    while (block_index_ < blocks_.size() &&
+           offset_ + needed > blocks_[block_index_].size) {
+      block_index_++;
+      offset_ = 0;
+    }
+    if (block_index_ == blocks_.size()) {
+      const size_t block_size = std::max(kBlockSize, needed);
+      blocks_.push_back(
+          {std::unique_ptr<std::max_align_t[]>(
+               new std::max_align_t[block_size / kAlignment]),
+           block_size});
+    }
+    uint8_t* header =
+        reinterpret_cast<uint8_t*>(blocks_[block_index_].memory.get()) +
+        offset_;
+    *reinterpret_cast<size_t*>(header) = size;
+    offset_ += needed;
+    last_allocation_ = header + kAlignment;
+    return last_allocation_;
+  }
+
+  void* Reallocate(void* data, size_t size) {
+    if (data == nullptr) {
+      return Allocate(size);
+    }
+    size_t& data_size = *reinterpret_cast<size_t*>(
+        static_cast<uint8_t*>(data) - kAlignment);
+    if (size <= data_size) {
+      return data;
+    }
+    // The latest allocation grows in place while its block has room.
+    if (data == last_allocation_) {
+      const size_t end = offset_ - Align(data_size) + Align(size);
+      if (end <= blocks_[block_index_].size) {
+        offset_ = end;
+        data_size = size;
+        return data;
+      }
+    }
+    void* result = Allocate(size);
+    std::memcpy(result, data, data_size);
+    return result;
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Arena);
+};
+
+Tessellator::Tessellator() : arena_(std::make_unique<Arena>()) {}
+
+Tessellator::~Tessellator() = default;
 
 Tessellator::Result Tessellator::Tessellate(FillType fill_type,
                                             const Path::Polyline& polyline,
-                                            VertexCallback callback) const {
+                                            VertexCallback callback) {
   if (!callback) {
     return Result::kInputError;
   }
@@ -45,13 +303,248 @@ Tessellator::Result Tessellator::Tessellate(FillType fill_type,
     return Result::kInputError;
   }
 
-  using CTessellator =
-      std::unique_ptr<TESStesselator, decltype(&DestroyTessellator)>;
+  if (FillsSimpleContour(fill_type) && CollectContour(polyline)) {
+    if (contour_.size() < 3) {
+      return Result::kSuccess;
+    }
+    if (IsConvex(contour_)) {
+      EmitFan(contour_, callback);
+      return Result::kSuccess;
+    }
+    if (TriangulateMonotone(/*sweep_x=*/false) ||
+        TriangulateMonotone(/*sweep_x=*/true) || TriangulateEarClipping()) {
+      for (uint32_t index : triangles_) {
+        callback(contour_[index]);
+      }
+      return Result::kSuccess;
+    }
+  }
+
+  return TessellateWithLibtess(fill_type, polyline, callback);
+}
+
+Tessellator::Result Tessellator::Tessellate(
+    const Path& path,
+    const SmoothingApproximation& approximation,
+    VertexCallback callback) {
+  path.CreatePolyline(polyline_, approximation);
+  return Tessellate(path.GetFillType(), polyline_, std::move(callback));
+}
+
+bool Tessellator::CollectContour(const Path::Polyline& polyline) {
+  contour_.clear();
+  for (size_t contour_i = 0; contour_i < polyline.contours.size();
+       contour_i++) {
+    size_t start_point_index, end_point_index;
+    std::tie(start_point_index, end_point_index) =
+        polyline.GetContourPointBounds(contour_i);
+    // Contours of fewer than three points enclose nothing.
+    if (end_point_index - start_point_index < 3) {
+      continue;
+    }
+    if (!contour_.empty()) {
+      return false;
+    }
+    for (size_t i = start_point_index; i < end_point_index; i++) {
+      if (contour_.empty() || contour_.back() != polyline.points[i]) {
+        contour_.push_back(polyline.points[i]);
+      }
+    }
+    while (contour_.size() > 1 && contour_.back() == contour_.front()) {
+      contour_.pop_back();
+    }
+  }
+  return true;
+}
+
+bool Tessellator::TriangulateMonotone(bool sweep_x) {
+  const std::vector<Point>& points = contour_;
+  const uint32_t count = points.size();
+
+  // Sweeps along one axis, and across it at the same position.
+  auto before = [&points, sweep_x](uint32_t a, uint32_t b) {
+    const Point& p = points[a];
+    const Point& q = points[b];
+    if (sweep_x) {
+      return p.x < q.x || (p.x == q.x && p.y < q.y);
+    }
+    return p.y < q.y || (p.y == q.y && p.x < q.x);
+  };
+
+  // The contour is monotone if it goes from its first point in the sweep to
+  // its last one and back without turning around in between.
+  uint32_t first = 0, last = 0;
+  int changes = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    const bool rises_in = before((i + count - 1) % count, i);
+    const bool rises_out = before(i, (i + 1) % count);
+    if (rises_in != rises_out) {
+      changes++;
+      if (rises_out) {
+        first = i;
+      } else {
+        last = i;
+      }
+    }
+  }
+  if (changes != 2) {
+    return false;
+  }
+
+  const Scalar orientation = GetOrientation(points);
+  if (orientation == 0) {
+    return false;
+  }
+
+  // Merges the chain that follows the contour from the first point to the
+  // last one with the chain that follows it back, in the order of the sweep.
+  // The inside is to the left of the contour when it turns counterclockwise,
+  // so every point of the chains has to be strictly on that side of the
+  // edge of the other chain it is swept past, or the chains cross or touch.
+  order_.clear();
+  order_.push_back(first);
+  uint32_t a = (first + 1) % count;
+  uint32_t b = (first + count - 1) % count;
+  while (a != last || b != last) {
+    if (b == last || (a != last && before(a, b))) {
+      if (Cross(points[(b + 1) % count], points[b], points[a]) * orientation >=
+          0) {
+        return false;
+      }
+      order_.push_back(a);
+      a = (a + 1) % count;
+    } else {
+      if (Cross(points[(a + count - 1) % count], points[a], points[b]) *
+              orientation <=
+          0) {
+        return false;
+      }
+      order_.push_back(b);
+      b = (b + count - 1) % count;
+    }
+  }
+  order_.push_back(last);
+
+  const uint32_t chain_length = (last + count - first) % count;
+  auto on_first_chain = [count, first, chain_length](uint32_t index) {
+    return (index + count - first) % count <= chain_length;
+  };
+  auto add_triangle = [this, &points](uint32_t i0, uint32_t i1, uint32_t i2) {
+    if (Cross(points[i0], points[i1], points[i2]) != 0) {
+      triangles_.push_back(i0);
+      triangles_.push_back(i1);
+      triangles_.push_back(i2);
+    }
+  };
+
+  // Triangulates the polygon in a single sweep, keeping the points that have
+  // been swept but still need triangles on a stack. See "Computational
+  // Geometry: Algorithms and Applications", section 3.3.
+  triangles_.clear();
+  stack_.clear();
+  stack_.push_back(order_[0]);
+  stack_.push_back(order_[1]);
+  for (size_t i = 2; i + 1 < order_.size(); i++) {
+    const uint32_t index = order_[i];
+    if (on_first_chain(index) != on_first_chain(stack_.back())) {
+      // The point sees all points on the stack across the polygon.
+      for (size_t j = 0; j + 1 < stack_.size(); j++) {
+        add_triangle(index, stack_[j], stack_[j + 1]);
+      }
+      const uint32_t top = stack_.back();
+      stack_.clear();
+      stack_.push_back(top);
+    } else {
+      // The point sees the points on the stack for as long as the chain
+      // turns towards the inside at them.
+      const Scalar inside = on_first_chain(index) ? orientation : -orientation;
+      uint32_t popped = stack_.back();
+      stack_.pop_back();
+      while (!stack_.empty() &&
+             Cross(points[stack_.back()], points[popped], points[index]) *
+                     inside >
+                 0) {
+        add_triangle(stack_.back(), popped, index);
+        popped = stack_.back();
+        stack_.pop_back();
+      }
+      stack_.push_back(popped);
+    }
+    stack_.push_back(index);
+  }
+  for (size_t j = 0; j + 1 < stack_.size(); j++) {
+    add_triangle(order_.back(), stack_[j], stack_[j + 1]);
+  }
+  return true;
+}
+
+bool Tessellator::TriangulateEarClipping() {
+  const std::vector<Point>& points = contour_;
+  if (points.size() > kMaxEarClippingPoints || !IsSimple(points)) {
+    return false;
+  }
+  const Scalar orientation = GetOrientation(points);
+  if (orientation == 0) {
+    return false;
+  }
 
-  CTessellator tessellator(
-      ::tessNewTess(nullptr /* the default ::malloc based allocator */),
-      DestroyTessellator);
+  // Cuts off a triangle at a point that turns towards the inside and has no
+  // other point in its triangle, until only one triangle is left.
+  triangles_.clear();
+  stack_.clear();
+  for (uint32_t i = 0; i < points.size(); i++) {
+    stack_.push_back(i);
+  }
+  size_t i = 0;
+  size_t skipped = 0;
+  while (stack_.size() > 3) {
+    const size_t count = stack_.size();
+    if (skipped > count) {
+      return false;
+    }
+    i %= count;
+    const uint32_t previous = stack_[(i + count - 1) % count];
+    const uint32_t current = stack_[i];
+    const uint32_t next = stack_[(i + 1) % count];
+    const Scalar turn =
+        Cross(points[previous], points[current], points[next]) * orientation;
+    bool is_ear = turn > 0;
+    for (size_t j = 0; is_ear && j < count; j++) {
+      const uint32_t other = stack_[j];
+      if (other == previous || other == current || other == next) {
+        continue;
+      }
+      is_ear = !IsInTriangle(points[previous], points[current], points[next],
+                             orientation, points[other]);
+    }
+    // A point in line with its neighbors is dropped without a triangle.
+    if (turn != 0 && !is_ear) {
+      i++;
+      skipped++;
+      continue;
+    }
+    if (is_ear) {
+      triangles_.push_back(previous);
+      triangles_.push_back(current);
+      triangles_.push_back(next);
+    }
+    stack_.erase(stack_.begin() + i);
+    skipped = 0;
+  }
+  if (Cross(points[stack_[0]], points[stack_[1]], points[stack_[2]]) != 0) {
+    triangles_.insert(triangles_.end(), stack_.begin(), stack_.end());
+  }
+  return true;
+}
 
+Tessellator::Result Tessellator::TessellateWithLibtess(
+    FillType fill_type,
+    const Path::Polyline& polyline,
+    const VertexCallback& callback) {
+  // The tessellator of the previous call is reclaimed along with its memory,
+  // instead of being deleted.
+  arena_->Reset();
+  TESStesselator* tessellator = ::tessNewTess(arena_->GetAllocator());
   if (!tessellator) {
     return Result::kTessellationError;
   }
@@ -69,8 +562,8 @@ Tessellator::Result Tessellator::Tessellate(FillType fill_type,
     std::tie(start_point_index, end_point_index) =
         polyline.GetContourPointBounds(contour_i);
 
-    ::tessAddContour(tessellator.get(),  // the C tessellator
-                     kVertexSize,        //
+    ::tessAddContour(tessellator,  // the C tessellator
+                     kVertexSize,  //
                      polyline.points.data() + start_point_index,  //
                      sizeof(Point),                               //
                      end_point_index - start_point_index          //
@@ -80,7 +573,7 @@ Tessellator::Result Tessellator::Tessellate(FillType fill_type,
   //----------------------------------------------------------------------------
   /// Let's tessellate.
   ///
-  auto result = ::tessTesselate(tessellator.get(),             // tessellator
+  auto result = ::tessTesselate(tessellator,                   // tessellator
                                 ToTessWindingRule(fill_type),  // winding
                                 TESS_POLYGONS,                 // element type
                                 kPolygonSize,                  // polygon size
@@ -92,25 +585,13 @@ Tessellator::Result Tessellator::Tessellate(FillType fill_type,
     return Result::kTessellationError;
   }
 
-  // TODO(csg): This copy can be elided entirely for the current use case.
-  std::vector<Point> points;
-  std::vector<uint32_t> indices;
-
-  int vertexItemCount = tessGetVertexCount(tessellator.get()) * kVertexSize;
-  auto vertices = tessGetVertices(tessellator.get());
-  for (int i = 0; i < vertexItemCount; i += 2) {
-    points.emplace_back(vertices[i], vertices[i + 1]);
-  }
-
-  int elementItemCount = tessGetElementCount(tessellator.get()) * kPolygonSize;
-  auto elements = tessGetElements(tessellator.get());
-  for (int i = 0; i < elementItemCount; i++) {
-    indices.emplace_back(elements[i]);
-  }
-
-  for (auto index : indices) {
-    auto vtx = points[index];
-    callback(vtx);
+  const TESSreal* vertices = ::tessGetVertices(tessellator);
+  const TESSindex* elements = ::tessGetElements(tessellator);
+  const int element_item_count =
+      ::tessGetElementCount(tessellator) * kPolygonSize;
+  for (int i = 0; i < element_item_count; i++) {
+    const TESSreal* vertex = vertices + elements[i] * kVertexSize;
+    callback(Point(vertex[0], vertex[1]));
   }
 
   return Result::kSuccess;
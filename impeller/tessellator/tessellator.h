@@ -5,6 +5,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <vector>
 
 #include "flutter/fml/macros.h"
@@ -22,6 +23,12 @@ enum class WindingOrder {
 /// @brief      A utility that generates triangles of the specified fill type
 ///             given a polyline. This happens on the CPU.
 ///
+///             Paths with a single convex or monotone contour, and small
+///             simple polygons, are triangulated directly. All others are
+///             tessellated by libtess2, in memory that is kept for the next
+///             call. A tessellator is meant to be reused for the paths of a
+///             frame, and must only be used by one thread at a time.
+///
 /// @bug        This should just be called a triangulator.
 ///
 class Tessellator {
@@ -49,9 +56,46 @@ class Tessellator {
   ///
   Tessellator::Result Tessellate(FillType fill_type,
                                  const Path::Polyline& polyline,
-                                 VertexCallback callback) const;
+                                 VertexCallback callback);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Flattens the path into a polyline that is kept for the next
+  ///             call, and generates filled triangles from that.
+  ///
+  /// @param[in]  path           The path, filled with its fill type.
+  /// @param[in]  approximation  How finely to flatten the curves.
+  /// @param[in]  callback       The callback
+  ///
+  /// @return The result status of the tessellation.
+  ///
+  Tessellator::Result Tessellate(const Path& path,
+                                 const SmoothingApproximation& approximation,
+                                 VertexCallback callback);
 
  private:
+  class Arena;
+
+  // The memory libtess2 allocates from.
+  std::unique_ptr<Arena> arena_;
+  Path::Polyline polyline_;
+  // The points of the contour that is triangulated directly, and the indices
+  // of its triangles into those points.
+  std::vector<Point> contour_;
+  std::vector<uint32_t> triangles_;
+  // The work lists of the monotone and ear clipping triangulators.
+  std::vector<uint32_t> order_;
+  std::vector<uint32_t> stack_;
+
+  bool CollectContour(const Path::Polyline& polyline);
+
+  bool TriangulateMonotone(bool sweep_x);
+
+  bool TriangulateEarClipping();
+
+  Tessellator::Result TessellateWithLibtess(FillType fill_type,
+                                            const Path::Polyline& polyline,
+                                            const VertexCallback& callback);
+
   FML_DISALLOW_COPY_AND_ASSIGN(Tessellator);
 };
 
@@ -0,0 +1,109 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+
+#include <cmath>
+
+#include "impeller/geometry/path_builder.h"
+#include "impeller/tessellator/tessellator.h"
+
+namespace impeller {
+namespace {
+
+// The paths of a typical frame of a chart heavy UI.
+Path CreateRect() {
+  return PathBuilder{}.AddRect(Rect::MakeXYWH(10, 10, 300, 40)).TakePath();
+}
+
+Path CreateRoundedRect() {
+  return PathBuilder{}
+      .AddRoundedRect(Rect::MakeXYWH(10, 10, 300, 40), 8)
+      .TakePath();
+}
+
+Path CreateCircle() {
+  return PathBuilder{}.AddCircle({100, 100}, 50).TakePath();
+}
+
+// The filled area under a line chart, which is monotone along x.
+Path CreateAreaChart() {
+  PathBuilder builder;
+  builder.MoveTo({0, 200});
+  for (int i = 0; i <= 200; i++) {
+    builder.LineTo({i * 2.0f, 100 + 80 * std::sin(i * 0.3f) * std::cos(i)});
+  }
+  return builder.LineTo({400, 200}).Close().TakePath();
+}
+
+// A pie chart slice that is more than half of the pie, which is concave.
+Path CreatePieSlice() {
+  PathBuilder builder;
+  builder.MoveTo({100, 100});
+  for (int i = 0; i <= 40; i++) {
+    const Scalar angle = kPi * 1.6 * i / 40;
+    builder.LineTo({100 + 80 * std::cos(angle), 100 + 80 * std::sin(angle)});
+  }
+  return builder.Close().TakePath();
+}
+
+Path CreateStar() {
+  PathBuilder builder;
+  for (int i = 0; i < 10; i++) {
+    const Scalar angle = kPi * i / 5;
+    const Scalar radius = i % 2 == 0 ? 50 : 20;
+    const Point point(100 + radius * std::cos(angle),
+                      100 + radius * std::sin(angle));
+    if (i == 0) {
+      builder.MoveTo(point);
+    } else {
+      builder.LineTo(point);
+    }
+  }
+  return builder.Close().TakePath();
+}
+
+// A ring, which has two contours and needs libtess2.
+Path CreateRing() {
+  return PathBuilder{}
+      .AddCircle({100, 100}, 50)
+      .AddCircle({100, 100}, 30)
+      .TakePath(FillType::kOdd);
+}
+
+void BM_Tessellate(benchmark::State& state,
+                   Path (*create_path)(),
+                   bool reuse_tessellator) {
+  const Path path = create_path();
+  const auto polyline = path.CreatePolyline();
+
+  Tessellator tessellator;
+  size_t vertex_count = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    vertex_count = 0;
+    auto callback = [&vertex_count](Point point) { vertex_count++; };
+    if (reuse_tessellator) {
+      tessellator.Tessellate(path.GetFillType(), polyline, callback);
+    } else {
+      Tessellator{}.Tessellate(path.GetFillType(), polyline, callback);
+    }
+  }
+  state.counters["vertices"] = vertex_count;
+}
+
+}  // namespace
+
+#define TESSELLATOR_BENCHMARK_CAPTURE(name, create_path)               \
+  BENCHMARK_CAPTURE(BM_Tessellate, name##_reused, create_path, true);  \
+  BENCHMARK_CAPTURE(BM_Tessellate, name##_new, create_path, false)
+
+TESSELLATOR_BENCHMARK_CAPTURE(rect, CreateRect);
+TESSELLATOR_BENCHMARK_CAPTURE(rounded_rect, CreateRoundedRect);
+TESSELLATOR_BENCHMARK_CAPTURE(circle, CreateCircle);
+TESSELLATOR_BENCHMARK_CAPTURE(area_chart, CreateAreaChart);
+TESSELLATOR_BENCHMARK_CAPTURE(pie_slice, CreatePieSlice);
+TESSELLATOR_BENCHMARK_CAPTURE(star, CreateStar);
+TESSELLATOR_BENCHMARK_CAPTURE(ring, CreateRing);
+
+}  // namespace impeller
@@ -10,6 +10,44 @@
 namespace impeller {
 namespace testing {
 
+namespace {
+
+// Tessellates |path| and returns the summed area of the triangles, or a
+// negative area if the tessellation failed.
+Scalar GetTessellatedArea(Tessellator& tessellator,
+                          const Path& path,
+                          size_t* vertex_count = nullptr) {
+  std::vector<Point> vertices;
+  auto result =
+      tessellator.Tessellate(path, {}, [&vertices](Point vertex) {
+        vertices.push_back(vertex);
+      });
+  if (result != Tessellator::Result::kSuccess || vertices.size() % 3 != 0) {
+    return -1;
+  }
+  if (vertex_count) {
+    *vertex_count = vertices.size();
+  }
+  Scalar area = 0;
+  for (size_t i = 0; i < vertices.size(); i += 3) {
+    area += std::abs((vertices[i + 1] - vertices[i])
+                         .Cross(vertices[i + 2] - vertices[i])) /
+            2;
+  }
+  return area;
+}
+
+Path MakePolygon(const std::vector<Point>& points) {
+  PathBuilder builder;
+  builder.MoveTo(points[0]);
+  for (size_t i = 1; i < points.size(); i++) {
+    builder.LineTo(points[i]);
+  }
+  return builder.Close().TakePath();
+}
+
+}  // namespace
+
 TEST(TessellatorTest, TessellatorReturnsCorrectResultStatus) {
   // Zero points.
   {
@@ -46,5 +84,131 @@ TEST(TessellatorTest, TessellatorReturnsCorrectResultStatus) {
   }
 }
 
+TEST(TessellatorTest, TriangulatesConvexPathsAsFan) {
+  Tessellator t;
+  size_t vertex_count = 0;
+  auto rect = PathBuilder{}.AddRect(Rect::MakeXYWH(10, 10, 100, 50)).TakePath();
+  ASSERT_FLOAT_EQ(GetTessellatedArea(t, rect, &vertex_count), 5000);
+  ASSERT_EQ(vertex_count, 6u);
+
+  // The same fill, whichever way the contour turns.
+  auto reversed = MakePolygon({{10, 10}, {10, 60}, {110, 60}, {110, 10}});
+  ASSERT_FLOAT_EQ(GetTessellatedArea(t, reversed, &vertex_count), 5000);
+  ASSERT_EQ(vertex_count, 6u);
+
+  // Points in line with their neighbors add no triangles.
+  auto collinear = MakePolygon({{0, 0}, {50, 0}, {100, 0}, {100, 100}});
+  ASSERT_FLOAT_EQ(GetTessellatedArea(t, collinear, &vertex_count), 5000);
+  ASSERT_EQ(vertex_count, 3u);
+
+  // The circle is flattened to within a quarter unit of its outline.
+  auto circle = PathBuilder{}.AddCircle({100, 100}, 50).TakePath();
+  ASSERT_NEAR(GetTessellatedArea(t, circle), kPi * 50 * 50, 2 * kPi * 50 / 4);
+}
+
+TEST(TessellatorTest, TriangulatesMonotonePaths) {
+  Tessellator t;
+  // An area chart, which is monotone along x.
+  auto chart = MakePolygon({{0, 100},
+                            {0, 40},
+                            {10, 80},
+                            {20, 20},
+                            {30, 60},
+                            {40, 0},
+                            {50, 90},
+                            {60, 30},
+                            {60, 100}});
+  ASSERT_FLOAT_EQ(GetTessellatedArea(t, chart), 3150);
+
+  // A bar chart on its side, which is monotone along y.
+  auto bars = MakePolygon({{100, 0},
+                           {40, 0},
+                           {80, 10},
+                           {20, 20},
+                           {60, 30},
+                           {0, 40},
+                           {90, 50},
+                           {30, 60},
+                           {100, 60}});
+  ASSERT_FLOAT_EQ(GetTessellatedArea(t, bars), 3150);
+}
+
+TEST(TessellatorTest, TriangulatesSimplePathsByEarClipping) {
+  Tessellator t;
+  // A spiral, which is monotone along neither axis.
+  auto spiral = MakePolygon({{0, 0},
+                             {50, 0},
+                             {50, 50},
+                             {10, 50},
+                             {10, 20},
+                             {30, 20},
+                             {30, 30},
+                             {20, 30},
+                             {20, 40},
+                             {40, 40},
+                             {40, 10},
+                             {0, 10}});
+  ASSERT_FLOAT_EQ(GetTessellatedArea(t, spiral), 1500);
+
+  auto comb = MakePolygon({{0, 0},
+                           {30, 0},
+                           {30, 10},
+                           {10, 10},
+                           {10, 20},
+                           {30, 20},
+                           {30, 30},
+                           {10, 30},
+                           {10, 40},
+                           {30, 40},
+                           {30, 50},
+                           {0, 50}});
+  ASSERT_FLOAT_EQ(GetTessellatedArea(t, comb), 1100);
+}
+
+TEST(TessellatorTest, TessellatesOtherPathsWithLibtess) {
+  Tessellator t;
+  // A bow tie crosses itself.
+  auto bow_tie = MakePolygon({{0, 0}, {10, 10}, {10, 0}, {0, 10}});
+  ASSERT_FLOAT_EQ(GetTessellatedArea(t, bow_tie), 50);
+
+  // A rect with a hole in it has two contours.
+  auto frame = PathBuilder{}
+                   .AddRect(Rect::MakeXYWH(0, 0, 30, 30))
+                   .AddRect(Rect::MakeXYWH(10, 10, 10, 10))
+                   .TakePath(FillType::kOdd);
+  ASSERT_FLOAT_EQ(GetTessellatedArea(t, frame), 800);
+
+  auto negative = PathBuilder{}
+                      .AddRect(Rect::MakeXYWH(0, 0, 30, 30))
+                      .TakePath(FillType::kNegative);
+  ASSERT_FLOAT_EQ(GetTessellatedArea(t, negative), 0);
+}
+
+TEST(TessellatorTest, ReusesLibtessMemoryAcrossTessellations) {
+  Tessellator t;
+  // A grid of 400 holes, whose tessellation takes several arena blocks.
+  PathBuilder builder;
+  builder.AddRect(Rect::MakeXYWH(0, 0, 60, 60));
+  for (int i = 0; i < 20; i++) {
+    for (int j = 0; j < 20; j++) {
+      builder.AddRect(Rect::MakeXYWH(3 * i + 1, 3 * j + 1, 1, 1));
+    }
+  }
+  auto grid = builder.TakePath(FillType::kOdd);
+
+  auto bow_tie = MakePolygon({{0, 0}, {10, 10}, {10, 0}, {0, 10}});
+  auto frame = PathBuilder{}
+                   .AddRect(Rect::MakeXYWH(0, 0, 30, 30))
+                   .AddRect(Rect::MakeXYWH(10, 10, 10, 10))
+                   .TakePath(FillType::kOdd);
+
+  // Each tessellation starts over in the memory of the previous ones.
+  for (int i = 0; i < 2; i++) {
+    ASSERT_FLOAT_EQ(GetTessellatedArea(t, frame), 800);
+    ASSERT_FLOAT_EQ(GetTessellatedArea(t, grid), 3200);
+    ASSERT_FLOAT_EQ(GetTessellatedArea(t, bow_tie), 50);
+  }
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -4,6 +4,11 @@
 
 #include "impeller/typographer/backends/skia/text_render_context_skia.h"
 
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <vector>
+
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
 #include "impeller/base/allocation.h"
@@ -15,11 +20,12 @@
 #include "third_party/skia/include/core/SkFontMetrics.h"
 #include "third_party/skia/include/core/SkRSXform.h"
 #include "third_party/skia/include/core/SkSurface.h"
-#include "third_party/skia/src/core/SkIPoint16.h"   //nogncheck
-#include "third_party/skia/src/gpu/GrRectanizer.h"  //nogncheck
 
 namespace impeller {
 
+static constexpr size_t kMinAtlasSize = 8u;
+static constexpr size_t kMaxAtlasSize = 4096u;
+
 TextRenderContextSkia::TextRenderContextSkia(std::shared_ptr<Context> context)
     : TextRenderContext(std::move(context)) {}
 
@@ -51,121 +57,83 @@ static FontGlyphPair::Vector CollectUniqueFontGlyphPairs(
   return vector;
 }
 
-static bool PairsFitInAtlasOfSize(const FontGlyphPair::Vector& pairs,
-                                  size_t atlas_size,
-                                  std::vector<Rect>& glyph_positions) {
-  if (atlas_size == 0u) {
-    return false;
-  }
-
-  auto rect_packer = std::unique_ptr<GrRectanizer>(
-      GrRectanizer::Factory(atlas_size, atlas_size));
-
-  glyph_positions.clear();
-  glyph_positions.reserve(pairs.size());
+static ISize GetGlyphSize(const FontGlyphPair& pair) {
+  return ISize::Ceil(pair.font.GetMetrics().GetBoundingBox().size *
+                     pair.font.GetMetrics().scale);
+}
 
+static size_t InitialAtlasSizeForFontGlyphPairs(
+    const FontGlyphPair::Vector& pairs) {
+  size_t area = 0u;
   for (const auto& pair : pairs) {
-    const auto glyph_size =
-        ISize::Ceil(pair.font.GetMetrics().GetBoundingBox().size *
-                    pair.font.GetMetrics().scale);
-    SkIPoint16 location_in_atlas;
-    if (!rect_packer->addRect(glyph_size.width,   //
-                              glyph_size.height,  //
-                              &location_in_atlas  //
-                              )) {
-      return false;
-    }
-    glyph_positions.emplace_back(Rect::MakeXYWH(location_in_atlas.x(),  //
-                                                location_in_atlas.y(),  //
-                                                glyph_size.width,       //
-                                                glyph_size.height       //
-                                                ));
+    area += GetGlyphSize(pair).Area();
   }
-
-  return true;
+  const auto side = static_cast<uint32_t>(std::ceil(std::sqrt(area)));
+  return std::clamp<size_t>(Allocation::NextPowerOfTwoSize(side),
+                            kMinAtlasSize, kMaxAtlasSize);
 }
 
-static size_t OptimumAtlasSizeForFontGlyphPairs(
-    const FontGlyphPair::Vector& pairs,
-    std::vector<Rect>& glyph_positions) {
-  static constexpr auto kMinAtlasSize = 8u;
-  static constexpr auto kMaxAtlasSize = 4096u;
-
-  TRACE_EVENT0("impeller", __FUNCTION__);
-
-  size_t current_size = kMinAtlasSize;
-  do {
-    if (PairsFitInAtlasOfSize(pairs, current_size, glyph_positions)) {
-      return current_size;
-    }
-    current_size = Allocation::NextPowerOfTwoSize(current_size + 1);
-  } while (current_size <= kMaxAtlasSize);
-  return 0u;
-}
-
-static std::shared_ptr<SkBitmap> CreateAtlasBitmap(const GlyphAtlas& atlas,
-                                                   size_t atlas_size) {
+static std::shared_ptr<SkBitmap> CreateAtlasBitmap(size_t atlas_size) {
   TRACE_EVENT0("impeller", __FUNCTION__);
   auto bitmap = std::make_shared<SkBitmap>();
   auto image_info = SkImageInfo::MakeA8(atlas_size, atlas_size);
   if (!bitmap->tryAllocPixels(image_info)) {
     return nullptr;
   }
-  auto surface = SkSurface::MakeRasterDirect(bitmap->pixmap());
-  if (!surface) {
-    return nullptr;
-  }
-  auto canvas = surface->getCanvas();
-  if (!canvas) {
-    return nullptr;
-  }
-
-  atlas.IterateGlyphs([canvas](const FontGlyphPair& font_glyph,
-                               const Rect& location) -> bool {
-    const auto position = SkPoint::Make(location.origin.x, location.origin.y);
-    SkGlyphID glyph_id = font_glyph.glyph.index;
-
-    SkFont sk_font(
-        TypefaceSkia::Cast(*font_glyph.font.GetTypeface()).GetSkiaTypeface(),
-        font_glyph.font.GetMetrics().point_size *
-            font_glyph.font.GetMetrics().scale);
-
-    const auto& metrics = font_glyph.font.GetMetrics();
-
-    auto glyph_color = SK_ColorWHITE;
-
-    SkPaint glyph_paint;
-    glyph_paint.setColor(glyph_color);
-    canvas->drawGlyphs(
-        1u,         // count
-        &glyph_id,  // glyphs
-        &position,  // positions
-        SkPoint::Make(-metrics.min_extent.x * metrics.scale,
-                      -metrics.ascent * metrics.scale),  // origin
-        sk_font,                                         // font
-        glyph_paint                                      // paint
-    );
-    return true;
-  });
-
+  bitmap->eraseColor(SK_ColorTRANSPARENT);
   return bitmap;
 }
 
+static void DrawGlyph(SkCanvas* canvas,
+                      const FontGlyphPair& font_glyph,
+                      const IRect& location) {
+  const auto position = SkPoint::Make(location.origin.x, location.origin.y);
+  SkGlyphID glyph_id = font_glyph.glyph.index;
+
+  SkFont sk_font(
+      TypefaceSkia::Cast(*font_glyph.font.GetTypeface()).GetSkiaTypeface(),
+      font_glyph.font.GetMetrics().point_size *
+          font_glyph.font.GetMetrics().scale);
+
+  const auto& metrics = font_glyph.font.GetMetrics();
+
+  auto glyph_color = SK_ColorWHITE;
+
+  SkPaint glyph_paint;
+  glyph_paint.setColor(glyph_color);
+
+  // The neighbours of the glyph stay in the atlas, and the location may still
+  // hold a glyph that was evicted from it.
+  canvas->save();
+  canvas->clipRect(SkRect::MakeXYWH(location.origin.x, location.origin.y,
+                                    location.size.width,
+                                    location.size.height));
+  canvas->clear(SK_ColorTRANSPARENT);
+  canvas->drawGlyphs(
+      1u,         // count
+      &glyph_id,  // glyphs
+      &position,  // positions
+      SkPoint::Make(-metrics.min_extent.x * metrics.scale,
+                    -metrics.ascent * metrics.scale),  // origin
+      sk_font,                                         // font
+      glyph_paint                                      // paint
+  );
+  canvas->restore();
+}
+
 static std::shared_ptr<Texture> UploadGlyphTextureAtlas(
     std::shared_ptr<Allocator> allocator,
-    std::shared_ptr<SkBitmap> bitmap,
-    size_t atlas_size) {
+    const SkBitmap& bitmap) {
   TRACE_EVENT0("impeller", __FUNCTION__);
   if (!allocator) {
     return nullptr;
   }
 
-  FML_DCHECK(bitmap != nullptr);
-  const auto& pixmap = bitmap->pixmap();
+  const auto& pixmap = bitmap.pixmap();
 
   TextureDescriptor texture_descriptor;
   texture_descriptor.format = PixelFormat::kA8UNormInt;
-  texture_descriptor.size = ISize::MakeWH(atlas_size, atlas_size);
+  texture_descriptor.size = ISize::MakeWH(pixmap.width(), pixmap.height());
 
   if (pixmap.rowBytes() * pixmap.height() !=
       texture_descriptor.GetByteSizeOfBaseMipLevel()) {
@@ -179,20 +147,108 @@ static std::shared_ptr<Texture> UploadGlyphTextureAtlas(
   }
   texture->SetLabel("GlyphAtlas");
 
-  auto mapping = std::make_shared<fml::NonOwnedMapping>(
-      reinterpret_cast<const uint8_t*>(bitmap->getAddr(0, 0)),  // data
-      texture_descriptor.GetByteSizeOfBaseMipLevel(),           // size
-      [bitmap](auto, auto) mutable { bitmap.reset(); }          // proc
-  );
-
-  if (!texture->SetContents(mapping)) {
+  // The bitmap keeps changing after this call, so its contents are copied
+  // rather than referenced.
+  if (!texture->SetContents(
+          reinterpret_cast<const uint8_t*>(bitmap.getAddr(0, 0)),  // data
+          texture_descriptor.GetByteSizeOfBaseMipLevel()            // size
+          )) {
     return nullptr;
   }
   return texture;
 }
 
+void TextRenderContextSkia::ResetAtlas() {
+  glyph_slots_.clear();
+  lru_glyphs_.clear();
+  rect_packer_.reset();
+  bitmap_.reset();
+  texture_.reset();
+}
+
+bool TextRenderContextSkia::GrowAtlas(size_t atlas_size) {
+  auto bitmap = CreateAtlasBitmap(atlas_size);
+  if (!bitmap) {
+    return false;
+  }
+  if (bitmap_ && !bitmap->writePixels(bitmap_->pixmap(), 0, 0)) {
+    return false;
+  }
+  bitmap_ = std::move(bitmap);
+
+  const auto size = ISize::MakeWH(atlas_size, atlas_size);
+  if (rect_packer_) {
+    rect_packer_->Grow(size);
+  } else {
+    rect_packer_ = std::make_unique<RectanglePacker>(size);
+  }
+  return true;
+}
+
+bool TextRenderContextSkia::EvictLeastRecentlyUsedGlyph() {
+  if (lru_glyphs_.empty()) {
+    return false;
+  }
+  auto slot = glyph_slots_.find(lru_glyphs_.back());
+  FML_DCHECK(slot != glyph_slots_.end());
+  // Glyphs needed by the current frames cannot be evicted.
+  if (slot->second.last_used == generation_) {
+    return false;
+  }
+  rect_packer_->RemoveRect(slot->second.location);
+  glyph_slots_.erase(slot);
+  lru_glyphs_.pop_back();
+  return true;
+}
+
+bool TextRenderContextSkia::CanAddGlyphAfterEviction(ISize glyph_size) const {
+  // Collect the locations in the order |EvictLeastRecentlyUsedGlyph| would
+  // free them.
+  std::vector<IRect> locations;
+  for (auto it = lru_glyphs_.rbegin(); it != lru_glyphs_.rend(); ++it) {
+    const auto& slot = glyph_slots_.find(*it)->second;
+    if (slot.last_used == generation_) {
+      break;
+    }
+    locations.push_back(slot.location);
+  }
+  return rect_packer_->CanAddRectAfterRemoving(glyph_size, locations);
+}
+
+std::optional<IRect> TextRenderContextSkia::AddGlyph(
+    const FontGlyphPair& pair,
+    bool& needs_new_texture) {
+  const auto glyph_size = GetGlyphSize(pair);
+  std::optional<bool> eviction_makes_room;
+  while (true) {
+    if (auto origin = rect_packer_->AddRect(glyph_size)) {
+      const auto location = IRect(origin.value(), glyph_size);
+      lru_glyphs_.push_front(pair);
+      glyph_slots_[pair] = {location, lru_glyphs_.begin(), generation_};
+      return location;
+    }
+    // Evicting glyphs that cannot make room for this one would only throw
+    // them away before the atlas grows or is reset anyway.
+    if (!eviction_makes_room.has_value()) {
+      eviction_makes_room = CanAddGlyphAfterEviction(glyph_size);
+    }
+    // Textures that were already handed out may still be sampled from the
+    // evicted locations, so eviction and growth upload a new texture.
+    if (eviction_makes_room.value() && EvictLeastRecentlyUsedGlyph()) {
+      needs_new_texture = true;
+      continue;
+    }
+    const auto atlas_size = static_cast<size_t>(rect_packer_->GetSize().width);
+    if (atlas_size >= kMaxAtlasSize || !GrowAtlas(atlas_size * 2)) {
+      return std::nullopt;
+    }
+    eviction_makes_room.reset();
+    needs_new_texture = true;
+  }
+}
+
 std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
-    FrameIterator frame_iterator) const {
+    FrameIterator frame_iterator) {
   TRACE_EVENT0("impeller", __FUNCTION__);
   if (!IsValid()) {
     return nullptr;
@@ -208,56 +264,106 @@ std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
   if (font_glyph_pairs.empty()) {
     return glyph_atlas;
   }
+  generation_++;
 
   // ---------------------------------------------------------------------------
-  // Step 2: Get the optimum size of the texture atlas.
+  // Step 2: Mark the font-glyph pairs that are already in the atlas as used
+  // and collect the ones that still need to be rendered.
   // ---------------------------------------------------------------------------
-  std::vector<Rect> glyph_positions;
-  const auto atlas_size =
-      OptimumAtlasSizeForFontGlyphPairs(font_glyph_pairs, glyph_positions);
-  if (atlas_size == 0u) {
-    return nullptr;
+  FontGlyphPair::Vector new_pairs;
+  for (const auto& pair : font_glyph_pairs) {
+    auto slot = glyph_slots_.find(pair);
+    if (slot == glyph_slots_.end()) {
+      new_pairs.push_back(pair);
+      continue;
+    }
+    slot->second.last_used = generation_;
+    lru_glyphs_.splice(lru_glyphs_.begin(), lru_glyphs_,
+                       slot->second.lru_position);
   }
 
   // ---------------------------------------------------------------------------
-  // Step 3: Find location of font-glyph pairs in the atlas. We have this from
-  // the last step. So no need to do create another rect packer. But just do a
-  // sanity check of counts. This could also be just an assertion as only a
-  // construction issue would cause such a failure.
+  // Step 3: Find locations for the new font-glyph pairs, evicting old glyphs
+  // and growing the atlas as necessary. If they still do not fit, start over
+  // with just the font-glyph pairs in the frame.
   // ---------------------------------------------------------------------------
-  if (glyph_positions.size() != font_glyph_pairs.size()) {
-    return nullptr;
+  bool needs_new_texture = !texture_;
+  std::vector<IRect> new_locations;
+  for (size_t attempt = 0; attempt < 2u; attempt++) {
+    if (!rect_packer_ &&
+        !GrowAtlas(InitialAtlasSizeForFontGlyphPairs(new_pairs))) {
+      ResetAtlas();
+      return nullptr;
+    }
+    new_locations.clear();
+    new_locations.reserve(new_pairs.size());
+    for (const auto& pair : new_pairs) {
+      auto location = AddGlyph(pair, needs_new_texture);
+      if (!location.has_value()) {
+        break;
+      }
+      new_locations.push_back(location.value());
+    }
+    if (new_locations.size() == new_pairs.size()) {
+      break;
+    }
+    ResetAtlas();
+    if (attempt > 0u) {
+      return nullptr;
+    }
+    new_pairs = font_glyph_pairs;
+    needs_new_texture = true;
   }
 
   // ---------------------------------------------------------------------------
-  // Step 4: Record the positions in the glyph atlas.
+  // Step 4: Draw the new font-glyph pairs in their spots in the atlas.
   // ---------------------------------------------------------------------------
-  for (size_t i = 0, count = glyph_positions.size(); i < count; i++) {
-    glyph_atlas->AddTypefaceGlyphPosition(font_glyph_pairs[i],
-                                          glyph_positions[i]);
+  std::optional<IRect> dirty_region;
+  if (!new_pairs.empty()) {
+    TRACE_EVENT0("impeller", "DrawGlyphs");
+    auto surface = SkSurface::MakeRasterDirect(bitmap_->pixmap());
+    if (!surface) {
+      ResetAtlas();
+      return nullptr;
+    }
+    auto canvas = surface->getCanvas();
+    for (size_t i = 0, count = new_pairs.size(); i < count; i++) {
+      DrawGlyph(canvas, new_pairs[i], new_locations[i]);
+      dirty_region = dirty_region.has_value()
+                         ? dirty_region->Union(new_locations[i])
+                         : new_locations[i];
+    }
   }
 
   // ---------------------------------------------------------------------------
-  // Step 5: Draw font-glyph pairs in the correct spot in the atlas.
+  // Step 5: Upload the new glyphs. Only the region they were drawn to needs to
+  // be uploaded into a texture that is reused.
   // ---------------------------------------------------------------------------
-  auto bitmap = CreateAtlasBitmap(*glyph_atlas, atlas_size);
-  if (!bitmap) {
-    return nullptr;
+  if (!needs_new_texture && dirty_region.has_value() &&
+      !dirty_region->IsEmpty()) {
+    const auto& region = dirty_region.value();
+    needs_new_texture = !texture_->SetRegionContents(
+        reinterpret_cast<const uint8_t*>(
+            bitmap_->getAddr(region.origin.x, region.origin.y)),
+        bitmap_->rowBytes(), region);
   }
-
-  // ---------------------------------------------------------------------------
-  // Step 6: Upload the atlas as a texture.
-  // ---------------------------------------------------------------------------
-  auto texture = UploadGlyphTextureAtlas(GetContext()->GetTransientsAllocator(),
-                                         bitmap, atlas_size);
-  if (!texture) {
-    return nullptr;
+  if (needs_new_texture) {
+    texture_ = UploadGlyphTextureAtlas(
+        GetContext()->GetPermanentsAllocator(), *bitmap_);
+    if (!texture_) {
+      ResetAtlas();
+      return nullptr;
+    }
   }
 
   // ---------------------------------------------------------------------------
-  // Step 7: Record the texture in the glyph atlas.
+  // Step 6: Record the positions and the texture in the glyph atlas.
   // ---------------------------------------------------------------------------
-  glyph_atlas->SetTexture(std::move(texture));
+  for (const auto& pair : font_glyph_pairs) {
+    glyph_atlas->AddTypefaceGlyphPosition(
+        pair, Rect(glyph_slots_.find(pair)->second.location));
+  }
+  glyph_atlas->SetTexture(texture_);
 
   return glyph_atlas;
 }
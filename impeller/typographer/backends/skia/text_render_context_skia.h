@@ -4,11 +4,28 @@
 
 #pragma once
 
+#include <list>
+#include <memory>
+#include <unordered_map>
+
 #include "flutter/fml/macros.h"
+#include "impeller/typographer/rectangle_packer.h"
 #include "impeller/typographer/text_render_context.h"
 
+class SkBitmap;
+
 namespace impeller {
 
+//------------------------------------------------------------------------------
+/// @brief      Renders glyphs with Skia into a single atlas that is kept
+///             across calls.
+///
+///             Glyphs keep their place in the atlas once rendered. New glyphs
+///             are rendered into free space and only that region is uploaded.
+///             When the atlas is full, glyphs that the current call does not
+///             need are evicted least recently used first, and the atlas is
+///             grown if that is not enough.
+///
 class TextRenderContextSkia : public TextRenderContext {
  public:
   TextRenderContextSkia(std::shared_ptr<Context> context);
@@ -17,9 +34,38 @@ class TextRenderContextSkia : public TextRenderContext {
 
   // |TextRenderContext|
   std::shared_ptr<GlyphAtlas> CreateGlyphAtlas(
-      FrameIterator iterator) const override;
+      FrameIterator iterator) override;
 
  private:
+  struct GlyphSlot {
+    IRect location;
+    std::list<FontGlyphPair>::iterator lru_position;
+    size_t last_used = 0u;
+  };
+
+  std::unordered_map<FontGlyphPair,
+                     GlyphSlot,
+                     FontGlyphPair::Hash,
+                     FontGlyphPair::Equal>
+      glyph_slots_;
+  // Most recently used glyphs first.
+  std::list<FontGlyphPair> lru_glyphs_;
+  std::unique_ptr<RectanglePacker> rect_packer_;
+  std::shared_ptr<SkBitmap> bitmap_;
+  std::shared_ptr<Texture> texture_;
+  size_t generation_ = 0u;
+
+  void ResetAtlas();
+
+  bool GrowAtlas(size_t atlas_size);
+
+  bool EvictLeastRecentlyUsedGlyph();
+
+  bool CanAddGlyphAfterEviction(ISize glyph_size) const;
+
+  std::optional<IRect> AddGlyph(const FontGlyphPair& pair,
+                                bool& needs_new_texture);
+
   FML_DISALLOW_COPY_AND_ASSIGN(TextRenderContextSkia);
 };
 
@@ -5,7 +5,6 @@
 #include "impeller/typographer/lazy_glyph_atlas.h"
 
 #include "impeller/base/validation.h"
-#include "impeller/typographer/text_render_context.h"
 
 namespace impeller {
 
@@ -19,13 +18,12 @@ void LazyGlyphAtlas::AddTextFrame(TextFrame frame) {
 }
 
 std::shared_ptr<GlyphAtlas> LazyGlyphAtlas::CreateOrGetGlyphAtlas(
-    std::shared_ptr<Context> context) const {
+    TextRenderContext& text_context) const {
   if (atlas_) {
     return atlas_;
   }
 
-  auto text_context = TextRenderContext::Create(std::move(context));
-  if (!text_context || !text_context->IsValid()) {
+  if (!text_context.IsValid()) {
     return nullptr;
   }
   size_t i = 0;
@@ -37,7 +35,7 @@ std::shared_ptr<GlyphAtlas> LazyGlyphAtlas::CreateOrGetGlyphAtlas(
     i++;
     return &result;
   };
-  auto atlas = text_context->CreateGlyphAtlas(iterator);
+  auto atlas = text_context.CreateGlyphAtlas(iterator);
   if (!atlas || !atlas->IsValid()) {
     VALIDATION_LOG << "Could not create valid atlas.";
     return nullptr;
@@ -5,9 +5,9 @@
 #pragma once
 
 #include "flutter/fml/macros.h"
-#include "impeller/renderer/context.h"
 #include "impeller/typographer/glyph_atlas.h"
 #include "impeller/typographer/text_frame.h"
+#include "impeller/typographer/text_render_context.h"
 
 namespace impeller {
 
@@ -20,7 +20,7 @@ class LazyGlyphAtlas {
   void AddTextFrame(TextFrame frame);
 
   std::shared_ptr<GlyphAtlas> CreateOrGetGlyphAtlas(
-      std::shared_ptr<Context> context) const;
+      TextRenderContext& text_context) const;
 
  private:
   std::vector<TextFrame> frames_;
@@ -0,0 +1,238 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/typographer/rectangle_packer.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "flutter/fml/logging.h"
+
+namespace impeller {
+
+RectanglePacker::RectanglePacker(ISize size) : size_(size) {
+  Reset();
+}
+
+RectanglePacker::~RectanglePacker() = default;
+
+ISize RectanglePacker::GetSize() const {
+  return size_;
+}
+
+void RectanglePacker::Reset() {
+  skyline_.clear();
+  skyline_.push_back({0, 0, size_.width});
+  free_rects_.clear();
+}
+
+void RectanglePacker::Grow(ISize size) {
+  FML_DCHECK(size.width >= size_.width && size.height >= size_.height);
+  if (size.width > size_.width) {
+    auto& last = skyline_.back();
+    if (last.y == 0) {
+      last.width += size.width - size_.width;
+    } else {
+      skyline_.push_back({size_.width, 0, size.width - size_.width});
+    }
+  }
+  // The skyline only tracks the top of the placed rectangles, so everything
+  // below it is free once the height grows.
+  size_ = size;
+}
+
+std::optional<IPoint> RectanglePacker::AddRect(ISize size) {
+  if (size.IsEmpty()) {
+    return IPoint{};
+  }
+  if (size.width > size_.width || size.height > size_.height) {
+    return std::nullopt;
+  }
+  if (auto origin = AddRectToFreeRects(size)) {
+    return origin;
+  }
+  return AddRectToSkyline(size);
+}
+
+void RectanglePacker::RemoveRect(IRect rect) {
+  AddFreeRect(free_rects_, rect);
+}
+
+bool RectanglePacker::CanAddRectAfterRemoving(
+    ISize size,
+    const std::vector<IRect>& rects) const {
+  if (size.IsEmpty()) {
+    return true;
+  }
+  if (size.width > size_.width || size.height > size_.height) {
+    return false;
+  }
+  auto free_rects = free_rects_;
+  for (const auto& rect : rects) {
+    AddFreeRect(free_rects, rect);
+  }
+  for (const auto& free_rect : free_rects) {
+    if (free_rect.size.width >= size.width &&
+        free_rect.size.height >= size.height) {
+      return true;
+    }
+  }
+  for (size_t i = 0; i < skyline_.size(); i++) {
+    if (FitsOnSkyline(i, size).has_value()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void RectanglePacker::AddFreeRect(std::vector<IRect>& free_rects,
+                                  IRect rect) {
+  if (rect.IsEmpty()) {
+    return;
+  }
+  // Merge the rectangle with the free ones it shares a full edge with, so that
+  // the space of neighbouring removed rectangles can hold larger ones.
+  for (size_t i = 0; i < free_rects.size();) {
+    const auto& other = free_rects[i];
+    const bool same_rows = other.origin.y == rect.origin.y &&
+                           other.size.height == rect.size.height;
+    const bool same_columns = other.origin.x == rect.origin.x &&
+                              other.size.width == rect.size.width;
+    if ((same_rows && (other.GetRight() == rect.GetLeft() ||
+                       rect.GetRight() == other.GetLeft())) ||
+        (same_columns && (other.GetBottom() == rect.GetTop() ||
+                          rect.GetBottom() == other.GetTop()))) {
+      rect = rect.Union(other);
+      free_rects[i] = free_rects.back();
+      free_rects.pop_back();
+      // The larger rectangle may now share an edge with earlier ones.
+      i = 0;
+      continue;
+    }
+    i++;
+  }
+  free_rects.push_back(rect);
+}
+
+std::optional<IPoint> RectanglePacker::AddRectToFreeRects(ISize size) {
+  // Pick the free rectangle that leaves the least area unused.
+  auto best = free_rects_.end();
+  auto best_area = std::numeric_limits<int64_t>::max();
+  for (auto it = free_rects_.begin(); it != free_rects_.end(); ++it) {
+    if (it->size.width < size.width || it->size.height < size.height) {
+      continue;
+    }
+    const auto area = it->size.Area();
+    if (area < best_area) {
+      best = it;
+      best_area = area;
+    }
+  }
+  if (best == free_rects_.end()) {
+    return std::nullopt;
+  }
+
+  const IRect free_rect = *best;
+  *best = free_rects_.back();
+  free_rects_.pop_back();
+
+  // Split the rest of the free rectangle in two along the axis that keeps the
+  // larger of the two pieces as large as possible.
+  const auto right_width = free_rect.size.width - size.width;
+  const auto bottom_height = free_rect.size.height - size.height;
+  IRect right;
+  IRect bottom;
+  if (right_width > bottom_height) {
+    right = IRect::MakeXYWH(free_rect.origin.x + size.width, free_rect.origin.y,
+                            right_width, free_rect.size.height);
+    bottom = IRect::MakeXYWH(free_rect.origin.x,
+                             free_rect.origin.y + size.height, size.width,
+                             bottom_height);
+  } else {
+    right = IRect::MakeXYWH(free_rect.origin.x + size.width, free_rect.origin.y,
+                            right_width, size.height);
+    bottom = IRect::MakeXYWH(free_rect.origin.x,
+                             free_rect.origin.y + size.height,
+                             free_rect.size.width, bottom_height);
+  }
+  RemoveRect(right);
+  RemoveRect(bottom);
+
+  return free_rect.origin;
+}
+
+std::optional<int64_t> RectanglePacker::FitsOnSkyline(size_t index,
+                                                      ISize size) const {
+  const auto x = skyline_[index].x;
+  if (x + size.width > size_.width) {
+    return std::nullopt;
+  }
+  int64_t y = skyline_[index].y;
+  for (auto width_left = size.width; width_left > 0; index++) {
+    y = std::max(y, skyline_[index].y);
+    if (y + size.height > size_.height) {
+      return std::nullopt;
+    }
+    width_left -= skyline_[index].width;
+  }
+  return y;
+}
+
+std::optional<IPoint> RectanglePacker::AddRectToSkyline(ISize size) {
+  // Place the rectangle as low as possible, and then on the narrowest node.
+  std::optional<size_t> best_index;
+  auto best_y = std::numeric_limits<int64_t>::max();
+  auto best_width = std::numeric_limits<int64_t>::max();
+  for (size_t i = 0; i < skyline_.size(); i++) {
+    const auto y = FitsOnSkyline(i, size);
+    if (!y.has_value()) {
+      continue;
+    }
+    if (y.value() < best_y ||
+        (y.value() == best_y && skyline_[i].width < best_width)) {
+      best_index = i;
+      best_y = y.value();
+      best_width = skyline_[i].width;
+    }
+  }
+  if (!best_index.has_value()) {
+    return std::nullopt;
+  }
+
+  const auto index = best_index.value();
+  const IPoint origin(skyline_[index].x, best_y);
+  skyline_.insert(skyline_.begin() + index,
+                  {origin.x, origin.y + size.height, size.width});
+
+  // Shrink or remove the nodes the new one now covers.
+  const auto right = origin.x + size.width;
+  for (auto i = index + 1; i < skyline_.size();) {
+    auto& node = skyline_[i];
+    if (node.x >= right) {
+      break;
+    }
+    const auto covered = right - node.x;
+    if (covered >= node.width) {
+      skyline_.erase(skyline_.begin() + i);
+      continue;
+    }
+    node.x += covered;
+    node.width -= covered;
+    break;
+  }
+
+  // Merge neighbouring nodes at the same height.
+  for (size_t i = 0; i + 1 < skyline_.size();) {
+    if (skyline_[i].y == skyline_[i + 1].y) {
+      skyline_[i].width += skyline_[i + 1].width;
+      skyline_.erase(skyline_.begin() + i + 1);
+    } else {
+      i++;
+    }
+  }
+
+  return origin;
+}
+
+}  // namespace impeller
@@ -0,0 +1,89 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "impeller/geometry/point.h"
+#include "impeller/geometry/rect.h"
+#include "impeller/geometry/size.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Packs rectangles into an area that can grow and from which
+///             rectangles can be removed again.
+///
+///             Fresh space is handed out with a bottom-left skyline. Removed
+///             rectangles are kept in a free list, merged with the free
+///             rectangles they share a full edge with, and are reused before
+///             the skyline, with the remainder of a reused rectangle split
+///             off guillotine style.
+///
+class RectanglePacker {
+ public:
+  explicit RectanglePacker(ISize size);
+
+  ~RectanglePacker();
+
+  ISize GetSize() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Find a place for a rectangle of the given size.
+  ///
+  /// @return     The origin of the rectangle, or `std::nullopt` if there is no
+  ///             room left for it.
+  ///
+  std::optional<IPoint> AddRect(ISize size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Make the area of a rectangle previously returned by `AddRect`
+  ///             available again.
+  ///
+  void RemoveRect(IRect rect);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether `AddRect` would find a place for a rectangle of the
+  ///             given size after removing the given rectangles in order.
+  ///
+  bool CanAddRectAfterRemoving(ISize size,
+                               const std::vector<IRect>& rects) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Grow the area to the right and bottom. Rectangles that were
+  ///             already placed keep their positions.
+  ///
+  void Grow(ISize size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forget all rectangles.
+  ///
+  void Reset();
+
+ private:
+  struct SkylineNode {
+    int64_t x = 0;
+    int64_t y = 0;
+    int64_t width = 0;
+  };
+
+  ISize size_;
+  std::vector<SkylineNode> skyline_;
+  std::vector<IRect> free_rects_;
+
+  static void AddFreeRect(std::vector<IRect>& free_rects, IRect rect);
+
+  std::optional<IPoint> AddRectToFreeRects(ISize size);
+
+  std::optional<IPoint> AddRectToSkyline(ISize size);
+
+  std::optional<int64_t> FitsOnSkyline(size_t index, ISize size) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RectanglePacker);
+};
+
+}  // namespace impeller
@@ -33,7 +33,7 @@ const std::shared_ptr<Context>& TextRenderContext::GetContext() const {
 }
 
 std::shared_ptr<GlyphAtlas> TextRenderContext::CreateGlyphAtlas(
-    const TextFrame& frame) const {
+    const TextFrame& frame) {
   size_t count = 0;
   FrameIterator iterator = [&]() -> const TextFrame* {
     count++;
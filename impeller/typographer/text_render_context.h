@@ -38,10 +38,22 @@ class TextRenderContext {
   const std::shared_ptr<Context>& GetContext() const;
 
   using FrameIterator = std::function<const TextFrame*(void)>;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Create a glyph atlas containing the glyphs of the frames.
+  ///
+  ///             Glyphs rendered by earlier calls may be kept and reused, so
+  ///             atlases returned by different calls can share a texture.
+  ///
+  /// @param[in]  iterator  The iterator over the frames. Returns `nullptr`
+  ///                       once all frames have been visited.
+  ///
+  /// @return     The glyph atlas, or `nullptr` if it could not be created.
+  ///
   virtual std::shared_ptr<GlyphAtlas> CreateGlyphAtlas(
-      FrameIterator iterator) const = 0;
+      FrameIterator iterator) = 0;
 
-  std::shared_ptr<GlyphAtlas> CreateGlyphAtlas(const TextFrame& frame) const;
+  std::shared_ptr<GlyphAtlas> CreateGlyphAtlas(const TextFrame& frame);
 
  protected:
   //----------------------------------------------------------------------------
@@ -2,10 +2,13 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <vector>
+
 #include "flutter/testing/testing.h"
 #include "impeller/playground/playground.h"
 #include "impeller/typographer/backends/skia/text_frame_skia.h"
 #include "impeller/typographer/backends/skia/text_render_context_skia.h"
+#include "impeller/typographer/rectangle_packer.h"
 #include "third_party/skia/include/core/SkTextBlob.h"
 
 namespace impeller {
@@ -43,5 +46,123 @@ TEST_P(TypographerTest, CanCreateGlyphAtlas) {
   OpenPlaygroundHere([](RenderTarget&) { return true; });
 }
 
+TEST_P(TypographerTest, GlyphAtlasKeepsRenderedGlyphs) {
+  auto context = TextRenderContext::Create(GetContext());
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font;
+  auto hello = context->CreateGlyphAtlas(
+      TextFrameFromTextBlob(SkTextBlob::MakeFromString("hello", sk_font)));
+  ASSERT_TRUE(hello && hello->IsValid());
+  auto world = context->CreateGlyphAtlas(
+      TextFrameFromTextBlob(SkTextBlob::MakeFromString("world", sk_font)));
+  ASSERT_TRUE(world && world->IsValid());
+
+  // The glyphs both words share keep their place in the atlas.
+  size_t shared_count = 0;
+  hello->IterateGlyphs([&](const FontGlyphPair& pair, const Rect& rect) {
+    auto position = world->FindFontGlyphPosition(pair);
+    if (position.has_value()) {
+      EXPECT_EQ(position.value(), rect);
+      shared_count++;
+    }
+    return true;
+  });
+  ASSERT_EQ(shared_count, 2u);  // "l" and "o"
+}
+
+static void ExpectRectsAreDisjoint(const std::vector<IRect>& rects,
+                                   ISize size) {
+  for (size_t i = 0; i < rects.size(); i++) {
+    ASSERT_TRUE(IRect::MakeSize(size).Contains(rects[i]));
+    for (size_t j = i + 1; j < rects.size(); j++) {
+      ASSERT_FALSE(rects[i].Intersection(rects[j]).has_value());
+    }
+  }
+}
+
+TEST(RectanglePackerTest, PacksDisjointRects) {
+  RectanglePacker packer(ISize(256, 256));
+  std::vector<IRect> rects;
+  for (int64_t i = 0;; i++) {
+    const ISize size(8 + (i * 7) % 23, 8 + (i * 13) % 17);
+    auto origin = packer.AddRect(size);
+    if (!origin.has_value()) {
+      break;
+    }
+    rects.push_back(IRect(origin.value(), size));
+  }
+  ASSERT_GT(rects.size(), 100u);
+  ExpectRectsAreDisjoint(rects, packer.GetSize());
+}
+
+TEST(RectanglePackerTest, ReusesRemovedRects) {
+  RectanglePacker packer(ISize(64, 64));
+  std::vector<IRect> rects;
+  while (auto origin = packer.AddRect(ISize(16, 16))) {
+    rects.push_back(IRect(origin.value(), ISize(16, 16)));
+  }
+  ASSERT_EQ(rects.size(), 16u);
+
+  // A smaller rectangle fits into the space of a removed one, and the rest of
+  // that space can still be used.
+  const auto removed = rects[5];
+  rects.erase(rects.begin() + 5);
+  packer.RemoveRect(removed);
+  auto origin = packer.AddRect(ISize(10, 16));
+  ASSERT_TRUE(origin.has_value());
+  ASSERT_EQ(origin.value(), removed.origin);
+  rects.push_back(IRect(origin.value(), ISize(10, 16)));
+  origin = packer.AddRect(ISize(6, 16));
+  ASSERT_TRUE(origin.has_value());
+  rects.push_back(IRect(origin.value(), ISize(6, 16)));
+  ASSERT_FALSE(packer.AddRect(ISize(1, 1)).has_value());
+  ExpectRectsAreDisjoint(rects, packer.GetSize());
+}
+
+TEST(RectanglePackerTest, KeepsRectsWhenGrowing) {
+  RectanglePacker packer(ISize(64, 64));
+  std::vector<IRect> rects;
+  while (auto origin = packer.AddRect(ISize(20, 12))) {
+    rects.push_back(IRect(origin.value(), ISize(20, 12)));
+  }
+  const auto count = rects.size();
+
+  packer.Grow(ISize(128, 128));
+  while (auto origin = packer.AddRect(ISize(20, 12))) {
+    rects.push_back(IRect(origin.value(), ISize(20, 12)));
+  }
+  ASSERT_GE(rects.size(), count * 4);
+  ExpectRectsAreDisjoint(rects, packer.GetSize());
+}
+
+TEST(RectanglePackerTest, MergesAdjacentRemovedRects) {
+  RectanglePacker packer(ISize(64, 64));
+  std::vector<IRect> rects;
+  while (auto origin = packer.AddRect(ISize(16, 16))) {
+    rects.push_back(IRect(origin.value(), ISize(16, 16)));
+  }
+  ASSERT_EQ(rects.size(), 16u);
+
+  // Removing the four rectangles in the top left corner makes room for one
+  // of their combined size, and only once all four of them are removed.
+  std::vector<IRect> corner;
+  for (const auto& rect : rects) {
+    if (rect.GetRight() <= 32 && rect.GetBottom() <= 32) {
+      corner.push_back(rect);
+    }
+  }
+  ASSERT_EQ(corner.size(), 4u);
+  ASSERT_TRUE(packer.CanAddRectAfterRemoving(ISize(32, 32), corner));
+  ASSERT_FALSE(packer.CanAddRectAfterRemoving(
+      ISize(32, 32), std::vector<IRect>(corner.begin(), corner.end() - 1)));
+  for (const auto& rect : corner) {
+    packer.RemoveRect(rect);
+  }
+  auto origin = packer.AddRect(ISize(32, 32));
+  ASSERT_TRUE(origin.has_value());
+  ASSERT_EQ(origin.value(), IPoint(0, 0));
+  ASSERT_FALSE(packer.AddRect(ISize(1, 1)).has_value());
+}
+
 }  // namespace testing
 }  // namespace impeller
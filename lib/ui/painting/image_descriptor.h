@@ -42,7 +42,8 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
   ///         image, as long as the format is recognized by an encoder installed
   ///         in the `ImageGeneratorRegistry`. Calling this method will create
   ///         an `ImageGenerator` and read EXIF corrected dimensions from the
-  ///         image data.
+  ///         image data. The image data is not copied, so a descriptor for
+  ///         a buffer created from a mapped asset decodes from the mapping.
   /// @see    `ImageGeneratorRegistry`
   static void initEncoded(Dart_NativeArguments args);
 
@@ -85,17 +85,41 @@ void ImmutableBuffer::initFromAsset(Dart_NativeArguments args) {
   }
 
   auto size = data->GetSize();
-  const void* bytes = static_cast<const void*>(data->GetMapping());
-  auto sk_data = MakeSkDataWithCopy(bytes, size);
+  sk_sp<SkData> sk_data = MakeSkDataFromAsset(std::move(data));
   auto buffer = fml::MakeRefCounted<ImmutableBuffer>(sk_data);
   buffer->AssociateWithDartWrapper(immutable_buffer);
   tonic::DartInvoke(callback_handle, {tonic::ToDart(size)});
 }
 
+sk_sp<SkData> ImmutableBuffer::MakeSkDataFromAsset(
+    std::unique_ptr<fml::Mapping> mapping) {
+  if (mapping->IsSharedFileBacked()) {
+    // The asset is mapped in from a file, so it is used in place. It is about
+    // to be read by whatever the buffer was created for, typically an image
+    // decoder, so its pages are read in ahead of time.
+    mapping->Advise(fml::Mapping::Advice::kWillNeed);
+    return MakeSkDataWithMapping(std::move(mapping));
+  }
+  return MakeSkDataWithCopy(mapping->GetMapping(), mapping->GetSize());
+}
+
 size_t ImmutableBuffer::GetAllocationSize() const {
   return sizeof(ImmutableBuffer) + data_->size();
 }
 
+sk_sp<SkData> ImmutableBuffer::MakeSkDataWithMapping(
+    std::unique_ptr<fml::Mapping> mapping) {
+  if (mapping->GetSize() == 0) {
+    return SkData::MakeEmpty();
+  }
+  fml::Mapping* raw_mapping = mapping.release();
+  SkData::ReleaseProc proc = [](const void* ptr, void* context) {
+    delete reinterpret_cast<fml::Mapping*>(context);
+  };
+  return SkData::MakeWithProc(raw_mapping->GetMapping(),
+                              raw_mapping->GetSize(), proc, raw_mapping);
+}
+
 #if FML_OS_ANDROID
 
 // Compressed image buffers are allocated on the UI thread but are deleted on a
@@ -105,6 +129,7 @@ size_t ImmutableBuffer::GetAllocationSize() const {
 // backed by an anonymous mapping.
 sk_sp<SkData> ImmutableBuffer::MakeSkDataWithCopy(const void* data,
                                                   size_t length) {
+  fml::Mapping::RecordCopiedBytes(length);
   if (length == 0) {
     return SkData::MakeEmpty();
   }
@@ -136,6 +161,7 @@ sk_sp<SkData> ImmutableBuffer::MakeSkDataWithCopy(const void* data,
 
 sk_sp<SkData> ImmutableBuffer::MakeSkDataWithCopy(const void* data,
                                                   size_t length) {
+  fml::Mapping::RecordCopiedBytes(length);
   return SkData::MakeWithCopy(data, length);
 }
 
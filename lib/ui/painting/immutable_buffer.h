@@ -6,8 +6,10 @@
 #define FLUTTER_LIB_UI_PAINTNIG_IMMUTABLE_BUFER_H_
 
 #include <cstdint>
+#include <memory>
 
 #include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/tonic/dart_library_natives.h"
@@ -50,6 +52,9 @@ class ImmutableBuffer : public RefCountedDartWrappable<ImmutableBuffer> {
   ///
   /// The second indexed argument is expected to be a void callback to signal
   /// when the copy has completed.
+  ///
+  /// Assets that are mapped in from a file are not copied; the buffer, and
+  /// any ImageDescriptor created from it, refers to the mapping directly.
   static void initFromAsset(Dart_NativeArguments args);
 
   /// The length of the data in bytes.
@@ -73,6 +78,13 @@ class ImmutableBuffer : public RefCountedDartWrappable<ImmutableBuffer> {
 
   size_t GetAllocationSize() const override;
 
+  /// Makes the data of a buffer for an asset. Assets that are
+  /// |fml::Mapping::IsSharedFileBacked| are used in place, and the returned
+  /// data takes ownership of their mapping. Other assets are copied, as their
+  /// mapping may refer to memory owned by the asset resolver.
+  static sk_sp<SkData> MakeSkDataFromAsset(
+      std::unique_ptr<fml::Mapping> mapping);
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
@@ -82,6 +94,11 @@ class ImmutableBuffer : public RefCountedDartWrappable<ImmutableBuffer> {
 
   static sk_sp<SkData> MakeSkDataWithCopy(const void* data, size_t length);
 
+  // Wraps the |mapping| without copying it. The mapping is destroyed along
+  // with the data.
+  static sk_sp<SkData> MakeSkDataWithMapping(
+      std::unique_ptr<fml::Mapping> mapping);
+
   DEFINE_WRAPPERTYPEINFO();
   FML_FRIEND_MAKE_REF_COUNTED(ImmutableBuffer);
   FML_DISALLOW_COPY_AND_ASSIGN(ImmutableBuffer);
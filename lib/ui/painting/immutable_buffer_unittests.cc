@@ -0,0 +1,44 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/immutable_buffer.h"
+
+#include <vector>
+
+#include "flutter/fml/mapping.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(ImmutableBufferTest, FileBackedAssetIsUsedInPlace) {
+  auto mapping = OpenFixtureAsMapping("DashInNooglerHat.jpg");
+  ASSERT_TRUE(mapping);
+  ASSERT_TRUE(mapping->IsSharedFileBacked());
+  const uint8_t* mapped = mapping->GetMapping();
+  const size_t size = mapping->GetSize();
+
+  const size_t copied_bytes = fml::Mapping::GetCopiedBytes();
+  sk_sp<SkData> data = ImmutableBuffer::MakeSkDataFromAsset(std::move(mapping));
+  ASSERT_EQ(data->size(), size);
+  ASSERT_EQ(data->bytes(), mapped);
+  ASSERT_EQ(fml::Mapping::GetCopiedBytes(), copied_bytes);
+}
+
+TEST(ImmutableBufferTest, AssetInMemoryIsCopied) {
+  auto mapping = std::make_unique<fml::DataMapping>(
+      std::vector<uint8_t>{1, 2, 3, 4, 5, 6, 7, 8});
+  ASSERT_FALSE(mapping->IsSharedFileBacked());
+  const uint8_t* bytes = mapping->GetMapping();
+
+  const size_t copied_bytes = fml::Mapping::GetCopiedBytes();
+  sk_sp<SkData> data = ImmutableBuffer::MakeSkDataFromAsset(std::move(mapping));
+  ASSERT_EQ(data->size(), 8u);
+  ASSERT_NE(data->bytes(), bytes);
+  ASSERT_EQ(data->bytes()[7], 8u);
+  ASSERT_EQ(fml::Mapping::GetCopiedBytes(), copied_bytes + 8u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -40,7 +40,13 @@ PictureRecorder::PictureRecorder() {}
 PictureRecorder::~PictureRecorder() {}
 
 SkCanvas* PictureRecorder::BeginRecording(SkRect bounds) {
-  display_list_recorder_ = sk_make_sp<DisplayListCanvasRecorder>(bounds);
+  // Pictures are frequently larger than the area that is visible in a
+  // frame (scrolling content, partial repaint), so we record an R-Tree
+  // that lets their rendering skip the ops outside of the clip. Small
+  // pictures are cheaper to render in full than to build an R-Tree for.
+  display_list_recorder_ =
+      sk_make_sp<DisplayListCanvasRecorder>(bounds, /*prepare_rtree=*/true);
+  display_list_recorder_->builder()->set_rtree_min_op_count(kRTreeMinOpCount);
   return display_list_recorder_.get();
 }
 
@@ -22,6 +22,9 @@ class PictureRecorder : public RefCountedDartWrappable<PictureRecorder> {
   FML_FRIEND_MAKE_REF_COUNTED(PictureRecorder);
 
  public:
+  // Pictures with fewer ops than this are recorded without an R-Tree.
+  static constexpr int kRTreeMinOpCount = 32;
+
   static fml::RefPtr<PictureRecorder> Create();
 
   ~PictureRecorder() override;
@@ -4,7 +4,9 @@
 
 #include "flutter/lib/ui/text/asset_manager_font_provider.h"
 
+#include "flutter/common/startup_profile.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/mapping.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkStream.h"
 #include "third_party/skia/include/core/SkString.h"
@@ -107,6 +109,12 @@ SkTypeface* AssetManagerFontStyleSet::createTypeface(int i) {
     if (asset_mapping == nullptr) {
       return nullptr;
     }
+    StartupProfile::Record(StartupProfile::Kind::kFont, asset.asset);
+    // Fonts that are not mapped in from a file were read into memory by the
+    // asset resolver.
+    if (!asset_mapping->IsSharedFileBacked()) {
+      fml::Mapping::RecordCopiedBytes(asset_mapping->GetSize());
+    }
 
     fml::Mapping* asset_mapping_ptr = asset_mapping.release();
     sk_sp<SkData> asset_data = SkData::MakeWithProc(
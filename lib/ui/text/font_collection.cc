@@ -6,6 +6,7 @@
 
 #include <mutex>
 
+#include "flutter/fml/mapping.h"
 #include "flutter/lib/ui/text/asset_manager_font_provider.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/platform_configuration.h"
@@ -160,6 +161,7 @@ void FontCollection::RegisterTestFonts() {
 void FontCollection::LoadFontFromList(const uint8_t* font_data,
                                       int length,
                                       std::string family_name) {
+  fml::Mapping::RecordCopiedBytes(length);
   std::unique_ptr<SkStreamAsset> font_stream =
       std::make_unique<SkMemoryStream>(font_data, length, true);
   sk_sp<SkTypeface> typeface =
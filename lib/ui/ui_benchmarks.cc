@@ -6,6 +6,8 @@
 #include "flutter/common/settings.h"
 #include "flutter/lib/ui/volatile_path_tracker.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
+#include "flutter/lib/ui/window/pointer_data_packet_converter.h"
+#include "flutter/lib/ui/window/pointer_data_resampler.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/dart_isolate_runner.h"
@@ -112,9 +114,100 @@ static void BM_PathVolatilityTracker(benchmark::State& state) {
   }
 }
 
+// A stylus and touches that report at 1 kHz, and the events they report in a
+// frame of 16 ms.
+constexpr int kPointerSamplesPerFrame = 16;
+constexpr int64_t kPointerSampleInterval = 1000;
+
+static PointerData CreatePointerSample(PointerData::Change change,
+                                       PointerData::DeviceKind kind,
+                                       int64_t device,
+                                       int64_t time_stamp) {
+  PointerData data;
+  data.Clear();
+  data.time_stamp = time_stamp;
+  data.change = change;
+  data.kind = kind;
+  data.device = device;
+  data.physical_x = 100 + device * 50 + time_stamp / 1000.0;
+  data.physical_y = 100 + time_stamp / 2000.0;
+  data.buttons = change == PointerData::Change::kUp ? 0 : 1;
+  return data;
+}
+
+// Platforms deliver a packet per sample, with an event for each pointer.
+static std::unique_ptr<PointerDataPacket> CreatePointerSamplePacket(
+    PointerData::Change change,
+    int pointer_count,
+    int64_t time_stamp) {
+  auto packet = std::make_unique<PointerDataPacket>(pointer_count);
+  for (int i = 0; i < pointer_count; i++) {
+    packet->SetPointerData(
+        i, CreatePointerSample(change,
+                               i == 0 ? PointerData::DeviceKind::kStylus
+                                      : PointerData::DeviceKind::kTouch,
+                               i, time_stamp));
+  }
+  return packet;
+}
+
+static void BM_PointerDataPacketConverter(benchmark::State& state) {
+  const int pointer_count = state.range(0);
+  PointerDataPacketConverter converter;
+  converter.Convert(
+      CreatePointerSamplePacket(PointerData::Change::kDown, pointer_count, 0));
+  int64_t time_stamp = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    for (int i = 0; i < kPointerSamplesPerFrame; i++) {
+      time_stamp += kPointerSampleInterval;
+      auto converted = converter.Convert(CreatePointerSamplePacket(
+          PointerData::Change::kMove, pointer_count, time_stamp));
+      benchmark::DoNotOptimize(converted);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kPointerSamplesPerFrame *
+                          pointer_count);
+}
+
+static void BM_PointerDataResampler(benchmark::State& state) {
+  const int pointer_count = state.range(0);
+  PointerDataPacketConverter converter;
+  PointerDataResampler resampler;
+  resampler.AddPacket(*converter.Convert(
+      CreatePointerSamplePacket(PointerData::Change::kDown, pointer_count, 0)));
+  int64_t time_stamp = 0;
+  size_t dispatched_count = 0;
+  for ([[maybe_unused]] auto _ : state) {
+    for (int i = 0; i < kPointerSamplesPerFrame; i++) {
+      time_stamp += kPointerSampleInterval;
+      resampler.AddPacket(*converter.Convert(CreatePointerSamplePacket(
+          PointerData::Change::kMove, pointer_count, time_stamp)));
+    }
+    // Sampled half a sample before the latest sample, as a display that is
+    // out of phase with the panel would.
+    auto resampled =
+        resampler.Resample(time_stamp - kPointerSampleInterval / 2);
+    dispatched_count += resampled->data().size() / sizeof(PointerData);
+  }
+  state.SetItemsProcessed(state.iterations() * kPointerSamplesPerFrame *
+                          pointer_count);
+  state.counters["dispatched_per_frame"] =
+      static_cast<double>(dispatched_count) / state.iterations();
+}
+
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(BM_PathVolatilityTracker)->Unit(benchmark::kMillisecond);
 
+BENCHMARK(BM_PointerDataPacketConverter)
+    ->Arg(1)
+    ->Arg(5)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_PointerDataResampler)
+    ->Arg(1)
+    ->Arg(5)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
@@ -162,6 +162,33 @@ Dart_Handle ToByteData(const fml::Mapping& buffer) {
   return tonic::DartByteData::Create(buffer.GetMapping(), buffer.GetSize());
 }
 
+// Messages at least this large are handed to Dart in place rather than
+// copied into the Dart heap, like |tonic::DartByteData::Create| does.
+constexpr size_t kExternalMessageSizeThreshold = 1000;
+
+void FinalizeMapping(void* isolate_callback_data, void* peer) {
+  delete reinterpret_cast<fml::Mapping*>(peer);
+}
+
+// Gives Dart the ownership of |buffer|, so that Dart can read it in place.
+Dart_Handle ToByteData(std::unique_ptr<fml::Mapping> buffer) {
+  const size_t size = buffer->GetSize();
+  if (size < kExternalMessageSizeThreshold) {
+    return ToByteData(*buffer);
+  }
+  // Dart only gets a writable view of external data, but neither the malloc
+  // buffers of messages nor the buffers that embedders hand over are read
+  // again once they are sent.
+  void* bytes = const_cast<uint8_t*>(buffer->GetMapping());
+  fml::Mapping* peer = buffer.release();
+  Dart_Handle byte_data = Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kByteData, bytes, size, peer, size, FinalizeMapping);
+  if (Dart_IsError(byte_data)) {
+    delete peer;
+  }
+  return byte_data;
+}
+
 }  // namespace
 
 PlatformConfigurationClient::~PlatformConfigurationClient() {}
@@ -286,8 +313,9 @@ void PlatformConfiguration::DispatchPlatformMessage(
     return;
   }
   tonic::DartState::Scope scope(dart_state);
-  Dart_Handle data_handle =
-      (message->hasData()) ? ToByteData(message->data()) : Dart_Null();
+  Dart_Handle data_handle = (message->hasData())
+                                ? ToByteData(message->releaseMapping())
+                                : Dart_Null();
   if (Dart_IsError(data_handle)) {
     FML_DLOG(WARNING)
         << "Dropping platform message because of a Dart error on channel: "
@@ -5,9 +5,11 @@
 #ifndef FLUTTER_LIB_UI_PLATFORM_PLATFORM_MESSAGE_H_
 #define FLUTTER_LIB_UI_PLATFORM_PLATFORM_MESSAGE_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "flutter/fml/mapping.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/memory/ref_ptr.h"
 #include "flutter/lib/ui/window/platform_message_response.h"
@@ -19,23 +21,39 @@ class PlatformMessage {
   PlatformMessage(std::string channel,
                   fml::MallocMapping data,
                   fml::RefPtr<PlatformMessageResponse> response);
+  // Wraps a buffer that the sender keeps alive until |data| is destroyed.
+  // The buffer is handed to Dart in place, so large messages are not copied
+  // on their way to the framework.
+  PlatformMessage(std::string channel,
+                  std::unique_ptr<fml::Mapping> data,
+                  fml::RefPtr<PlatformMessageResponse> response);
   PlatformMessage(std::string channel,
                   fml::RefPtr<PlatformMessageResponse> response);
   ~PlatformMessage();
 
   const std::string& channel() const { return channel_; }
-  const fml::MallocMapping& data() const { return data_; }
+  const fml::Mapping& data() const {
+    if (external_data_) {
+      return *external_data_;
+    }
+    return data_;
+  }
   bool hasData() { return hasData_; }
 
   const fml::RefPtr<PlatformMessageResponse>& response() const {
     return response_;
   }
 
-  fml::MallocMapping releaseData() { return std::move(data_); }
+  // Copies the data if it is in a buffer that the sender owns.
+  fml::MallocMapping releaseData();
+
+  // Takes the data, without copying it.
+  std::unique_ptr<fml::Mapping> releaseMapping();
 
  private:
   std::string channel_;
   fml::MallocMapping data_;
+  std::unique_ptr<fml::Mapping> external_data_;
   bool hasData_;
   fml::RefPtr<PlatformMessageResponse> response_;
 };
@@ -18,28 +18,25 @@ PointerDataPacketConverter::~PointerDataPacketConverter() = default;
 std::unique_ptr<PointerDataPacket> PointerDataPacketConverter::Convert(
     std::unique_ptr<PointerDataPacket> packet) {
   size_t kBytesPerPointerData = kPointerDataFieldCount * kBytesPerField;
-  auto buffer = packet->data();
-  size_t buffer_length = buffer.size();
+  const std::vector<uint8_t>& buffer = packet->data();
+  const size_t count = buffer.size() / kBytesPerPointerData;
 
-  std::vector<PointerData> converted_pointers;
   // Converts each pointer data in the buffer and stores it in the
-  // converted_pointers.
-  for (size_t i = 0; i < buffer_length / kBytesPerPointerData; i++) {
+  // converted_pointers_, which keeps its capacity from one packet to the
+  // next.
+  converted_pointers_.clear();
+  converted_pointers_.reserve(count);
+  for (size_t i = 0; i < count; i++) {
     PointerData pointer_data;
     memcpy(&pointer_data, &buffer[i * kBytesPerPointerData],
            sizeof(PointerData));
-    ConvertPointerData(pointer_data, converted_pointers);
+    ConvertPointerData(pointer_data, converted_pointers_);
   }
 
-  // Writes converted_pointers into converted_packet.
-  auto converted_packet =
-      std::make_unique<flutter::PointerDataPacket>(converted_pointers.size());
-  size_t count = 0;
-  for (auto& converted_pointer : converted_pointers) {
-    converted_packet->SetPointerData(count++, converted_pointer);
-  }
-
-  return converted_packet;
+  // Writes converted_pointers_ into converted_packet in one copy.
+  return std::make_unique<flutter::PointerDataPacket>(
+      reinterpret_cast<uint8_t*>(converted_pointers_.data()),
+      converted_pointers_.size() * sizeof(PointerData));
 }
 
 void PointerDataPacketConverter::ConvertPointerData(
@@ -52,9 +49,9 @@ void PointerDataPacketConverter::ConvertPointerData(
         // to a non-existing pointer. Drops the cancel if pointer
         // is not previously added.
         // https://github.com/flutter/flutter/issues/20517
-        auto iter = states_.find(pointer_data.device);
-        if (iter != states_.end()) {
-          PointerState state = iter->second;
+        PointerState* found = FindPointerState(pointer_data.device);
+        if (found != nullptr) {
+          PointerState state = *found;
           FML_DCHECK(state.is_down);
           UpdatePointerIdentifier(pointer_data, state, false);
 
@@ -69,22 +66,22 @@ void PointerDataPacketConverter::ConvertPointerData(
           }
 
           state.is_down = false;
-          states_[pointer_data.device] = state;
+          SetPointerState(pointer_data.device, state);
           converted_pointers.push_back(pointer_data);
         }
         break;
       }
       case PointerData::Change::kAdd: {
-        FML_DCHECK(states_.find(pointer_data.device) == states_.end());
+        FML_DCHECK(FindPointerState(pointer_data.device) == nullptr);
         EnsurePointerState(pointer_data);
         converted_pointers.push_back(pointer_data);
         break;
       }
       case PointerData::Change::kRemove: {
         // Makes sure we have an existing pointer
-        auto iter = states_.find(pointer_data.device);
-        FML_DCHECK(iter != states_.end());
-        PointerState state = iter->second;
+        PointerState* found = FindPointerState(pointer_data.device);
+        FML_DCHECK(found != nullptr);
+        PointerState state = *found;
 
         if (state.is_down) {
           // Synthesizes cancel event if the pointer is down.
@@ -94,7 +91,7 @@ void PointerDataPacketConverter::ConvertPointerData(
           UpdatePointerIdentifier(synthesized_cancel_event, state, false);
 
           state.is_down = false;
-          states_[synthesized_cancel_event.device] = state;
+          SetPointerState(synthesized_cancel_event.device, state);
           converted_pointers.push_back(synthesized_cancel_event);
         }
 
@@ -108,14 +105,14 @@ void PointerDataPacketConverter::ConvertPointerData(
           converted_pointers.push_back(synthesized_hover_event);
         }
 
-        states_.erase(pointer_data.device);
+        ErasePointerState(pointer_data.device);
         converted_pointers.push_back(pointer_data);
         break;
       }
       case PointerData::Change::kHover: {
-        auto iter = states_.find(pointer_data.device);
+        PointerState* found = FindPointerState(pointer_data.device);
         PointerState state;
-        if (iter == states_.end()) {
+        if (found == nullptr) {
           // Synthesizes add event if the pointer is not previously added.
           PointerData synthesized_add_event = pointer_data;
           synthesized_add_event.change = PointerData::Change::kAdd;
@@ -124,7 +121,7 @@ void PointerDataPacketConverter::ConvertPointerData(
           state = EnsurePointerState(synthesized_add_event);
           converted_pointers.push_back(synthesized_add_event);
         } else {
-          state = iter->second;
+          state = *found;
         }
 
         FML_DCHECK(!state.is_down);
@@ -136,9 +133,9 @@ void PointerDataPacketConverter::ConvertPointerData(
         break;
       }
       case PointerData::Change::kDown: {
-        auto iter = states_.find(pointer_data.device);
+        PointerState* found = FindPointerState(pointer_data.device);
         PointerState state;
-        if (iter == states_.end()) {
+        if (found == nullptr) {
           // Synthesizes a add event if the pointer is not previously added.
           PointerData synthesized_add_event = pointer_data;
           synthesized_add_event.change = PointerData::Change::kAdd;
@@ -147,7 +144,7 @@ void PointerDataPacketConverter::ConvertPointerData(
           state = EnsurePointerState(synthesized_add_event);
           converted_pointers.push_back(synthesized_add_event);
         } else {
-          state = iter->second;
+          state = *found;
         }
 
         FML_DCHECK(!state.is_down);
@@ -165,15 +162,15 @@ void PointerDataPacketConverter::ConvertPointerData(
         UpdatePointerIdentifier(pointer_data, state, true);
         state.is_down = true;
         state.buttons = pointer_data.buttons;
-        states_[pointer_data.device] = state;
+        SetPointerState(pointer_data.device, state);
         converted_pointers.push_back(pointer_data);
         break;
       }
       case PointerData::Change::kMove: {
         // Makes sure we have an existing pointer in down state
-        auto iter = states_.find(pointer_data.device);
-        FML_DCHECK(iter != states_.end());
-        PointerState state = iter->second;
+        PointerState* found = FindPointerState(pointer_data.device);
+        FML_DCHECK(found != nullptr);
+        PointerState state = *found;
         FML_DCHECK(state.is_down);
 
         UpdatePointerIdentifier(pointer_data, state, false);
@@ -184,9 +181,9 @@ void PointerDataPacketConverter::ConvertPointerData(
       }
       case PointerData::Change::kUp: {
         // Makes sure we have an existing pointer in down state
-        auto iter = states_.find(pointer_data.device);
-        FML_DCHECK(iter != states_.end());
-        PointerState state = iter->second;
+        PointerState* found = FindPointerState(pointer_data.device);
+        FML_DCHECK(found != nullptr);
+        PointerState state = *found;
         FML_DCHECK(state.is_down);
 
         UpdatePointerIdentifier(pointer_data, state, false);
@@ -204,15 +201,15 @@ void PointerDataPacketConverter::ConvertPointerData(
 
         state.is_down = false;
         state.buttons = pointer_data.buttons;
-        states_[pointer_data.device] = state;
+        SetPointerState(pointer_data.device, state);
         converted_pointers.push_back(pointer_data);
         break;
       }
       case PointerData::Change::kPanZoomStart: {
         // Makes sure we have an existing pointer
-        auto iter = states_.find(pointer_data.device);
+        PointerState* found = FindPointerState(pointer_data.device);
         PointerState state;
-        if (iter == states_.end()) {
+        if (found == nullptr) {
           // Synthesizes add event if the pointer is not previously added.
           PointerData synthesized_add_event = pointer_data;
           synthesized_add_event.change = PointerData::Change::kAdd;
@@ -221,7 +218,7 @@ void PointerDataPacketConverter::ConvertPointerData(
           state = EnsurePointerState(synthesized_add_event);
           converted_pointers.push_back(synthesized_add_event);
         } else {
-          state = iter->second;
+          state = *found;
         }
         FML_DCHECK(!state.is_down);
         FML_DCHECK(!state.is_pan_zoom_active);
@@ -242,15 +239,15 @@ void PointerDataPacketConverter::ConvertPointerData(
         state.pan_y = 0;
         state.scale = 1;
         state.rotation = 0;
-        states_[pointer_data.device] = state;
+        SetPointerState(pointer_data.device, state);
         converted_pointers.push_back(pointer_data);
         break;
       }
       case PointerData::Change::kPanZoomUpdate: {
         // Makes sure we have an existing pointer in pan_zoom_active state
-        auto iter = states_.find(pointer_data.device);
-        FML_DCHECK(iter != states_.end());
-        PointerState state = iter->second;
+        PointerState* found = FindPointerState(pointer_data.device);
+        FML_DCHECK(found != nullptr);
+        PointerState state = *found;
         FML_DCHECK(!state.is_down);
         FML_DCHECK(state.is_pan_zoom_active);
 
@@ -262,9 +259,9 @@ void PointerDataPacketConverter::ConvertPointerData(
       }
       case PointerData::Change::kPanZoomEnd: {
         // Makes sure we have an existing pointer in pan_zoom_active state
-        auto iter = states_.find(pointer_data.device);
-        FML_DCHECK(iter != states_.end());
-        PointerState state = iter->second;
+        PointerState* found = FindPointerState(pointer_data.device);
+        FML_DCHECK(found != nullptr);
+        PointerState state = *found;
         FML_DCHECK(state.is_pan_zoom_active);
 
         UpdatePointerIdentifier(pointer_data, state, false);
@@ -286,7 +283,7 @@ void PointerDataPacketConverter::ConvertPointerData(
         }
 
         state.is_pan_zoom_active = false;
-        states_[pointer_data.device] = state;
+        SetPointerState(pointer_data.device, state);
         converted_pointers.push_back(pointer_data);
         break;
       }
@@ -299,10 +296,10 @@ void PointerDataPacketConverter::ConvertPointerData(
     switch (pointer_data.signal_kind) {
       case PointerData::SignalKind::kScroll: {
         // Makes sure we have an existing pointer
-        auto iter = states_.find(pointer_data.device);
+        PointerState* found = FindPointerState(pointer_data.device);
         PointerState state;
 
-        if (iter == states_.end()) {
+        if (found == nullptr) {
           // Synthesizes a add event if the pointer is not previously added.
           PointerData synthesized_add_event = pointer_data;
           synthesized_add_event.signal_kind = PointerData::SignalKind::kNone;
@@ -312,7 +309,7 @@ void PointerDataPacketConverter::ConvertPointerData(
           state = EnsurePointerState(synthesized_add_event);
           converted_pointers.push_back(synthesized_add_event);
         } else {
-          state = iter->second;
+          state = *found;
         }
 
         if (LocationNeedsUpdate(pointer_data, state)) {
@@ -351,6 +348,35 @@ void PointerDataPacketConverter::ConvertPointerData(
   }
 }
 
+PointerState* PointerDataPacketConverter::FindPointerState(int64_t device) {
+  for (auto& [state_device, state] : states_) {
+    if (state_device == device) {
+      return &state;
+    }
+  }
+  return nullptr;
+}
+
+void PointerDataPacketConverter::SetPointerState(int64_t device,
+                                                 const PointerState& state) {
+  PointerState* found = FindPointerState(device);
+  if (found != nullptr) {
+    *found = state;
+  } else {
+    states_.emplace_back(device, state);
+  }
+}
+
+void PointerDataPacketConverter::ErasePointerState(int64_t device) {
+  for (auto it = states_.begin(); it != states_.end(); ++it) {
+    if (it->first == device) {
+      *it = states_.back();
+      states_.pop_back();
+      return;
+    }
+  }
+}
+
 PointerState PointerDataPacketConverter::EnsurePointerState(
     PointerData pointer_data) {
   PointerState state;
@@ -361,7 +387,7 @@ PointerState PointerDataPacketConverter::EnsurePointerState(
   state.physical_y = pointer_data.physical_y;
   state.pan_x = 0;
   state.pan_y = 0;
-  states_[pointer_data.device] = state;
+  SetPointerState(pointer_data.device, state);
   return state;
 }
 
@@ -377,7 +403,7 @@ void PointerDataPacketConverter::UpdateDeltaAndState(PointerData& pointer_data,
   state.pan_y = pointer_data.pan_y;
   state.scale = pointer_data.scale;
   state.rotation = pointer_data.rotation;
-  states_[pointer_data.device] = state;
+  SetPointerState(pointer_data.device, state);
 }
 
 bool PointerDataPacketConverter::LocationNeedsUpdate(
@@ -393,7 +419,7 @@ void PointerDataPacketConverter::UpdatePointerIdentifier(
     bool start_new_pointer) {
   if (start_new_pointer) {
     state.pointer_identifier = ++pointer_;
-    states_[pointer_data.device] = state;
+    SetPointerState(pointer_data.device, state);
   }
   pointer_data.pointer_identifier = state.pointer_identifier;
 }
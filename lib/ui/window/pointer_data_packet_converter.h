@@ -6,8 +6,8 @@
 #define FLUTTER_LIB_UI_WINDOW_POINTER_DATA_PACKET_CONVERTER_H_
 
 #include <cstring>
-#include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "flutter/fml/macros.h"
@@ -97,10 +97,22 @@ class PointerDataPacketConverter {
       std::unique_ptr<PointerDataPacket> packet);
 
  private:
-  std::map<int64_t, PointerState> states_;
+  // The state of each added device. Only a handful of devices are added at
+  // any time, so scanning a flat array beats looking them up in a tree.
+  std::vector<std::pair<int64_t, PointerState>> states_;
 
   int64_t pointer_;
 
+  // Reused by every |Convert|, so that converting stops allocating once it
+  // has grown to fit the largest packet.
+  std::vector<PointerData> converted_pointers_;
+
+  PointerState* FindPointerState(int64_t device);
+
+  void SetPointerState(int64_t device, const PointerState& state);
+
+  void ErasePointerState(int64_t device);
+
   void ConvertPointerData(PointerData pointer_data,
                           std::vector<PointerData>& converted_pointers);
 
@@ -0,0 +1,224 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/window/pointer_data_resampler.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+namespace {
+
+// Samples closer together than this give too noisy a velocity to predict
+// from, in microseconds.
+constexpr int64_t kMinPredictionSpan = 2000;
+
+// Samples older than this are not used to predict from, as the pointer may
+// have been resting in between, in microseconds.
+constexpr int64_t kMaxSampleAge = 20000;
+
+bool IsMove(const PointerData& pointer_data) {
+  return pointer_data.signal_kind == PointerData::SignalKind::kNone &&
+         pointer_data.change == PointerData::Change::kMove;
+}
+
+}  // namespace
+
+PointerDataResampler::PointerDataResampler(fml::TimeDelta max_prediction)
+    : max_prediction_(std::max<int64_t>(max_prediction.ToMicroseconds(), 0)) {}
+
+PointerDataResampler::~PointerDataResampler() = default;
+
+void PointerDataResampler::AddPacket(const PointerDataPacket& packet) {
+  const std::vector<uint8_t>& data = packet.data();
+  const size_t count = data.size() / sizeof(PointerData);
+  const size_t start = queued_.size();
+  queued_.resize(start + count);
+  memcpy(queued_.data() + start, data.data(), count * sizeof(PointerData));
+}
+
+bool PointerDataResampler::HasPendingEvents() const {
+  if (!queued_.empty()) {
+    return true;
+  }
+  for (const PointerSamples& pointer : pointers_) {
+    if (pointer.has_pending_move) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::unique_ptr<PointerDataPacket> PointerDataResampler::Resample(
+    int64_t sample_time) {
+  output_.clear();
+  for (const PointerData& event : queued_) {
+    PointerSamples& pointer = GetPointer(event.device);
+    if (IsMove(event)) {
+      AddSample(pointer, event);
+      pointer.pending_move = event;
+      pointer.has_pending_move = true;
+    } else {
+      Emit(pointer, event);
+    }
+  }
+  queued_.clear();
+
+  for (PointerSamples& pointer : pointers_) {
+    if (pointer.has_pending_move) {
+      EmitResampledMove(pointer, sample_time);
+    }
+  }
+  pointers_.erase(std::remove_if(pointers_.begin(), pointers_.end(),
+                                 [](const PointerSamples& pointer) {
+                                   return pointer.is_removed;
+                                 }),
+                  pointers_.end());
+
+  return std::make_unique<PointerDataPacket>(
+      reinterpret_cast<uint8_t*>(output_.data()),
+      output_.size() * sizeof(PointerData));
+}
+
+PointerDataResampler::PointerSamples& PointerDataResampler::GetPointer(
+    int64_t device) {
+  for (PointerSamples& pointer : pointers_) {
+    if (pointer.device == device) {
+      return pointer;
+    }
+  }
+  pointers_.emplace_back();
+  pointers_.back().device = device;
+  return pointers_.back();
+}
+
+void PointerDataResampler::AddSample(PointerSamples& pointer,
+                                     const PointerData& move) {
+  if (pointer.sample_count == kMaxSamples) {
+    std::move(pointer.samples + 1, pointer.samples + kMaxSamples,
+              pointer.samples);
+    pointer.sample_count--;
+  }
+  pointer.samples[pointer.sample_count++] = {
+      .time = move.time_stamp,
+      .x = move.physical_x,
+      .y = move.physical_y,
+  };
+}
+
+void PointerDataResampler::Emit(PointerSamples& pointer, PointerData event) {
+  if (pointer.has_pending_move) {
+    pointer.has_pending_move = false;
+    PointerData move = pointer.pending_move;
+    SetDispatched(pointer, move);
+    output_.push_back(move);
+  }
+
+  if (event.signal_kind == PointerData::SignalKind::kNone) {
+    switch (event.change) {
+      case PointerData::Change::kAdd:
+        pointer.is_removed = false;
+        break;
+      case PointerData::Change::kRemove:
+        pointer.is_removed = true;
+        pointer.is_down = false;
+        pointer.sample_count = 0;
+        break;
+      case PointerData::Change::kDown:
+        pointer.is_down = true;
+        pointer.buttons = event.buttons;
+        pointer.sample_count = 0;
+        AddSample(pointer, event);
+        break;
+      case PointerData::Change::kUp:
+      case PointerData::Change::kCancel:
+        if (pointer.is_down && (event.physical_x != pointer.dispatched_x ||
+                                event.physical_y != pointer.dispatched_y)) {
+          // A predicted move went elsewhere than the pointer went up.
+          PointerData synthesized_move_event = event;
+          synthesized_move_event.change = PointerData::Change::kMove;
+          synthesized_move_event.buttons = pointer.buttons;
+          synthesized_move_event.synthesized = 1;
+          SetDispatched(pointer, synthesized_move_event);
+          output_.push_back(synthesized_move_event);
+        }
+        pointer.is_down = false;
+        pointer.sample_count = 0;
+        break;
+      default:
+        break;
+    }
+  }
+
+  SetDispatched(pointer, event);
+  output_.push_back(event);
+}
+
+bool PointerDataResampler::EmitResampledMove(PointerSamples& pointer,
+                                             int64_t sample_time) {
+  FML_DCHECK(pointer.has_pending_move && pointer.sample_count > 0);
+  const Sample* samples = pointer.samples;
+  const Sample& latest = samples[pointer.sample_count - 1];
+  PointerData move = pointer.pending_move;
+
+  if (sample_time < latest.time) {
+    // Interpolates between the samples around the sample time. The latest
+    // sample stays pending for a later frame.
+    for (size_t i = pointer.sample_count - 1; i > 0; i--) {
+      const Sample& before = samples[i - 1];
+      const Sample& after = samples[i];
+      if (before.time <= sample_time) {
+        const double t = static_cast<double>(sample_time - before.time) /
+                         (after.time - before.time);
+        move.time_stamp = sample_time;
+        move.physical_x = before.x + (after.x - before.x) * t;
+        move.physical_y = before.y + (after.y - before.y) * t;
+        SetDispatched(pointer, move);
+        output_.push_back(move);
+        break;
+      }
+    }
+    return false;
+  }
+
+  pointer.has_pending_move = false;
+  size_t oldest = 0;
+  while (latest.time - samples[oldest].time > kMaxSampleAge) {
+    oldest++;
+  }
+  const int64_t span = latest.time - samples[oldest].time;
+  if (span >= kMinPredictionSpan) {
+    // Predicts from the velocity over the recent samples, no further ahead
+    // than those samples span.
+    const int64_t prediction =
+        std::min({sample_time - latest.time, max_prediction_, span});
+    const double t = static_cast<double>(prediction) / span;
+    move.time_stamp = latest.time + prediction;
+    move.physical_x = latest.x + (latest.x - samples[oldest].x) * t;
+    move.physical_y = latest.y + (latest.y - samples[oldest].y) * t;
+  }
+  SetDispatched(pointer, move);
+  output_.push_back(move);
+  return true;
+}
+
+void PointerDataResampler::SetDispatched(PointerSamples& pointer,
+                                         PointerData& event) {
+  if (event.signal_kind == PointerData::SignalKind::kNone &&
+      (event.change == PointerData::Change::kMove ||
+       event.change == PointerData::Change::kHover)) {
+    event.physical_delta_x = event.physical_x - pointer.dispatched_x;
+    event.physical_delta_y = event.physical_y - pointer.dispatched_y;
+  }
+  if (IsMove(event)) {
+    pointer.buttons = event.buttons;
+  }
+  pointer.dispatched_x = event.physical_x;
+  pointer.dispatched_y = event.physical_y;
+}
+
+}  // namespace flutter
@@ -0,0 +1,128 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_WINDOW_POINTER_DATA_RESAMPLER_H_
+#define FLUTTER_LIB_UI_WINDOW_POINTER_DATA_RESAMPLER_H_
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/lib/ui/window/pointer_data_packet.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Resamples the moves of pointers to the time a frame is displayed.
+///
+/// Touch panels and styluses report positions at rates of up to a kilohertz,
+/// which are neither a multiple of the refresh rate nor in phase with it.
+/// Dispatching every sample makes the framework do the work of a move for
+/// each one, and the position a frame shows is up to a sample interval old.
+///
+/// The resampler queues the converted events of a frame. When the frame is
+/// produced, it replaces the moves of each pointer with a single move at the
+/// sample time of the frame. The position of that move is interpolated
+/// between the two samples around the sample time, or predicted from the
+/// velocity of the latest samples when the sample time is past the latest
+/// sample. A prediction never reaches further ahead than the samples it is
+/// based on span, nor further than the maximum prediction.
+///
+/// All other events are dispatched unchanged and in order. A pointer's latest
+/// real move is dispatched before any other event of the pointer, and a
+/// synthesized move is added before an up or cancel at a position other than
+/// the one that was last dispatched, so that the framework sees the same
+/// positions as without resampling. The deltas of the moves and hovers are
+/// recomputed from the positions that were dispatched.
+///
+class PointerDataResampler {
+ public:
+  // The number of the latest samples of each pointer that are kept to
+  // interpolate and predict from.
+  static constexpr size_t kMaxSamples = 8;
+
+  //----------------------------------------------------------------------------
+  /// @param[in]  max_prediction  How far past the latest sample of a pointer
+  ///                             its position may be predicted.
+  ///
+  explicit PointerDataResampler(
+      fml::TimeDelta max_prediction = fml::TimeDelta::FromMilliseconds(8));
+
+  ~PointerDataResampler();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Queues the events of a packet that was converted by a
+  ///             |PointerDataPacketConverter|.
+  ///
+  void AddPacket(const PointerDataPacket& packet);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether there are queued events, or moves that were
+  ///             resampled at a time before the latest sample and have to be
+  ///             resampled again by a later frame.
+  ///
+  bool HasPendingEvents() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Dispatches the queued events, with the moves of each pointer
+  ///             resampled at |sample_time|.
+  ///
+  /// @param[in]  sample_time  The time the frame is displayed, in the
+  ///                          microseconds of |PointerData::time_stamp|.
+  ///
+  /// @return     The events to dispatch, which may be none.
+  ///
+  std::unique_ptr<PointerDataPacket> Resample(int64_t sample_time);
+
+ private:
+  struct Sample {
+    int64_t time;
+    double x;
+    double y;
+  };
+
+  struct PointerSamples {
+    int64_t device = 0;
+    bool is_removed = false;
+    bool is_down = false;
+    int64_t buttons = 0;
+    double dispatched_x = 0;
+    double dispatched_y = 0;
+    // The latest samples, from the oldest to the newest.
+    Sample samples[kMaxSamples];
+    size_t sample_count = 0;
+    // The latest real move, if it has not been dispatched yet.
+    bool has_pending_move = false;
+    PointerData pending_move;
+  };
+
+  const int64_t max_prediction_;
+  std::vector<PointerData> queued_;
+  std::vector<PointerData> output_;
+  // Only a handful of pointers are down at a time, so they are looked up in
+  // a flat array.
+  std::vector<PointerSamples> pointers_;
+
+  PointerSamples& GetPointer(int64_t device);
+
+  void AddSample(PointerSamples& pointer, const PointerData& move);
+
+  // Emits |event|, after the pending move of its pointer and any synthesized
+  // move that it needs.
+  void Emit(PointerSamples& pointer, PointerData event);
+
+  // Emits the pending move of |pointer| at |sample_time|. Returns false if
+  // the move has to stay pending as its latest sample is after the sample
+  // time.
+  bool EmitResampledMove(PointerSamples& pointer, int64_t sample_time);
+
+  void SetDispatched(PointerSamples& pointer, PointerData& event);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PointerDataResampler);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_WINDOW_POINTER_DATA_RESAMPLER_H_
@@ -0,0 +1,132 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/window/pointer_data_resampler.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+PointerData CreateTouchData(PointerData::Change change,
+                            int64_t time_stamp,
+                            double x,
+                            double y) {
+  PointerData data;
+  data.Clear();
+  data.time_stamp = time_stamp;
+  data.change = change;
+  data.kind = PointerData::DeviceKind::kTouch;
+  data.signal_kind = PointerData::SignalKind::kNone;
+  data.device = 1;
+  data.physical_x = x;
+  data.physical_y = y;
+  data.buttons = change == PointerData::Change::kUp ? 0 : 1;
+  return data;
+}
+
+void AddEvents(PointerDataResampler& resampler,
+               const std::vector<PointerData>& events) {
+  PointerDataPacket packet(events.size());
+  for (size_t i = 0; i < events.size(); i++) {
+    packet.SetPointerData(i, events[i]);
+  }
+  resampler.AddPacket(packet);
+}
+
+std::vector<PointerData> Unpack(const PointerDataPacket& packet) {
+  std::vector<PointerData> events(packet.data().size() / sizeof(PointerData));
+  memcpy(events.data(), packet.data().data(), packet.data().size());
+  return events;
+}
+
+std::vector<PointerData> DownAndMoves() {
+  return {
+      CreateTouchData(PointerData::Change::kAdd, 0, 0, 0),
+      CreateTouchData(PointerData::Change::kDown, 0, 0, 0),
+      CreateTouchData(PointerData::Change::kMove, 4000, 4, 8),
+      CreateTouchData(PointerData::Change::kMove, 8000, 8, 16),
+  };
+}
+
+}  // namespace
+
+TEST(PointerDataResamplerTest, InterpolatesBetweenSamples) {
+  PointerDataResampler resampler;
+  AddEvents(resampler, DownAndMoves());
+
+  auto events = Unpack(*resampler.Resample(6000));
+  ASSERT_EQ(events.size(), 3u);
+  EXPECT_EQ(events[0].change, PointerData::Change::kAdd);
+  EXPECT_EQ(events[1].change, PointerData::Change::kDown);
+  EXPECT_EQ(events[2].change, PointerData::Change::kMove);
+  EXPECT_EQ(events[2].time_stamp, 6000);
+  EXPECT_DOUBLE_EQ(events[2].physical_x, 6);
+  EXPECT_DOUBLE_EQ(events[2].physical_y, 12);
+  EXPECT_DOUBLE_EQ(events[2].physical_delta_x, 6);
+  EXPECT_DOUBLE_EQ(events[2].physical_delta_y, 12);
+
+  // The latest sample is after the sample time, so it is resampled again by
+  // the next frame.
+  EXPECT_TRUE(resampler.HasPendingEvents());
+  events = Unpack(*resampler.Resample(8000));
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_DOUBLE_EQ(events[0].physical_x, 8);
+  EXPECT_DOUBLE_EQ(events[0].physical_delta_x, 2);
+  EXPECT_FALSE(resampler.HasPendingEvents());
+}
+
+TEST(PointerDataResamplerTest, LimitsPrediction) {
+  PointerDataResampler resampler(fml::TimeDelta::FromMilliseconds(2));
+  AddEvents(resampler, DownAndMoves());
+
+  auto events = Unpack(*resampler.Resample(16000));
+  ASSERT_EQ(events.size(), 3u);
+  EXPECT_EQ(events[2].time_stamp, 10000);
+  EXPECT_DOUBLE_EQ(events[2].physical_x, 10);
+  EXPECT_DOUBLE_EQ(events[2].physical_y, 20);
+  EXPECT_FALSE(resampler.HasPendingEvents());
+}
+
+TEST(PointerDataResamplerTest, DispatchesLatestMoveBeforeUp) {
+  PointerDataResampler resampler;
+  auto input = DownAndMoves();
+  input.push_back(CreateTouchData(PointerData::Change::kUp, 8000, 8, 16));
+  AddEvents(resampler, input);
+
+  auto events = Unpack(*resampler.Resample(6000));
+  ASSERT_EQ(events.size(), 4u);
+  EXPECT_EQ(events[2].change, PointerData::Change::kMove);
+  EXPECT_EQ(events[2].time_stamp, 8000);
+  EXPECT_DOUBLE_EQ(events[2].physical_x, 8);
+  EXPECT_DOUBLE_EQ(events[2].physical_delta_x, 8);
+  EXPECT_EQ(events[3].change, PointerData::Change::kUp);
+  EXPECT_FALSE(resampler.HasPendingEvents());
+}
+
+TEST(PointerDataResamplerTest, SynthesizesMoveBeforeUpAfterPrediction) {
+  PointerDataResampler resampler;
+  AddEvents(resampler, DownAndMoves());
+  auto events = Unpack(*resampler.Resample(12000));
+  ASSERT_EQ(events.size(), 3u);
+  EXPECT_DOUBLE_EQ(events[2].physical_x, 12);
+
+  AddEvents(resampler,
+            {CreateTouchData(PointerData::Change::kUp, 9000, 9, 18)});
+  events = Unpack(*resampler.Resample(28000));
+  ASSERT_EQ(events.size(), 2u);
+  EXPECT_EQ(events[0].change, PointerData::Change::kMove);
+  EXPECT_EQ(events[0].synthesized, 1);
+  EXPECT_EQ(events[0].buttons, 1);
+  EXPECT_DOUBLE_EQ(events[0].physical_x, 9);
+  EXPECT_DOUBLE_EQ(events[0].physical_delta_x, -3);
+  EXPECT_EQ(events[1].change, PointerData::Change::kUp);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -34,9 +34,15 @@ static std::unique_ptr<const fml::Mapping> GetFileMapping(
     bool executable) {
   if (executable) {
     return fml::FileMapping::CreateReadExecute(path);
-  } else {
-    return fml::FileMapping::CreateReadOnly(path);
   }
+  auto mapping = fml::FileMapping::CreateReadOnly(path);
+  if (mapping) {
+    // Snapshot data is deserialized in full as soon as the VM or isolate
+    // starts, so it is read in ahead of time. Instructions are only paged in
+    // as they run.
+    mapping->Advise(fml::Mapping::Advice::kWillNeed);
+  }
+  return mapping;
 }
 
 // The first party embedders don't yet use the stable embedder API and depend on
@@ -283,7 +283,11 @@ size_t DartVM::GetVMLaunchCount() {
 DartVM::DartVM(std::shared_ptr<const DartVMData> vm_data,
                std::shared_ptr<IsolateNameServer> isolate_name_server)
     : settings_(vm_data->GetSettings()),
-      concurrent_message_loop_(fml::ConcurrentMessageLoop::Create()),
+      concurrent_message_loop_(fml::ConcurrentMessageLoop::Create(
+          std::thread::hardware_concurrency(),
+          settings_.enable_concurrent_work_stealing
+              ? fml::ConcurrentMessageLoop::Scheduling::kWorkStealing
+              : fml::ConcurrentMessageLoop::Scheduling::kSharedQueue)),
       skia_concurrent_executor_(
           [runner = concurrent_message_loop_->GetTaskRunner()](
               fml::closure work) { runner->PostTask(work); }),
@@ -21,25 +21,37 @@ constexpr fml::TimeDelta kNotifyIdleTaskWaitTime =
 
 }  // namespace
 
+static uint32_t GetDefaultPipelineDepth(const TaskRunners& task_runners) {
+#if SHELL_ENABLE_METAL
+  return 2;
+#else   // SHELL_ENABLE_METAL
+  // TODO(dnfield): We should remove this logic and set the pipeline depth
+  // back to 2 in this case. See
+  // https://github.com/flutter/engine/pull/9132 for discussion.
+  return task_runners.GetPlatformTaskRunner() ==
+                 task_runners.GetRasterTaskRunner()
+             ? 1
+             : 2;
+#endif  // SHELL_ENABLE_METAL
+}
+
 Animator::Animator(Delegate& delegate,
                    TaskRunners task_runners,
-                   std::unique_ptr<VsyncWaiter> waiter)
+                   std::unique_ptr<VsyncWaiter> waiter,
+                   uint32_t pipeline_depth,
+                   PipelineDiscardPolicy discard_policy)
     : delegate_(delegate),
       task_runners_(std::move(task_runners)),
       waiter_(std::move(waiter)),
-#if SHELL_ENABLE_METAL
-      layer_tree_pipeline_(std::make_shared<LayerTreePipeline>(2)),
-#else   // SHELL_ENABLE_METAL
-      // TODO(dnfield): We should remove this logic and set the pipeline depth
-      // back to 2 in this case. See
-      // https://github.com/flutter/engine/pull/9132 for discussion.
       layer_tree_pipeline_(std::make_shared<LayerTreePipeline>(
-          task_runners.GetPlatformTaskRunner() ==
-                  task_runners.GetRasterTaskRunner()
-              ? 1
-              : 2)),
-#endif  // SHELL_ENABLE_METAL
+          pipeline_depth > 0 ? pipeline_depth
+                             : GetDefaultPipelineDepth(task_runners_),
+          discard_policy)),
       pending_frame_semaphore_(1),
+      // Frames produced ahead would only replace each other when stale frames
+      // are discarded.
+      produce_frames_ahead_(pipeline_depth > 2 &&
+                            discard_policy == PipelineDiscardPolicy::kKeepAll),
       weak_factory_(this) {
 }
 
@@ -64,10 +76,13 @@ static fml::TimePoint FxlToDartOrEarlier(fml::TimePoint time) {
 }
 
 void Animator::BeginFrame(
-    std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder) {
-  TRACE_EVENT_ASYNC_END0("flutter", "Frame Request Pending",
-                         frame_request_number_);
-  frame_request_number_++;
+    std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder,
+    bool ahead_of_vsync) {
+  if (!ahead_of_vsync) {
+    TRACE_EVENT_ASYNC_END0("flutter", "Frame Request Pending",
+                           frame_request_number_);
+    frame_request_number_++;
+  }
 
   frame_timings_recorder_ = std::move(frame_timings_recorder);
   frame_timings_recorder_->RecordBuildStart(fml::TimePoint::Now());
@@ -83,7 +98,11 @@ void Animator::BeginFrame(
   frame_scheduled_ = false;
   notify_idle_task_id_++;
   regenerate_layer_tree_ = false;
-  pending_frame_semaphore_.Signal();
+  if (!ahead_of_vsync) {
+    // A frame produced ahead of vsync leaves the vsync request that is still
+    // pending in place, see |OnVsync|.
+    pending_frame_semaphore_.Signal();
+  }
 
   if (!producer_continuation_) {
     // We may already have a valid pipeline continuation in case a previous
@@ -101,6 +120,11 @@ void Animator::BeginFrame(
     }
   }
 
+  if (ahead_of_vsync) {
+    produced_frame_ahead_ = true;
+  }
+  last_frame_target_time_ = frame_timings_recorder_->GetVsyncTargetTime();
+
   // We have acquired a valid continuation from the pipeline and are ready
   // to service potential frame.
   FML_DCHECK(producer_continuation_);
@@ -174,6 +198,19 @@ void Animator::Render(std::unique_ptr<flutter::LayerTree> layer_tree) {
     return;
   }
 
+  if (produce_frames_ahead_ && frame_scheduled_ &&
+      !layer_tree_pipeline_->IsFull()) {
+    // Another frame has already been requested and the pipeline has room for
+    // it, so start on it right away instead of waiting for the next vsync.
+    // Posted so that the current frame can finish first.
+    task_runners_.GetUITaskRunner()->PostTask(
+        [self = weak_factory_.GetWeakPtr()]() {
+          if (self) {
+            self->BeginFrameAhead();
+          }
+        });
+  }
+
   if (!result.is_first_item) {
     // It has been successfully pushed to the pipeline but not as the first
     // item. Eventually the 'Rasterizer' will consume it, so we don't need to
@@ -184,6 +221,57 @@ void Animator::Render(std::unique_ptr<flutter::LayerTree> layer_tree) {
   delegate_.OnAnimatorDraw(layer_tree_pipeline_);
 }
 
+void Animator::BeginFrameAhead() {
+  if (!frame_scheduled_ || !regenerate_layer_tree_ || producer_continuation_ ||
+      layer_tree_pipeline_->IsFull() || frame_interval_ <= fml::TimeDelta()) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "Animator::BeginFrameAhead");
+  auto frame_timings_recorder = std::make_unique<FrameTimingsRecorder>();
+  frame_timings_recorder->RecordVsync(
+      last_frame_target_time_, last_frame_target_time_ + frame_interval_);
+  BeginFrame(std::move(frame_timings_recorder), /*ahead_of_vsync=*/true);
+}
+
+void Animator::OnVsync(
+    std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder) {
+  const fml::TimePoint vsync_start =
+      frame_timings_recorder->GetVsyncStartTime();
+  const fml::TimePoint vsync_target =
+      frame_timings_recorder->GetVsyncTargetTime();
+  frame_interval_ = vsync_target - vsync_start;
+
+  if (!produced_frame_ahead_) {
+    if (CanReuseLastLayerTree()) {
+      DrawLastLayerTree(std::move(frame_timings_recorder));
+    } else {
+      BeginFrame(std::move(frame_timings_recorder));
+    }
+    return;
+  }
+
+  produced_frame_ahead_ = false;
+  if (!regenerate_layer_tree_) {
+    // The frame for this vsync is already in the pipeline, and nothing asked
+    // for another one while it was being built.
+    TRACE_EVENT_ASYNC_END0("flutter", "Frame Request Pending",
+                           frame_request_number_);
+    frame_request_number_++;
+    pending_frame_semaphore_.Signal();
+    return;
+  }
+
+  // Keep targeting the interval after the frames that were produced ahead,
+  // unless the UI thread has fallen behind them.
+  const fml::TimePoint next_target = last_frame_target_time_ + frame_interval_;
+  if (vsync_target < next_target) {
+    frame_timings_recorder = std::make_unique<FrameTimingsRecorder>(
+        frame_timings_recorder->GetFrameNumber());
+    frame_timings_recorder->RecordVsync(vsync_start, next_target);
+  }
+  BeginFrame(std::move(frame_timings_recorder));
+}
+
 const std::weak_ptr<VsyncWaiter> Animator::GetVsyncWaiter() const {
   std::weak_ptr<VsyncWaiter> weak = waiter_;
   return weak;
@@ -210,6 +298,9 @@ void Animator::RequestFrame(bool regenerate_layer_tree) {
   if (regenerate_layer_tree) {
     regenerate_layer_tree_ = true;
   }
+  // Set even if a vsync request is already pending, as a frame that was
+  // produced ahead of that vsync may have cleared it.
+  frame_scheduled_ = true;
 
   if (!pending_frame_semaphore_.TryWait()) {
     // Multiple calls to Animator::RequestFrame will still result in a
@@ -234,7 +325,6 @@ void Animator::RequestFrame(bool regenerate_layer_tree) {
                                  frame_request_number);
         self->AwaitVSync();
       });
-  frame_scheduled_ = true;
 }
 
 void Animator::AwaitVSync() {
@@ -242,11 +332,7 @@ void Animator::AwaitVSync() {
       [self = weak_factory_.GetWeakPtr()](
           std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder) {
         if (self) {
-          if (self->CanReuseLastLayerTree()) {
-            self->DrawLastLayerTree(std::move(frame_timings_recorder));
-          } else {
-            self->BeginFrame(std::move(frame_timings_recorder));
-          }
+          self->OnVsync(std::move(frame_timings_recorder));
         }
       });
   if (has_rendered_) {
@@ -259,6 +345,10 @@ void Animator::ScheduleSecondaryVsyncCallback(uintptr_t id,
   waiter_->ScheduleSecondaryCallback(id, callback);
 }
 
+fml::TimePoint Animator::GetLastVsyncTargetTime() const {
+  return waiter_->GetLastFrameTargetTime();
+}
+
 void Animator::ScheduleMaybeClearTraceFlowIds() {
   waiter_->ScheduleSecondaryCallback(
       reinterpret_cast<uintptr_t>(this), [self = weak_factory_.GetWeakPtr()] {
@@ -46,9 +46,17 @@ class Animator final {
         std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder) = 0;
   };
 
+  /// Creates an animator that hands frames to the rasterizer through a
+  /// pipeline of |pipeline_depth| frames, or of a depth picked from the
+  /// threading configuration when it is 0. With a depth greater than 2, and
+  /// unless stale frames are discarded, the animator produces frames ahead
+  /// of vsync while frames keep being requested and the pipeline has room.
   Animator(Delegate& delegate,
            TaskRunners task_runners,
-           std::unique_ptr<VsyncWaiter> waiter);
+           std::unique_ptr<VsyncWaiter> waiter,
+           uint32_t pipeline_depth = 0,
+           PipelineDiscardPolicy discard_policy =
+               PipelineDiscardPolicy::kKeepAll);
 
   ~Animator();
 
@@ -76,13 +84,31 @@ class Animator final {
   void ScheduleSecondaryVsyncCallback(uintptr_t id,
                                       const fml::closure& callback);
 
+  //--------------------------------------------------------------------------
+  /// @brief    The target time of the latest vsync, including the vsyncs that
+  ///           only fired secondary callbacks.
+  ///
+  /// @see      `PointerDataDispatcher::Delegate::GetLastVsyncTargetTime`.
+  fml::TimePoint GetLastVsyncTargetTime() const;
+
   // Enqueue |trace_flow_id| into |trace_flow_ids_|.  The flow event will be
   // ended at either the next frame, or the next vsync interval with no active
   // active rendering.
   void EnqueueTraceFlowId(uint64_t trace_flow_id);
 
  private:
-  void BeginFrame(std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder);
+  // |ahead_of_vsync| is set for the frames that are produced before the
+  // vsync they target, which leave the pending vsync request alone.
+  void BeginFrame(std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder,
+                  bool ahead_of_vsync = false);
+
+  // Begins a frame that targets the interval after the last produced frame
+  // if another frame was requested and the pipeline has room for it.
+  void BeginFrameAhead();
+
+  // Handles a vsync for which a frame was requested, taking into account the
+  // frames that were already produced ahead of it.
+  void OnVsync(std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder);
 
   bool CanReuseLastLayerTree();
 
@@ -110,6 +136,11 @@ class Animator final {
   SkISize last_layer_tree_size_ = {0, 0};
   std::deque<uint64_t> trace_flow_ids_;
   bool has_rendered_ = false;
+  const bool produce_frames_ahead_;
+  // Whether a frame was produced ahead of the vsync that is being waited for.
+  bool produced_frame_ahead_ = false;
+  fml::TimePoint last_frame_target_time_;
+  fml::TimeDelta frame_interval_;
 
   fml::WeakPtrFactory<Animator> weak_factory_;
 
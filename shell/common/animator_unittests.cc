@@ -9,6 +9,7 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <vector>
 
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/shell_test_platform_view.h"
@@ -108,6 +109,20 @@ TEST_F(ShellTest, VSyncTargetTime) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
 }
 
+// A vsync waiter that only fires when the test tells it to.
+class ManualVsyncWaiter : public VsyncWaiter {
+ public:
+  explicit ManualVsyncWaiter(TaskRunners task_runners)
+      : VsyncWaiter(std::move(task_runners)) {}
+
+  void Fire(fml::TimePoint frame_start_time, fml::TimeDelta interval) {
+    FireCallback(frame_start_time, frame_start_time + interval);
+  }
+
+ protected:
+  void AwaitVSync() override {}
+};
+
 TEST_F(ShellTest, AnimatorDoesNotNotifyIdleBeforeRender) {
   FakeAnimatorDelegate delegate;
   TaskRunners task_runners = {
@@ -248,6 +263,77 @@ TEST_F(ShellTest, AnimatorDoesNotNotifyDelegateIfPipelineIsNotEmpty) {
   PostTaskSync(task_runners.GetUITaskRunner(), [&] { animator.reset(); });
 }
 
+TEST_F(ShellTest, AnimatorProducesFramesAheadOfVsyncWithDeepPipeline) {
+  FakeAnimatorDelegate delegate;
+  TaskRunners task_runners = {
+      "test",
+      CreateNewThread(),  // platform
+      CreateNewThread(),  // raster
+      CreateNewThread(),  // ui
+      CreateNewThread()   // io
+  };
+
+  std::shared_ptr<Animator> animator;
+  ManualVsyncWaiter* vsync_waiter = nullptr;
+  PostTaskSync(task_runners.GetUITaskRunner(), [&] {
+    auto waiter = std::make_unique<ManualVsyncWaiter>(task_runners);
+    vsync_waiter = waiter.get();
+    animator = std::make_unique<Animator>(delegate, task_runners,
+                                          std::move(waiter), 3);
+  });
+
+  const size_t frame_count = 3;
+  std::vector<fml::TimePoint> frame_target_times;
+  fml::AutoResetWaitableEvent frames_latch;
+  EXPECT_CALL(delegate, OnAnimatorBeginFrame)
+      .WillRepeatedly(
+          [&](fml::TimePoint frame_target_time, uint64_t frame_number) {
+            frame_target_times.push_back(frame_target_time);
+            // Behave like a running animation that ends after |frame_count|
+            // frames.
+            if (frame_target_times.size() < frame_count) {
+              animator->RequestFrame();
+            }
+            animator->Render(
+                std::make_unique<LayerTree>(SkISize::Make(600, 800), 1.0));
+            if (frame_target_times.size() == frame_count) {
+              frames_latch.Signal();
+            }
+          });
+  EXPECT_CALL(delegate, OnAnimatorUpdateLatestFrameTargetTime)
+      .Times(frame_count);
+  // Nothing consumes the pipeline, so only the first frame is the first item.
+  EXPECT_CALL(delegate, OnAnimatorDraw).Times(1);
+
+  PostTaskSync(task_runners.GetUITaskRunner(),
+               [&] { animator->RequestFrame(); });
+  // Let the vsync request that was posted by |RequestFrame| run.
+  PostTaskSync(task_runners.GetUITaskRunner(), [] {});
+
+  // A single vsync produces all of the frames, each one targeting the
+  // interval after the previous one.
+  const fml::TimePoint vsync_start = fml::TimePoint::Now();
+  const fml::TimeDelta interval = fml::TimeDelta::FromMilliseconds(16);
+  vsync_waiter->Fire(vsync_start, interval);
+  frames_latch.Wait();
+
+  PostTaskSync(task_runners.GetUITaskRunner(), [&] {
+    ASSERT_EQ(frame_target_times.size(), 3u);
+    EXPECT_EQ(frame_target_times[0], vsync_start + interval);
+    EXPECT_EQ(frame_target_times[1], vsync_start + interval * 2);
+    EXPECT_EQ(frame_target_times[2], vsync_start + interval * 3);
+  });
+
+  // The vsync requested by the first frame was already served by the frames
+  // produced ahead of it, so it does not begin another frame.
+  vsync_waiter->Fire(fml::TimePoint::Now(), interval);
+  PostTaskSync(task_runners.GetUITaskRunner(), [&] {
+    ASSERT_EQ(frame_target_times.size(), 3u);
+  });
+
+  PostTaskSync(task_runners.GetUITaskRunner(), [&] { animator.reset(); });
+}
+
 }  // namespace testing
 }  // namespace flutter
 
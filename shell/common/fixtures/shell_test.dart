@@ -122,6 +122,14 @@ void sayHiFromFixturesAreFunctionalMain() native 'SayHiFromFixturesAreFunctional
 @pragma('vm:entry-point')
 void notifyNative() native 'NotifyNative';
 
+@pragma('vm:entry-point')
+void platformMessageSink() {
+  PlatformDispatcher.instance.onPlatformMessage = (String name, ByteData? data, PlatformMessageResponseCallback? callback) {
+    callback!(null);
+  };
+  notifyNative();
+}
+
 @pragma('vm:entry-point')
 void thousandCallsToNative() {
   for (int i = 0; i < 1000; i++) {
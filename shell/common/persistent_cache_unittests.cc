@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/common/graphics/persistent_cache_file.h"
 #include "flutter/flow/layers/container_layer.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/layers/physical_shape_layer.h"
@@ -361,5 +362,190 @@ TEST_F(PersistentCacheTest, PurgeAllowsFutureSkSLCache) {
   DestroyShell(std::move(shell));
 }
 
+TEST_F(PersistentCacheTest, DiscardPrefetchedDropsUnloadedFiles) {
+  sk_sp<SkData> shader_key = SkData::MakeWithCString("key");
+  std::string shader_filename = PersistentCache::SkKeyToFilePath(*shader_key);
+
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  auto cache_dir = fml::CreateDirectory(
+      base_dir.fd(),
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion()},
+      fml::FilePermission::kReadWrite);
+  fml::DataMapping shader_value(std::string("value"));
+  ASSERT_TRUE(fml::WriteAtomically(cache_dir, shader_filename.c_str(),
+                                   shader_value));
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+  ASSERT_EQ(persistent_cache->Prefetch({shader_filename}), 1u);
+  persistent_cache->DiscardPrefetched();
+  ASSERT_EQ(persistent_cache->Prefetch({shader_filename}), 0u);
+
+  // The file is still loaded from the disk.
+  auto loaded = persistent_cache->load(*shader_key);
+  ASSERT_TRUE(loaded);
+  ASSERT_EQ(loaded->size(), shader_value.GetSize());
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+static std::string TestHash(char c) {
+  return std::string(40, c);
+}
+
+static std::string ToString(const sk_sp<SkData>& data) {
+  return std::string(reinterpret_cast<const char*>(data->bytes()),
+                     data->size());
+}
+
+TEST(PersistentCacheFileTest, StoresAndLoadsEntriesAcrossFlushes) {
+  fml::ScopedTemporaryDirectory dir;
+  auto directory = std::make_shared<fml::UniqueFD>(
+      fml::OpenDirectory(dir.path().c_str(), false,
+                         fml::FilePermission::kReadWrite));
+  {
+    PersistentCacheFile file(directory, 1024);
+    file.Store(TestHash('a'), *SkData::MakeWithCString("key a"),
+               *SkData::MakeWithCString("value a"));
+    file.Store(TestHash('b'), *SkData::MakeWithCString("key b"),
+               *SkData::MakeWithCString("value b"));
+    ASSERT_TRUE(file.Flush());
+    // Entries are read from the new file once it has been written.
+    ASSERT_NE(file.Load(TestHash('a')), nullptr);
+    EXPECT_EQ(ToString(file.Load(TestHash('a'))), std::string("value a", 8));
+  }
+
+  PersistentCacheFile file(directory, 1024);
+  EXPECT_EQ(file.GetEntryCount(), 2u);
+  EXPECT_EQ(ToString(file.Load(TestHash('b'))), std::string("value b", 8));
+  EXPECT_EQ(file.Load(TestHash('c')), nullptr);
+  auto entries = file.GetEntries();
+  ASSERT_EQ(entries.size(), 2u);
+  EXPECT_EQ(ToString(entries[0].key), std::string("key a", 6));
+  EXPECT_EQ(ToString(entries[1].value), std::string("value b", 8));
+}
+
+TEST(PersistentCacheFileTest, LoadsEntriesAgainAfterRewritingTheFile) {
+  fml::ScopedTemporaryDirectory dir;
+  auto directory = std::make_shared<fml::UniqueFD>(
+      fml::OpenDirectory(dir.path().c_str(), false,
+                         fml::FilePermission::kReadWrite));
+  {
+    PersistentCacheFile file(directory, 1024);
+    file.Store(TestHash('a'), *SkData::MakeWithCString("key a"),
+               *SkData::MakeWithCString("value a"));
+    ASSERT_TRUE(file.Flush());
+  }
+
+  // Each flush replaces the file that the entries were loaded from.
+  PersistentCacheFile file(directory, 1024);
+  EXPECT_EQ(ToString(file.Load(TestHash('a'))), std::string("value a", 8));
+  file.Store(TestHash('b'), *SkData::MakeWithCString("key b"),
+             *SkData::MakeWithCString("value b"));
+  ASSERT_TRUE(file.Flush());
+  EXPECT_EQ(ToString(file.Load(TestHash('a'))), std::string("value a", 8));
+  EXPECT_EQ(ToString(file.Load(TestHash('b'))), std::string("value b", 8));
+  ASSERT_TRUE(file.Flush());
+  EXPECT_EQ(ToString(file.Load(TestHash('a'))), std::string("value a", 8));
+  EXPECT_EQ(ToString(file.Load(TestHash('b'))), std::string("value b", 8));
+}
+
+TEST(PersistentCacheFileTest, TrimsLeastRecentlyUsedEntries) {
+  fml::ScopedTemporaryDirectory dir;
+  auto directory = std::make_shared<fml::UniqueFD>(
+      fml::OpenDirectory(dir.path().c_str(), false,
+                         fml::FilePermission::kReadWrite));
+  auto value = SkData::MakeWithCopy(std::string(100, 'x').data(), 100);
+  auto key = SkData::MakeWithCopy("key", 3);
+  PersistentCacheFile file(directory, 250);
+  file.Store(TestHash('a'), *key, *value);
+  file.Store(TestHash('b'), *key, *value);
+  file.Store(TestHash('c'), *key, *value);
+  // Using the oldest entry keeps it over the second oldest one.
+  ASSERT_NE(file.Load(TestHash('a')), nullptr);
+  ASSERT_TRUE(file.Flush());
+
+  EXPECT_EQ(file.GetEntryCount(), 2u);
+  EXPECT_LE(file.GetDataSize(), 250u);
+  EXPECT_NE(file.Load(TestHash('a')), nullptr);
+  EXPECT_EQ(file.Load(TestHash('b')), nullptr);
+  EXPECT_NE(file.Load(TestHash('c')), nullptr);
+}
+
+TEST(PersistentCacheFileTest, KeepsRecencyOfLoadsAcrossSessions) {
+  fml::ScopedTemporaryDirectory dir;
+  auto directory = std::make_shared<fml::UniqueFD>(
+      fml::OpenDirectory(dir.path().c_str(), false,
+                         fml::FilePermission::kReadWrite));
+  auto value = SkData::MakeWithCopy(std::string(100, 'x').data(), 100);
+  auto key = SkData::MakeWithCopy("key", 3);
+  {
+    PersistentCacheFile file(directory, 1024);
+    file.Store(TestHash('a'), *key, *value);
+    file.Store(TestHash('b'), *key, *value);
+    file.Store(TestHash('c'), *key, *value);
+    ASSERT_TRUE(file.Flush());
+  }
+  {
+    // A session that only loads still saves the order it used entries in.
+    PersistentCacheFile file(directory, 1024);
+    ASSERT_NE(file.Load(TestHash('a')), nullptr);
+    ASSERT_TRUE(file.Flush());
+  }
+  PersistentCacheFile file(directory, 250);
+  file.Store(TestHash('d'), *key, *value);
+  ASSERT_TRUE(file.Flush());
+
+  EXPECT_EQ(file.GetEntryCount(), 2u);
+  EXPECT_NE(file.Load(TestHash('a')), nullptr);
+  EXPECT_EQ(file.Load(TestHash('b')), nullptr);
+  EXPECT_EQ(file.Load(TestHash('c')), nullptr);
+  EXPECT_NE(file.Load(TestHash('d')), nullptr);
+}
+
+TEST(PersistentCacheFileTest, DropsCorruptEntriesAndFiles) {
+  fml::ScopedTemporaryDirectory dir;
+  auto directory = std::make_shared<fml::UniqueFD>(
+      fml::OpenDirectory(dir.path().c_str(), false,
+                         fml::FilePermission::kReadWrite));
+  {
+    PersistentCacheFile file(directory, 1024);
+    file.Store(TestHash('a'), *SkData::MakeWithCString("key a"),
+               *SkData::MakeWithCString("value a"));
+    file.Store(TestHash('b'), *SkData::MakeWithCString("key b"),
+               *SkData::MakeWithCString("value b"));
+    ASSERT_TRUE(file.Flush());
+  }
+
+  // Flip the last byte, which belongs to the value of the last entry.
+  std::vector<uint8_t> contents;
+  {
+    auto fd = fml::OpenFileReadOnly(*directory, PersistentCacheFile::kFileName);
+    fml::FileMapping mapping(fd);
+    contents.assign(mapping.GetMapping(),
+                    mapping.GetMapping() + mapping.GetSize());
+  }
+  contents.back() ^= 0xff;
+  ASSERT_TRUE(fml::WriteAtomically(*directory, PersistentCacheFile::kFileName,
+                                   fml::DataMapping(contents)));
+  {
+    PersistentCacheFile file(directory, 1024);
+    EXPECT_EQ(file.GetEntryCount(), 2u);
+    EXPECT_NE(file.Load(TestHash('a')), nullptr);
+    EXPECT_EQ(file.Load(TestHash('b')), nullptr);
+    EXPECT_EQ(file.GetEntryCount(), 1u);
+  }
+
+  // A truncated file is ignored as a whole.
+  contents.resize(contents.size() / 2);
+  ASSERT_TRUE(fml::WriteAtomically(*directory, PersistentCacheFile::kFileName,
+                                   fml::DataMapping(contents)));
+  PersistentCacheFile file(directory, 1024);
+  EXPECT_EQ(file.GetEntryCount(), 0u);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,8 +4,24 @@
 
 #include "flutter/shell/common/pipeline.h"
 
+#include <algorithm>
+
 namespace flutter {
 
+void PipelineStageStats::Record(fml::TimeDelta latency) {
+  count++;
+  total = total + latency;
+  max = std::max(max, latency);
+  last = latency;
+}
+
+fml::TimeDelta PipelineStageStats::Average() const {
+  if (count == 0) {
+    return fml::TimeDelta::Zero();
+  }
+  return total / static_cast<int64_t>(count);
+}
+
 size_t GetNextPipelineTraceID() {
   static std::atomic_size_t PipelineLastTraceID = {0};
   return ++PipelineLastTraceID;
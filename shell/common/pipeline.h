@@ -14,6 +14,8 @@
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/synchronization/semaphore.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -32,6 +34,43 @@ enum class PipelineConsumeResult {
   MoreAvailable,
 };
 
+/// What the pipeline does with the items that are still waiting to be
+/// consumed when a new item is committed.
+enum class PipelineDiscardPolicy {
+  /// Every committed item is consumed, in the order it was committed.
+  kKeepAll,
+  /// A committed item replaces the items that are still waiting to be
+  /// consumed, so the consumer always gets the newest one. This trades frames
+  /// for latency when the consumer cannot keep up.
+  kKeepNewest,
+};
+
+/// The latencies of one stage of the items that went through a pipeline.
+struct PipelineStageStats {
+  size_t count = 0;
+  fml::TimeDelta total;
+  fml::TimeDelta max;
+  fml::TimeDelta last;
+
+  void Record(fml::TimeDelta latency);
+
+  fml::TimeDelta Average() const;
+};
+
+/// The latencies of the items that went through a pipeline, split in the
+/// stages an item goes through.
+struct PipelineStats {
+  /// From the producer reserving a spot to committing the item.
+  PipelineStageStats produce;
+  /// From the item being committed to the consumer taking it.
+  PipelineStageStats wait;
+  /// The time the consumer took to process the item.
+  PipelineStageStats consume;
+  /// The number of committed items that were replaced by newer ones before
+  /// they were consumed. See |PipelineDiscardPolicy::kKeepNewest|.
+  size_t discarded_count = 0;
+};
+
 size_t GetNextPipelineTraceID();
 
 /// A thread-safe queue of resources for a single consumer and a single
@@ -49,7 +88,9 @@ class Pipeline {
     ProducerContinuation() : trace_id_(0) {}
 
     ProducerContinuation(ProducerContinuation&& other)
-        : continuation_(other.continuation_), trace_id_(other.trace_id_) {
+        : continuation_(other.continuation_),
+          trace_id_(other.trace_id_),
+          produce_start_(other.produce_start_) {
       other.continuation_ = nullptr;
       other.trace_id_ = 0;
     }
@@ -57,12 +98,13 @@ class Pipeline {
     ProducerContinuation& operator=(ProducerContinuation&& other) {
       std::swap(continuation_, other.continuation_);
       std::swap(trace_id_, other.trace_id_);
+      std::swap(produce_start_, other.produce_start_);
       return *this;
     }
 
     ~ProducerContinuation() {
       if (continuation_) {
-        continuation_(nullptr, trace_id_);
+        continuation_(nullptr, trace_id_, produce_start_);
         TRACE_EVENT_ASYNC_END0("flutter", "PipelineProduce", trace_id_);
         // The continuation is being dropped on the floor. End the flow.
         TRACE_FLOW_END("flutter", "PipelineItem", trace_id_);
@@ -73,7 +115,8 @@ class Pipeline {
     [[nodiscard]] PipelineProduceResult Complete(ResourcePtr resource) {
       PipelineProduceResult result;
       if (continuation_) {
-        result = continuation_(std::move(resource), trace_id_);
+        result =
+            continuation_(std::move(resource), trace_id_, produce_start_);
         continuation_ = nullptr;
         TRACE_EVENT_ASYNC_END0("flutter", "PipelineProduce", trace_id_);
         TRACE_FLOW_STEP("flutter", "PipelineItem", trace_id_);
@@ -85,14 +128,17 @@ class Pipeline {
 
    private:
     friend class Pipeline;
-    using Continuation =
-        std::function<PipelineProduceResult(ResourcePtr, size_t)>;
+    using Continuation = std::function<
+        PipelineProduceResult(ResourcePtr, size_t, fml::TimePoint)>;
 
     Continuation continuation_;
     size_t trace_id_;
+    fml::TimePoint produce_start_;
 
     ProducerContinuation(const Continuation& continuation, size_t trace_id)
-        : continuation_(continuation), trace_id_(trace_id) {
+        : continuation_(continuation),
+          trace_id_(trace_id),
+          produce_start_(fml::TimePoint::Now()) {
       TRACE_FLOW_BEGIN("flutter", "PipelineItem", trace_id_);
       TRACE_EVENT_ASYNC_BEGIN0("flutter", "PipelineItem", trace_id_);
       TRACE_EVENT_ASYNC_BEGIN0("flutter", "PipelineProduce", trace_id_);
@@ -101,13 +147,38 @@ class Pipeline {
     FML_DISALLOW_COPY_AND_ASSIGN(ProducerContinuation);
   };
 
-  explicit Pipeline(uint32_t depth)
-      : depth_(depth), empty_(depth), available_(0), inflight_(0) {}
+  explicit Pipeline(
+      uint32_t depth,
+      PipelineDiscardPolicy discard_policy = PipelineDiscardPolicy::kKeepAll)
+      : depth_(depth),
+        discard_policy_(discard_policy),
+        empty_(depth),
+        available_(0),
+        inflight_(0) {}
 
   ~Pipeline() = default;
 
   bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
 
+  uint32_t GetDepth() const { return depth_; }
+
+  PipelineDiscardPolicy GetDiscardPolicy() const { return discard_policy_; }
+
+  /// The number of items that are being produced, waiting to be consumed or
+  /// being consumed.
+  int GetInflightCount() const { return inflight_.load(); }
+
+  /// Whether |Produce| would fail because every spot of the pipeline is
+  /// taken.
+  bool IsFull() const { return GetInflightCount() >= static_cast<int>(depth_); }
+
+  /// A snapshot of the latencies of the items that went through the
+  /// pipeline so far.
+  PipelineStats GetStats() const {
+    std::scoped_lock lock(queue_mutex_);
+    return stats_;
+  }
+
   ProducerContinuation Produce() {
     if (!empty_.TryWait()) {
       return {};
@@ -120,7 +191,8 @@ class Pipeline {
 
     return ProducerContinuation{
         std::bind(&Pipeline::ProducerCommit, this, std::placeholders::_1,
-                  std::placeholders::_2),  // continuation
+                  std::placeholders::_2,
+                  std::placeholders::_3),  // continuation
         GetNextPipelineTraceID()};         // trace id
   }
 
@@ -140,7 +212,8 @@ class Pipeline {
 
     return ProducerContinuation{
         std::bind(&Pipeline::ProducerCommitIfEmpty, this, std::placeholders::_1,
-                  std::placeholders::_2),  // continuation
+                  std::placeholders::_2,
+                  std::placeholders::_3),  // continuation
         GetNextPipelineTraceID()};         // trace id
   }
 
@@ -156,22 +229,43 @@ class Pipeline {
       return PipelineConsumeResult::NoneAvailable;
     }
 
-    ResourcePtr resource;
-    size_t trace_id = 0;
+    QueueItem item;
     size_t items_count = 0;
+    const fml::TimePoint consume_start = fml::TimePoint::Now();
 
     {
       std::scoped_lock lock(queue_mutex_);
-      std::tie(resource, trace_id) = std::move(queue_.front());
+      item = std::move(queue_.front());
       queue_.pop_front();
       items_count = queue_.size();
+      stats_.wait.Record(consume_start - item.commit_time);
     }
+    const size_t trace_id = item.trace_id;
+    TRACE_EVENT_ASYNC_END0("flutter", "PipelineWait", trace_id);
 
-    consumer(std::move(resource));
+    {
+      TRACE_EVENT0("flutter", "PipelineConsume");
+      consumer(std::move(item.resource));
+    }
+    const fml::TimeDelta consume_latency =
+        fml::TimePoint::Now() - consume_start;
 
     empty_.Signal();
     --inflight_;
 
+    PipelineStats stats;
+    {
+      std::scoped_lock lock(queue_mutex_);
+      stats_.consume.Record(consume_latency);
+      stats = stats_;
+    }
+    FML_TRACE_COUNTER("flutter", "Pipeline Latency",
+                      reinterpret_cast<int64_t>(this),                    //
+                      "produce (us)", stats.produce.last.ToMicroseconds(),  //
+                      "wait (us)", stats.wait.last.ToMicroseconds(),        //
+                      "consume (us)", stats.consume.last.ToMicroseconds()   //
+    );
+
     TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
     TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", trace_id);
 
@@ -180,19 +274,65 @@ class Pipeline {
   }
 
  private:
+  struct QueueItem {
+    ResourcePtr resource;
+    size_t trace_id = 0;
+    fml::TimePoint commit_time;
+  };
+
   const uint32_t depth_;
+  const PipelineDiscardPolicy discard_policy_;
   fml::Semaphore empty_;
   fml::Semaphore available_;
   std::atomic<int> inflight_;
-  std::mutex queue_mutex_;
-  std::deque<std::pair<ResourcePtr, size_t>> queue_;
+  mutable std::mutex queue_mutex_;
+  std::deque<QueueItem> queue_;
+  PipelineStats stats_;
+
+  // Must be called with the queue mutex held.
+  void PushItemLocked(ResourcePtr resource,
+                      size_t trace_id,
+                      fml::TimePoint produce_start) {
+    const fml::TimePoint now = fml::TimePoint::Now();
+    stats_.produce.Record(now - produce_start);
+    queue_.push_back({std::move(resource), trace_id, now});
+    TRACE_EVENT_ASYNC_BEGIN0("flutter", "PipelineWait", trace_id);
+  }
 
-  PipelineProduceResult ProducerCommit(ResourcePtr resource, size_t trace_id) {
+  PipelineProduceResult ProducerCommit(ResourcePtr resource,
+                                       size_t trace_id,
+                                       fml::TimePoint produce_start) {
     bool is_first_item = false;
+    std::deque<QueueItem> discarded;
     {
       std::scoped_lock lock(queue_mutex_);
-      is_first_item = queue_.empty();
-      queue_.emplace_back(std::move(resource), trace_id);
+      if (discard_policy_ == PipelineDiscardPolicy::kKeepNewest) {
+        // Every commit leaves a single item in the queue, so at most one item
+        // is replaced. That keeps the count of the available semaphore equal
+        // to the size of the queue without having to decrement it: the
+        // consumer that was signaled for the replaced item takes the new one.
+        FML_DCHECK(queue_.size() <= 1);
+        std::swap(discarded, queue_);
+        stats_.discarded_count += discarded.size();
+      }
+      is_first_item = queue_.empty() && discarded.empty();
+      PushItemLocked(std::move(resource), trace_id, produce_start);
+    }
+
+    for (const QueueItem& item : discarded) {
+      // The replaced item was already signaled as available, so only its spot
+      // in the pipeline has to be released.
+      empty_.Signal();
+      --inflight_;
+      TRACE_EVENT_ASYNC_END0("flutter", "PipelineWait", item.trace_id);
+      TRACE_EVENT_INSTANT0("flutter", "PipelineItemDiscarded");
+      TRACE_FLOW_END("flutter", "PipelineItem", item.trace_id);
+      TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", item.trace_id);
+    }
+    if (!discarded.empty()) {
+      // The consumer has already been notified of the item that was
+      // replaced.
+      return {.success = true, .is_first_item = false};
     }
 
     // Ensure the queue mutex is not held as that would be a pessimization.
@@ -201,7 +341,8 @@ class Pipeline {
   }
 
   PipelineProduceResult ProducerCommitIfEmpty(ResourcePtr resource,
-                                              size_t trace_id) {
+                                              size_t trace_id,
+                                              fml::TimePoint produce_start) {
     {
       std::scoped_lock lock(queue_mutex_);
       if (!queue_.empty()) {
@@ -210,7 +351,7 @@ class Pipeline {
         empty_.Signal();
         return {.success = false, .is_first_item = false};
       }
-      queue_.emplace_back(std::move(resource), trace_id);
+      PushItemLocked(std::move(resource), trace_id, produce_start);
     }
 
     // Ensure the queue mutex is not held as that would be a pessimization.
@@ -6,9 +6,13 @@
 
 #include "flutter/shell/common/pipeline.h"
 
+#include <algorithm>
+#include <chrono>
 #include <functional>
 #include <future>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -144,5 +148,139 @@ TEST(PipelineTest, ProduceIfEmptySuccessfulIfQueueIsEmpty) {
   ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
 }
 
+TEST(PipelineTest, DeepPipelineHoldsFramesUntilFull) {
+  const int depth = 4;
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(depth);
+
+  std::vector<Continuation> continuations;
+  for (int i = 0; i < depth; i++) {
+    ASSERT_FALSE(pipeline->IsFull());
+    continuations.push_back(pipeline->Produce());
+    ASSERT_TRUE(continuations.back());
+  }
+  ASSERT_TRUE(pipeline->IsFull());
+  ASSERT_EQ(pipeline->GetInflightCount(), depth);
+  ASSERT_FALSE(pipeline->Produce());
+
+  for (int i = 0; i < depth; i++) {
+    PipelineProduceResult result =
+        continuations[i].Complete(std::make_unique<int>(i));
+    ASSERT_EQ(result.success, true);
+    ASSERT_EQ(result.is_first_item, i == 0);
+  }
+
+  for (int i = 0; i < depth; i++) {
+    PipelineConsumeResult consume_result = pipeline->Consume(
+        [i](std::unique_ptr<int> v) { ASSERT_EQ(*v, i); });
+    ASSERT_EQ(consume_result, i == depth - 1
+                                  ? PipelineConsumeResult::Done
+                                  : PipelineConsumeResult::MoreAvailable);
+  }
+  ASSERT_EQ(pipeline->GetInflightCount(), 0);
+}
+
+TEST(PipelineTest, KeepNewestDiscardsStaleItems) {
+  const int depth = 3;
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(
+      depth, PipelineDiscardPolicy::kKeepNewest);
+
+  Continuation continuation_1 = pipeline->Produce();
+  Continuation continuation_2 = pipeline->Produce();
+  Continuation continuation_3 = pipeline->Produce();
+
+  PipelineProduceResult result =
+      continuation_1.Complete(std::make_unique<int>(1));
+  ASSERT_EQ(result.success, true);
+  ASSERT_EQ(result.is_first_item, true);
+  result = continuation_2.Complete(std::make_unique<int>(2));
+  ASSERT_EQ(result.success, true);
+  ASSERT_EQ(result.is_first_item, false);
+
+  // The spot of the discarded item can be reused right away.
+  ASSERT_EQ(pipeline->GetInflightCount(), 2);
+  Continuation continuation_4 = pipeline->Produce();
+  ASSERT_TRUE(continuation_4);
+
+  result = continuation_3.Complete(std::make_unique<int>(3));
+  ASSERT_EQ(result.success, true);
+  ASSERT_EQ(result.is_first_item, false);
+
+  PipelineConsumeResult consume_result =
+      pipeline->Consume([](std::unique_ptr<int> v) { ASSERT_EQ(*v, 3); });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+  consume_result = pipeline->Consume([](std::unique_ptr<int> v) { FAIL(); });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::NoneAvailable);
+
+  // Once the queue is empty, the next item is the first one again.
+  result = continuation_4.Complete(std::make_unique<int>(4));
+  ASSERT_EQ(result.success, true);
+  ASSERT_EQ(result.is_first_item, true);
+  consume_result =
+      pipeline->Consume([](std::unique_ptr<int> v) { ASSERT_EQ(*v, 4); });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+
+  ASSERT_EQ(pipeline->GetInflightCount(), 0);
+  ASSERT_EQ(pipeline->GetStats().discarded_count, 2u);
+}
+
+TEST(PipelineTest, KeepNewestReplacesItemTheConsumerWasSignaledFor) {
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(
+      2, PipelineDiscardPolicy::kKeepNewest);
+
+  std::vector<int> consumed;
+  std::thread consumer([&]() {
+    while (consumed.empty() || consumed.back() != 100) {
+      PipelineConsumeResult consume_result = pipeline->Consume(
+          [&](std::unique_ptr<int> v) { consumed.push_back(*v); });
+      if (consume_result == PipelineConsumeResult::NoneAvailable) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (int i = 1; i <= 100; i++) {
+    Continuation continuation;
+    while (!(continuation = pipeline->Produce())) {
+      std::this_thread::yield();
+    }
+    PipelineProduceResult result =
+        continuation.Complete(std::make_unique<int>(i));
+    ASSERT_EQ(result.success, true);
+  }
+  consumer.join();
+
+  // Items are consumed in order, though some may have been skipped.
+  ASSERT_TRUE(std::is_sorted(consumed.begin(), consumed.end()));
+  ASSERT_EQ(consumed.size() + pipeline->GetStats().discarded_count, 100u);
+  ASSERT_EQ(pipeline->GetInflightCount(), 0);
+}
+
+TEST(PipelineTest, RecordsStageLatencies) {
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(2);
+  const auto delay = fml::TimeDelta::FromMilliseconds(2);
+
+  Continuation continuation = pipeline->Produce();
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  PipelineProduceResult result =
+      continuation.Complete(std::make_unique<int>(1));
+  ASSERT_EQ(result.success, true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  PipelineConsumeResult consume_result =
+      pipeline->Consume([](std::unique_ptr<int> v) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+
+  PipelineStats stats = pipeline->GetStats();
+  for (const PipelineStageStats* stage :
+       {&stats.produce, &stats.wait, &stats.consume}) {
+    ASSERT_EQ(stage->count, 1u);
+    ASSERT_GE(stage->last, delay);
+    ASSERT_EQ(stage->max, stage->last);
+    ASSERT_EQ(stage->Average(), stage->last);
+  }
+  ASSERT_EQ(stats.discarded_count, 0u);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -97,6 +97,10 @@ std::shared_ptr<impeller::Context> PlatformView::GetImpellerContext() const {
   return nullptr;
 }
 
+bool PlatformView::PrecompilesKnownSkSLs() const {
+  return !delegate_.OnPlatformViewGetSettings().enable_software_rendering;
+}
+
 void PlatformView::ReleaseResourceContext() const {}
 
 PointerDataDispatcherMaker PlatformView::GetDispatcherMaker() {
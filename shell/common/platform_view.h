@@ -532,6 +532,18 @@ class PlatformView {
 
   virtual std::shared_ptr<impeller::Context> GetImpellerContext() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Whether the surfaces of this platform view precompile the
+  ///             known SkSLs of the persistent cache, which the OpenGL and
+  ///             Metal surfaces of Skia do. The shell only loads the SkSLs
+  ///             ahead of time for those.
+  ///
+  ///             The default implementation returns `true` unless software
+  ///             rendering is enabled in the settings, which is how the
+  ///             platforms that default to OpenGL or Metal opt out of them.
+  ///
+  virtual bool PrecompilesKnownSkSLs() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Used by the shell to notify the embedder that the resource
   ///             context previously obtained via a call to
@@ -15,6 +15,11 @@ SmoothPointerDataDispatcher::SmoothPointerDataDispatcher(Delegate& delegate)
     : DefaultPointerDataDispatcher(delegate), weak_factory_(this) {}
 SmoothPointerDataDispatcher::~SmoothPointerDataDispatcher() = default;
 
+ResamplingPointerDataDispatcher::ResamplingPointerDataDispatcher(
+    Delegate& delegate)
+    : DefaultPointerDataDispatcher(delegate), weak_factory_(this) {}
+ResamplingPointerDataDispatcher::~ResamplingPointerDataDispatcher() = default;
+
 void DefaultPointerDataDispatcher::DispatchPacket(
     std::unique_ptr<PointerDataPacket> packet,
     uint64_t trace_flow_id) {
@@ -68,4 +73,65 @@ void SmoothPointerDataDispatcher::DispatchPendingPacket() {
   ScheduleSecondaryVsyncCallback();
 }
 
+void ResamplingPointerDataDispatcher::DispatchPacket(
+    std::unique_ptr<PointerDataPacket> packet,
+    uint64_t trace_flow_id) {
+  TRACE_EVENT0("flutter", "ResamplingPointerDataDispatcher::DispatchPacket");
+  TRACE_FLOW_STEP("flutter", "PointerEvent", trace_flow_id);
+  resampler_.AddPacket(*packet);
+  pending_trace_flow_ids_.push_back(trace_flow_id);
+  ScheduleSecondaryVsyncCallback();
+}
+
+void ResamplingPointerDataDispatcher::ScheduleSecondaryVsyncCallback() {
+  if (is_callback_scheduled_) {
+    return;
+  }
+  is_callback_scheduled_ = true;
+  delegate_.ScheduleSecondaryVsyncCallback(
+      reinterpret_cast<uintptr_t>(this),
+      [dispatcher = weak_factory_.GetWeakPtr()]() {
+        if (dispatcher) {
+          dispatcher->is_callback_scheduled_ = false;
+          dispatcher->DispatchResampledPackets();
+        }
+      });
+}
+
+void ResamplingPointerDataDispatcher::DispatchResampledPackets() {
+  TRACE_EVENT0("flutter",
+               "ResamplingPointerDataDispatcher::DispatchResampledPackets");
+  const int64_t sample_time =
+      delegate_.GetLastVsyncTargetTime().ToEpochDelta().ToMicroseconds();
+  std::unique_ptr<PointerDataPacket> packet = resampler_.Resample(sample_time);
+
+  if (packet->data().empty()) {
+    for (uint64_t trace_flow_id : pending_trace_flow_ids_) {
+      TRACE_FLOW_END("flutter", "PointerEvent", trace_flow_id);
+    }
+  } else {
+    // The packets of the frame are dispatched as one, which continues the
+    // flow of the first of them and ends the others. Moves that are resampled
+    // again by a later frame have no packet of their own, so they get a new
+    // flow.
+    uint64_t trace_flow_id;
+    if (pending_trace_flow_ids_.empty()) {
+      trace_flow_id = fml::tracing::TraceNonce();
+      TRACE_FLOW_BEGIN("flutter", "PointerEvent", trace_flow_id);
+    } else {
+      trace_flow_id = pending_trace_flow_ids_.front();
+      for (size_t i = 1; i < pending_trace_flow_ids_.size(); i++) {
+        TRACE_FLOW_END("flutter", "PointerEvent", pending_trace_flow_ids_[i]);
+      }
+    }
+    DefaultPointerDataDispatcher::DispatchPacket(std::move(packet),
+                                                 trace_flow_id);
+  }
+  pending_trace_flow_ids_.clear();
+
+  if (resampler_.HasPendingEvents()) {
+    ScheduleSecondaryVsyncCallback();
+  }
+}
+
 }  // namespace flutter
@@ -5,6 +5,9 @@
 #ifndef POINTER_DATA_DISPATCHER_H_
 #define POINTER_DATA_DISPATCHER_H_
 
+#include <vector>
+
+#include "flutter/lib/ui/window/pointer_data_resampler.h"
 #include "flutter/runtime/runtime_controller.h"
 #include "flutter/shell/common/animator.h"
 
@@ -64,6 +67,14 @@ class PointerDataDispatcher {
     virtual void ScheduleSecondaryVsyncCallback(
         uintptr_t id,
         const fml::closure& callback) = 0;
+
+    //--------------------------------------------------------------------------
+    /// @brief    The target time of the latest vsync, which is the time the
+    ///           frame that is being produced for it is displayed.
+    ///
+    ///           This is used by `ResamplingPointerDataDispatcher` to resample
+    ///           the pointer events to the time they are displayed.
+    virtual fml::TimePoint GetLastVsyncTargetTime() = 0;
   };
 
   //----------------------------------------------------------------------------
@@ -163,6 +174,43 @@ class SmoothPointerDataDispatcher : public DefaultPointerDataDispatcher {
   FML_DISALLOW_COPY_AND_ASSIGN(SmoothPointerDataDispatcher);
 };
 
+//------------------------------------------------------------------------------
+/// A dispatcher that dispatches the packets it receives once per vsync, with
+/// the moves of each pointer resampled to the target time of the vsync. See
+/// `PointerDataResampler` for how the moves are resampled.
+///
+/// Touch panels and styluses that report positions at rates above the refresh
+/// rate deliver several moves per frame. Without resampling, the framework
+/// handles each of them, and the position a frame shows depends on when the
+/// latest sample happened to arrive rather than on when the frame is shown.
+///
+/// Resampling adds up to a frame of latency to the events that are not moves,
+/// so it is only used when `Settings::resample_pointer_events` is set.
+class ResamplingPointerDataDispatcher : public DefaultPointerDataDispatcher {
+ public:
+  explicit ResamplingPointerDataDispatcher(Delegate& delegate);
+
+  // |PointerDataDispatcer|
+  void DispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                      uint64_t trace_flow_id) override;
+
+  virtual ~ResamplingPointerDataDispatcher();
+
+ private:
+  void DispatchResampledPackets();
+  void ScheduleSecondaryVsyncCallback();
+
+  PointerDataResampler resampler_;
+  // The flows of the packets that were added to |resampler_| since the last
+  // dispatch.
+  std::vector<uint64_t> pending_trace_flow_ids_;
+  bool is_callback_scheduled_ = false;
+
+  // WeakPtrFactory must be the last member.
+  fml::WeakPtrFactory<ResamplingPointerDataDispatcher> weak_factory_;
+  FML_DISALLOW_COPY_AND_ASSIGN(ResamplingPointerDataDispatcher);
+};
+
 //--------------------------------------------------------------------------
 /// @brief      Signature for constructing PointerDataDispatcher.
 ///
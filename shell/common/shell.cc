@@ -5,6 +5,7 @@
 #define RAPIDJSON_HAS_STDSTRING 1
 #include "flutter/shell/common/shell.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <vector>
@@ -17,6 +18,7 @@
 #include "flutter/fml/log_settings.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/make_copyable.h"
+#include "flutter/fml/mapping.h"
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
@@ -120,6 +122,19 @@ void PerformInitializationTasks(Settings& settings) {
   PersistentCache::SetCacheSkSL(settings.cache_sksl);
 }
 
+// Has the OS read the given assets into memory ahead of the threads that
+// need them. The mappings themselves are dropped right away.
+void PrefetchAssets(const AssetManager& asset_manager,
+                    const std::vector<std::string>& asset_names) {
+  StartupProfile::ScopedNoRecording no_recording;
+  for (const auto& asset_name : asset_names) {
+    auto mapping = asset_manager.GetAsMapping(asset_name);
+    if (mapping) {
+      mapping->Advise(fml::Mapping::Advice::kWillNeed);
+    }
+  }
+}
+
 }  // namespace
 
 std::unique_ptr<Shell> Shell::Create(
@@ -190,6 +205,10 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
                     !settings.skia_deterministic_rendering_on_cpu),
                 is_gpu_disabled));
 
+  if (settings.enable_startup_profile) {
+    shell->StartStartupProfile();
+  }
+
   // Create the rasterizer on the raster thread.
   std::promise<std::unique_ptr<Rasterizer>> rasterizer_promise;
   auto rasterizer_future = rasterizer_promise.get_future();
@@ -202,12 +221,31 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
                                            shell = shell.get()    //
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupGPUSubsystem");
+        const fml::TimePoint start = fml::TimePoint::Now();
         std::unique_ptr<Rasterizer> rasterizer(on_create_rasterizer(*shell));
+        RasterCache& raster_cache =
+            rasterizer->compositor_context()->raster_cache();
+        const Settings& settings = shell->GetSettings();
+        if (settings.enable_async_raster_cache && shell->GetDartVM()) {
+          raster_cache.SetAsyncTaskRunner(
+              shell->GetDartVM()->GetConcurrentWorkerTaskRunner());
+        }
+        if (settings.raster_cache_byte_budget > 0) {
+          raster_cache.SetEvictionPolicy(
+              std::make_unique<CostAwareEvictionPolicy>(
+                  settings.raster_cache_byte_budget));
+        }
+        if (settings.enable_raster_cache_atlas) {
+          raster_cache.SetAtlas(std::make_unique<RasterCacheAtlas>());
+        }
         snapshot_delegate_promise.set_value(rasterizer->GetSnapshotDelegate());
         rasterizer_promise.set_value(std::move(rasterizer));
+        shell->startup_orchestrator_->RecordStage(
+            "ShellSetupGPUSubsystem", start, fml::TimePoint::Now());
       });
 
   // Create the platform view on the platform thread (this thread).
+  const fml::TimePoint platform_view_start = fml::TimePoint::Now();
   auto platform_view = on_create_platform_view(*shell.get());
   if (!platform_view || !platform_view->GetWeakPtr()) {
     return nullptr;
@@ -219,6 +257,8 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   if (!vsync_waiter) {
     return nullptr;
   }
+  shell->startup_orchestrator_->RecordStage(
+      "ShellSetupPlatformView", platform_view_start, fml::TimePoint::Now());
 
   // Create the IO manager on the IO thread. The IO manager must be initialized
   // first because it has state that the other subsystems depend on. It must
@@ -243,9 +283,11 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
        &unref_queue_promise,                                              //
        platform_view_ptr,                                                 //
        io_task_runner,                                                    //
+       orchestrator = shell->startup_orchestrator_.get(),                 //
        is_backgrounded_sync_switch = shell->GetIsGpuDisabledSyncSwitch()  //
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupIOSubsystem");
+        const fml::TimePoint start = fml::TimePoint::Now();
         std::shared_ptr<ShellIOManager> io_manager;
         if (parent_io_manager) {
           io_manager = parent_io_manager;
@@ -260,11 +302,18 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
         weak_io_manager_promise.set_value(io_manager->GetWeakPtr());
         unref_queue_promise.set_value(io_manager->GetSkiaUnrefQueue());
         io_manager_promise.set_value(io_manager);
+        orchestrator->RecordStage("ShellSetupIOSubsystem", start,
+                                  fml::TimePoint::Now());
       });
 
   // Send dispatcher_maker to the engine constructor because shell won't have
   // platform_view set until Shell::Setup is called later.
   auto dispatcher_maker = platform_view->GetDispatcherMaker();
+  if (shell->GetSettings().resample_pointer_events) {
+    dispatcher_maker = [](PointerDataDispatcher::Delegate& delegate) {
+      return std::make_unique<ResamplingPointerDataDispatcher>(delegate);
+    };
+  }
 
   // Create the engine on the UI thread.
   std::promise<std::unique_ptr<Engine>> engine_promise;
@@ -282,12 +331,18 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
                          &unref_queue_future,                             //
                          &on_create_engine]() mutable {
         TRACE_EVENT0("flutter", "ShellSetupUISubsystem");
+        const fml::TimePoint start = fml::TimePoint::Now();
         const auto& task_runners = shell->GetTaskRunners();
 
         // The animator is owned by the UI thread but it gets its vsync pulses
         // from the platform.
-        auto animator = std::make_unique<Animator>(*shell, task_runners,
-                                                   std::move(vsync_waiter));
+        const Settings& settings = shell->GetSettings();
+        auto animator = std::make_unique<Animator>(
+            *shell, task_runners, std::move(vsync_waiter),
+            settings.raster_pipeline_depth,
+            settings.discard_stale_frames
+                ? PipelineDiscardPolicy::kKeepNewest
+                : PipelineDiscardPolicy::kKeepAll);
 
         engine_promise.set_value(
             on_create_engine(*shell,                          //
@@ -302,6 +357,8 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
                              unref_queue_future.get(),        //
                              snapshot_delegate_future.get(),  //
                              shell->volatile_path_tracker_));
+        shell->startup_orchestrator_->RecordStage(
+            "ShellSetupUISubsystem", start, fml::TimePoint::Now());
       }));
 
   if (!shell->Setup(std::move(platform_view),  //
@@ -399,6 +456,8 @@ Shell::Shell(DartVMRef vm,
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
   display_manager_ = std::make_unique<DisplayManager>();
+  startup_orchestrator_ = std::make_unique<StartupOrchestrator>(
+      vm_->GetConcurrentWorkerTaskRunner());
   resource_cache_limit_calculator->AddResourceCacheLimitItem(
       weak_factory_.GetWeakPtr());
 
@@ -588,6 +647,9 @@ void Shell::RunEngine(
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
+  PrepareKnownSkSLs();
+  PrefetchStartupProfileAssets(run_configuration.GetAssetManager());
+
   fml::TaskRunner::RunNowOrPostTask(
       task_runners_.GetUITaskRunner(),
       fml::MakeCopyable(
@@ -1394,6 +1456,112 @@ void Shell::ReportTimings() {
   });
 }
 
+void Shell::StartStartupProfile() {
+  FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
+  // The profile covers the startup of the process, so shells spawned later
+  // neither replay nor record one.
+  static std::atomic_flag started = ATOMIC_FLAG_INIT;
+  if (started.test_and_set()) {
+    return;
+  }
+  auto cache_directory =
+      PersistentCache::GetCacheForProcess()->GetCacheDirectory();
+  if (!cache_directory) {
+    return;
+  }
+
+  auto replayed = std::make_shared<StartupProfile>();
+  replayed_startup_profile_ = replayed;
+  load_startup_profile_stage_ = startup_orchestrator_->AddStage(
+      "LoadStartupProfile",
+      [replayed, cache_directory]() { replayed->Load(*cache_directory); });
+  startup_orchestrator_->AddStage(
+      "PrefetchShaders",
+      [replayed]() {
+        PersistentCache::GetCacheForProcess()->Prefetch(
+            replayed->Get(StartupProfile::Kind::kShader));
+      },
+      {load_startup_profile_stage_});
+
+  recorded_startup_profile_ = std::make_shared<StartupProfile>();
+  StartupProfile::SetRecording(recorded_startup_profile_);
+}
+
+void Shell::PrepareKnownSkSLs() {
+  // Impeller does not precompile SkSLs, and neither do the software and
+  // Vulkan surfaces. The prepared SkSLs would be kept for nothing.
+  if (settings_.enable_impeller || !platform_view_ ||
+      !platform_view_->PrecompilesKnownSkSLs()) {
+    return;
+  }
+  std::vector<StartupOrchestrator::StageId> dependencies;
+  if (replayed_startup_profile_) {
+    dependencies.push_back(load_startup_profile_stage_);
+  }
+  startup_orchestrator_->AddStage(
+      "PrepareKnownSkSLs",
+      [replayed = replayed_startup_profile_]() {
+        PersistentCache::GetCacheForProcess()->PrepareKnownSkSLs(
+            replayed ? replayed->Get(StartupProfile::Kind::kShader)
+                     : std::vector<std::string>{});
+      },
+      dependencies);
+}
+
+void Shell::PrefetchStartupProfileAssets(
+    const std::shared_ptr<AssetManager>& asset_manager) {
+  if (!replayed_startup_profile_ || !asset_manager) {
+    return;
+  }
+  auto replayed = std::move(replayed_startup_profile_);
+  startup_orchestrator_->AddStage(
+      "PrefetchFonts",
+      [replayed, asset_manager]() {
+        PrefetchAssets(*asset_manager,
+                       replayed->Get(StartupProfile::Kind::kFont));
+      },
+      {load_startup_profile_stage_});
+  startup_orchestrator_->AddStage(
+      "PrefetchAssets",
+      [replayed, asset_manager]() {
+        // Fonts are loaded through the asset manager too, so they are also
+        // listed as assets.
+        auto fonts = replayed->Get(StartupProfile::Kind::kFont);
+        std::vector<std::string> assets;
+        for (auto& asset : replayed->Get(StartupProfile::Kind::kAsset)) {
+          if (std::find(fonts.begin(), fonts.end(), asset) == fonts.end()) {
+            assets.push_back(std::move(asset));
+          }
+        }
+        PrefetchAssets(*asset_manager, assets);
+      },
+      {load_startup_profile_stage_});
+}
+
+void Shell::FinishStartup() {
+  startup_orchestrator_->TraceTimeline(fml::TimePoint::Now());
+  if (replayed_startup_profile_) {
+    // The shaders the first frame did not load are not kept in memory.
+    PersistentCache::GetCacheForProcess()->DiscardPrefetched();
+  }
+  if (!recorded_startup_profile_) {
+    return;
+  }
+  StartupProfile::SetRecording(nullptr);
+  auto cache_directory =
+      PersistentCache::GetCacheForProcess()->GetCacheDirectory();
+  if (!cache_directory) {
+    return;
+  }
+  startup_orchestrator_->AddStage(
+      "SaveStartupProfile",
+      [recorded = std::move(recorded_startup_profile_), cache_directory]() {
+        if (!recorded->Save(*cache_directory)) {
+          FML_LOG(WARNING) << "Could not save the startup profile.";
+        }
+      });
+}
+
 size_t Shell::UnreportedFramesCount() const {
   // Check that this is running on the raster thread to avoid race conditions.
   FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
@@ -1411,6 +1579,16 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
     settings_.frame_rasterized_callback(timing);
   }
 
+  if (!startup_traced_) {
+    // How much of the data loaded during startup, such as snapshots and
+    // assets, was used in place from file mappings and how much was copied.
+    startup_traced_ = true;
+    FML_TRACE_COUNTER("flutter", "StartupLoadedBytes", 0,             //
+                      "mapped", fml::Mapping::GetFileMappedBytes(),  //
+                      "copied", fml::Mapping::GetCopiedBytes());
+    FinishStartup();
+  }
+
   if (!needs_report_timings_) {
     return;
   }
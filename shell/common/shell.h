@@ -13,6 +13,7 @@
 #include "flutter/assets/directory_asset_bundle.h"
 #include "flutter/common/graphics/texture.h"
 #include "flutter/common/settings.h"
+#include "flutter/common/startup_profile.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/closure.h"
@@ -40,6 +41,7 @@
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/resource_cache_limit_calculator.h"
 #include "flutter/shell/common/shell_io_manager.h"
+#include "flutter/shell/common/startup_orchestrator.h"
 
 namespace flutter {
 
@@ -445,6 +447,20 @@ class Shell final : public PlatformView::Delegate,
   uint64_t next_pointer_flow_id_ = 0;
 
   bool first_frame_rasterized_ = false;
+  // Whether the bytes loaded and the timeline of the startup have been
+  // traced, which happens once the first frame has been rasterized.
+  bool startup_traced_ = false;
+
+  // Runs the parts of the startup that can happen on worker threads and
+  // keeps the timeline of the startup. Thread safe.
+  std::unique_ptr<StartupOrchestrator> startup_orchestrator_;
+  // The profile recorded by the previous launch, which the stage
+  // |load_startup_profile_stage_| loads. Only set until the assets it lists
+  // are prefetched, and only if |Settings::enable_startup_profile| is set.
+  std::shared_ptr<StartupProfile> replayed_startup_profile_;
+  StartupOrchestrator::StageId load_startup_profile_stage_ = 0;
+  // The profile recorded by this launch until the first frame.
+  std::shared_ptr<StartupProfile> recorded_startup_profile_;
   std::atomic<bool> waiting_for_first_frame_ = true;
   std::mutex waiting_for_first_frame_mutex_;
   std::condition_variable waiting_for_first_frame_condition_;
@@ -525,6 +541,23 @@ class Shell final : public PlatformView::Delegate,
 
   void ReportTimings();
 
+  // Starts loading what the profile of the previous launch lists on worker
+  // threads, and starts recording the profile of this launch.
+  void StartStartupProfile();
+
+  // Loads the SkSLs to precompile on a worker, ordered by when the previous
+  // launch first used them, before the rendering context asks for them.
+  void PrepareKnownSkSLs();
+
+  // Prefetches the fonts and assets the profile of the previous launch
+  // lists from the |asset_manager| the engine is run with.
+  void PrefetchStartupProfileAssets(
+      const std::shared_ptr<AssetManager>& asset_manager);
+
+  // Traces the timeline of the startup and saves the profile this launch
+  // recorded. Called once the first frame has been rasterized.
+  void FinishStartup();
+
   // |PlatformView::Delegate|
   void OnPlatformViewCreated(std::unique_ptr<Surface> surface) override;
 
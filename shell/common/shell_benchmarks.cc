@@ -6,9 +6,12 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/make_copyable.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/run_configuration.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/elf_loader.h"
+#include "flutter/testing/fixture_test.h"
 #include "flutter/testing/testing.h"
 
 namespace flutter {
@@ -120,4 +123,116 @@ static void BM_ShellInitializationAndShutdown(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitializationAndShutdown);
 
+namespace {
+
+class PlatformMessageFixture : public testing::FixtureTest {
+  void TestBody() override{};
+};
+
+class SignalingPlatformMessageResponse : public PlatformMessageResponse {
+ public:
+  explicit SignalingPlatformMessageResponse(fml::AutoResetWaitableEvent& latch)
+      : latch_(latch) {}
+
+  void Complete(std::unique_ptr<fml::Mapping> data) override {
+    latch_.Signal();
+  }
+
+  void CompleteEmpty() override { latch_.Signal(); }
+
+ private:
+  fml::AutoResetWaitableEvent& latch_;
+};
+
+}  // namespace
+
+// Sends messages from the platform thread to a Dart handler that responds
+// right away, and waits for each response.
+static void SendPlatformMessages(benchmark::State& state, bool copy) {
+  PlatformMessageFixture fixture;
+  fml::AutoResetWaitableEvent ready;
+  fixture.AddNativeCallback("NotifyNative",
+                            CREATE_NATIVE_ENTRY([&ready](Dart_NativeArguments) {
+                              ready.Signal();
+                            }));
+  Settings settings = fixture.CreateSettingsForFixture();
+  ThreadHost thread_host(ThreadHost::ThreadHostConfig(
+      "io.flutter.bench.", ThreadHost::Type::Platform |
+                               ThreadHost::Type::RASTER |
+                               ThreadHost::Type::IO | ThreadHost::Type::UI));
+  TaskRunners task_runners("test",
+                           thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  std::unique_ptr<Shell> shell = Shell::Create(
+      flutter::PlatformData(), task_runners, settings,
+      [](Shell& shell) {
+        return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
+      },
+      [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+  FML_CHECK(shell);
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("platformMessageSink");
+  fml::TaskRunner::RunNowOrPostTask(
+      task_runners.GetPlatformTaskRunner(), [&shell, &configuration]() {
+        shell->RunEngine(std::move(configuration));
+      });
+  ready.Wait();
+
+  const size_t size = state.range(0);
+  std::vector<uint8_t> payload(size, 0x2a);
+  fml::AutoResetWaitableEvent responded;
+  for ([[maybe_unused]] auto _ : state) {
+    auto response =
+        fml::MakeRefCounted<SignalingPlatformMessageResponse>(responded);
+    std::unique_ptr<PlatformMessage> message;
+    if (copy) {
+      // What embedders that do not hand over their buffers pay.
+      message = std::make_unique<PlatformMessage>(
+          "benchmark", fml::MallocMapping::Copy(payload.data(), size),
+          response);
+    } else {
+      message = std::make_unique<PlatformMessage>(
+          "benchmark",
+          std::make_unique<fml::NonOwnedMapping>(payload.data(), size),
+          response);
+    }
+    fml::TaskRunner::RunNowOrPostTask(
+        task_runners.GetPlatformTaskRunner(),
+        fml::MakeCopyable([&shell, message = std::move(message)]() mutable {
+          shell->GetPlatformView()->DispatchPlatformMessage(std::move(message));
+        }));
+    responded.Wait();
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+
+  fml::AutoResetWaitableEvent shutdown;
+  fml::TaskRunner::RunNowOrPostTask(task_runners.GetPlatformTaskRunner(),
+                                    [&shell, &shutdown]() {
+                                      shell.reset();
+                                      shutdown.Signal();
+                                    });
+  shutdown.Wait();
+}
+
+static void BM_PlatformMessageCopied(benchmark::State& state) {
+  SendPlatformMessages(state, true);
+}
+
+static void BM_PlatformMessageInPlace(benchmark::State& state) {
+  SendPlatformMessages(state, false);
+}
+
+BENCHMARK(BM_PlatformMessageCopied)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 64 << 20)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_PlatformMessageInPlace)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 64 << 20)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
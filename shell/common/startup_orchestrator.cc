@@ -0,0 +1,170 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/startup_orchestrator.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+struct StartupOrchestrator::Stage {
+  const char* name;
+  fml::closure task;
+  size_t pending_dependencies = 0;
+  std::vector<StageId> dependents;
+  bool finished = false;
+};
+
+struct StartupOrchestrator::State {
+  explicit State(std::shared_ptr<fml::ConcurrentTaskRunner> worker)
+      : worker_task_runner(std::move(worker)) {}
+
+  const std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner;
+  std::mutex mutex;
+  std::condition_variable stages_finished;
+  std::vector<Stage> stages;
+  size_t unfinished_stages = 0;
+  std::vector<StageTiming> timeline;
+};
+
+StartupOrchestrator::StartupOrchestrator(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner)
+    : creation_time_(fml::TimePoint::Now()),
+      state_(std::make_shared<State>(std::move(worker_task_runner))) {}
+
+// Stages that are still running keep the state alive and finish on their
+// own.
+StartupOrchestrator::~StartupOrchestrator() = default;
+
+StartupOrchestrator::StageId StartupOrchestrator::AddStage(
+    const char* name,
+    const fml::closure& task,
+    const std::vector<StageId>& dependencies) {
+  StageId stage_id;
+  bool ready;
+  {
+    std::scoped_lock lock(state_->mutex);
+    stage_id = state_->stages.size();
+    Stage stage;
+    stage.name = name;
+    stage.task = task;
+    for (StageId dependency : dependencies) {
+      FML_DCHECK(dependency < stage_id);
+      Stage& dependency_stage = state_->stages[dependency];
+      if (!dependency_stage.finished) {
+        dependency_stage.dependents.push_back(stage_id);
+        stage.pending_dependencies++;
+      }
+    }
+    ready = stage.pending_dependencies == 0;
+    state_->stages.push_back(std::move(stage));
+    state_->unfinished_stages++;
+  }
+  if (ready) {
+    Schedule(state_, stage_id);
+  }
+  return stage_id;
+}
+
+void StartupOrchestrator::Schedule(const std::shared_ptr<State>& state,
+                                   StageId stage_id) {
+  if (!state->worker_task_runner) {
+    Run(state, stage_id);
+    return;
+  }
+  // The first frame usually waits on what the stages prepare, so they go
+  // ahead of background work on the workers.
+  state->worker_task_runner->PostTask(
+      [state, stage_id]() { Run(state, stage_id); },
+      fml::ConcurrentTaskPriority::kHigh);
+}
+
+void StartupOrchestrator::Run(const std::shared_ptr<State>& state,
+                              StageId stage_id) {
+  const char* name;
+  fml::closure task;
+  {
+    std::scoped_lock lock(state->mutex);
+    name = state->stages[stage_id].name;
+    task = std::move(state->stages[stage_id].task);
+  }
+
+  const fml::TimePoint start = fml::TimePoint::Now();
+  {
+    TRACE_EVENT0("flutter", name);
+    if (task) {
+      task();
+    }
+  }
+  const fml::TimePoint end = fml::TimePoint::Now();
+
+  std::vector<StageId> ready;
+  {
+    std::scoped_lock lock(state->mutex);
+    Stage& stage = state->stages[stage_id];
+    stage.finished = true;
+    for (StageId dependent : stage.dependents) {
+      if (--state->stages[dependent].pending_dependencies == 0) {
+        ready.push_back(dependent);
+      }
+    }
+    stage.dependents.clear();
+  }
+
+  // The dependents are posted before the stage counts as finished, so that
+  // nothing is posted to the workers once |Wait| has returned and their
+  // owner may be shutting them down.
+  for (StageId dependent : ready) {
+    Schedule(state, dependent);
+  }
+
+  {
+    std::scoped_lock lock(state->mutex);
+    state->timeline.push_back({name, start, end});
+    state->unfinished_stages--;
+  }
+  state->stages_finished.notify_all();
+}
+
+void StartupOrchestrator::RecordStage(const char* name,
+                                      fml::TimePoint start,
+                                      fml::TimePoint end) {
+  std::scoped_lock lock(state_->mutex);
+  state_->timeline.push_back({name, start, end});
+}
+
+void StartupOrchestrator::Wait() {
+  std::unique_lock lock(state_->mutex);
+  state_->stages_finished.wait(
+      lock, [state = state_.get()] { return state->unfinished_stages == 0; });
+}
+
+std::vector<StartupOrchestrator::StageTiming>
+StartupOrchestrator::GetTimeline() const {
+  std::vector<StageTiming> timeline;
+  {
+    std::scoped_lock lock(state_->mutex);
+    timeline = state_->timeline;
+  }
+  std::stable_sort(timeline.begin(), timeline.end(),
+                   [](const StageTiming& a, const StageTiming& b) {
+                     return a.start < b.start;
+                   });
+  return timeline;
+}
+
+void StartupOrchestrator::TraceTimeline(fml::TimePoint end) const {
+  fml::tracing::TraceEventAsyncComplete("flutter", "StartupTimeToFirstFrame",
+                                        creation_time_, end);
+  for (const StageTiming& stage : GetTimeline()) {
+    fml::tracing::TraceEventAsyncComplete("flutter", "StartupStage",
+                                          stage.start, stage.end,  //
+                                          "name", stage.name);
+  }
+}
+
+}  // namespace flutter
@@ -0,0 +1,104 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_STARTUP_ORCHESTRATOR_H_
+#define FLUTTER_SHELL_COMMON_STARTUP_ORCHESTRATOR_H_
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Runs the stages of the startup of a shell that do not depend
+///             on each other in parallel on a worker pool, and keeps a
+///             timeline of when each stage of the startup ran.
+///
+///             Stages may be added at any time and from any thread. A stage
+///             runs as soon as all of the stages it depends on have finished.
+///             The work that has to happen on one of the threads of the
+///             shell, like creating the rasterizer, is not run by the
+///             orchestrator but may be recorded into its timeline.
+///
+class StartupOrchestrator {
+ public:
+  using StageId = size_t;
+
+  struct StageTiming {
+    const char* name;
+    fml::TimePoint start;
+    fml::TimePoint end;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @param[in]  worker_task_runner  The workers to run stages on. If this is
+  ///                                 nullptr, stages run on the thread that
+  ///                                 made them ready to run.
+  ///
+  explicit StartupOrchestrator(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner);
+
+  ~StartupOrchestrator();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds a stage that runs |task| on a worker once all of the
+  ///             |dependencies| have finished.
+  ///
+  /// @param[in]  name          The name of the stage in traces and in the
+  ///                           timeline. Must outlive the orchestrator.
+  /// @param[in]  task          The work of the stage.
+  /// @param[in]  dependencies  Stages returned by earlier calls to |AddStage|.
+  ///
+  StageId AddStage(const char* name,
+                   const fml::closure& task,
+                   const std::vector<StageId>& dependencies = {});
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds a stage that ran outside of the orchestrator to the
+  ///             timeline.
+  ///
+  void RecordStage(const char* name, fml::TimePoint start, fml::TimePoint end);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Blocks until all of the stages that were added have
+  ///             finished.
+  ///
+  void Wait();
+
+  //----------------------------------------------------------------------------
+  /// @brief      The stages that have finished or were recorded so far,
+  ///             ordered by the time they started.
+  ///
+  std::vector<StageTiming> GetTimeline() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds the timeline to the trace, along with the time it took
+  ///             from the creation of the orchestrator to |end|.
+  ///
+  void TraceTimeline(fml::TimePoint end) const;
+
+ private:
+  struct Stage;
+  struct State;
+
+  static void Schedule(const std::shared_ptr<State>& state, StageId stage_id);
+
+  static void Run(const std::shared_ptr<State>& state, StageId stage_id);
+
+  const fml::TimePoint creation_time_;
+  std::shared_ptr<State> state_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(StartupOrchestrator);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_STARTUP_ORCHESTRATOR_H_
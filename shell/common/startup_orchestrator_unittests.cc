@@ -0,0 +1,133 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/startup_orchestrator.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "flutter/common/startup_profile.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(StartupOrchestratorTest, RunsStagesAfterTheirDependencies) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  StartupOrchestrator orchestrator(loop->GetTaskRunner());
+  std::atomic<int> first_done = 0;
+  std::atomic<int> second_saw = -1;
+  std::atomic<int> third_saw = -1;
+
+  auto first = orchestrator.AddStage("First", [&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    first_done = 1;
+  });
+  auto second = orchestrator.AddStage(
+      "Second", [&]() { second_saw = first_done.load(); }, {first});
+  orchestrator.AddStage(
+      "Third", [&]() { third_saw = first_done.load(); }, {first, second});
+  orchestrator.Wait();
+
+  EXPECT_EQ(second_saw, 1);
+  EXPECT_EQ(third_saw, 1);
+  EXPECT_EQ(orchestrator.GetTimeline().size(), 3u);
+}
+
+TEST(StartupOrchestratorTest, RunsIndependentStagesInParallel) {
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  StartupOrchestrator orchestrator(loop->GetTaskRunner());
+  // Each stage waits for the other one to start, which only finishes if they
+  // run at the same time.
+  fml::CountDownLatch latch(2);
+  orchestrator.AddStage("A", [&]() {
+    latch.CountDown();
+    latch.Wait();
+  });
+  orchestrator.AddStage("B", [&]() {
+    latch.CountDown();
+    latch.Wait();
+  });
+  orchestrator.Wait();
+  EXPECT_EQ(orchestrator.GetTimeline().size(), 2u);
+}
+
+TEST(StartupOrchestratorTest, RunsStagesAddedAfterTheirDependenciesFinished) {
+  StartupOrchestrator orchestrator(nullptr);
+  bool ran = false;
+  auto first = orchestrator.AddStage("First", []() {});
+  orchestrator.AddStage("Second", [&]() { ran = true; }, {first});
+  EXPECT_TRUE(ran);
+}
+
+TEST(StartupOrchestratorTest, TimelineIsOrderedByStartTime) {
+  StartupOrchestrator orchestrator(nullptr);
+  const fml::TimePoint now = fml::TimePoint::Now();
+  orchestrator.RecordStage("Later", now + fml::TimeDelta::FromSeconds(1),
+                           now + fml::TimeDelta::FromSeconds(2));
+  orchestrator.RecordStage("Earlier", now - fml::TimeDelta::FromSeconds(1),
+                           now);
+  auto timeline = orchestrator.GetTimeline();
+  ASSERT_EQ(timeline.size(), 2u);
+  EXPECT_EQ(std::strcmp(timeline[0].name, "Earlier"), 0);
+  EXPECT_EQ(std::strcmp(timeline[1].name, "Later"), 0);
+}
+
+TEST(StartupProfileTest, SavesAndLoadsEntries) {
+  fml::ScopedTemporaryDirectory directory;
+  StartupProfile profile;
+  profile.Add(StartupProfile::Kind::kAsset, "assets/logo.png");
+  profile.Add(StartupProfile::Kind::kFont, "fonts/Roboto.ttf");
+  profile.Add(StartupProfile::Kind::kShader, "ABCDEFGH");
+  profile.Add(StartupProfile::Kind::kAsset, "assets/logo.png");
+  profile.Add(StartupProfile::Kind::kAsset, "multi\nline");
+  EXPECT_EQ(profile.GetEntryCount(), 3u);
+  ASSERT_TRUE(profile.Save(directory.fd()));
+
+  StartupProfile loaded;
+  ASSERT_TRUE(loaded.Load(directory.fd()));
+  EXPECT_EQ(loaded.Get(StartupProfile::Kind::kAsset),
+            std::vector<std::string>{"assets/logo.png"});
+  EXPECT_EQ(loaded.Get(StartupProfile::Kind::kFont),
+            std::vector<std::string>{"fonts/Roboto.ttf"});
+  EXPECT_EQ(loaded.Get(StartupProfile::Kind::kShader),
+            std::vector<std::string>{"ABCDEFGH"});
+}
+
+TEST(StartupProfileTest, LoadFailsWithoutProfile) {
+  fml::ScopedTemporaryDirectory directory;
+  StartupProfile profile;
+  EXPECT_FALSE(profile.Load(directory.fd()));
+  EXPECT_EQ(profile.GetEntryCount(), 0u);
+}
+
+TEST(StartupProfileTest, RecordsOnlyWhileRecording) {
+  StartupProfile::Record(StartupProfile::Kind::kAsset, "before");
+  auto profile = std::make_shared<StartupProfile>();
+  StartupProfile::SetRecording(profile);
+  StartupProfile::Record(StartupProfile::Kind::kAsset, "during");
+  {
+    StartupProfile::ScopedNoRecording no_recording;
+    StartupProfile::Record(StartupProfile::Kind::kAsset, "replayed");
+  }
+  StartupProfile::SetRecording(nullptr);
+  StartupProfile::Record(StartupProfile::Kind::kAsset, "after");
+  EXPECT_EQ(profile->Get(StartupProfile::Kind::kAsset),
+            std::vector<std::string>{"during"});
+}
+
+TEST(StartupProfileTest, LimitsTheNumberOfEntries) {
+  StartupProfile profile;
+  for (size_t i = 0; i < StartupProfile::kMaxEntriesPerKind + 10; i++) {
+    profile.Add(StartupProfile::Kind::kShader, std::to_string(i));
+  }
+  EXPECT_EQ(profile.GetEntryCount(), StartupProfile::kMaxEntriesPerKind);
+}
+
+}  // namespace testing
+}  // namespace flutter
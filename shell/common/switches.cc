@@ -429,6 +429,31 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.enable_impeller =
       command_line.HasOption(FlagForSwitch(Switch::EnableImpeller));
 
+  settings.enable_async_raster_cache =
+      command_line.HasOption(FlagForSwitch(Switch::EnableAsyncRasterCache));
+
+  settings.enable_raster_cache_atlas =
+      command_line.HasOption(FlagForSwitch(Switch::EnableRasterCacheAtlas));
+
+  settings.enable_concurrent_work_stealing = command_line.HasOption(
+      FlagForSwitch(Switch::EnableConcurrentWorkStealing));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterPipelineDepth))) {
+    std::string raster_pipeline_depth;
+    command_line.GetOptionValue(FlagForSwitch(Switch::RasterPipelineDepth),
+                                &raster_pipeline_depth);
+    settings.raster_pipeline_depth = std::stoul(raster_pipeline_depth);
+  }
+
+  settings.discard_stale_frames =
+      command_line.HasOption(FlagForSwitch(Switch::DiscardStaleFrames));
+
+  settings.enable_startup_profile =
+      command_line.HasOption(FlagForSwitch(Switch::EnableStartupProfile));
+
+  settings.resample_pointer_events =
+      command_line.HasOption(FlagForSwitch(Switch::ResamplePointerEvents));
+
   settings.prefetched_default_font_manager = command_line.HasOption(
       FlagForSwitch(Switch::PrefetchedDefaultFontManager));
 
@@ -475,6 +500,13 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
         std::stoi(resource_cache_max_bytes_threshold);
   }
 
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterCacheByteBudget))) {
+    std::string raster_cache_byte_budget;
+    command_line.GetOptionValue(FlagForSwitch(Switch::RasterCacheByteBudget),
+                                &raster_cache_byte_budget);
+    settings.raster_cache_byte_budget = std::stoull(raster_cache_byte_budget);
+  }
+
   if (command_line.HasOption(FlagForSwitch(Switch::MsaaSamples))) {
     std::string msaa_samples;
     command_line.GetOptionValue(FlagForSwitch(Switch::MsaaSamples),
@@ -236,6 +236,41 @@ DEF_SWITCH(EnableImpeller,
            "enable-impeller",
            "Enable the Impeller renderer on supported platforms. Ignored if "
            "Impeller is not supported on the platform.")
+DEF_SWITCH(EnableAsyncRasterCache,
+           "enable-async-raster-cache",
+           "Rasterize picture raster cache entries on worker threads instead "
+           "of the raster thread.")
+DEF_SWITCH(RasterCacheByteBudget,
+           "raster-cache-byte-budget",
+           "The number of bytes of raster cache images to keep across frames "
+           "that do not use them, weighted by how expensive they were to "
+           "produce. 0, the default, evicts images as soon as they go unused.")
+DEF_SWITCH(EnableRasterCacheAtlas,
+           "enable-raster-cache-atlas",
+           "Pack the images of small raster cache entries into shared atlas "
+           "textures so that they can be drawn without switching textures.")
+DEF_SWITCH(EnableConcurrentWorkStealing,
+           "enable-concurrent-work-stealing",
+           "Give each concurrent worker thread its own task queue and let idle "
+           "workers steal tasks from busy ones.")
+DEF_SWITCH(RasterPipelineDepth,
+           "raster-pipeline-depth",
+           "The number of frames that may be in flight between the UI and the "
+           "raster threads. Depths greater than 2 let the UI thread produce "
+           "frames ahead of vsync. 0, the default, picks the depth based on "
+           "the threading configuration.")
+DEF_SWITCH(DiscardStaleFrames,
+           "discard-stale-frames",
+           "Have a newly built frame replace the frame that is still waiting "
+           "to be rasterized, instead of rasterizing every frame.")
+DEF_SWITCH(EnableStartupProfile,
+           "enable-startup-profile",
+           "Record the fonts, assets and shaders used before the first frame "
+           "and load them ahead of time on worker threads at the next launch.")
+DEF_SWITCH(ResamplePointerEvents,
+           "resample-pointer-events",
+           "Dispatch pointer events once per vsync, with the moves of each "
+           "pointer resampled to the time the frame is displayed.")
 DEF_SWITCH(LeakVM,
            "leak-vm",
            "When the last shell shuts down, the shared VM is leaked by default "
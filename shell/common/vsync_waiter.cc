@@ -78,6 +78,11 @@ void VsyncWaiter::ScheduleSecondaryCallback(uintptr_t id,
   AwaitVSyncForSecondaryCallback();
 }
 
+fml::TimePoint VsyncWaiter::GetLastFrameTargetTime() {
+  std::scoped_lock lock(callback_mutex_);
+  return last_frame_target_time_;
+}
+
 void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
                                fml::TimePoint frame_target_time,
                                bool pause_secondary_tasks) {
@@ -88,6 +93,7 @@ void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
 
   {
     std::scoped_lock lock(callback_mutex_);
+    last_frame_target_time_ = frame_target_time;
     callback = std::move(callback_);
     for (auto& pair : secondary_callbacks_) {
       secondary_callbacks.push_back(std::move(pair.second));
@@ -32,6 +32,10 @@ class VsyncWaiter : public std::enable_shared_from_this<VsyncWaiter> {
   /// |Animator::ScheduleMaybeClearTraceFlowIds|.
   void ScheduleSecondaryCallback(uintptr_t id, const fml::closure& callback);
 
+  /// The target time of the latest vsync that fired, which the secondary
+  /// callbacks of that vsync can read to know when its frame is displayed.
+  fml::TimePoint GetLastFrameTargetTime();
+
  protected:
   // On some backends, the |FireCallback| needs to be made from a static C
   // method.
@@ -75,6 +79,7 @@ class VsyncWaiter : public std::enable_shared_from_this<VsyncWaiter> {
   std::mutex callback_mutex_;
   Callback callback_;
   std::unordered_map<uintptr_t, fml::closure> secondary_callbacks_;
+  fml::TimePoint last_frame_target_time_;
 
   void PauseDartMicroTasks();
   static void ResumeDartMicroTasks(fml::TaskQueueId ui_task_queue_id);
@@ -54,6 +54,23 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
     return nullptr;
   }
 
+  // The previous frame is still in a backing store that retains its
+  // contents, so only the parts of this frame that changed are repainted.
+  if (delegate_->BackingStoreRetainsContents()) {
+    framebuffer_info.supports_partial_repaint = true;
+    if (backing_store == last_presented_backing_store_) {
+      framebuffer_info.existing_damage = SkIRect::MakeEmpty();
+    }
+  }
+  // Frames that are acquired but never presented may leave the backing store
+  // partially painted.
+  last_presented_backing_store_ = nullptr;
+
+  if (delegate_->GetTileRasterizer() != nullptr) {
+    return AcquireTiledFrame(std::move(backing_store),
+                             std::move(framebuffer_info));
+  }
+
   // If the surface has been scaled, we need to apply the inverse scaling to the
   // underlying canvas so that coordinates are mapped to the same spot
   // irrespective of surface scaling.
@@ -70,13 +87,72 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
 
     canvas->flush();
 
-    return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
+    return self->PresentBackingStore(surface_frame.SkiaSurface(),
+                                     surface_frame.submit_info());
   };
 
   return std::make_unique<SurfaceFrame>(backing_store,
                                         std::move(framebuffer_info), on_submit);
 }
 
+std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireTiledFrame(
+    sk_sp<SkSurface> backing_store,
+    SurfaceFrame::FramebufferInfo framebuffer_info) {
+  // The frame is recorded into a DisplayList and is only rasterized into the
+  // backing store when it is submitted, so there are no pixels to read back
+  // while the layer tree is being painted.
+  framebuffer_info.supports_readback = false;
+
+  SurfaceFrame::SubmitCallback on_submit =
+      [self = weak_factory_.GetWeakPtr(), backing_store](
+          SurfaceFrame& surface_frame, SkCanvas* canvas) -> bool {
+    // If the surface itself went away, there is nothing more to do.
+    if (!self || !self->IsValid()) {
+      return false;
+    }
+
+    auto display_list = surface_frame.BuildDisplayList();
+    if (!display_list) {
+      FML_LOG(ERROR) << "Could not build display list for surface frame.";
+      return false;
+    }
+
+    const DisplayListTileRasterizer* tile_rasterizer =
+        self->delegate_->GetTileRasterizer();
+    SkPixmap pixmap;
+    if (tile_rasterizer == nullptr || !backing_store->peekPixels(&pixmap) ||
+        !tile_rasterizer->Rasterize(display_list, pixmap,
+                                    backing_store->props())) {
+      FML_LOG(ERROR) << "Could not rasterize the frame into the backing store.";
+      return false;
+    }
+
+    return self->PresentBackingStore(backing_store,
+                                     surface_frame.submit_info());
+  };
+
+  return std::make_unique<SurfaceFrame>(nullptr,                      //
+                                        std::move(framebuffer_info),  //
+                                        on_submit,                    //
+                                        nullptr,                      //
+                                        true,  // display list fallback
+                                        true   // display list rtree
+  );
+}
+
+bool GPUSurfaceSoftware::PresentBackingStore(
+    sk_sp<SkSurface> backing_store,
+    const SurfaceFrame::SubmitInfo& submit_info) {
+  if (!delegate_->PresentBackingStoreWithDamage(
+          backing_store, submit_info.frame_damage_rects)) {
+    return false;
+  }
+  if (delegate_->BackingStoreRetainsContents()) {
+    last_presented_backing_store_ = std::move(backing_store);
+  }
+  return true;
+}
+
 // |Surface|
 SkMatrix GPUSurfaceSoftware::GetRootTransformation() const {
   // This backend does not currently support root surface transformations. Just
@@ -38,7 +38,22 @@ class GPUSurfaceSoftware : public Surface {
   // hack to make avoid allocating resources for the root surface when an
   // external view embedder is present.
   const bool render_to_surface_;
+  // The backing store that the last frame was presented from, if the frame
+  // after it has not been acquired yet. Only set when the delegate's backing
+  // stores retain their contents.
+  sk_sp<SkSurface> last_presented_backing_store_;
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
+
+  // Acquires a frame that is recorded into a DisplayList and rasterized into
+  // the |backing_store| by the delegate's tile rasterizer on submit.
+  std::unique_ptr<SurfaceFrame> AcquireTiledFrame(
+      sk_sp<SkSurface> backing_store,
+      SurfaceFrame::FramebufferInfo framebuffer_info);
+
+  // Presents the |backing_store| along with the damage of the frame.
+  bool PresentBackingStore(sk_sp<SkSurface> backing_store,
+                           const SurfaceFrame::SubmitInfo& submit_info);
+
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftware);
 };
 
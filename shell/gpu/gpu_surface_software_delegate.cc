@@ -8,4 +8,19 @@ namespace flutter {
 
 GPUSurfaceSoftwareDelegate::~GPUSurfaceSoftwareDelegate() = default;
 
+bool GPUSurfaceSoftwareDelegate::PresentBackingStoreWithDamage(
+    sk_sp<SkSurface> backing_store,
+    const std::optional<std::vector<SkIRect>>& frame_damage) {
+  return PresentBackingStore(std::move(backing_store));
+}
+
+bool GPUSurfaceSoftwareDelegate::BackingStoreRetainsContents() const {
+  return false;
+}
+
+const DisplayListTileRasterizer* GPUSurfaceSoftwareDelegate::GetTileRasterizer()
+    const {
+  return nullptr;
+}
+
 }  // namespace flutter
@@ -5,6 +5,10 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_DELEGATE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_DELEGATE_H_
 
+#include <optional>
+#include <vector>
+
+#include "flutter/display_list/display_list_tile_rasterizer.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkSurface.h"
@@ -48,6 +52,48 @@ class GPUSurfaceSoftwareDelegate {
   ///             the screen.
   ///
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called instead of |PresentBackingStore| by the GPU surface,
+  ///             along with the parts of the backing store that changed since
+  ///             the last frame. Platforms that copy the backing store to the
+  ///             screen can use these to copy less. By default, this calls
+  ///             |PresentBackingStore|.
+  ///
+  /// @param[in]  backing_store  The software backing store to present.
+  /// @param[in]  frame_damage   The rects of the backing store that changed
+  ///                            since the last frame, or nullopt if all of it
+  ///                            may have changed.
+  ///
+  /// @return     Returns if the platform could present the backing store onto
+  ///             the screen.
+  ///
+  virtual bool PresentBackingStoreWithDamage(
+      sk_sp<SkSurface> backing_store,
+      const std::optional<std::vector<SkIRect>>& frame_damage);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called by the GPU surface when it acquires a frame to decide
+  ///             whether only the parts of the frame that changed need to be
+  ///             repainted. This is only possible when a backing store that is
+  ///             returned again by |AcquireBackingStore| still holds the
+  ///             frame that was last presented from it.
+  ///
+  /// @return     Whether backing stores keep their contents between frames.
+  ///             False by default.
+  ///
+  virtual bool BackingStoreRetainsContents() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called by the GPU surface when it acquires a frame to decide
+  ///             whether that frame should be recorded and then rasterized
+  ///             into the backing store using several threads.
+  ///
+  /// @return     The rasterizer to use for the frame, or nullptr (the default)
+  ///             to render the frame directly into the backing store on the
+  ///             raster thread.
+  ///
+  virtual const DisplayListTileRasterizer* GetTileRasterizer() const;
 };
 
 }  // namespace flutter
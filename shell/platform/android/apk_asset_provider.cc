@@ -50,6 +50,11 @@ class APKAssetMapping : public fml::Mapping {
 
   bool IsDontNeedSafe() const override { return !AAsset_isAllocated(asset_); }
 
+  // Assets that are stored uncompressed are mapped in from the APK.
+  bool IsSharedFileBacked() const override {
+    return !AAsset_isAllocated(asset_);
+  }
+
  private:
   AAsset* const asset_;
 
@@ -12,6 +12,7 @@
 #include <iostream>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "byte_buffer_streams.h"
@@ -78,6 +79,78 @@ EncodedType EncodedTypeForValue(const EncodableValue& value) {
   return EncodedType::kNull;
 }
 
+// Returns the number of bytes that |StandardCodecSerializer::WriteSize|
+// writes for |size|.
+size_t EncodedSizeOfSize(size_t size) {
+  if (size < 254) {
+    return 1;
+  }
+  return size <= 0xffff ? 3 : 5;
+}
+
+template <typename T>
+size_t EncodedSizeBoundOfVector(const std::vector<T>& vector) {
+  // Up to sizeof(T) - 1 bytes of padding align the elements.
+  return EncodedSizeOfSize(vector.size()) + sizeof(T) - 1 +
+         vector.size() * sizeof(T);
+}
+
+// Returns an upper bound of the size of the encoding of |value|, so that
+// encoders can allocate their buffer once rather than growing it value by
+// value. Custom values are not counted, so the buffer still grows for them.
+size_t EncodedSizeBound(const EncodableValue& value) {
+  // The type discrimination byte.
+  size_t size = 1;
+  switch (value.index()) {
+    case 2:
+      size += 4;
+      break;
+    case 3:
+      size += 8;
+      break;
+    case 4:
+      size += 7 + 8;
+      break;
+    case 5: {
+      const auto& string_value = std::get<std::string>(value);
+      size += EncodedSizeOfSize(string_value.size()) + string_value.size();
+      break;
+    }
+    case 6:
+      size += EncodedSizeBoundOfVector(std::get<std::vector<uint8_t>>(value));
+      break;
+    case 7:
+      size += EncodedSizeBoundOfVector(std::get<std::vector<int32_t>>(value));
+      break;
+    case 8:
+      size += EncodedSizeBoundOfVector(std::get<std::vector<int64_t>>(value));
+      break;
+    case 9:
+      size += EncodedSizeBoundOfVector(std::get<std::vector<double>>(value));
+      break;
+    case 10: {
+      const auto& list = std::get<EncodableList>(value);
+      size += EncodedSizeOfSize(list.size());
+      for (const auto& item : list) {
+        size += EncodedSizeBound(item);
+      }
+      break;
+    }
+    case 11: {
+      const auto& map = std::get<EncodableMap>(value);
+      size += EncodedSizeOfSize(map.size());
+      for (const auto& pair : map) {
+        size += EncodedSizeBound(pair.first) + EncodedSizeBound(pair.second);
+      }
+      break;
+    }
+    case 13:
+      size += EncodedSizeBoundOfVector(std::get<std::vector<float>>(value));
+      break;
+  }
+  return size;
+}
+
 }  // namespace
 
 StandardCodecSerializer::StandardCodecSerializer() = default;
@@ -188,7 +261,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       std::string string_value;
       string_value.resize(size);
       stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
-      return EncodableValue(string_value);
+      return EncodableValue(std::move(string_value));
     }
     case EncodedType::kUInt8List:
       return ReadVector<uint8_t>(stream);
@@ -205,7 +278,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       for (size_t i = 0; i < length; ++i) {
         list_value.push_back(ReadValue(stream));
       }
-      return EncodableValue(list_value);
+      return EncodableValue(std::move(list_value));
     }
     case EncodedType::kMap: {
       size_t length = ReadSize(stream);
@@ -215,7 +288,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
         EncodableValue value = ReadValue(stream);
         map_value.emplace(std::move(key), std::move(value));
       }
-      return EncodableValue(map_value);
+      return EncodableValue(std::move(map_value));
     }
     case EncodedType::kFloat32List: {
       return ReadVector<float>(stream);
@@ -268,11 +341,11 @@ EncodableValue StandardCodecSerializer::ReadVector(
   }
   stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
                     count * type_size);
-  return EncodableValue(vector);
+  return EncodableValue(std::move(vector));
 }
 
 template <typename T>
-void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
+void StandardCodecSerializer::WriteVector(const std::vector<T>& vector,
                                           ByteStreamWriter* stream) const {
   size_t count = vector.size();
   WriteSize(count, stream);
@@ -329,6 +402,7 @@ std::unique_ptr<std::vector<uint8_t>>
 StandardMessageCodec::EncodeMessageInternal(
     const EncodableValue& message) const {
   auto encoded = std::make_unique<std::vector<uint8_t>>();
+  encoded->reserve(EncodedSizeBound(message));
   ByteBufferStreamWriter stream(encoded.get());
   serializer_->WriteValue(message, &stream);
   return encoded;
@@ -382,9 +456,14 @@ StandardMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
 std::unique_ptr<std::vector<uint8_t>>
 StandardMethodCodec::EncodeMethodCallInternal(
     const MethodCall<EncodableValue>& method_call) const {
+  EncodableValue method_name(method_call.method_name());
   auto encoded = std::make_unique<std::vector<uint8_t>>();
+  encoded->reserve(
+      EncodedSizeBound(method_name) +
+      (method_call.arguments() ? EncodedSizeBound(*method_call.arguments())
+                               : 1));
   ByteBufferStreamWriter stream(encoded.get());
-  serializer_->WriteValue(EncodableValue(method_call.method_name()), &stream);
+  serializer_->WriteValue(method_name, &stream);
   if (method_call.arguments()) {
     serializer_->WriteValue(*method_call.arguments(), &stream);
   } else {
@@ -397,6 +476,7 @@ std::unique_ptr<std::vector<uint8_t>>
 StandardMethodCodec::EncodeSuccessEnvelopeInternal(
     const EncodableValue* result) const {
   auto encoded = std::make_unique<std::vector<uint8_t>>();
+  encoded->reserve(1 + (result ? EncodedSizeBound(*result) : 1));
   ByteBufferStreamWriter stream(encoded.get());
   stream.WriteByte(0);
   if (result) {
@@ -4,6 +4,7 @@
 
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
 
+#include <cstring>
 #include <map>
 #include <vector>
 
@@ -224,6 +225,33 @@ TEST(StandardMessageCodec, CanEncodeAndDecodeFloat64Array) {
   CheckEncodeDecode(value, bytes);
 }
 
+TEST(StandardMessageCodec, CanEncodeAndDecodeLargeTypedList) {
+  std::vector<double> samples(70000);
+  for (size_t i = 0; i < samples.size(); i++) {
+    samples[i] = i * 0.5;
+  }
+  EncodableValue value(
+      EncodableList{EncodableValue(u8"imu"), EncodableValue(samples)});
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(value);
+  ASSERT_TRUE(encoded);
+
+  std::vector<uint8_t> prefix = {
+      0x0c, 0x02,                    // list of two values
+      0x07, 0x03, 0x69, 0x6d, 0x75,  // string
+      0x0b, 0xff, 0x70, 0x11, 0x01,  // Float64List with a 32-bit length
+      0x00, 0x00, 0x00, 0x00,        // length and alignment padding
+  };
+  ASSERT_EQ(encoded->size(), prefix.size() + samples.size() * sizeof(double));
+  EXPECT_TRUE(std::equal(prefix.begin(), prefix.end(), encoded->begin()));
+  EXPECT_EQ(std::memcmp(encoded->data() + prefix.size(), samples.data(),
+                        samples.size() * sizeof(double)),
+            0);
+
+  auto decoded = codec.DecodeMessage(*encoded);
+  EXPECT_EQ(value, *decoded);
+}
+
 TEST(StandardMessageCodec, CanEncodeAndDecodeSimpleCustomType) {
   std::vector<uint8_t> bytes = {0x80, 0x09, 0x00, 0x00, 0x00,
                                 0x10, 0x00, 0x00, 0x00};
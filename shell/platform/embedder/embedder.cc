@@ -141,8 +141,8 @@ static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
 
   const FlutterSoftwareRendererConfig* software_config = &config->software;
 
-  if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) ==
-      nullptr) {
+  if (!SAFE_EXISTS(software_config, surface_present_callback) &&
+      !SAFE_EXISTS(software_config, surface_present_with_info_callback)) {
     return false;
   }
 
@@ -509,24 +509,76 @@ InferSoftwarePlatformViewCreationCallback(
   }
 
   auto software_present_backing_store =
-      [ptr = config->software.surface_present_callback, user_data](
-          const void* allocation, size_t row_bytes, size_t height) -> bool {
-    return ptr(user_data, allocation, row_bytes, height);
+      [present = SAFE_ACCESS(&config->software, surface_present_callback,
+                             nullptr),
+       present_with_info = SAFE_ACCESS(
+           &config->software, surface_present_with_info_callback, nullptr),
+       user_data](const void* allocation, size_t row_bytes, size_t height,
+                  const std::vector<SkIRect>& frame_damage,
+                  const std::vector<SkIRect>& buffer_damage) -> bool {
+    if (!present_with_info) {
+      return present(user_data, allocation, row_bytes, height);
+    }
+    auto to_flutter_rects = [](const std::vector<SkIRect>& rects) {
+      std::vector<FlutterRect> flutter_rects;
+      flutter_rects.reserve(rects.size());
+      for (const auto& rect : rects) {
+        flutter_rects.push_back(
+            FlutterRect{static_cast<double>(rect.fLeft),
+                        static_cast<double>(rect.fTop),
+                        static_cast<double>(rect.fRight),
+                        static_cast<double>(rect.fBottom)});
+      }
+      return flutter_rects;
+    };
+    std::vector<FlutterRect> frame_rects = to_flutter_rects(frame_damage);
+    std::vector<FlutterRect> buffer_rects = to_flutter_rects(buffer_damage);
+
+    FlutterSoftwarePresentInfo present_info = {};
+    present_info.struct_size = sizeof(FlutterSoftwarePresentInfo);
+    present_info.allocation = allocation;
+    present_info.row_bytes = row_bytes;
+    present_info.height = height;
+    present_info.frame_damage.struct_size = sizeof(FlutterDamage);
+    present_info.frame_damage.num_rects = frame_rects.size();
+    present_info.frame_damage.damage = frame_rects.data();
+    present_info.buffer_damage.struct_size = sizeof(FlutterDamage);
+    present_info.buffer_damage.num_rects = buffer_rects.size();
+    present_info.buffer_damage.damage = buffer_rects.data();
+    return present_with_info(user_data, &present_info);
   };
 
+  std::function<uint32_t(void)> software_buffer_age = nullptr;
+  if (auto buffer_age = SAFE_ACCESS(&config->software,
+                                    surface_buffer_age_callback, nullptr)) {
+    software_buffer_age = [buffer_age, user_data]() -> uint32_t {
+      return buffer_age(user_data);
+    };
+  }
+
+  const bool software_present_with_damage =
+      SAFE_EXISTS(&config->software, surface_present_with_info_callback);
+
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
       software_dispatch_table = {
           software_present_backing_store,  // required
+          software_buffer_age,             // optional
+          software_present_with_damage,    // optional
       };
 
+  size_t raster_tile_worker_count =
+      SAFE_ACCESS(&config->software, raster_tile_worker_count, 0);
+
   return fml::MakeCopyable(
-      [software_dispatch_table, platform_dispatch_table,
+      [software_dispatch_table, raster_tile_worker_count,
+       platform_dispatch_table,
        external_view_embedder =
            std::move(external_view_embedder)](flutter::Shell& shell) mutable {
         return std::make_unique<flutter::PlatformViewEmbedder>(
             shell,                             // delegate
             shell.GetTaskRunners(),            // task runners
             software_dispatch_table,           // software dispatch table
+            raster_tile_worker_count,          // raster tile worker count
             platform_dispatch_table,           // platform dispatch table
             std::move(external_view_embedder)  // external view embedder
         );
@@ -1933,14 +1985,29 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
     return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid message argument.");
   }
 
+  size_t message_size = SAFE_ACCESS(flutter_message, message_size, 0);
+  const uint8_t* message_data = SAFE_ACCESS(flutter_message, message, nullptr);
+
+  // Taking the ownership of the message first releases it on every return
+  // below.
+  std::unique_ptr<fml::Mapping> external_data;
+  if (VoidCallback release_callback =
+          SAFE_ACCESS(flutter_message, message_release_callback, nullptr)) {
+    void* release_user_data =
+        SAFE_ACCESS(flutter_message, message_release_user_data, nullptr);
+    external_data = std::make_unique<fml::NonOwnedMapping>(
+        message_data, message_size,
+        [release_callback, release_user_data](const uint8_t* data,
+                                              size_t size) {
+          release_callback(release_user_data);
+        });
+  }
+
   if (SAFE_ACCESS(flutter_message, channel, nullptr) == nullptr) {
     return LOG_EMBEDDER_ERROR(
         kInvalidArguments, "Message argument did not specify a valid channel.");
   }
 
-  size_t message_size = SAFE_ACCESS(flutter_message, message_size, 0);
-  const uint8_t* message_data = SAFE_ACCESS(flutter_message, message, nullptr);
-
   if (message_size != 0 && message_data == nullptr) {
     return LOG_EMBEDDER_ERROR(
         kInvalidArguments,
@@ -1959,6 +2026,9 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
   if (message_size == 0) {
     message = std::make_unique<flutter::PlatformMessage>(
         flutter_message->channel, response);
+  } else if (external_data) {
+    message = std::make_unique<flutter::PlatformMessage>(
+        flutter_message->channel, std::move(external_data), response);
   } else {
     message = std::make_unique<flutter::PlatformMessage>(
         flutter_message->channel,
@@ -377,6 +377,16 @@ typedef struct {
   FlutterSize lower_left_corner_radius;
 } FlutterRoundedRect;
 
+/// A region of a surface, made up of rectangles in physical pixels.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterDamage).
+  size_t struct_size;
+  /// The number of rectangles in `damage`.
+  size_t num_rects;
+  /// The rectangles making up the region. They may overlap.
+  FlutterRect* damage;
+} FlutterDamage;
+
 /// This information is passed to the embedder when requesting a frame buffer
 /// object.
 ///
@@ -664,6 +674,31 @@ typedef struct {
 
 } FlutterVulkanRendererConfig;
 
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterSoftwarePresentInfo).
+  size_t struct_size;
+  /// The fully populated buffer. The pixel format of the buffer is the native
+  /// 32-bit RGBA format. The buffer is owned by the Flutter engine and must be
+  /// copied in the callback if needed.
+  const void* allocation;
+  /// The number of bytes in each row of the `allocation`.
+  size_t row_bytes;
+  /// The number of rows of the `allocation`.
+  size_t height;
+  /// The parts of the `allocation` that changed since the last frame was
+  /// presented.
+  FlutterDamage frame_damage;
+  /// The parts of the `allocation` that must be copied to bring the buffer
+  /// the embedder presents up to date, given the age of that buffer reported
+  /// by the `surface_buffer_age_callback`. This is the whole `allocation` if
+  /// no such callback was given or the age is not known.
+  FlutterDamage buffer_damage;
+} FlutterSoftwarePresentInfo;
+
+typedef bool (*SoftwareSurfacePresentWithInfoCallback)(
+    void* /* user data */,
+    const FlutterSoftwarePresentInfo* /* present info */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterSoftwareRendererConfig).
   size_t struct_size;
@@ -672,6 +707,25 @@ typedef struct {
   /// format. The buffer is owned by the Flutter engine and must be copied in
   /// this callback if needed.
   SoftwareSurfacePresentCallback surface_present_callback;
+  /// The number of worker threads, in addition to the raster thread, that the
+  /// engine may use to rasterize each frame. When non-zero, frames are split
+  /// into tiles that are rasterized concurrently before being presented, which
+  /// reduces the rasterization time of large frames on multi-core devices.
+  /// When zero (the default), frames are rasterized on the raster thread.
+  size_t raster_tile_worker_count;
+  /// The callback presented to the embedder to present a fully populated
+  /// buffer along with the parts of it that changed. When specified, it is
+  /// called instead of the `surface_present_callback`, which may then be
+  /// `NULL`. This lets an embedder copy only the changed pixels into its own
+  /// buffers.
+  SoftwareSurfacePresentWithInfoCallback surface_present_with_info_callback;
+  /// The callback invoked right before each present to query the age of the
+  /// buffer the embedder will copy the frame into: 1 if that buffer holds the
+  /// last frame presented, 2 if it holds the frame before that, and so on, or
+  /// 0 if its contents are unknown. The `buffer_damage` passed to the
+  /// `surface_present_with_info_callback` covers everything that changed
+  /// over that many frames. This field is optional.
+  UIntCallback surface_buffer_age_callback;
 } FlutterSoftwareRendererConfig;
 
 typedef struct {
@@ -904,6 +958,18 @@ typedef struct {
   /// `FlutterEngineSendPlatformMessageResponse` will cause a memory leak. It is
   /// not safe to send multiple responses on a single response object.
   const FlutterPlatformMessageResponseHandle* response_handle;
+  /// When sending a message with `FlutterEngineSendPlatformMessage`, an
+  /// optional callback that hands the ownership of `message` to the engine,
+  /// which avoids copying large messages such as camera frames. The engine
+  /// gives the Flutter application a view of the buffer instead of a copy,
+  /// and invokes the callback on an arbitrary thread once that view is
+  /// garbage collected. The buffer must stay valid and unchanged until then.
+  /// Unless the engine or the message are invalid, the callback is invoked
+  /// exactly once, even if sending the message fails. Messages that the
+  /// engine sends to the embedder never set it.
+  VoidCallback message_release_callback;
+  /// The user data passed to `message_release_callback`.
+  void* message_release_user_data;
 } FlutterPlatformMessage;
 
 typedef void (*FlutterPlatformMessageCallback)(
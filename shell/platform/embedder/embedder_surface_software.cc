@@ -13,12 +13,19 @@ namespace flutter {
 
 EmbedderSurfaceSoftware::EmbedderSurfaceSoftware(
     SoftwareDispatchTable software_dispatch_table,
+    size_t raster_tile_worker_count,
     std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
     : software_dispatch_table_(software_dispatch_table),
       external_view_embedder_(external_view_embedder) {
   if (!software_dispatch_table_.software_present_backing_store) {
     return;
   }
+  if (raster_tile_worker_count > 0) {
+    tile_worker_loop_ =
+        fml::ConcurrentMessageLoop::Create(raster_tile_worker_count);
+    tile_rasterizer_ = std::make_unique<DisplayListTileRasterizer>(
+        tile_worker_loop_->GetTaskRunner(), raster_tile_worker_count);
+  }
   valid_ = true;
 }
 
@@ -80,6 +87,13 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
 // |GPUSurfaceSoftwareDelegate|
 bool EmbedderSurfaceSoftware::PresentBackingStore(
     sk_sp<SkSurface> backing_store) {
+  return PresentBackingStoreWithDamage(std::move(backing_store), std::nullopt);
+}
+
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::PresentBackingStoreWithDamage(
+    sk_sp<SkSurface> backing_store,
+    const std::optional<std::vector<SkIRect>>& frame_damage) {
   if (!IsValid()) {
     FML_LOG(ERROR) << "Tried to present an invalid software surface.";
     return false;
@@ -101,11 +115,58 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
     return false;
   }
 
-  return software_dispatch_table_.software_present_backing_store(
+  const std::vector<SkIRect> full_damage = {pixmap.bounds()};
+  const std::vector<SkIRect>& damage =
+      frame_damage ? *frame_damage : full_damage;
+
+  // A buffer that is |age| frames old is missing the damage of the frames
+  // presented since, in addition to the damage of this frame.
+  uint32_t age = software_dispatch_table_.software_buffer_age
+                     ? software_dispatch_table_.software_buffer_age()
+                     : 0;
+  std::vector<SkIRect> buffer_damage = full_damage;
+  if (age > 0 && age - 1 <= damage_history_.size()) {
+    buffer_damage = damage;
+    auto frame = damage_history_.rbegin();
+    for (uint32_t i = 1; i < age; ++i, ++frame) {
+      buffer_damage.insert(buffer_damage.end(), frame->begin(), frame->end());
+    }
+  }
+
+  damage_history_.push_back(damage);
+  if (damage_history_.size() > kMaxDamageHistorySize) {
+    damage_history_.pop_front();
+  }
+
+  bool presented = software_dispatch_table_.software_present_backing_store(
       pixmap.addr(),      //
       pixmap.rowBytes(),  //
-      pixmap.height()     //
+      pixmap.height(),    //
+      damage,             //
+      buffer_damage       //
   );
+  if (!presented) {
+    // The buffers of the embedder may not hold what the history says.
+    damage_history_.clear();
+  }
+  return presented;
+}
+
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::BackingStoreRetainsContents() const {
+  // The backing store is owned by the engine and the embedder only copies
+  // from it, so it holds the last frame for as long as its size is the same.
+  // Repainting only the damage is not worth computing it for unless the
+  // embedder is told the damage, or keeps buffers of its own whose age it
+  // reports so that only their damage needs to be copied into them.
+  return software_dispatch_table_.software_present_with_damage ||
+         software_dispatch_table_.software_buffer_age != nullptr;
+}
+
+// |GPUSurfaceSoftwareDelegate|
+const DisplayListTileRasterizer* EmbedderSurfaceSoftware::GetTileRasterizer()
+    const {
+  return tile_rasterizer_.get();
 }
 
 }  // namespace flutter
@@ -5,6 +5,11 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 
+#include <list>
+#include <optional>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_software.h"
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
@@ -16,21 +21,44 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
                                       public GPUSurfaceSoftwareDelegate {
  public:
   struct SoftwareDispatchTable {
-    std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
+    // Presents the allocation along with the rects that changed since the
+    // last frame and the rects that must be copied into a buffer of the age
+    // returned by |software_buffer_age|.
+    std::function<bool(const void* allocation,
+                       size_t row_bytes,
+                       size_t height,
+                       const std::vector<SkIRect>& frame_damage,
+                       const std::vector<SkIRect>& buffer_damage)>
         software_present_backing_store;  // required
+    std::function<uint32_t(void)> software_buffer_age;  // optional
+    // Whether |software_present_backing_store| hands the damage to the
+    // embedder rather than only the allocation.
+    bool software_present_with_damage = false;  // optional
   };
 
+  // If |raster_tile_worker_count| is non-zero then frames are recorded and
+  // rasterized into the backing store in tiles by that many worker threads
+  // in addition to the raster thread.
   EmbedderSurfaceSoftware(
       SoftwareDispatchTable software_dispatch_table,
+      size_t raster_tile_worker_count,
       std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
 
   ~EmbedderSurfaceSoftware() override;
 
  private:
+  // The number of frames whose damage is kept to compute the buffer damage
+  // of buffers that are that old.
+  static constexpr size_t kMaxDamageHistorySize = 10;
+
   bool valid_ = false;
   SoftwareDispatchTable software_dispatch_table_;
   sk_sp<SkSurface> sk_surface_;
   std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
+  std::shared_ptr<fml::ConcurrentMessageLoop> tile_worker_loop_;
+  std::unique_ptr<DisplayListTileRasterizer> tile_rasterizer_;
+  // The frame damage of the most recently presented frames, oldest first.
+  std::list<std::vector<SkIRect>> damage_history_;
 
   // |EmbedderSurface|
   bool IsValid() const override;
@@ -47,6 +75,17 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   // |GPUSurfaceSoftwareDelegate|
   bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
 
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStoreWithDamage(
+      sk_sp<SkSurface> backing_store,
+      const std::optional<std::vector<SkIRect>>& frame_damage) override;
+
+  // |GPUSurfaceSoftwareDelegate|
+  bool BackingStoreRetainsContents() const override;
+
+  // |GPUSurfaceSoftwareDelegate|
+  const DisplayListTileRasterizer* GetTileRasterizer() const override;
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceSoftware);
 };
 
@@ -386,6 +386,22 @@ Picture CreateColoredBox(Color color, Size size) {
   return baseRecorder.endRecording();
 }
 
+@pragma('vm:entry-point')
+void render_moving_box() {
+  int frame = 0;
+  PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
+    SceneBuilder builder = SceneBuilder();
+    builder.addPicture(Offset(frame * 200.0, 0.0),
+        CreateColoredBox(Color.fromARGB(255, 0, 0, 255), Size(100.0, 100.0)));
+    PlatformDispatcher.instance.views.first.render(builder.build());
+    frame++;
+    if (frame < 3) {
+      PlatformDispatcher.instance.scheduleFrame();
+    }
+  };
+  PlatformDispatcher.instance.scheduleFrame();
+}
+
 @pragma('vm:entry-point')
 void can_composite_platform_views_with_known_scene() {
   PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
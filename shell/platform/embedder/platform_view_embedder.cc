@@ -10,14 +10,17 @@ PlatformViewEmbedder::PlatformViewEmbedder(
     PlatformView::Delegate& delegate,
     flutter::TaskRunners task_runners,
     EmbedderSurfaceSoftware::SoftwareDispatchTable software_dispatch_table,
+    size_t raster_tile_worker_count,
     PlatformDispatchTable platform_dispatch_table,
     std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
     : PlatformView(delegate, std::move(task_runners)),
       external_view_embedder_(external_view_embedder),
-      embedder_surface_(
-          std::make_unique<EmbedderSurfaceSoftware>(software_dispatch_table,
-                                                    external_view_embedder_)),
-      platform_dispatch_table_(platform_dispatch_table) {}
+      embedder_surface_(std::make_unique<EmbedderSurfaceSoftware>(
+          software_dispatch_table,
+          raster_tile_worker_count,
+          external_view_embedder_)),
+      platform_dispatch_table_(platform_dispatch_table),
+      precompiles_known_sksls_(false) {}
 
 #ifdef SHELL_ENABLE_GL
 PlatformViewEmbedder::PlatformViewEmbedder(
@@ -33,7 +36,8 @@ PlatformViewEmbedder::PlatformViewEmbedder(
           std::make_unique<EmbedderSurfaceGL>(gl_dispatch_table,
                                               fbo_reset_after_present,
                                               external_view_embedder_)),
-      platform_dispatch_table_(platform_dispatch_table) {}
+      platform_dispatch_table_(platform_dispatch_table),
+      precompiles_known_sksls_(true) {}
 #endif
 
 #ifdef SHELL_ENABLE_METAL
@@ -46,7 +50,8 @@ PlatformViewEmbedder::PlatformViewEmbedder(
     : PlatformView(delegate, std::move(task_runners)),
       external_view_embedder_(external_view_embedder),
       embedder_surface_(std::move(embedder_surface)),
-      platform_dispatch_table_(platform_dispatch_table) {}
+      platform_dispatch_table_(platform_dispatch_table),
+      precompiles_known_sksls_(true) {}
 #endif
 
 #ifdef SHELL_ENABLE_VULKAN
@@ -59,7 +64,8 @@ PlatformViewEmbedder::PlatformViewEmbedder(
     : PlatformView(delegate, std::move(task_runners)),
       external_view_embedder_(external_view_embedder),
       embedder_surface_(std::move(embedder_surface)),
-      platform_dispatch_table_(platform_dispatch_table) {}
+      platform_dispatch_table_(platform_dispatch_table),
+      precompiles_known_sksls_(false) {}
 #endif
 
 PlatformViewEmbedder::~PlatformViewEmbedder() = default;
@@ -118,6 +124,11 @@ sk_sp<GrDirectContext> PlatformViewEmbedder::CreateResourceContext() const {
   return embedder_surface_->CreateResourceContext();
 }
 
+// |PlatformView|
+bool PlatformViewEmbedder::PrecompilesKnownSkSLs() const {
+  return precompiles_known_sksls_;
+}
+
 // |PlatformView|
 std::unique_ptr<VsyncWaiter> PlatformViewEmbedder::CreateVSyncWaiter() {
   if (!platform_dispatch_table_.vsync_callback) {
@@ -59,6 +59,7 @@ class PlatformViewEmbedder final : public PlatformView {
       PlatformView::Delegate& delegate,
       flutter::TaskRunners task_runners,
       EmbedderSurfaceSoftware::SoftwareDispatchTable software_dispatch_table,
+      size_t raster_tile_worker_count,
       PlatformDispatchTable platform_dispatch_table,
       std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
 
@@ -107,6 +108,8 @@ class PlatformViewEmbedder final : public PlatformView {
   std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
   std::unique_ptr<EmbedderSurface> embedder_surface_;
   PlatformDispatchTable platform_dispatch_table_;
+  // Only the OpenGL and Metal surfaces precompile SkSLs.
+  const bool precompiles_known_sksls_;
 
   // |PlatformView|
   std::unique_ptr<Surface> CreateRenderingSurface() override;
@@ -117,6 +120,9 @@ class PlatformViewEmbedder final : public PlatformView {
   // |PlatformView|
   sk_sp<GrDirectContext> CreateResourceContext() const override;
 
+  // |PlatformView|
+  bool PrecompilesKnownSkSLs() const override;
+
   // |PlatformView|
   std::unique_ptr<VsyncWaiter> CreateVSyncWaiter() override;
 
@@ -165,6 +165,20 @@ void EmbedderConfigBuilder::SetOpenGLPresentCallBack() {
 #endif
 }
 
+void EmbedderConfigBuilder::SetSoftwarePresentWithInfoCallbacks() {
+  FML_CHECK(renderer_config_.type == FlutterRendererType::kSoftware);
+  renderer_config_.software.surface_present_with_info_callback =
+      [](void* context, const FlutterSoftwarePresentInfo* present_info) {
+        return reinterpret_cast<EmbedderTestContextSoftware*>(context)
+            ->PresentWithInfo(present_info);
+      };
+  renderer_config_.software.surface_buffer_age_callback =
+      [](void* context) -> uint32_t {
+    return reinterpret_cast<EmbedderTestContextSoftware*>(context)
+        ->GetBufferAge();
+  };
+}
+
 void EmbedderConfigBuilder::SetRendererConfig(EmbedderTestContextType type,
                                               SkISize surface_size) {
   switch (type) {
@@ -67,6 +67,12 @@ class EmbedderConfigBuilder {
   // test this behavior.
   void SetOpenGLPresentCallBack();
 
+  // Used to set the `software.surface_present_with_info_callback` and the
+  // `software.surface_buffer_age_callback`, which hand the presented frames
+  // and their damage to the callbacks set on the software test context.
+  // SetSoftwareRendererConfig must be called before this.
+  void SetSoftwarePresentWithInfoCallbacks();
+
   void SetAssetsPath();
 
   void SetSnapshots();
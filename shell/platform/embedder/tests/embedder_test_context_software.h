@@ -12,6 +12,10 @@ namespace testing {
 
 class EmbedderTestContextSoftware : public EmbedderTestContext {
  public:
+  using PresentInfoCallback =
+      std::function<void(const FlutterSoftwarePresentInfo& present_info)>;
+  using BufferAgeCallback = std::function<uint32_t(void)>;
+
   explicit EmbedderTestContextSoftware(std::string assets_path = "");
 
   ~EmbedderTestContextSoftware() override;
@@ -23,6 +27,29 @@ class EmbedderTestContextSoftware : public EmbedderTestContext {
 
   bool Present(sk_sp<SkImage> image);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets a callback that will be invoked (on the raster task
+  ///             runner) with the info of each frame presented through the
+  ///             `surface_present_with_info_callback`.
+  ///
+  /// @attention  The callback will be invoked on the raster task runner. The
+  ///             callback can be set on the tests host thread.
+  ///
+  /// @param[in]  callback  The callback to set. The previous callback will be
+  ///                       un-registered.
+  ///
+  void SetPresentInfoCallback(PresentInfoCallback callback);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets a callback that will be invoked (on the raster task
+  ///             runner) for the age reported by the
+  ///             `surface_buffer_age_callback`. The age is 0 without one.
+  ///
+  /// @param[in]  callback  The callback to set. The previous callback will be
+  ///                       un-registered.
+  ///
+  void SetBufferAgeCallback(BufferAgeCallback callback);
+
  protected:
   virtual void SetupCompositor() override;
 
@@ -30,6 +57,17 @@ class EmbedderTestContextSoftware : public EmbedderTestContext {
   sk_sp<SkSurface> surface_;
   SkISize surface_size_;
   size_t software_surface_present_count_ = 0;
+  std::mutex software_callback_mutex_;
+  PresentInfoCallback present_info_callback_;
+  BufferAgeCallback buffer_age_callback_;
+
+  // This allows the builder to access the hooks.
+  friend class EmbedderConfigBuilder;
+
+  bool PresentWithInfo(const FlutterSoftwarePresentInfo* present_info);
+
+  uint32_t GetBufferAge();
+
   void SetupSurface(SkISize surface_size) override;
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderTestContextSoftware);
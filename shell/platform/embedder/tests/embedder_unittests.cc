@@ -4,6 +4,7 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -438,6 +439,68 @@ TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithoutResponseHandles) {
   message.Wait();
 }
 
+//------------------------------------------------------------------------------
+/// Tests that a platform message that is sent with a release callback reaches
+/// the application intact, and is released exactly once.
+///
+TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithReleaseCallbacks) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.SetDartEntrypoint("platform_messages_no_response");
+
+  // Large enough to be handed to the application without a copy.
+  const std::string message_data(64 * 1024, 'x');
+
+  fml::AutoResetWaitableEvent ready, message;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY(
+          ([&message, &message_data](Dart_NativeArguments args) {
+            auto received_message = tonic::DartConverter<std::string>::FromDart(
+                Dart_GetNativeArgument(args, 0));
+            ASSERT_EQ(received_message, message_data);
+            message.Signal();
+          })));
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+  ready.Wait();
+
+  std::atomic<int> release_count = 0;
+  FlutterPlatformMessage platform_message = {};
+  platform_message.struct_size = sizeof(FlutterPlatformMessage);
+  platform_message.channel = "test_channel";
+  platform_message.message =
+      reinterpret_cast<const uint8_t*>(message_data.data());
+  platform_message.message_size = message_data.size();
+  platform_message.message_release_callback = [](void* user_data) {
+    reinterpret_cast<std::atomic<int>*>(user_data)->fetch_add(1);
+  };
+  platform_message.message_release_user_data = &release_count;
+
+  auto result =
+      FlutterEngineSendPlatformMessage(engine.get(), &platform_message);
+  ASSERT_EQ(result, kSuccess);
+  message.Wait();
+
+  // The application may hold on to the message until it shuts down.
+  engine.reset();
+  ASSERT_EQ(release_count.load(), 1);
+
+  // Messages that cannot be sent are released right away.
+  platform_message.channel = nullptr;
+  result = FlutterEngineSendPlatformMessage(
+      reinterpret_cast<FlutterEngine>(1), &platform_message);
+  ASSERT_EQ(result, kInvalidArguments);
+  ASSERT_EQ(release_count.load(), 2);
+}
+
 //------------------------------------------------------------------------------
 /// Tests that a null platform message can be sent.
 ///
@@ -941,6 +1004,86 @@ TEST_F(EmbedderTest, CanQueryDartAOTMode) {
             flutter::DartVM::IsRunningPrecompiledCode());
 }
 
+TEST_F(EmbedderTest, SoftwarePresentWithInfoReceivesFrameAndBufferDamage) {
+  auto& context = static_cast<EmbedderTestContextSoftware&>(
+      GetEmbedderContext(EmbedderTestContextType::kSoftwareContext));
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetSoftwarePresentWithInfoCallbacks();
+  builder.SetDartEntrypoint("render_moving_box");
+
+  // Every frame is drawn into a buffer that last held the first frame, or
+  // into a new one for the first frame itself.
+  std::atomic<uint32_t> presented_frames = 0u;
+  context.SetBufferAgeCallback(
+      [&presented_frames]() -> uint32_t { return presented_frames.load(); });
+
+  auto to_sk_irects = [](const FlutterDamage& damage) {
+    std::vector<SkIRect> rects;
+    for (size_t i = 0; i < damage.num_rects; i++) {
+      const FlutterRect& rect = damage.damage[i];
+      rects.push_back(SkIRect::MakeLTRB(rect.left, rect.top, rect.right,
+                                        rect.bottom));
+    }
+    return rects;
+  };
+  auto bounds = [](const std::vector<SkIRect>& rects) {
+    SkIRect bounds = SkIRect::MakeEmpty();
+    for (const auto& rect : rects) {
+      bounds.join(rect);
+    }
+    return bounds;
+  };
+
+  std::vector<std::vector<SkIRect>> frame_damage;
+  std::vector<std::vector<SkIRect>> buffer_damage;
+  fml::CountDownLatch latch(3);
+  context.SetPresentInfoCallback(
+      [&](const FlutterSoftwarePresentInfo& present_info) {
+        frame_damage.push_back(to_sk_irects(present_info.frame_damage));
+        buffer_damage.push_back(to_sk_irects(present_info.buffer_damage));
+        presented_frames++;
+        latch.CountDown();
+      });
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  latch.Wait();
+
+  const SkIRect surface = SkIRect::MakeWH(800, 600);
+  ASSERT_EQ(frame_damage.size(), 3u);
+
+  // Nothing was presented before the first frame.
+  ASSERT_EQ(bounds(frame_damage[0]), surface);
+  ASSERT_EQ(bounds(buffer_damage[0]), surface);
+
+  // The box moved from x = 0 to x = 200.
+  ASSERT_TRUE(
+      bounds(frame_damage[1]).contains(SkIRect::MakeLTRB(0, 0, 300, 100)));
+  ASSERT_NE(bounds(frame_damage[1]), surface);
+
+  // The box moved from x = 200 to x = 400, and the buffer for the third frame
+  // still holds the first, so it also misses the damage of the second.
+  const SkIRect first_box = SkIRect::MakeWH(100, 100);
+  for (const auto& rect : frame_damage[2]) {
+    ASSERT_FALSE(SkIRect::Intersects(rect, first_box));
+  }
+  ASSERT_TRUE(
+      bounds(buffer_damage[2]).contains(SkIRect::MakeLTRB(0, 0, 500, 100)));
+  ASSERT_NE(bounds(buffer_damage[2]), surface);
+}
+
 TEST_F(EmbedderTest, VerifyB143464703WithSoftwareBackend) {
   auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
 
@@ -64,6 +64,10 @@ bool FileInNamespaceBuffer::IsDontNeedSafe() const {
   return true;
 }
 
+bool FileInNamespaceBuffer::IsSharedFileBacked() const {
+  return address_ != nullptr;
+}
+
 std::unique_ptr<fml::Mapping> LoadFile(int namespace_fd,
                                        const char* path,
                                        bool executable) {
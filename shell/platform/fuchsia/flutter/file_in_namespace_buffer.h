@@ -28,6 +28,9 @@ class FileInNamespaceBuffer final : public fml::Mapping {
   // |fml::Mapping|
   bool IsDontNeedSafe() const override;
 
+  // |fml::Mapping|
+  bool IsSharedFileBacked() const override;
+
  private:
   /// The address that was mapped to the buffer.
   void* address_;
@@ -478,6 +478,12 @@ std::unique_ptr<flutter::Surface> PlatformView::CreateRenderingSurface() {
   return on_create_surface_callback_ ? on_create_surface_callback_() : nullptr;
 }
 
+// |flutter::PlatformView|
+bool PlatformView::PrecompilesKnownSkSLs() const {
+  // The surfaces on Fuchsia are Vulkan surfaces.
+  return false;
+}
+
 // |flutter::PlatformView|
 std::shared_ptr<flutter::ExternalViewEmbedder>
 PlatformView::CreateExternalViewEmbedder() {
@@ -131,6 +131,9 @@ class PlatformView : public flutter::PlatformView,
   // |flutter::PlatformView|
   std::unique_ptr<flutter::Surface> CreateRenderingSurface() override;
 
+  // |flutter::PlatformView|
+  bool PrecompilesKnownSkSLs() const override;
+
   // |flutter::PlatformView|
   void HandlePlatformMessage(
       std::unique_ptr<flutter::PlatformMessage> message) override;
@@ -11,6 +11,7 @@ set -ex
 
 ./txt_benchmarks --benchmark_format=json > txt_benchmarks.json
 ./fml_benchmarks --benchmark_format=json > fml_benchmarks.json
+./flow_benchmarks --benchmark_format=json > flow_benchmarks.json
 ./shell_benchmarks --benchmark_format=json > shell_benchmarks.json
 ./ui_benchmarks --benchmark_format=json > ui_benchmarks.json
 
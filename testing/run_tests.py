@@ -430,8 +430,16 @@ def RunEngineBenchmarks(build_dir, filter):
 
   RunEngineExecutable(build_dir, 'fml_benchmarks', filter, icu_flags)
 
+  RunEngineExecutable(build_dir, 'flow_benchmarks', filter, icu_flags)
+
   RunEngineExecutable(build_dir, 'ui_benchmarks', filter, icu_flags)
 
+  RunEngineExecutable(build_dir, 'entity_benchmarks', filter, icu_flags)
+
+  RunEngineExecutable(build_dir, 'geometry_benchmarks', filter, icu_flags)
+
+  RunEngineExecutable(build_dir, 'tessellator_benchmarks', filter, icu_flags)
+
   if IsLinux():
     RunEngineExecutable(build_dir, 'txt_benchmarks', filter, icu_flags)
 